@@ -28,7 +28,9 @@
 #ifndef RAYCHELSCRIPT_ASSEMBLY_H
 #define RAYCHELSCRIPT_ASSEMBLY_H
 
+#include <cstdint>
 #include <variant>
+#include <vector>
 
 #include "AssemblerErrorCode.h"
 
@@ -47,8 +49,39 @@
 
 namespace RaychelScript::Assembler {
 
+    /**
+    * \brief Version of the code assemble() generates
+    *
+    * Compilation caches key their entries by this (see CachePipe.h). Bump it whenever assemble() emits different code for
+    * the same AST, even if the RSBF format stays the same.
+    */
+    constexpr std::uint32_t codegen_version = 2U;
+
+    /**
+    * \brief Assemble an AST into bytecode for the VM
+    *
+    * Calls to non-recursive functions whose body has at most inline_threshold AST nodes are expanded into the calling frame.
+    * The threshold can be set in the config block of the script (default: 16, 0 disables inlining).
+    */
     RAYCHELSCRIPT_ASSEMBLER_API [[nodiscard]] std::variant<AssemblerErrorCode, VM::VMData> assemble(const AST& ast) noexcept;
 
+    /**
+    * \brief Replace common instruction pairs in code by the equivalent fused instructions. Jump offsets are adjusted accordingly
+    *
+    * This is run on every call frame by assemble()
+    */
+    RAYCHELSCRIPT_ASSEMBLER_API void fuse_instructions(std::vector<Assembly::Instruction>& code) noexcept;
+
+    /**
+    * \brief Give every memory location of frame the lowest position that does not overlap with any other location it is live with
+    *
+    * Slot 0 (A) and the num_input_slots + num_output_slots slots after it keep their positions. Input slots are assumed to be
+    * written before the frame is entered and output slots to be read after it halts. frame.size shrinks accordingly.
+    * This is run on every call frame by assemble()
+    */
+    RAYCHELSCRIPT_ASSEMBLER_API void
+    allocate_slots(VM::CallFrameDescriptor& frame, std::uint32_t num_input_slots, std::uint32_t num_output_slots) noexcept;
+
 } //namespace RaychelScript::Assembler
 
 #endif //!RAYCHELSCRIPT_ASSEMBLY_H
@@ -40,6 +40,7 @@ namespace RaychelScript::Assembler {
         unknown_arithmetic_operation,
         unknown_relational_operation,
         invalid_scope_pop,
+        invalid_config_value,
         not_implemented,
     };
 
@@ -58,6 +59,8 @@ namespace RaychelScript::Assembler {
                 return "Unknown relational operation";
             case AssemblerErrorCode::invalid_scope_pop:
                 return "Tried to pop a scope with no scopes left on the stack";
+            case AssemblerErrorCode::invalid_config_value:
+                return "Invalid value for configuration variable";
             case AssemblerErrorCode::not_implemented:
                 return "Not implemented";
         }
@@ -40,6 +40,7 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <variant>
 
 namespace RaychelScript::Assembler {
@@ -88,6 +89,20 @@ namespace RaychelScript::Assembler {
             return _current_scope().lookup_table.emplace(std::move(name), _new_stack_index()).first->second;
         }
 
+        //Make name refer to a slot that already holds its value
+        ErrorOr<MemoryIndex> bind_variable(std::string name, MemoryIndex index)
+        {
+            if (has_identifier(scopes_, name))
+                return AssemblerErrorCode::duplicate_name;
+            return _current_scope().lookup_table.emplace(std::move(name), index).first->second;
+        }
+
+        //Allocate a stack slot that is not bound to any name yet
+        MemoryIndex allocate_stack_slot()
+        {
+            return _new_stack_index();
+        }
+
         MemoryIndex allocate_intermediate()
         {
             if (_current_scope().scope_data.empty()) {
@@ -107,13 +122,12 @@ namespace RaychelScript::Assembler {
 
         MemoryIndex allocate_immediate(double x)
         {
-            for (std::size_t i{}; i != data_.immediate_values.size(); ++i) {
-                if (data_.immediate_values.at(i) == x) {
-                    return make_memory_index(i, MemoryIndex::ValueType::immediate);
-                }
+            //Values that compare equal share one entry, just like a linear search with == would find them
+            const auto [it, inserted] = immediate_indices_.try_emplace(x, data_.immediate_values.size());
+            if (inserted) {
+                data_.immediate_values.emplace_back(x);
             }
-            data_.immediate_values.emplace_back(x);
-            return make_memory_index(data_.immediate_values.size() - 1, MemoryIndex::ValueType::immediate);
+            return make_memory_index(it->second, MemoryIndex::ValueType::immediate);
         }
 
         ErrorOr<MemoryIndex> index_for(const std::string& name)
@@ -148,12 +162,25 @@ namespace RaychelScript::Assembler {
             push_scope(false, name);
         }
 
+        void push_function_scope(const FunctionData& function)
+        {
+            push_function_scope(function.mangled_name);
+            current_function_ = &function;
+        }
+
         void pop_function_scope(std::string_view name)
         {
             current_frame_ = &data_.call_frames.front();
+            current_function_ = nullptr;
             (void)pop_scope(name);
         }
 
+        //The function whose call frame is being assembled, or nullptr for the global frame
+        [[nodiscard]] const FunctionData* current_function() const
+        {
+            return current_function_;
+        }
+
         template <OpCode op_code>
         auto emit(MemoryIndex a = {}, MemoryIndex b = {})
         {
@@ -203,6 +230,44 @@ namespace RaychelScript::Assembler {
             return AssemblerErrorCode::unresolved_identifier;
         }
 
+        void set_inlinable_functions(std::set<std::string> mangled_names)
+        {
+            inlinable_functions_ = std::move(mangled_names);
+        }
+
+        [[nodiscard]] bool should_inline(const std::string& mangled_name) const
+        {
+            return inlinable_functions_.contains(mangled_name);
+        }
+
+        /**
+        * \brief Start expanding a function body into the current call frame
+        *
+        * Return statements inside the body jump to the end of the expansion instead of emitting a RET. The jumps are collected
+        * here until the expansion is finished.
+        */
+        void push_inline_frame()
+        {
+            inline_frames_.emplace_back();
+        }
+
+        std::vector<std::size_t> pop_inline_frame()
+        {
+            auto return_jumps = std::move(inline_frames_.back());
+            inline_frames_.pop_back();
+            return return_jumps;
+        }
+
+        [[nodiscard]] bool is_inlining() const
+        {
+            return !inline_frames_.empty();
+        }
+
+        void add_return_jump(std::size_t instruction_index)
+        {
+            inline_frames_.back().push_back(instruction_index);
+        }
+
         bool has_marked_functions()
         {
             return !marked_functions_.empty();
@@ -243,8 +308,12 @@ namespace RaychelScript::Assembler {
 
         std::queue<FunctionData> marked_functions_{};
         std::set<MarkedFunction> all_marked_functions_{};
+        std::set<std::string> inlinable_functions_{};
+        std::vector<std::vector<std::size_t>> inline_frames_{};
+        std::unordered_map<double, std::size_t> immediate_indices_{};
         VM::VMData& data_;
         VM::CallFrameDescriptor* current_frame_{};
+        const FunctionData* current_function_{};
         std::vector<Scope> scopes_{};
     };
 
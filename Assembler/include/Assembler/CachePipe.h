@@ -0,0 +1,104 @@
+/**
+* \file CachePipe.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the cached compilation pipe
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_PIPES_CACHE_H
+#define RAYCHELSCRIPT_PIPES_CACHE_H
+
+#include "AssemblerPipe.h"
+#include "Parser/ParserPipe.h"
+#include "rasm/cache.h"
+#include "shared/Pipes/PipeResult.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "RaychelLogger/Logger.h"
+
+namespace RaychelScript::Pipes {
+
+    /**
+    * \brief Compile a script, or load it from a compilation cache if the same source was compiled before
+    *
+    * Can be used in place of Lex | Parse | Assemble. Cache entries are keyed by a hash of the source text, the RSBF
+    * version and Assembler::codegen_version (see rasm/cache.h). Entries compiled from a different source are misses. On a
+    * miss the script is compiled and written to the cache, so the next run skips lexing, parsing and assembling.
+    */
+    class CompileCached
+    {
+    public:
+        CompileCached(std::string_view source_text, std::string_view cache_directory)
+            : source_text_{source_text}, cache_directory_{cache_directory}, has_source_{true}
+        {}
+
+        CompileCached(details::LexFileTag /*unused*/, std::string_view file_path, std::string_view cache_directory)
+            : cache_directory_{cache_directory}
+        {
+            std::ifstream stream{std::string{file_path}};
+            if (!stream)
+                return;
+
+            source_text_.assign(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+            has_source_ = true;
+        }
+
+        PipeResult<VM::VMData> operator()() const noexcept
+        {
+            if (!has_source_) {
+                return Lexer::LexerErrorCode::no_input;
+            }
+
+            const auto key = Assembly::cache_key(source_text_, Assembler::codegen_version);
+            if (auto data_or_error = Assembly::read_cached_rsbf(cache_directory_, key, source_text_);
+                data_or_error.index() != 0U) {
+                return data_or_error;
+            }
+
+            auto data_or_error = Lex{source_text_} | Parse{} | Assemble{};
+            if (!data_or_error.is_error() &&
+                !Assembly::write_cached_rsbf(cache_directory_, key, source_text_, data_or_error.value())) {
+                Logger::warn("Could not write compilation cache entry for key ", key, " to '", cache_directory_, "'\n");
+            }
+
+            return data_or_error;
+        }
+
+        operator PipeResult<VM::VMData>() const noexcept //NOLINT: we want this conversion operator to be implicit
+        {
+            return (*this)();
+        }
+
+    private:
+        std::string source_text_;
+        std::string cache_directory_;
+        bool has_source_{false};
+    };
+
+} //namespace RaychelScript::Pipes
+
+#endif //!RAYCHELSCRIPT_PIPES_CACHE_H
@@ -29,12 +29,18 @@
 #include "Assembler/Assembler.h"
 
 #include "Assembler/AssemblingContext.h"
+#include "shared/Misc/Purity.h"
 #include "shared/Misc/WalkAST.h"
 
 #include "RaychelCore/AssertingGet.h"
 #include "RaychelCore/Finally.h"
 #include "RaychelCore/ScopedTimer.h"
 
+#include <charconv>
+#include <map>
+#include <ranges>
+#include <set>
+
 #define RAYCHELSCRIPT_ASSEMBLER_VERBOSE 1
 
 #define TRY(expression, name)                                                                                                    \
@@ -59,6 +65,9 @@
 
 namespace RaychelScript::Assembler {
 
+    //Measured in AST nodes of the function body
+    constexpr std::size_t default_inline_threshold = 16U;
+
     [[nodiscard]] static ErrorOr<Assembly::MemoryIndex> assemble(const AST_Node& node, AssemblingContext& ctx) noexcept;
 
     [[nodiscard]] static ErrorOr<Assembly::MemoryIndex>
@@ -376,10 +385,86 @@ namespace RaychelScript::Assembler {
         return AssemblerErrorCode::ok;
     }
 
+    [[nodiscard]] static bool function_writes_to(const FunctionData& function, const std::string& name) noexcept
+    {
+        bool writes{false};
+        for_each_node(function.body, [&](const AST_Node& node) {
+            if (node.type() == NodeType::assignment) {
+                const auto lhs = node.to_node_data<AssignmentExpressionData>().lhs;
+                writes = writes || (lhs.type() == NodeType::variable_ref && lhs.to_node_data<VariableReferenceData>().name == name);
+            } else if (node.type() == NodeType::update_expression) {
+                const auto lhs = node.to_node_data<UpdateExpressionData>().lhs;
+                writes = writes || (lhs.type() == NodeType::variable_ref && lhs.to_node_data<VariableReferenceData>().name == name);
+            }
+        });
+        return writes;
+    }
+
+    [[nodiscard]] static ErrorOr<Assembly::MemoryIndex>
+    assemble_inline(const FunctionCallData& data, const FunctionData& function, AssemblingContext& ctx) noexcept
+    {
+        RAYCHELSCRIPT_ASSEMBLER_DEBUG("Inlining function call ", data.mangled_callee_name, '\n');
+
+        //Arguments are evaluated in the scope of the caller. The body clobbers the A index, so values in it get their own slot
+        std::vector<std::pair<MemoryIndex, bool>> argument_indecies{};
+
+        for (const auto& argument : data.argument_expressions) {
+            TRY(assemble(argument, ctx), argument_index);
+
+            if (argument_index == ctx.a_index()) {
+                const auto slot_index = ctx.allocate_stack_slot();
+                ctx.emit<OpCode::mov>(argument_index, slot_index);
+                argument_indecies.emplace_back(slot_index, true);
+                continue;
+            }
+            argument_indecies.emplace_back(argument_index, false);
+        }
+
+        ScopePusher _{ctx, false, data.mangled_callee_name};
+
+        //Arguments refer directly to the slot holding their value unless the body writes to a slot owned by the caller
+        for (std::size_t i{}; i != function.arguments.size(); ++i) {
+            const auto& name = function.arguments.at(i);
+            const auto [argument_index, is_owned] = argument_indecies.at(i);
+
+            if (is_owned || !function_writes_to(function, name)) {
+                TRY(ctx.bind_variable(name, argument_index), bound_index);
+                RAYCHELSCRIPT_ASSEMBLER_DEBUG("Bound argument '", name, "' to index ", bound_index, '\n');
+                continue;
+            }
+
+            TRY(ctx.add_variable(name), slot_index);
+            ctx.emit<OpCode::mov>(argument_index, slot_index);
+        }
+
+        ctx.push_inline_frame();
+        for (const auto& node : function.body) {
+            TRY_NO_INDEX(assemble(node, ctx));
+        }
+        auto return_jumps = ctx.pop_inline_frame();
+
+        //Nothing can jump past a return at the very end of the body, so it can just fall through
+        if (!function.body.empty() && function.body.back().type() == NodeType::function_return && !return_jumps.empty() &&
+            return_jumps.back() == ctx.next_instruction_index() - 1U) {
+            ctx.instructions().pop_back();
+            return_jumps.pop_back();
+        }
+
+        for (const auto jump_index : return_jumps) {
+            ctx.instructions().at(jump_index).index1() = make_jump_offset(jump_index, ctx.next_instruction_index());
+        }
+
+        return ctx.a_index();
+    }
+
     [[nodiscard]] static ErrorOr<Assembly::MemoryIndex> assemble(const FunctionCallData& data, AssemblingContext& ctx) noexcept
     {
         RAYCHELSCRIPT_ASSEMBLER_DEBUG("Assembling function call ", data.mangled_callee_name, '\n');
 
+        if (ctx.should_inline(data.mangled_callee_name)) {
+            return assemble_inline(data, ctx.ast.functions.at(data.mangled_callee_name), ctx);
+        }
+
         //Check if function exists / get its index
 
         if (const auto ec = ctx.mark_function(data.mangled_callee_name); ec != AssemblerErrorCode::ok)
@@ -415,16 +500,85 @@ namespace RaychelScript::Assembler {
         return ctx.a_index();
     }
 
+    [[nodiscard]] static bool is_self_tail_call(const FunctionReturnData& data, AssemblingContext& ctx) noexcept
+    {
+        if (ctx.is_inlining() || ctx.current_function() == nullptr || data.return_value.type() != NodeType::function_call) {
+            return false;
+        }
+        return data.return_value.to_node_data<FunctionCallData>().mangled_callee_name == ctx.current_function()->mangled_name;
+    }
+
+    /**
+    * Compile return f(...) inside f into a loop: the arguments are reassigned and execution jumps back to the start of the body.
+    * The new argument values are computed before any of them is overwritten, just like they would be for a call.
+    */
+    [[nodiscard]] static ErrorOr<Assembly::MemoryIndex> assemble_self_tail_call(const FunctionCallData& data, AssemblingContext& ctx) noexcept
+    {
+        RAYCHELSCRIPT_ASSEMBLER_DEBUG("Assembling self tail call ", data.mangled_callee_name, '\n');
+
+        const auto& function = *ctx.current_function();
+
+        std::vector<MemoryIndex> argument_slots{};
+        for (const auto& name : function.arguments) {
+            TRY(ctx.index_for(name), slot_index);
+            argument_slots.push_back(slot_index);
+        }
+
+        std::vector<MemoryIndex> argument_indecies{};
+        for (const auto& argument : data.argument_expressions) {
+            TRY(assemble(argument, ctx), argument_index);
+
+            //The A index is volatile, so every value in it must be saved before the next argument is evaluated
+            if (argument_index == ctx.a_index()) {
+                const auto intermediate_index = ctx.allocate_intermediate();
+                ctx.emit<OpCode::mov>(argument_index, intermediate_index);
+                argument_index = intermediate_index;
+            }
+            argument_indecies.push_back(argument_index);
+        }
+
+        //An argument that reads another argument's slot must not see the new value of that slot
+        for (std::size_t i{}; i != argument_indecies.size(); ++i) {
+            auto& argument_index = argument_indecies.at(i);
+            if (argument_index != argument_slots.at(i) && std::ranges::find(argument_slots, argument_index) != argument_slots.end()) {
+                const auto intermediate_index = ctx.allocate_intermediate();
+                ctx.emit<OpCode::mov>(argument_index, intermediate_index);
+                argument_index = intermediate_index;
+            }
+        }
+
+        for (std::size_t i{}; i != argument_indecies.size(); ++i) {
+            const auto argument_index = argument_indecies.at(i);
+            if (argument_index != argument_slots.at(i)) {
+                ctx.emit<OpCode::mov>(argument_index, argument_slots.at(i));
+            }
+            ctx.free_intermediate(argument_index);
+        }
+
+        ctx.emit<OpCode::jmp>(make_jump_offset(ctx.next_instruction_index(), 0U));
+
+        return AssemblerErrorCode::ok;
+    }
+
     [[nodiscard]] static ErrorOr<Assembly::MemoryIndex> assemble(const FunctionReturnData& data, AssemblingContext& ctx) noexcept
     {
         RAYCHELSCRIPT_ASSEMBLER_DEBUG("Assembling return expression\n");
 
+        if (is_self_tail_call(data, ctx)) {
+            return assemble_self_tail_call(data.return_value.to_node_data<FunctionCallData>(), ctx);
+        }
+
         TRY(assemble(data.return_value, ctx), return_index);
 
         if (return_index != ctx.a_index()) {
             ctx.emit<OpCode::mov>(return_index, ctx.a_index());
         }
 
+        if (ctx.is_inlining()) {
+            ctx.add_return_jump(ctx.emit<OpCode::jmp>());
+            return AssemblerErrorCode::ok;
+        }
+
         ctx.emit<OpCode::ret>();
 
         return AssemblerErrorCode::ok;
@@ -440,6 +594,70 @@ namespace RaychelScript::Assembler {
         return maybe_result;
     }
 
+    [[nodiscard]] static ErrorOr<std::size_t> get_inline_threshold(const ConfigBlock& config_block) noexcept
+    {
+        const auto it = config_block.config_vars.find("inline_threshold");
+        if (it == config_block.config_vars.end()) {
+            return default_inline_threshold;
+        }
+
+        const auto& values = it->second;
+        std::size_t threshold{};
+        if (values.size() == 1U) {
+            const auto& value = values.front();
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), threshold);
+            if (ec == std::errc{} && end == value.data() + value.size()) {
+                return threshold;
+            }
+        }
+
+        Logger::error("Config variable 'inline_threshold' must be a single non-negative integer!\n");
+        return AssemblerErrorCode::invalid_config_value;
+    }
+
+    //Functions that are part of a call cycle can never be fully expanded
+    [[nodiscard]] static std::set<std::string> find_inlinable_functions(const AST& ast, std::size_t threshold) noexcept
+    {
+        std::map<std::string, std::set<std::string>> callees;
+        for (const auto& [name, function] : ast.functions) {
+            for_each_node(function.body, [&callees, &name = name](const AST_Node& node) {
+                if (node.type() == NodeType::function_call) {
+                    callees[name].insert(node.to_node_data<FunctionCallData>().mangled_callee_name);
+                }
+            });
+        }
+
+        const auto is_recursive = [&callees](const std::string& name) {
+            std::set<std::string> visited;
+            std::vector<std::string> pending{name};
+            while (!pending.empty()) {
+                const auto current = std::move(pending.back());
+                pending.pop_back();
+                for (const auto& callee : callees[current]) {
+                    if (callee == name) {
+                        return true;
+                    }
+                    if (visited.insert(callee).second) {
+                        pending.push_back(callee);
+                    }
+                }
+            }
+            return false;
+        };
+
+        std::set<std::string> inlinable_functions;
+        for (const auto& [name, function] : ast.functions) {
+            std::size_t size{};
+            for_each_node(function.body, [&size](const AST_Node& /*unused*/) { ++size; });
+
+            //a function with an empty body would still fit into a threshold of 0, which has to disable inlining entirely
+            if (threshold != 0U && size <= threshold && !is_recursive(name)) {
+                inlinable_functions.insert(name);
+            }
+        }
+        return inlinable_functions;
+    }
+
     [[nodiscard]] ErrorOr<VM::VMData> assemble(const AST& ast) noexcept
     {
         [[maybe_unused]] Raychel::ScopedTimer<std::chrono::microseconds> timer{"Assembling time"};
@@ -447,6 +665,12 @@ namespace RaychelScript::Assembler {
         VM::VMData output{};
         AssemblingContext ctx{ast, output};
 
+        const auto maybe_threshold = get_inline_threshold(ast.config_block);
+        if (const auto* ec = std::get_if<AssemblerErrorCode>(&maybe_threshold); ec) {
+            return *ec;
+        }
+        ctx.set_inlinable_functions(find_inlinable_functions(ast, Raychel::get<std::size_t>(maybe_threshold)));
+
         for (const auto& name : ast.config_block.input_identifiers) {
             TRY(ctx.add_variable(name), index)
             ++output.num_input_identifiers;
@@ -465,10 +689,13 @@ namespace RaychelScript::Assembler {
 
         ctx.emit<OpCode::hlt>();
 
+        const auto pure_functions = find_pure_functions(ast);
         while (ctx.has_marked_functions()) {
             const auto function = ctx.next_marked_function();
             RAYCHELSCRIPT_ASSEMBLER_DEBUG("Assembling function '", function.mangled_name, "'\n");
-            ctx.push_function_scope(function.mangled_name);
+            ctx.push_function_scope(function);
+            output.call_frames.back().num_arguments = static_cast<std::uint32_t>(function.arguments.size());
+            output.call_frames.back().is_pure = pure_functions.contains(function.mangled_name);
             for (const auto& arg : function.arguments) {
                 TRY(ctx.add_variable(arg), index);
                 (void)index;
@@ -480,6 +707,16 @@ namespace RaychelScript::Assembler {
             ctx.pop_function_scope(function.mangled_name);
         }
 
+        //Function frames only receive their arguments from the caller, the result is passed back in A
+        allocate_slots(output.call_frames.front(), output.num_input_identifiers, output.num_output_identifiers);
+        for (auto& frame : output.call_frames | std::views::drop(1)) {
+            allocate_slots(frame, frame.num_arguments, 0U);
+        }
+
+        for (auto& frame : output.call_frames) {
+            fuse_instructions(frame.instructions);
+        }
+
         return output;
     }
 
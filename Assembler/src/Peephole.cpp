@@ -0,0 +1,186 @@
+/**
+* \file Peephole.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the peephole pass that emits fused instructions
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "Assembler/Assembler.h"
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace RaychelScript::Assembler {
+
+    using Assembly::Instruction;
+    using Assembly::MemoryIndex;
+    using Assembly::OpCode;
+
+    namespace {
+
+        constexpr auto no_target = std::numeric_limits<std::size_t>::max();
+
+        //The A register is stack slot zero, no matter what kind of index refers to it
+        bool is_a_index(MemoryIndex index) noexcept
+        {
+            return index.type() != MemoryIndex::ValueType::immediate && index.value() == 0U;
+        }
+
+        MemoryIndex* jump_offset(Instruction& instruction) noexcept
+        {
+            switch (instruction.op_code()) {
+                case OpCode::jpz:
+                case OpCode::jmp:
+                    return &instruction.index1();
+                case OpCode::jnl:
+                case OpCode::jng:
+                case OpCode::jne:
+                case OpCode::jeq:
+                    return &instruction.index3();
+                default:
+                    return nullptr;
+            }
+        }
+
+        //Index of the instruction that the jump at code[index] lands on, or no_target if code[index] is not a jump
+        std::size_t jump_target(const std::vector<Instruction>& code, std::size_t index) noexcept
+        {
+            auto instruction = code[index];
+            const auto* offset = jump_offset(instruction);
+            if (offset == nullptr)
+                return no_target;
+            return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(index) + offset->offset());
+        }
+
+        std::optional<OpCode> fused_branch(OpCode compare) noexcept
+        {
+            switch (compare) {
+                case OpCode::clt:
+                    return OpCode::jnl;
+                case OpCode::cgt:
+                    return OpCode::jng;
+                case OpCode::ceq:
+                    return OpCode::jne;
+                case OpCode::cne:
+                    return OpCode::jeq;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        std::optional<OpCode> fused_store(OpCode arithmetic) noexcept
+        {
+            switch (arithmetic) {
+                case OpCode::add:
+                    return OpCode::adt;
+                case OpCode::sub:
+                    return OpCode::sbt;
+                case OpCode::mul:
+                    return OpCode::mlt;
+                case OpCode::div:
+                    return OpCode::dvt;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        std::optional<Instruction> fuse(const Instruction& first, const Instruction& second) noexcept
+        {
+            //CMP a b; JPZ c -> J** a b c
+            if (const auto code = fused_branch(first.op_code()); code.has_value() && second.op_code() == OpCode::jpz)
+                return Instruction{*code, first.index1(), first.index2(), second.index1()};
+
+            //MUL a b; ADD A c -> MAD a b c. IEEE addition is commutative, so ADD c A works too.
+            //c must not be A itself because MAD reads it after the product has been computed
+            if (first.op_code() == OpCode::mul && second.op_code() == OpCode::add) {
+                const auto lhs = second.index1();
+                const auto rhs = second.index2();
+                if (is_a_index(lhs) && !is_a_index(rhs))
+                    return Instruction{OpCode::mad, first.index1(), first.index2(), rhs};
+                if (is_a_index(rhs) && !is_a_index(lhs))
+                    return Instruction{OpCode::mad, first.index1(), first.index2(), lhs};
+            }
+
+            //OP a b; MOV A c -> OPT a b c. The result is still written to A, so it does not matter if A is read later on
+            if (const auto code = fused_store(first.op_code()); code.has_value() && second.op_code() == OpCode::mov) {
+                if (is_a_index(second.index1()) && !is_a_index(second.index2()))
+                    return Instruction{*code, first.index1(), first.index2(), second.index2()};
+            }
+
+            return std::nullopt;
+        }
+
+    } // namespace
+
+    void fuse_instructions(std::vector<Instruction>& code) noexcept
+    {
+        //Fusing an instruction that a jump lands on would move the jump target into the middle of the fused instruction
+        std::vector<bool> is_jump_target(code.size() + 1, false);
+        for (std::size_t i{}; i != code.size(); ++i) {
+            const auto target = jump_target(code, i);
+            if (target == no_target)
+                continue;
+            if (target > code.size()) [[unlikely]]
+                return; //Malformed jump. Leave the code alone so it still fails the same way at runtime
+            is_jump_target[target] = true;
+        }
+
+        std::vector<Instruction> fused{};
+        std::vector<std::size_t> targets{};
+        std::vector<std::size_t> new_index(code.size() + 1);
+        fused.reserve(code.size());
+        targets.reserve(code.size());
+
+        for (std::size_t i{}; i != code.size(); ++i) {
+            new_index[i] = fused.size();
+
+            if (i + 1 != code.size() && !is_jump_target[i + 1]) {
+                if (const auto instruction = fuse(code[i], code[i + 1]); instruction.has_value()) {
+                    new_index[i + 1] = fused.size();
+                    //If the pair contained a jump, it was the second instruction
+                    targets.push_back(jump_target(code, i + 1));
+                    fused.push_back(*instruction);
+                    ++i;
+                    continue;
+                }
+            }
+
+            targets.push_back(jump_target(code, i));
+            fused.push_back(code[i]);
+        }
+        new_index[code.size()] = fused.size();
+
+        //Fusing only ever shrinks the code, so the relocated offsets still fit
+        for (std::size_t i{}; i != fused.size(); ++i) {
+            if (targets[i] == no_target)
+                continue;
+            *jump_offset(fused[i]) = make_memory_index(
+                static_cast<std::ptrdiff_t>(new_index[targets[i]]) - static_cast<std::ptrdiff_t>(i), MemoryIndex::ValueType::jump_offset);
+        }
+
+        code = std::move(fused);
+    }
+
+} //namespace RaychelScript::Assembler
@@ -0,0 +1,352 @@
+/**
+* \file SlotAllocation.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the call frame slot allocator
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "Assembler/Assembler.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace RaychelScript::Assembler {
+
+    using Assembly::Instruction;
+    using Assembly::MemoryIndex;
+    using Assembly::OpCode;
+
+    namespace {
+
+        constexpr auto no_successor = std::numeric_limits<std::size_t>::max();
+
+        enum class Access : std::uint8_t {
+            none,
+            read,
+            write,
+            read_write,
+        };
+
+        using OperandAccess = std::array<Access, 3>;
+
+        //How an instruction accesses the memory locations its three indices refer to. Writes to A are not listed.
+        std::optional<OperandAccess> operand_access(OpCode code) noexcept
+        {
+            using enum Access;
+            switch (code) {
+                case OpCode::mov:
+                    return OperandAccess{read, write, none};
+                case OpCode::add:
+                case OpCode::sub:
+                case OpCode::mul:
+                case OpCode::div:
+                case OpCode::pow:
+                case OpCode::clt:
+                case OpCode::cgt:
+                case OpCode::ceq:
+                case OpCode::cne:
+                case OpCode::jnl:
+                case OpCode::jng:
+                case OpCode::jne:
+                case OpCode::jeq:
+                    return OperandAccess{read, read, none};
+                case OpCode::mag:
+                case OpCode::fac:
+                //The second index of PUT lives in the frame of the callee
+                case OpCode::put:
+                    return OperandAccess{read, none, none};
+                case OpCode::inc:
+                case OpCode::dec:
+                case OpCode::mas:
+                case OpCode::das:
+                case OpCode::pas:
+                    return OperandAccess{read_write, read, none};
+                case OpCode::mad:
+                    return OperandAccess{read, read, read};
+                case OpCode::adt:
+                case OpCode::sbt:
+                case OpCode::mlt:
+                case OpCode::dvt:
+                    return OperandAccess{read, read, write};
+                case OpCode::jpz:
+                case OpCode::jmp:
+                case OpCode::hlt:
+                case OpCode::jsr:
+                case OpCode::ret:
+                    return OperandAccess{none, none, none};
+                case OpCode::num_op_codes:
+                    break;
+            }
+            return std::nullopt;
+        }
+
+        //The A register is never renamed because every frame expects its result there
+        bool is_slot(MemoryIndex index) noexcept
+        {
+            return (index.type() == MemoryIndex::ValueType::stack || index.type() == MemoryIndex::ValueType::intermediate) &&
+                   index.value() != 0U;
+        }
+
+        std::array<MemoryIndex*, 3> operands(Instruction& instruction) noexcept
+        {
+            return {&instruction.index1(), &instruction.index2(), &instruction.index3()};
+        }
+
+        std::optional<MemoryIndex> jump_offset(const Instruction& instruction) noexcept
+        {
+            switch (instruction.op_code()) {
+                case OpCode::jpz:
+                case OpCode::jmp:
+                    return instruction.index1();
+                case OpCode::jnl:
+                case OpCode::jng:
+                case OpCode::jne:
+                case OpCode::jeq:
+                    return instruction.index3();
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        //One bit per memory location of a call frame
+        class SlotSet
+        {
+            static constexpr std::size_t bits_per_word = 64U;
+
+        public:
+            explicit SlotSet(std::size_t size) : words_((size + bits_per_word - 1U) / bits_per_word)
+            {}
+
+            void insert(std::uint32_t slot) noexcept
+            {
+                words_[slot / bits_per_word] |= std::uint64_t{1} << (slot % bits_per_word);
+            }
+
+            void erase(std::uint32_t slot) noexcept
+            {
+                words_[slot / bits_per_word] &= ~(std::uint64_t{1} << (slot % bits_per_word));
+            }
+
+            void merge(const SlotSet& other) noexcept
+            {
+                for (std::size_t i{}; i != words_.size(); ++i) {
+                    words_[i] |= other.words_[i];
+                }
+            }
+
+            template <typename F>
+            void for_each(F&& f) const noexcept
+            {
+                for (std::size_t i{}; i != words_.size(); ++i) {
+                    auto word = words_[i];
+                    while (word != 0U) {
+                        const auto bit = static_cast<std::size_t>(std::countr_zero(word));
+                        f(static_cast<std::uint32_t>(i * bits_per_word + bit));
+                        word &= word - 1U;
+                    }
+                }
+            }
+
+            bool operator==(const SlotSet& other) const noexcept = default;
+
+        private:
+            std::vector<std::uint64_t> words_;
+        };
+
+        struct InstructionInfo
+        {
+            std::array<std::size_t, 2> successors{no_successor, no_successor};
+            SlotSet uses;
+            SlotSet defs;
+        };
+
+        //Returns std::nullopt if the code contains anything we do not understand. The frame is left alone in that case
+        std::optional<std::vector<InstructionInfo>>
+        analyze_instructions(std::vector<Instruction>& code, std::uint32_t num_slots) noexcept
+        {
+            std::vector<InstructionInfo> infos;
+            infos.reserve(code.size());
+
+            for (std::size_t i{}; i != code.size(); ++i) {
+                auto& info = infos.emplace_back(InstructionInfo{.uses = SlotSet{num_slots}, .defs = SlotSet{num_slots}});
+                const auto access = operand_access(code[i].op_code());
+                if (!access.has_value())
+                    return std::nullopt;
+
+                const auto indices = operands(code[i]);
+                for (std::size_t j{}; j != indices.size(); ++j) {
+                    const auto index = *indices[j];
+                    if ((*access)[j] == Access::none || !is_slot(index))
+                        continue;
+                    if (index.value() >= num_slots)
+                        return std::nullopt;
+
+                    if ((*access)[j] != Access::write)
+                        info.uses.insert(index.value());
+                    if ((*access)[j] != Access::read)
+                        info.defs.insert(index.value());
+                }
+
+                const auto code_ends = code[i].op_code() == OpCode::hlt || code[i].op_code() == OpCode::ret;
+                if (!code_ends && code[i].op_code() != OpCode::jmp && i + 1 != code.size())
+                    info.successors[0] = i + 1;
+
+                if (const auto offset = jump_offset(code[i]); offset.has_value()) {
+                    const auto target = static_cast<std::ptrdiff_t>(i) + offset->offset();
+                    if (target < 0 || std::cmp_greater(target, code.size()))
+                        return std::nullopt;
+                    if (std::cmp_less(target, code.size()))
+                        info.successors[1] = static_cast<std::size_t>(target);
+                }
+            }
+
+            return infos;
+        }
+
+        struct Liveness
+        {
+            std::vector<SlotSet> live_in;
+            std::vector<SlotSet> live_out;
+        };
+
+        //Iterate the backwards dataflow equations until nothing changes
+        Liveness compute_liveness(
+            const std::vector<Instruction>& code, const std::vector<InstructionInfo>& infos, const SlotSet& live_at_halt,
+            std::uint32_t num_slots) noexcept
+        {
+            Liveness liveness{
+                .live_in = std::vector<SlotSet>(code.size(), SlotSet{num_slots}),
+                .live_out = std::vector<SlotSet>(code.size(), SlotSet{num_slots})};
+
+            bool changed{true};
+            while (changed) {
+                changed = false;
+                for (std::size_t i = code.size(); i-- != 0U;) {
+                    SlotSet live = code[i].op_code() == OpCode::hlt ? live_at_halt : SlotSet{num_slots};
+                    for (const auto successor : infos[i].successors) {
+                        if (successor != no_successor)
+                            live.merge(liveness.live_in[successor]);
+                    }
+                    liveness.live_out[i] = live;
+
+                    infos[i].defs.for_each([&live](std::uint32_t slot) { live.erase(slot); });
+                    live.merge(infos[i].uses);
+
+                    if (live != liveness.live_in[i]) {
+                        liveness.live_in[i] = std::move(live);
+                        changed = true;
+                    }
+                }
+            }
+
+            return liveness;
+        }
+
+    } // namespace
+
+    void allocate_slots(VM::CallFrameDescriptor& frame, std::uint32_t num_input_slots, std::uint32_t num_output_slots) noexcept
+    {
+        auto& code = frame.instructions;
+        const auto num_slots = frame.size;
+        const auto num_fixed_slots = 1U + num_input_slots + num_output_slots;
+        if (code.empty() || num_fixed_slots >= num_slots)
+            return;
+
+        const auto maybe_infos = analyze_instructions(code, num_slots);
+        if (!maybe_infos.has_value())
+            return;
+        const auto& infos = *maybe_infos;
+
+        SlotSet live_at_halt{num_slots};
+        for (auto slot = 1U + num_input_slots; slot != num_fixed_slots; ++slot) {
+            live_at_halt.insert(slot);
+        }
+
+        const auto [live_in, live_out] = compute_liveness(code, infos, live_at_halt, num_slots);
+
+        //Two slots interfere if one is written while the other one is live
+        std::vector<SlotSet> interferes_with(num_slots, SlotSet{num_slots});
+        const auto add_interference = [&interferes_with](std::uint32_t slot, const SlotSet& live) {
+            live.for_each([&](std::uint32_t other) {
+                if (other != slot) {
+                    interferes_with[slot].insert(other);
+                    interferes_with[other].insert(slot);
+                }
+            });
+        };
+
+        for (std::size_t i{}; i != code.size(); ++i) {
+            infos[i].defs.for_each([&](std::uint32_t slot) { add_interference(slot, live_out[i]); });
+        }
+
+        //Inputs, outputs and arguments are written before the first instruction runs. Slots that are read before they are
+        //written have to keep whatever was there on entry, too
+        auto written_on_entry = live_in.front();
+        for (auto slot = 1U; slot != num_fixed_slots; ++slot) {
+            written_on_entry.insert(slot);
+        }
+        written_on_entry.for_each([&](std::uint32_t slot) { add_interference(slot, live_in.front()); });
+
+        //Fixed slots keep their position. Every other slot gets the lowest position none of its neighbours already has
+        std::vector<std::uint32_t> new_position(num_slots);
+        for (std::uint32_t slot{}; slot != num_fixed_slots; ++slot) {
+            new_position[slot] = slot;
+        }
+
+        auto new_size = num_fixed_slots;
+        std::vector<bool> is_taken;
+        for (auto slot = num_fixed_slots; slot != num_slots; ++slot) {
+            is_taken.assign(new_size + 1U, false);
+            interferes_with[slot].for_each([&](std::uint32_t other) {
+                if (other < slot)
+                    is_taken[new_position[other]] = true;
+            });
+
+            std::uint32_t position{1U};
+            while (is_taken[position]) {
+                ++position;
+            }
+            new_position[slot] = position;
+            new_size = std::max(new_size, position + 1U);
+        }
+
+        for (auto& instruction : code) {
+            const auto access = *operand_access(instruction.op_code());
+            const auto indices = operands(instruction);
+            for (std::size_t j{}; j != indices.size(); ++j) {
+                if (access[j] != Access::none && is_slot(*indices[j]))
+                    *indices[j] = make_memory_index(new_position[indices[j]->value()], indices[j]->type());
+            }
+        }
+
+        frame.size = new_size;
+    }
+
+} //namespace RaychelScript::Assembler
@@ -3,6 +3,10 @@
 #include "Lexer/LexerPipe.h"
 #include "Parser/ParserPipe.h"
 #include "rasm/write.h"
+#include "shared/Misc/WalkAST.h"
+
+#include <algorithm>
+#include <charconv>
 
 int main(int argc, char** argv)
 {
@@ -24,7 +28,8 @@ int main(int argc, char** argv)
 
     Logger::setMinimumLogLevel(Logger::LogLevel::debug);
 
-    auto data_or_error = Lex{lex_file, script_name} | Parse{} | Assemble{};
+    const auto ast_or_error = Lex{lex_file, script_name} | Parse{};
+    auto data_or_error = ast_or_error | Assemble{};
     if (log_if_error(data_or_error)) {
         return 1;
     }
@@ -47,6 +52,51 @@ int main(int argc, char** argv)
         }
     }
 
+    //Scripts that test slot allocation state how many slots their global frame may take at most
+    const auto& config_vars = ast_or_error.value().config_block.config_vars;
+    if (const auto it = config_vars.find("max_frame_size"); it != config_vars.end()) {
+        std::size_t max_frame_size{};
+        const auto& value = it->second.at(0);
+        (void)std::from_chars(value.data(), value.data() + value.size(), max_frame_size);
+        const auto frame_size = data.call_frames.front().size;
+        if (frame_size > max_frame_size) {
+            Logger::error("The global frame takes ", frame_size, " slots, expected at most ", max_frame_size, "!\n");
+            return 1;
+        }
+    }
+
+    //A threshold of 0 disables inlining, so every call in the global scope has to stay a JSR
+    auto ast = ast_or_error.value();
+    ast.config_block.config_vars["inline_threshold"] = {"0"};
+    const auto not_inlined_or_error = PipeResult<RaychelScript::AST>{ast} | Assemble{};
+    if (log_if_error(not_inlined_or_error)) {
+        return 1;
+    }
+    std::size_t number_of_calls{};
+    RaychelScript::for_each_node(ast.nodes, [&number_of_calls](const RaychelScript::AST_Node& node) {
+        if (node.type() == RaychelScript::NodeType::function_call) {
+            ++number_of_calls;
+        }
+    });
+    const auto& global_instructions = not_inlined_or_error.value().call_frames.front().instructions;
+    const auto number_of_jumps = std::ranges::count_if(
+        global_instructions, [](const auto& instr) { return instr.op_code() == RaychelScript::Assembly::OpCode::jsr; });
+    if (static_cast<std::size_t>(number_of_jumps) != number_of_calls) {
+        Logger::error("Assembling with inline_threshold 0 emitted ", number_of_jumps, " JSRs for ", number_of_calls, " calls!\n");
+        return 1;
+    }
+
+    for (const auto& malformed_threshold : std::vector<std::vector<std::string>>{{"-1"}, {"16x"}, {"1.5"}, {"4", "8"}, {}}) {
+        ast.config_block.config_vars["inline_threshold"] = malformed_threshold;
+        const auto malformed_or_error = PipeResult<RaychelScript::AST>{ast} | Assemble{};
+        if (!malformed_or_error.is_error() || malformed_or_error.error_type() != ErrorType::assembler_error ||
+            malformed_or_error.to_error_code<RaychelScript::Assembler::AssemblerErrorCode>() !=
+                RaychelScript::Assembler::AssemblerErrorCode::invalid_config_value) {
+            Logger::error("A malformed inline_threshold was not rejected as an invalid config value!\n");
+            return 1;
+        }
+    }
+
     if (output_filename.empty())
         return 0;
 
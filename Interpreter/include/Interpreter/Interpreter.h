@@ -45,10 +45,12 @@
 #include <concepts>
 #include <map>
 #include <optional>
+#include <span>
 #include <string>
 #include <variant>
 
 #include "shared/AST/AST.h"
+#include "shared/Misc/CallCache.h"
 
 #include "RaychelCore/AssertingGet.h"
 #include "RaychelCore/AssertingOptional.h"
@@ -60,6 +62,29 @@ namespace RaychelScript::Interpreter {
     RAYCHELSCRIPT_INTERPRETER_API [[nodiscard]] ExecutionResult
     interpret(const AST& ast, const std::map<std::string, double>& parameters) noexcept;
 
+    /**
+    * \brief Interpret the script with memoisation of pure functions enabled
+    *
+    * call_cache keeps its entries between runs and must have been created with make_call_cache() for the same AST.
+    */
+    RAYCHELSCRIPT_INTERPRETER_API [[nodiscard]] ExecutionResult
+    interpret(const AST& ast, const std::map<std::string, double>& parameters, CallCache& call_cache) noexcept;
+
+    /**
+    * \brief Create a memoisation cache with capacity entries for every pure function of ast
+    */
+    RAYCHELSCRIPT_INTERPRETER_API [[nodiscard]] CallCache
+    make_call_cache(const AST& ast, std::size_t capacity = CallCache::default_capacity) noexcept;
+
+    /**
+    * \brief Interpret the script for count input vectors
+    *
+    * Inputs and outputs are laid out as structure-of-arrays like in VM::execute_batch(), in the order of the config block.
+    * ast is only read, so several threads may interpret the same AST at once.
+    */
+    RAYCHELSCRIPT_INTERPRETER_API [[nodiscard]] InterpreterErrorCode interpret_batch(
+        const AST& ast, std::span<const double> input_values, std::span<double> output_values, std::size_t count) noexcept;
+
 } // namespace RaychelScript::Interpreter
 
 #endif //!RAYCHELSCRIPT_INTERPRETER_H
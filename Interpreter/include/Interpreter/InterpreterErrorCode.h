@@ -38,6 +38,7 @@ namespace RaychelScript::Interpreter {
         no_input,
         not_enough_input_identifiers,
         invalid_input_identifier,
+        mismatched_outputs,
         divide_by_zero,
         constant_reassign,
         invalid_argument,
@@ -64,6 +65,8 @@ namespace RaychelScript::Interpreter {
                 return "Not enough input identifiers were provided"sv;
             case EC::invalid_input_identifier:
                 return "Input identifier was not in the ASTs input specification";
+            case EC::mismatched_outputs:
+                return "Output buffer does not match the ASTs output specification"sv;
             case EC::divide_by_zero:
                 return "Division by Zero"sv;
             case EC::constant_reassign:
@@ -39,6 +39,7 @@
 
 namespace RaychelScript {
     struct AST;
+    class CallCache;
 } //namespace RaychelScript
 
 namespace RaychelScript::Interpreter {
@@ -79,6 +80,9 @@ namespace RaychelScript::Interpreter {
         bool _load_references{false};
 
         std::size_t indent{};
+
+        //Consulted by function calls if memoisation is enabled. Functions are numbered in the order of AST::functions
+        CallCache* call_cache{};
     };
 } //namespace RaychelScript::Interpreter
 
@@ -28,6 +28,7 @@
 
 #include "Interpreter/Interpreter.h"
 #include "shared/AST/NodeData.h"
+#include "shared/Misc/Purity.h"
 
 #include <algorithm>
 #include <cmath>
@@ -191,6 +192,11 @@ namespace RaychelScript::Interpreter {
             return;
         }
 
+        //Values are allocated in scope order, so the values of the innermost scope are always at the end.
+        //Erasing them one by one in lookup table order would shift the indices of the ones not yet erased
+        std::size_t number_of_constants{};
+        std::size_t number_of_variables{};
+
         const auto& scope = scopes.back();
         for ([[maybe_unused]] const auto& [name, index] : scope.lookup_table) {
             RAYCHELSCRIPT_INTERPRETER_DEBUG(
@@ -202,11 +208,13 @@ namespace RaychelScript::Interpreter {
                 index.index,
                 '\n');
             if (index.is_constant) {
-                constants.erase(constants.begin() + static_cast<std::ptrdiff_t>(index.index));
+                ++number_of_constants;
             } else {
-                variables.erase(variables.begin() + static_cast<std::ptrdiff_t>(index.index));
+                ++number_of_variables;
             }
         }
+        constants.resize(constants.size() - number_of_constants);
+        variables.resize(variables.size() - number_of_variables);
         scopes.pop_back();
         _current_descriptor.reset();
     }
@@ -646,6 +654,25 @@ namespace RaychelScript::Interpreter {
 
         RAYCHELSCRIPT_INTERPRETER_DEBUG("end evaluating argument list for function ", data.mangled_callee_name, '\n');
 
+        std::size_t function_index{};
+        std::vector<double> memoised_arguments;
+        if (state.call_cache != nullptr) {
+            function_index = static_cast<std::size_t>(
+                std::distance(state.ast.functions.begin(), state.ast.functions.find(data.mangled_callee_name)));
+        }
+        const auto is_memoised = state.call_cache != nullptr && state.call_cache->is_cached(function_index);
+        if (is_memoised) {
+            memoised_arguments.reserve(argument_values.size());
+            for (const auto& [name, value] : argument_values) {
+                memoised_arguments.push_back(value);
+            }
+            if (const auto result = state.call_cache->find(function_index, memoised_arguments); result.has_value()) {
+                state.registers.result = *result;
+                return InterpreterErrorCode::ok;
+            }
+        }
+
+        const auto scope_depth = state.scopes.size();
         RAYCHEL_ANON_VAR ScopePusher{state, false, data.mangled_callee_name};
 
         //Push all arguments into the function scope
@@ -660,7 +687,16 @@ namespace RaychelScript::Interpreter {
             }
         }
 
+        //Returning from inside an inline scope skips its pop
+        while (state.scopes.size() > scope_depth + 1) {
+            state.pop_scope("inline");
+        }
+
         state.registers.flags = StateFlags::none;
+
+        if (is_memoised) {
+            state.call_cache->insert(function_index, memoised_arguments, state.registers.result);
+        }
         return InterpreterErrorCode::ok;
     }
 
@@ -708,8 +744,11 @@ namespace RaychelScript::Interpreter {
             case NodeType::relational_operator:
                 return handle_relational_operator(state, node);
             case NodeType::inline_state_push:
+                state.push_scope(true, "inline");
+                return InterpreterErrorCode::ok;
             case NodeType::inline_state_pop:
-                break;
+                state.pop_scope("inline");
+                return InterpreterErrorCode::ok;
             case NodeType::loop:
                 return handle_loop(state, node);
             case NodeType::function_call:
@@ -723,11 +762,9 @@ namespace RaychelScript::Interpreter {
 
     //Interpreter entry point
 
-    [[nodiscard]] Interpreter::ExecutionResult interpret(const AST& ast, const std::map<std::string, double>& parameters) noexcept
+    [[nodiscard]] static InterpreterErrorCode
+    run_script(State& state, const AST& ast, const std::map<std::string, double>& parameters) noexcept
     {
-        const auto start = std::chrono::high_resolution_clock::now();
-        State state{.ast = ast};
-
         state.scopes.push_back(Scope{.inherits_from_parent_scope = false, .lookup_table = {}});
 
         TRY(populate_input_descriptors(state, ast, parameters));
@@ -743,9 +780,90 @@ namespace RaychelScript::Interpreter {
 
             TRY(execute_node(state, node));
         }
+
+        return InterpreterErrorCode::ok;
+    }
+
+    [[nodiscard]] Interpreter::ExecutionResult interpret(const AST& ast, const std::map<std::string, double>& parameters) noexcept
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        State state{.ast = ast};
+
+        TRY(run_script(state, ast, parameters));
+
         Logger::info(duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count(), "µs\n");
 
         return state;
     }
 
+    [[nodiscard]] Interpreter::ExecutionResult
+    interpret(const AST& ast, const std::map<std::string, double>& parameters, CallCache& call_cache) noexcept
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+        State state{.ast = ast, .call_cache = &call_cache};
+
+        TRY(run_script(state, ast, parameters));
+
+        const auto [hits, misses] = call_cache.statistics();
+        Logger::info(
+            duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count(),
+            "µs (",
+            hits,
+            " cache hits, ",
+            misses,
+            " cache misses)\n");
+
+        return state;
+    }
+
+    [[nodiscard]] CallCache make_call_cache(const AST& ast, std::size_t capacity) noexcept
+    {
+        const auto pure_functions = find_pure_functions(ast);
+
+        std::vector<std::optional<std::uint32_t>> arities;
+        arities.reserve(ast.functions.size());
+        for (const auto& [name, function] : ast.functions) {
+            if (pure_functions.contains(name)) {
+                arities.emplace_back(static_cast<std::uint32_t>(function.arguments.size()));
+            } else {
+                arities.emplace_back(std::nullopt);
+            }
+        }
+        return CallCache{arities, capacity};
+    }
+
+    [[nodiscard]] InterpreterErrorCode interpret_batch(
+        const AST& ast, std::span<const double> input_values, std::span<double> output_values, std::size_t count) noexcept
+    {
+        const auto& input_identifiers = ast.config_block.input_identifiers;
+        const auto& output_identifiers = ast.config_block.output_identifiers;
+
+        if (input_values.size() != input_identifiers.size() * count) {
+            return InterpreterErrorCode::not_enough_input_identifiers;
+        }
+        if (output_values.size() != output_identifiers.size() * count) {
+            return InterpreterErrorCode::mismatched_outputs;
+        }
+
+        std::map<std::string, double> parameters;
+        for (std::size_t k{}; k != count; ++k) {
+            for (std::size_t i{}; i != input_identifiers.size(); ++i) {
+                parameters.insert_or_assign(input_identifiers[i], input_values[i * count + k]);
+            }
+
+            State state{.ast = ast};
+            TRY(run_script(state, ast, parameters));
+
+            for (std::size_t j{}; j != output_identifiers.size(); ++j) {
+                const auto descriptor = find_identifier(state.scopes, output_identifiers[j]);
+                if (!descriptor.has_value()) {
+                    return InterpreterErrorCode::unresolved_identifier;
+                }
+                output_values[j * count + k] = get_descriptor_value(state, *descriptor);
+            }
+        }
+
+        return InterpreterErrorCode::ok;
+    }
+
 } // namespace RaychelScript::Interpreter
@@ -27,10 +27,13 @@
 */
 
 #include "Interpreter/InterpreterPipe.h"
+#include "Optimizer/OptimizerPipe.h"
 #include "Parser/ParserPipe.h"
 
 #include "RaychelCore/AssertingGet.h"
+#include "shared/AST/NodeData.h"
 
+#include <algorithm>
 #include <charconv>
 #include <cstring>
 #include <map>
@@ -54,6 +57,65 @@ try_parse_argument(char const* const* const argv, int argument_index) noexcept
     return std::make_pair(std::move(argument_name), value);
 }
 
+static std::map<std::string, double> get_outputs(const RaychelScript::Interpreter::State& state) noexcept
+{
+    std::map<std::string, double> outputs;
+    for (const auto& name : state.ast.config_block.output_identifiers) {
+        const auto descriptor = state.scopes.front().lookup_table.at(name);
+        outputs.emplace(name, state.variables.at(descriptor.index));
+    }
+    return outputs;
+}
+
+//An inline scope that declares nothing does nothing, so none of them may be left in an optimized block
+static bool has_empty_inline_scopes(const std::vector<RaychelScript::AST_Node>& nodes) noexcept
+{
+    using namespace RaychelScript; //NOLINT
+
+    std::vector<bool> scope_declares_variables;
+    for (const auto& node : nodes) {
+        switch (node.type()) {
+            case NodeType::inline_state_push:
+                scope_declares_variables.push_back(false);
+                break;
+            case NodeType::inline_state_pop:
+                if (!scope_declares_variables.empty() && !scope_declares_variables.back()) {
+                    return true;
+                }
+                if (!scope_declares_variables.empty()) {
+                    scope_declares_variables.pop_back();
+                }
+                break;
+            case NodeType::variable_decl:
+                if (!scope_declares_variables.empty()) {
+                    scope_declares_variables.back() = true;
+                }
+                break;
+            case NodeType::assignment:
+                if (!scope_declares_variables.empty() &&
+                    node.to_node_data<AssignmentExpressionData>().lhs.type() == NodeType::variable_decl) {
+                    scope_declares_variables.back() = true;
+                }
+                break;
+            case NodeType::conditional_construct: {
+                const auto data = node.to_node_data<ConditionalConstructData>();
+                if (has_empty_inline_scopes(data.body) || has_empty_inline_scopes(data.else_body)) {
+                    return true;
+                }
+                break;
+            }
+            case NodeType::loop:
+                if (has_empty_inline_scopes(node.to_node_data<LoopData>().body)) {
+                    return true;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
 int main(int argc, char** argv)
 {
     using namespace RaychelScript::Pipes; //NOLINT(google-build-using-namespace)
@@ -84,9 +146,50 @@ int main(int argc, char** argv)
         return res;
     }();
 
-    const auto state_or_error = Lex{lex_file, argv[1]} | Parse{} | Interpret{args};
+    const auto ast_or_error = Lex{lex_file, argv[1]} | Parse{};
+    const auto state_or_error = ast_or_error | Interpret{args};
+
+    const auto optimized_or_error = ast_or_error | Optimize{};
+    if (log_if_error(optimized_or_error)) {
+        return 1;
+    }
+
+    const auto& optimized = optimized_or_error.value();
+    if (has_empty_inline_scopes(optimized.nodes) || std::ranges::any_of(optimized.functions, [](const auto& entry) {
+            return has_empty_inline_scopes(entry.second.body);
+        })) {
+        Logger::error("The optimized script contains inline scopes that do not declare anything!\n");
+        return 1;
+    }
+
+    const auto optimized_state_or_error = optimized_or_error | Interpret{args};
+
+    //Removing code must not remove the errors it reports
+    if (state_or_error.is_error()) {
+        (void)log_if_error(state_or_error);
+        if (!optimized_state_or_error.is_error() ||
+            optimized_state_or_error.to_error_code<RaychelScript::Interpreter::InterpreterErrorCode>() !=
+                state_or_error.to_error_code<RaychelScript::Interpreter::InterpreterErrorCode>()) {
+            Logger::error("The optimized script did not report the same error!\n");
+        }
+        return 1;
+    }
+
+    if (log_if_error(optimized_state_or_error)) {
+        return 1;
+    }
+
+    if (get_outputs(optimized_state_or_error.value()) != get_outputs(state_or_error.value())) {
+        Logger::error("The optimized script computed different outputs!\n");
+        return 1;
+    }
 
-    if (log_if_error(state_or_error)) {
+    //Memoising pure functions must not change any values
+    auto call_cache = RaychelScript::Interpreter::make_call_cache(ast_or_error.value());
+    const auto memoised_state_or_error = RaychelScript::Interpreter::interpret(ast_or_error.value(), args, call_cache);
+    if (const auto* memoised_state = std::get_if<RaychelScript::Interpreter::State>(&memoised_state_or_error);
+        memoised_state == nullptr || memoised_state->variables != state_or_error.value().variables) {
+        Logger::error("Memoised interpretation does not match regular interpretation!\n");
         return 1;
     }
 
@@ -0,0 +1,75 @@
+/**
+* \file ElfWriter.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for ElfWriter class
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_ELF_WRITER_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_ELF_WRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    /**
+    * \brief Packs finished Encoder output into an ELF64 shared object the dynamic loader can map directly
+    *
+    * The code and all exported objects share one read-only, executable segment. The code is position independent and
+    * self-contained, so the object has no relocations and no dependencies.
+    */
+    class ElfWriter
+    {
+        struct Symbol
+        {
+            std::string name;
+            std::size_t offset;
+            std::size_t size;
+            bool is_object;
+        };
+
+    public:
+        explicit ElfWriter(std::vector<std::uint8_t> code) noexcept : text_{std::move(code)}
+        {}
+
+        //Export offset (relative to the start of the code) as a function
+        void add_function(std::string_view name, std::size_t offset) noexcept;
+
+        //Append bytes behind the code and export them as a read-only object
+        void add_object(std::string_view name, std::span<const std::uint8_t> bytes) noexcept;
+
+        [[nodiscard]] bool write(std::ostream& output_stream) const noexcept;
+
+    private:
+        std::vector<std::uint8_t> text_;
+        std::vector<Symbol> symbols_{};
+    };
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_ELF_WRITER_H
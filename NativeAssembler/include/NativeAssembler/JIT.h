@@ -0,0 +1,150 @@
+/**
+* \file JIT.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the in-memory x86-64 JIT
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_JIT_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_JIT_H
+
+#include "NativeAssemblerErrorCode.h"
+#include "VM/VMErrorCode.h"
+#include "shared/VM/VMData.h"
+
+#include "RaychelCore/ClassMacros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <variant>
+
+namespace RaychelScript::NativeAssembler {
+
+    /**
+    * \brief A script that has been compiled into executable memory by jit_compile()
+    *
+    * The generated code keeps the VM's memory model: every call frame gets a window of a per-invocation memory block
+    * (allocated on the native stack), slot 0 of each window is the A register and immediates are read from a constant pool.
+    * Calling the entry point is thread-safe.
+    */
+    class CompiledScript
+    {
+        friend std::variant<NativeAssemblerErrorCode, CompiledScript>
+        jit_compile(const VM::VMData& data, std::size_t stack_size, std::size_t memory_size) noexcept;
+
+        //The generated code returns a VMErrorCode. It is ignored when called through EntryPoint
+        using CheckedEntryPoint = std::uint32_t (*)(double const* input_vector, double* output_vector) noexcept;
+
+        //Structure-of-arrays inputs and outputs for count invocations, see VM::execute_batch()
+        using BatchEntryPoint = std::uint32_t (*)(double const* input_values, double* output_values, std::size_t count) noexcept;
+
+        explicit CompiledScript(
+            void* code, std::size_t mapping_size, std::size_t batch_entry_offset, std::uint32_t num_inputs,
+            std::uint32_t num_outputs) noexcept
+            : code_{code},
+              mapping_size_{mapping_size},
+              batch_entry_offset_{batch_entry_offset},
+              num_input_identifiers_{num_inputs},
+              num_output_identifiers_{num_outputs}
+        {}
+
+    public:
+        //Same signature as Runtime::ScriptRunner::EntryPoint
+        using EntryPoint = void (*)(double const* const input_vector, double* const output_vector) noexcept;
+
+        RAYCHEL_MAKE_NONCOPY(CompiledScript)
+
+        CompiledScript(CompiledScript&& other) noexcept
+            : code_{std::exchange(other.code_, nullptr)},
+              mapping_size_{std::exchange(other.mapping_size_, 0U)},
+              batch_entry_offset_{other.batch_entry_offset_},
+              num_input_identifiers_{other.num_input_identifiers_},
+              num_output_identifiers_{other.num_output_identifiers_}
+        {}
+
+        CompiledScript& operator=(CompiledScript&& other) noexcept
+        {
+            std::swap(code_, other.code_);
+            std::swap(mapping_size_, other.mapping_size_);
+            batch_entry_offset_ = other.batch_entry_offset_;
+            num_input_identifiers_ = other.num_input_identifiers_;
+            num_output_identifiers_ = other.num_output_identifiers_;
+            return *this;
+        }
+
+        /**
+        * \brief Return the raw native function. Runtime errors leave the output vector untouched
+        */
+        [[nodiscard]] EntryPoint entry_point() const noexcept;
+
+        /**
+        * \brief Run the script and report runtime errors the same way VM::execute() does
+        */
+        [[nodiscard]] VM::VMErrorCode run(std::span<const double> input_values, std::span<double> output_values) const noexcept;
+
+        /**
+        * \brief Run the script for count input vectors with the same memory layout as VM::execute_batch()
+        *
+        * Groups of invocations run through vector code for the best instruction set the CPU supports. A group whose invocations
+        * take different branches or run into an error is re-run one invocation at a time, so the outputs and the first reported
+        * error match calling run() for every invocation in order.
+        */
+        [[nodiscard]] VM::VMErrorCode
+        run_batch(std::span<const double> input_values, std::span<double> output_values, std::size_t count) const noexcept;
+
+        [[nodiscard]] std::uint32_t num_input_identifiers() const noexcept
+        {
+            return num_input_identifiers_;
+        }
+
+        [[nodiscard]] std::uint32_t num_output_identifiers() const noexcept
+        {
+            return num_output_identifiers_;
+        }
+
+        ~CompiledScript() noexcept;
+
+    private:
+        void* code_{};
+        std::size_t mapping_size_{};
+        std::size_t batch_entry_offset_{};
+        std::uint32_t num_input_identifiers_{};
+        std::uint32_t num_output_identifiers_{};
+    };
+
+    /**
+    * \brief Compile a script to x86-64 machine code in executable memory
+    *
+    * Each call frame becomes a native function. Runtime behaviour matches VM::execute() with the same stack_size
+    * (maximum call depth) and memory_size (number of memory slots).
+    * The memory lives on the native stack of the calling thread. Scripts that could use more than 4 MiB of it with the given
+    * stack_size are rejected with NativeAssemblerErrorCode::memory_overflow.
+    */
+    [[nodiscard]] std::variant<NativeAssemblerErrorCode, CompiledScript>
+    jit_compile(const VM::VMData& data, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U) noexcept;
+
+} // namespace RaychelScript::NativeAssembler
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_JIT_H
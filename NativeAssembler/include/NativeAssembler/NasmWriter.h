@@ -0,0 +1,171 @@
+/**
+* \file NasmWriter.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the NASM text backend of the x86-64 lowering
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_NASM_WRITER_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_NASM_WRITER_H
+
+#include "X86_64.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    /**
+    * \brief Prints the instructions the x86-64 lowering emits as NASM source
+    *
+    * This has the same interface as Encoder. Constants are collected and written into .rodata by finish().
+    */
+    class NasmWriter
+    {
+    public:
+        explicit NasmWriter(std::ostream& output_stream) noexcept : output_stream_{output_stream}
+        {}
+
+        [[nodiscard]] Label make_label() noexcept;
+
+        void bind(Label label) noexcept;
+
+        [[nodiscard]] std::uint32_t add_constant(std::uint64_t bits) noexcept;
+
+        [[nodiscard]] std::uint32_t add_constant(double value) noexcept;
+
+        //Export the current position under name
+        void global(std::string_view name) noexcept;
+
+        //Width of the AVX packed double instructions that follow
+        void set_vector_length(VectorLength length) noexcept;
+
+        //SSE2 scalar double instructions
+        void movsd(XMMRegister destination, Address source) noexcept;
+        void movsd(Address destination, XMMRegister source) noexcept;
+        void movapd(XMMRegister destination, XMMRegister source) noexcept;
+        void addsd(XMMRegister destination, Address source) noexcept;
+        void addsd(XMMRegister destination, XMMRegister source) noexcept;
+        void subsd(XMMRegister destination, Address source) noexcept;
+        void subsd(XMMRegister destination, XMMRegister source) noexcept;
+        void mulsd(XMMRegister destination, Address source) noexcept;
+        void mulsd(XMMRegister destination, XMMRegister source) noexcept;
+        void divsd(XMMRegister destination, Address source) noexcept;
+        void divsd(XMMRegister destination, XMMRegister source) noexcept;
+        void ucomisd(XMMRegister lhs, Address rhs) noexcept;
+        void ucomisd(XMMRegister lhs, XMMRegister rhs) noexcept;
+        void sqrtsd(XMMRegister destination, XMMRegister source) noexcept;
+        void minsd(XMMRegister destination, XMMRegister source) noexcept;
+        void maxsd(XMMRegister destination, XMMRegister source) noexcept;
+        void andpd(XMMRegister destination, XMMRegister source) noexcept;
+        void xorpd(XMMRegister destination, XMMRegister source) noexcept;
+
+        //SSE2 integer instructions on the low quadword, used to take doubles apart
+        void paddq(XMMRegister destination, XMMRegister source) noexcept;
+        void psllq(XMMRegister destination, std::uint8_t bits) noexcept;
+        void psrlq(XMMRegister destination, std::uint8_t bits) noexcept;
+
+        //AVX packed double instructions. They operate on the ymm or zmm register with the same number, see set_vector_length()
+        void vmovupd(XMMRegister destination, Address source) noexcept;
+        void vmovupd(Address destination, XMMRegister source) noexcept;
+        void vmovapd(XMMRegister destination, XMMRegister source) noexcept;
+        void vbroadcastsd(XMMRegister destination, Address source) noexcept;
+        void vaddpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vaddpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vsubpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vsubpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vmulpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vmulpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vdivpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vdivpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vsqrtpd(XMMRegister destination, XMMRegister source) noexcept;
+        void vminpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vmaxpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vandpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vxorpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vcmppd(XMMRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept;
+        void vcmppd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept;
+        void vmovmskpd(Register destination, XMMRegister source) noexcept;
+        void vzeroupper() noexcept;
+
+        //AVX2 and AVX-512 integer instructions on the quadwords of a vector
+        void vpaddq(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vpsllq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept;
+        void vpsrlq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept;
+
+        //AVX-512 comparisons write a lane mask into an opmask register instead of a vector register
+        void vcmppd(MaskRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept;
+        void vcmppd(MaskRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept;
+        void kmovw(Register destination, MaskRegister source) noexcept;
+
+        //general purpose instructions. Unless noted otherwise, these operate on the full 64 bits
+        void mov(Register destination, Address source) noexcept;
+        void mov(Address destination, Register source) noexcept;
+        void mov(Register destination, Register source) noexcept;
+        void mov(Register destination, std::uint64_t immediate) noexcept;
+        void mov(Address destination, std::int32_t immediate) noexcept;
+        void mov32(Register destination, std::uint32_t immediate) noexcept;
+        void lea(Register destination, Address source) noexcept;
+        void add(Register destination, std::int32_t immediate) noexcept;
+        void add(Register destination, Register source) noexcept;
+        void sub(Register destination, std::int32_t immediate) noexcept;
+        void cmp(Register lhs, Register rhs) noexcept;
+        void cmp(Register lhs, std::int32_t immediate) noexcept;
+        void test32(Register lhs, Register rhs) noexcept;
+        void xor32(Register destination, Register source) noexcept;
+        void btr(Register destination, std::uint8_t bit) noexcept;
+        void shl(Register destination, std::uint8_t bits) noexcept;
+        void setcc(Condition condition, Register destination) noexcept;
+        void movzx8(Register destination, Register source) noexcept;
+        void and8(Register destination, Register source) noexcept;
+        void or8(Register destination, Register source) noexcept;
+        void push(Register source) noexcept;
+        void pop(Register destination) noexcept;
+        void rep_stosq() noexcept;
+
+        //control flow
+        void jmp(Label target) noexcept;
+        void jcc(Condition condition, Label target) noexcept;
+        void call(Label target) noexcept;
+        void call(Register target) noexcept;
+        void ret() noexcept;
+
+        /**
+        * \brief Write the constant pool
+        *
+        * \return true if every write to the output stream succeeded
+        */
+        [[nodiscard]] bool finish() noexcept;
+
+    private:
+        std::ostream& output_stream_;
+        std::uint32_t number_of_labels_{};
+        VectorLength vector_length_{VectorLength::v256};
+        std::vector<std::uint64_t> constants_{};
+    };
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_NASM_WRITER_H
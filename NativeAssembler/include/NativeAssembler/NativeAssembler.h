@@ -51,10 +51,20 @@ namespace RaychelScript::NativeAssembler {
     inline namespace details {
         struct X86_64_Tag
         {};
+
+        struct X86_64_ELF_Tag
+        {};
     } // namespace details
+
+    //NASM source, which has to be assembled and linked into a shared object
     constexpr details::X86_64_Tag assemble_x86_64{};
 
+    //A ready to load ELF64 shared object with the same symbols. The output stream should be opened in binary mode
+    constexpr details::X86_64_ELF_Tag assemble_x86_64_elf{};
+
     RAYCHELSCRIPT_NATIVE_ASSEMBLER_DECLARE_ASSEMBLER_FUNCTION(X86_64)
 
+    RAYCHELSCRIPT_NATIVE_ASSEMBLER_DECLARE_ASSEMBLER_FUNCTION(X86_64_ELF)
+
 } // namespace RaychelScript::NativeAssembler
 #endif //RAYCHELSCRIPT_NATIVE_ASSEMBLER_H
@@ -37,6 +37,10 @@ namespace RaychelScript::NativeAssembler {
         ok = 0,
         unknown_instruction,
         stream_write_error,
+        invalid_operand,
+        memory_overflow,
+        code_allocation_error,
+        unsupported_platform,
     };
 
     constexpr std::string_view error_code_to_reason_string(NativeAssemblerErrorCode ec)
@@ -49,6 +53,14 @@ namespace RaychelScript::NativeAssembler {
                 return "Unknown instruction in RASM bytecode";
             case N::stream_write_error:
                 return "Error while writing to output stream";
+            case N::invalid_operand:
+                return "Invalid operand in RASM bytecode";
+            case N::memory_overflow:
+                return "Global call frame does not fit into script memory";
+            case N::code_allocation_error:
+                return "Could not allocate executable memory";
+            case N::unsupported_platform:
+                return "Native code generation is not supported on this platform";
         }
         return "Unknown error code!";
     }
@@ -0,0 +1,194 @@
+/**
+* \file X86_64.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the x86-64 operand types shared by the native backends
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    enum class Register : std::uint8_t {
+        rax,
+        rcx,
+        rdx,
+        rbx,
+        rsp,
+        rbp,
+        rsi,
+        rdi,
+        r8,
+        r9,
+        r10,
+        r11,
+        r12,
+        r13,
+        r14,
+        r15,
+    };
+
+    enum class XMMRegister : std::uint8_t {
+        xmm0,
+        xmm1,
+        xmm2,
+        xmm3,
+        xmm4,
+        xmm5,
+        xmm6,
+        xmm7,
+        xmm8,
+        xmm9,
+        xmm10,
+        xmm11,
+        xmm12,
+        xmm13,
+        xmm14,
+        xmm15,
+    };
+
+    //AVX-512 opmask registers
+    enum class MaskRegister : std::uint8_t {
+        k0,
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        k7,
+    };
+
+    //Width of the packed AVX instructions. 512-bit instructions use the EVEX encoding and the zmm registers
+    enum class VectorLength : std::uint8_t {
+        v256,
+        v512,
+    };
+
+    //Instruction set extensions a variant of the generated code may use on top of baseline x86-64
+    enum class InstructionSet : std::uint8_t {
+        sse2,
+        avx2,
+        avx512,
+
+        num_instruction_sets
+    };
+
+    [[nodiscard]] constexpr std::string_view instruction_set_name(InstructionSet instruction_set) noexcept
+    {
+        switch (instruction_set) {
+            case InstructionSet::sse2:
+                return "sse2";
+            case InstructionSet::avx2:
+                return "avx2";
+            case InstructionSet::avx512:
+                return "avx512";
+            case InstructionSet::num_instruction_sets:
+                break;
+        }
+        return "<unknown>";
+    }
+
+    //Condition codes in the order of their hardware encoding
+    enum class Condition : std::uint8_t {
+        overflow,
+        no_overflow,
+        below,
+        above_or_equal,
+        equal,
+        not_equal,
+        below_or_equal,
+        above,
+        sign,
+        no_sign,
+        parity,
+        no_parity,
+        less,
+        greater_or_equal,
+        less_or_equal,
+        greater,
+    };
+
+    //Predicates of cmppd. The ordered ones are false if either operand is NaN, the unordered ones are true
+    enum class ComparisonPredicate : std::uint8_t {
+        equal_ordered = 0x00U,
+        not_equal_unordered = 0x04U,
+        less_than_ordered = 0x11U,
+        less_or_equal_ordered = 0x12U,
+        greater_or_equal_ordered = 0x1DU,
+        greater_than_ordered = 0x1EU,
+    };
+
+    /**
+    * \brief A memory operand. Either [base + displacement] or an entry of the constant pool, which is addressed RIP-relative
+    */
+    class Address
+    {
+        explicit Address(Register base, std::int32_t displacement, bool is_constant) noexcept
+            : base_{base}, displacement_{displacement}, is_constant_{is_constant}
+        {}
+
+    public:
+        [[nodiscard]] static Address at(Register base, std::int32_t displacement = 0) noexcept
+        {
+            return Address{base, displacement, false};
+        }
+
+        [[nodiscard]] static Address constant(std::uint32_t constant_index) noexcept
+        {
+            return Address{Register::rax, static_cast<std::int32_t>(constant_index), true};
+        }
+
+        [[nodiscard]] Register base() const noexcept
+        {
+            return base_;
+        }
+
+        [[nodiscard]] std::int32_t displacement() const noexcept
+        {
+            return displacement_;
+        }
+
+        [[nodiscard]] bool is_constant() const noexcept
+        {
+            return is_constant_;
+        }
+
+    private:
+        Register base_;
+        std::int32_t displacement_;
+        bool is_constant_;
+    };
+
+    struct Label
+    {
+        std::uint32_t id{};
+    };
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_H
@@ -0,0 +1,214 @@
+/**
+* \file X86_64Encoder.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the x86-64 machine code encoder
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_ENCODER_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_ENCODER_H
+
+#include "X86_64.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    /**
+    * \brief Encodes the subset of x86-64 the native backends need into a flat code buffer
+    *
+    * Jumps and calls to labels use 32-bit relative displacements, so the finished code is position independent.
+    * Constants are collected into a pool that finish() appends behind the code.
+    */
+    class Encoder
+    {
+        struct Fixup
+        {
+            std::size_t position;
+            std::uint32_t target;
+        };
+
+    public:
+        [[nodiscard]] Label make_label() noexcept;
+
+        void bind(Label label) noexcept;
+
+        [[nodiscard]] std::uint32_t add_constant(std::uint64_t bits) noexcept;
+
+        [[nodiscard]] std::uint32_t add_constant(double value) noexcept;
+
+        //Export the current position under name
+        void global(std::string_view name) noexcept;
+
+        //Width of the AVX packed double instructions that follow
+        void set_vector_length(VectorLength length) noexcept;
+
+        //SSE2 scalar double instructions
+        void movsd(XMMRegister destination, Address source) noexcept;
+        void movsd(Address destination, XMMRegister source) noexcept;
+        void movapd(XMMRegister destination, XMMRegister source) noexcept;
+        void addsd(XMMRegister destination, Address source) noexcept;
+        void addsd(XMMRegister destination, XMMRegister source) noexcept;
+        void subsd(XMMRegister destination, Address source) noexcept;
+        void subsd(XMMRegister destination, XMMRegister source) noexcept;
+        void mulsd(XMMRegister destination, Address source) noexcept;
+        void mulsd(XMMRegister destination, XMMRegister source) noexcept;
+        void divsd(XMMRegister destination, Address source) noexcept;
+        void divsd(XMMRegister destination, XMMRegister source) noexcept;
+        void ucomisd(XMMRegister lhs, Address rhs) noexcept;
+        void ucomisd(XMMRegister lhs, XMMRegister rhs) noexcept;
+        void sqrtsd(XMMRegister destination, XMMRegister source) noexcept;
+        void minsd(XMMRegister destination, XMMRegister source) noexcept;
+        void maxsd(XMMRegister destination, XMMRegister source) noexcept;
+        void andpd(XMMRegister destination, XMMRegister source) noexcept;
+        void xorpd(XMMRegister destination, XMMRegister source) noexcept;
+
+        //SSE2 integer instructions on the low quadword, used to take doubles apart
+        void paddq(XMMRegister destination, XMMRegister source) noexcept;
+        void psllq(XMMRegister destination, std::uint8_t bits) noexcept;
+        void psrlq(XMMRegister destination, std::uint8_t bits) noexcept;
+
+        //AVX packed double instructions. They operate on the ymm or zmm register with the same number, see set_vector_length()
+        void vmovupd(XMMRegister destination, Address source) noexcept;
+        void vmovupd(Address destination, XMMRegister source) noexcept;
+        void vmovapd(XMMRegister destination, XMMRegister source) noexcept;
+        void vbroadcastsd(XMMRegister destination, Address source) noexcept;
+        void vaddpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vaddpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vsubpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vsubpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vmulpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vmulpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vdivpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept;
+        void vdivpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vsqrtpd(XMMRegister destination, XMMRegister source) noexcept;
+        void vminpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vmaxpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vandpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vxorpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vcmppd(XMMRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept;
+        void vcmppd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept;
+        void vmovmskpd(Register destination, XMMRegister source) noexcept;
+        void vzeroupper() noexcept;
+
+        //AVX2 and AVX-512 integer instructions on the quadwords of a vector
+        void vpaddq(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept;
+        void vpsllq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept;
+        void vpsrlq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept;
+
+        //AVX-512 comparisons write a lane mask into an opmask register instead of a vector register
+        void vcmppd(MaskRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept;
+        void vcmppd(MaskRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept;
+        void kmovw(Register destination, MaskRegister source) noexcept;
+
+        //general purpose instructions. Unless noted otherwise, these operate on the full 64 bits
+        void mov(Register destination, Address source) noexcept;
+        void mov(Address destination, Register source) noexcept;
+        void mov(Register destination, Register source) noexcept;
+        void mov(Register destination, std::uint64_t immediate) noexcept;
+        void mov(Address destination, std::int32_t immediate) noexcept;
+        void mov32(Register destination, std::uint32_t immediate) noexcept;
+        void lea(Register destination, Address source) noexcept;
+        void add(Register destination, std::int32_t immediate) noexcept;
+        void add(Register destination, Register source) noexcept;
+        void sub(Register destination, std::int32_t immediate) noexcept;
+        void cmp(Register lhs, Register rhs) noexcept;
+        void cmp(Register lhs, std::int32_t immediate) noexcept;
+        void test32(Register lhs, Register rhs) noexcept;
+        void xor32(Register destination, Register source) noexcept;
+        void btr(Register destination, std::uint8_t bit) noexcept;
+        void shl(Register destination, std::uint8_t bits) noexcept;
+        void setcc(Condition condition, Register destination) noexcept;
+        void movzx8(Register destination, Register source) noexcept;
+        void and8(Register destination, Register source) noexcept;
+        void or8(Register destination, Register source) noexcept;
+        void push(Register source) noexcept;
+        void pop(Register destination) noexcept;
+        void rep_stosq() noexcept;
+
+        //control flow
+        void jmp(Label target) noexcept;
+        void jcc(Condition condition, Label target) noexcept;
+        void call(Label target) noexcept;
+        void call(Register target) noexcept;
+        void ret() noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return code_.size();
+        }
+
+        //offset of the symbol name from the start of the code, std::nullopt if it was never exported
+        [[nodiscard]] std::optional<std::size_t> symbol_offset(std::string_view name) const noexcept;
+
+        [[nodiscard]] const std::vector<std::pair<std::string, std::size_t>>& symbols() const noexcept
+        {
+            return symbols_;
+        }
+
+        /**
+        * \brief Resolve all label references, append the constant pool and return the finished code
+        *
+        * \return std::nullopt if a referenced label was never bound
+        */
+        [[nodiscard]] std::optional<std::vector<std::uint8_t>> finish() noexcept;
+
+    private:
+        void _emit(std::uint8_t byte) noexcept;
+        void _emit32(std::uint32_t value) noexcept;
+        void _emit64(std::uint64_t value) noexcept;
+        void _rex(bool wide, std::uint8_t reg, std::uint8_t base, bool force = false) noexcept;
+        void _modrm(std::uint8_t reg, Address address, std::int32_t disp8_scale = 1) noexcept;
+        void _modrm(std::uint8_t reg, std::uint8_t rm) noexcept;
+        void _sse(std::uint8_t prefix, std::uint8_t op_code, XMMRegister reg, Address address) noexcept;
+        void _sse(std::uint8_t prefix, std::uint8_t op_code, XMMRegister reg, XMMRegister rm) noexcept;
+        void _op(bool wide, std::uint8_t op_code, std::uint8_t reg, Address address) noexcept;
+        void _op(bool wide, std::uint8_t op_code, std::uint8_t reg, Register rm) noexcept;
+        void _op(std::uint8_t extension, Register destination, std::int32_t immediate) noexcept;
+        void _branch(Label target) noexcept;
+        void _vex(std::uint8_t map, std::uint8_t reg, std::uint8_t source, std::uint8_t base) noexcept;
+        void _evex(std::uint8_t map, std::uint8_t reg, std::uint8_t source, std::uint8_t base) noexcept;
+        void _avx(
+            std::uint8_t map, std::uint8_t op_code, XMMRegister reg, XMMRegister source, Address address,
+            bool scalar_memory_operand = false) noexcept;
+        void _avx(std::uint8_t map, std::uint8_t op_code, XMMRegister reg, XMMRegister source, XMMRegister rm) noexcept;
+        void _sse_shift(std::uint8_t extension, XMMRegister destination, std::uint8_t bits) noexcept;
+        void _avx_shift(std::uint8_t extension, XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept;
+
+        VectorLength vector_length_{VectorLength::v256};
+        std::vector<std::uint8_t> code_{};
+        std::vector<std::uint64_t> constants_{};
+        std::vector<std::size_t> label_positions_{};
+        std::vector<Fixup> label_fixups_{};
+        std::vector<Fixup> constant_fixups_{};
+        std::vector<std::pair<std::string, std::size_t>> symbols_{};
+    };
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_ENCODER_H
@@ -0,0 +1,131 @@
+/**
+* \file X86_64Lowering.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the lowering of RASM call frames to x86-64
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_LOWERING_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_LOWERING_H
+
+#include "NasmWriter.h"
+#include "NativeAssemblerErrorCode.h"
+#include "X86_64Encoder.h"
+#include "X86_64Math.h"
+#include "shared/VM/VMData.h"
+
+#include <cstddef>
+#include <string_view>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    //symbols lower() exports through Writer::global(). Each variant of the code gets its own pair
+    [[nodiscard]] constexpr std::string_view entry_point_name(InstructionSet instruction_set) noexcept
+    {
+        switch (instruction_set) {
+            case InstructionSet::sse2:
+                return "raychelscript_entry_sse2";
+            case InstructionSet::avx2:
+                return "raychelscript_entry_avx2";
+            case InstructionSet::avx512:
+                return "raychelscript_entry_avx512";
+            case InstructionSet::num_instruction_sets:
+                break;
+        }
+        return "<unknown>";
+    }
+
+    [[nodiscard]] constexpr std::string_view batch_entry_point_name(InstructionSet instruction_set) noexcept
+    {
+        switch (instruction_set) {
+            case InstructionSet::sse2:
+                return "raychelscript_entry_batch_sse2";
+            case InstructionSet::avx2:
+                return "raychelscript_entry_batch_avx2";
+            case InstructionSet::avx512:
+                return "raychelscript_entry_batch_avx512";
+            case InstructionSet::num_instruction_sets:
+                break;
+        }
+        return "<unknown>";
+    }
+
+    struct LoweringOptions
+    {
+        //maximum call depth, including the global frame
+        std::size_t stack_size{128U};
+        //number of memory slots all active call frames may use at once
+        std::size_t memory_size{1'024U};
+        //extensions the code may use. The scalar entry point is plain SSE2 in every variant
+        InstructionSet instruction_set{InstructionSet::sse2};
+    };
+
+    /**
+    * \brief Lower a script to a native function with the signature std::uint32_t(const double* inputs, double* outputs)
+    *
+    * The entry point is the first instruction lower() writes. Several variants (see LoweringOptions::instruction_set) can be
+    * lowered into the same writer one after another. Every call frame becomes a native function with its own stack frame:
+    * the slots of a call frame live in the outgoing argument area of its caller, so put writes straight into the callee.
+    * The function returns a VM::VMErrorCode and only writes the outputs if execution succeeded.
+    * Runtime errors, the call depth limit and the memory limit behave like in VM::execute(). Because the memory lives on the
+    * native stack, a script that could need more than 4 MiB of native stack at the maximum call depth is rejected with
+    * NativeAssemblerErrorCode::memory_overflow.
+    * pow and fac call math routines that are written behind the scalar code (see X86_64Math.h) instead of libm, so the code
+    * has no external dependencies.
+    *
+    * The batch entry point (see lower_batch()) is written right after the scalar code.
+    *
+    * Writer is either Encoder (machine code) or NasmWriter (assembly source).
+    */
+    template <typename Writer>
+    [[nodiscard]] NativeAssemblerErrorCode lower(const VM::VMData& data, Writer& writer, const LoweringOptions& options) noexcept;
+
+    /**
+    * \brief Lower the batch entry point std::uint32_t(const double* inputs, double* outputs, std::size_t count)
+    *
+    * Inputs and outputs are laid out as structure-of-arrays like in VM::execute_batch(): input #i of invocation #k lives at
+    * inputs[i * count + k]. Groups of invocations run side by side in the lanes of the vector registers: four in the ymm
+    * registers with InstructionSet::avx2 and eight in the zmm registers with InstructionSet::avx512 (AVX-512F and DQ).
+    * The InstructionSet::sse2 variant runs every invocation through the scalar entry point.
+    * Lanes only run together while they agree on every branch. If they diverge, or if any lane would raise an error, the group
+    * is thrown away and its invocations are re-run one by one through the scalar entry point at scalar_entry. This also
+    * handles the invocations that are left over at the end.
+    * Returns the VM::VMErrorCode of the first invocation that failed. Invocations before it have written their outputs.
+    *
+    * data must already have been lowered by lower(), which validates it and emits the scalar math routines in math.
+    */
+    template <typename Writer>
+    [[nodiscard]] NativeAssemblerErrorCode lower_batch(
+        const VM::VMData& data, Writer& writer, const LoweringOptions& options, Label scalar_entry,
+        const MathRoutines& math) noexcept;
+
+    extern template NativeAssemblerErrorCode lower<Encoder>(const VM::VMData&, Encoder&, const LoweringOptions&) noexcept;
+    extern template NativeAssemblerErrorCode lower<NasmWriter>(const VM::VMData&, NasmWriter&, const LoweringOptions&) noexcept;
+    extern template NativeAssemblerErrorCode
+    lower_batch<Encoder>(const VM::VMData&, Encoder&, const LoweringOptions&, Label, const MathRoutines&) noexcept;
+    extern template NativeAssemblerErrorCode
+    lower_batch<NasmWriter>(const VM::VMData&, NasmWriter&, const LoweringOptions&, Label, const MathRoutines&) noexcept;
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_LOWERING_H
@@ -0,0 +1,138 @@
+/**
+* \file X86_64Math.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the math routines of the x86-64 backends
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_MATH_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_MATH_H
+
+#include "NasmWriter.h"
+#include "X86_64Encoder.h"
+#include "shared/VM/VMData.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    /*
+    There are no instructions for pow, exp, log or tgamma, so the generated code brings its own.
+    log and exp follow fdlibm: log reduces to [sqrt(2)/2, sqrt(2)) and uses a degree 14 polynomial in s = f / (2 + f),
+    exp reduces to [-ln(2)/2, ln(2)/2] and uses the degree 5 Remez polynomial. Both are accurate to about 1 ulp.
+    pow(x, y) = 2^(y * log2(x)) follows fdlibm's pow and carries log2(x) and y * log2(x) with about 20 extra bits, so it is
+    accurate to about 1 ulp. Integer powers are exact when the result is representable, and results beyond the double range
+    are +-inf or +-0.
+    tgamma uses the Lanczos approximation with g = 7 and 9 coefficients on [0.5, 171.625), with a relative error below
+    3e-13. Smaller arguments are shifted into that range, integers are multiplied out.
+    The scalar and the vector routines run the same operations, so the lanes of a batch get the same results as the scalar code.
+    */
+
+    //The routines clobber xmm0, xmm1 and these registers, but no general purpose registers
+    constexpr std::array math_temporaries{
+        XMMRegister::xmm8,
+        XMMRegister::xmm9,
+        XMMRegister::xmm10,
+        XMMRegister::xmm11,
+        XMMRegister::xmm12,
+        XMMRegister::xmm13,
+        XMMRegister::xmm14,
+        XMMRegister::xmm15,
+    };
+
+    [[nodiscard]] constexpr bool is_math_temporary(XMMRegister reg) noexcept
+    {
+        return std::ranges::find(math_temporaries, reg) != math_temporaries.end();
+    }
+
+    //Entry points of the scalar routines of one variant of the code
+    struct MathRoutines
+    {
+        Label pow{};
+        Label tgamma{};
+    };
+
+    /**
+    * \brief x^exponent for an exponent that is known when the code is generated: x^power, times sqrt(x), inverted
+    *
+    * Multiplying out the power takes one rounding per multiplication, so the error is at most (power - 1) / 2 ulp before the
+    * square root and the reciprocal, which are rounded correctly. The only result that differs from std::pow beyond that is
+    * (-inf)^(n + 0.5), which is NaN instead of inf or 0.
+    */
+    struct PowerChain
+    {
+        std::uint32_t power{};
+        bool square_root{};
+        bool reciprocal{};
+    };
+
+    //integer and half-integer exponents up to this magnitude are multiplied out
+    constexpr double max_power_chain_exponent = 32.0;
+
+    [[nodiscard]] std::optional<PowerChain> power_chain(double exponent) noexcept;
+
+    //the power chain for the exponent operand of a pow or pas instruction, if it is a suitable immediate
+    [[nodiscard]] std::optional<PowerChain> power_chain(const VM::VMData& data, Assembly::MemoryIndex exponent) noexcept;
+
+    //result = base^chain with SSE2 scalar instructions. base is overwritten
+    template <typename Writer>
+    void emit_scalar_power_chain(Writer& writer, PowerChain chain, XMMRegister result, XMMRegister base) noexcept;
+
+    //result = base^chain in every lane with AVX instructions. base is overwritten
+    template <typename Writer>
+    void emit_vector_power_chain(Writer& writer, PowerChain chain, XMMRegister result, XMMRegister base) noexcept;
+
+    //xmm0 = pow(xmm0, xmm1) with all the special cases of std::pow
+    template <typename Writer>
+    void emit_scalar_pow(Writer& writer, Label entry) noexcept;
+
+    //xmm0 = tgamma(xmm0) with all the special cases of std::tgamma
+    template <typename Writer>
+    void emit_scalar_tgamma(Writer& writer, Label entry) noexcept;
+
+    /**
+    * \brief xmm0 = pow(xmm0, xmm1) in every lane
+    *
+    * Every lane of xmm0 has to be a positive normal number and every lane of xmm1 has to be finite. The vector length is the
+    * one set on the writer.
+    */
+    template <typename Writer>
+    void emit_vector_pow(Writer& writer, Label entry) noexcept;
+
+    extern template void emit_scalar_power_chain<Encoder>(Encoder&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    extern template void emit_scalar_power_chain<NasmWriter>(NasmWriter&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    extern template void emit_vector_power_chain<Encoder>(Encoder&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    extern template void emit_vector_power_chain<NasmWriter>(NasmWriter&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    extern template void emit_scalar_pow<Encoder>(Encoder&, Label) noexcept;
+    extern template void emit_scalar_pow<NasmWriter>(NasmWriter&, Label) noexcept;
+    extern template void emit_scalar_tgamma<Encoder>(Encoder&, Label) noexcept;
+    extern template void emit_scalar_tgamma<NasmWriter>(NasmWriter&, Label) noexcept;
+    extern template void emit_vector_pow<Encoder>(Encoder&, Label) noexcept;
+    extern template void emit_vector_pow<NasmWriter>(NasmWriter&, Label) noexcept;
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_MATH_H
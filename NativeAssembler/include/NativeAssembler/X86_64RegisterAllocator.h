@@ -0,0 +1,75 @@
+/**
+* \file X86_64RegisterAllocator.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the linear-scan register allocator of the x86-64 lowering
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_REGISTER_ALLOCATOR_H
+#define RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_REGISTER_ALLOCATOR_H
+
+#include "X86_64.h"
+#include "shared/VM/VMData.h"
+
+#include <bitset>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    //Only the first number_of_tracked_slots slots of a call frame are considered for registers. The rest always live in memory
+    constexpr std::size_t number_of_tracked_slots = 256U;
+
+    //One bit per tracked slot of a call frame
+    using SlotSet = std::bitset<number_of_tracked_slots>;
+
+    struct RegisterAllocation
+    {
+        //the register each slot lives in, std::nullopt if it stays in memory
+        std::vector<std::optional<XMMRegister>> registers{};
+
+        //allocated slots whose value on entry to the frame is read later. These have to be loaded from memory
+        SlotSet live_on_entry{};
+
+        //for every instruction that calls out of the frame: the allocated slots that have to survive the call.
+        //These are stored to their memory slots before the call and reloaded afterwards
+        std::vector<SlotSet> preserved{};
+    };
+
+    /**
+    * \brief Map the slots of a call frame onto xmm registers
+    *
+    * Liveness is computed over the control flow graph of the frame and every slot gets the interval from its first to its
+    * last live point. The intervals are then assigned with linear scan. If there are not enough registers, the interval
+    * with the fewest references per instruction it covers stays in memory.
+    * A slot keeps its register for its whole interval, so control flow never needs to move values around. The only spills
+    * happen around calls to other call frames, which clobber every xmm register, and to the math routines for pow and fac.
+    *
+    * Invalid operands are ignored here. They are reported when the frame is lowered.
+    */
+    [[nodiscard]] RegisterAllocation allocate_registers(const VM::VMData& data, std::size_t frame_index) noexcept;
+
+} // namespace RaychelScript::NativeAssembler::X86_64
+
+#endif //!RAYCHELSCRIPT_NATIVE_ASSEMBLER_X86_64_REGISTER_ALLOCATOR_H
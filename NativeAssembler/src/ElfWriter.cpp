@@ -0,0 +1,394 @@
+/**
+* \file ElfWriter.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for ElfWriter class
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/ElfWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        static_assert(std::endian::native == std::endian::little, "ELF images are written in host byte order");
+
+        constexpr std::size_t page_size = 0x1000U;
+
+        constexpr std::size_t header_size = 64U;
+        constexpr std::size_t program_header_size = 56U;
+        constexpr std::size_t section_header_size = 64U;
+        constexpr std::size_t symbol_size = 24U;
+        constexpr std::size_t dynamic_entry_size = 16U;
+
+        constexpr std::uint16_t et_dyn = 3U;
+        constexpr std::uint16_t em_x86_64 = 62U;
+
+        constexpr std::uint32_t pt_load = 1U;
+        constexpr std::uint32_t pt_dynamic = 2U;
+        constexpr std::uint32_t pt_gnu_stack = 0x6474'E551U;
+        constexpr std::uint32_t pf_x = 1U;
+        constexpr std::uint32_t pf_w = 2U;
+        constexpr std::uint32_t pf_r = 4U;
+
+        constexpr std::uint32_t sht_progbits = 1U;
+        constexpr std::uint32_t sht_strtab = 3U;
+        constexpr std::uint32_t sht_hash = 5U;
+        constexpr std::uint32_t sht_dynamic = 6U;
+        constexpr std::uint32_t sht_dynsym = 11U;
+        constexpr std::uint64_t shf_write = 1U;
+        constexpr std::uint64_t shf_alloc = 2U;
+        constexpr std::uint64_t shf_execinstr = 4U;
+
+        constexpr std::uint8_t stb_global = 1U;
+        constexpr std::uint8_t stt_object = 1U;
+        constexpr std::uint8_t stt_func = 2U;
+
+        constexpr std::int64_t dt_null = 0;
+        constexpr std::int64_t dt_hash = 4;
+        constexpr std::int64_t dt_strtab = 5;
+        constexpr std::int64_t dt_symtab = 6;
+        constexpr std::int64_t dt_strsz = 10;
+        constexpr std::int64_t dt_syment = 11;
+
+        //section indices, in the order the section headers are written
+        enum class Section : std::uint16_t {
+            null,
+            hash,
+            dynsym,
+            dynstr,
+            text,
+            dynamic,
+            shstrtab,
+
+            num_sections
+        };
+
+        constexpr std::size_t align_up(std::size_t value, std::size_t alignment) noexcept
+        {
+            return (value + alignment - 1U) / alignment * alignment;
+        }
+
+        //System V ABI symbol hash
+        constexpr std::uint32_t elf_hash(std::string_view name) noexcept
+        {
+            std::uint32_t hash{};
+            for (const auto c : name) {
+                hash = (hash << 4U) + static_cast<std::uint8_t>(c);
+                const auto high = hash & 0xF000'0000U;
+                if (high != 0U) {
+                    hash ^= high >> 24U;
+                }
+                hash &= ~high;
+            }
+            return hash;
+        }
+
+        class StringTable
+        {
+        public:
+            StringTable() noexcept : data_(1U, '\0')
+            {}
+
+            std::uint32_t add(std::string_view string) noexcept
+            {
+                const auto offset = static_cast<std::uint32_t>(data_.size());
+                data_.append(string);
+                data_.push_back('\0');
+                return offset;
+            }
+
+            [[nodiscard]] const std::string& data() const noexcept
+            {
+                return data_;
+            }
+
+        private:
+            std::string data_;
+        };
+
+        class Image
+        {
+        public:
+            template <typename T>
+            void put(T value) noexcept
+            {
+                std::array<std::uint8_t, sizeof(T)> bytes{};
+                std::memcpy(bytes.data(), &value, sizeof(T));
+                bytes_.insert(bytes_.end(), bytes.begin(), bytes.end());
+            }
+
+            void put(std::span<const std::uint8_t> bytes) noexcept
+            {
+                bytes_.insert(bytes_.end(), bytes.begin(), bytes.end());
+            }
+
+            void put(std::string_view string) noexcept
+            {
+                bytes_.insert(bytes_.end(), string.begin(), string.end());
+            }
+
+            void pad_to(std::size_t offset) noexcept
+            {
+                bytes_.resize(std::max(bytes_.size(), offset), 0U);
+            }
+
+            [[nodiscard]] std::size_t size() const noexcept
+            {
+                return bytes_.size();
+            }
+
+            [[nodiscard]] const std::vector<std::uint8_t>& bytes() const noexcept
+            {
+                return bytes_;
+            }
+
+        private:
+            std::vector<std::uint8_t> bytes_{};
+        };
+
+        void put_program_header(
+            Image& image, std::uint32_t type, std::uint32_t flags, std::size_t offset, std::size_t size,
+            std::size_t alignment) noexcept
+        {
+            //Every byte is mapped at the address equal to its file offset
+            image.put(type);
+            image.put(flags);
+            image.put<std::uint64_t>(offset);
+            image.put<std::uint64_t>(offset);
+            image.put<std::uint64_t>(offset);
+            image.put<std::uint64_t>(size);
+            image.put<std::uint64_t>(size);
+            image.put<std::uint64_t>(alignment);
+        }
+
+        struct SectionHeader
+        {
+            std::uint32_t name{};
+            std::uint32_t type{};
+            std::uint64_t flags{};
+            std::size_t offset{};
+            std::size_t size{};
+            Section link{Section::null};
+            std::uint32_t info{};
+            std::size_t alignment{};
+            std::size_t entry_size{};
+        };
+
+        void put_section_header(Image& image, const SectionHeader& header) noexcept
+        {
+            const auto is_allocated = (header.flags & shf_alloc) != 0U;
+            image.put(header.name);
+            image.put(header.type);
+            image.put(header.flags);
+            image.put<std::uint64_t>(is_allocated ? header.offset : 0U);
+            image.put<std::uint64_t>(header.offset);
+            image.put<std::uint64_t>(header.size);
+            image.put(static_cast<std::uint32_t>(header.link));
+            image.put(header.info);
+            image.put<std::uint64_t>(header.alignment);
+            image.put<std::uint64_t>(header.entry_size);
+        }
+
+    } // namespace
+
+    void ElfWriter::add_function(std::string_view name, std::size_t offset) noexcept
+    {
+        symbols_.push_back(Symbol{std::string{name}, offset, 0U, false});
+    }
+
+    void ElfWriter::add_object(std::string_view name, std::span<const std::uint8_t> bytes) noexcept
+    {
+        text_.resize(align_up(text_.size(), sizeof(std::uint64_t)), 0U);
+        symbols_.push_back(Symbol{std::string{name}, text_.size(), bytes.size(), true});
+        text_.insert(text_.end(), bytes.begin(), bytes.end());
+    }
+
+    bool ElfWriter::write(std::ostream& output_stream) const noexcept
+    {
+        //dynamic symbol table: the null symbol and then the exported symbols
+        StringTable dynstr{};
+        std::vector<std::uint32_t> symbol_names{};
+        for (const auto& symbol : symbols_) {
+            symbol_names.push_back(dynstr.add(symbol.name));
+        }
+        const auto num_symbols = symbols_.size() + 1U;
+        const auto num_buckets = std::max<std::size_t>(num_symbols / 2U, 1U);
+
+        StringTable shstrtab{};
+        const std::array section_names{
+            0U,
+            shstrtab.add(".hash"),
+            shstrtab.add(".dynsym"),
+            shstrtab.add(".dynstr"),
+            shstrtab.add(".text"),
+            shstrtab.add(".dynamic"),
+            shstrtab.add(".shstrtab")};
+
+        constexpr auto num_program_headers = 5U;
+        constexpr auto num_dynamic_entries = 6U;
+
+        //read-only segment: headers and everything the dynamic loader reads
+        const auto hash_offset = align_up(header_size + num_program_headers * program_header_size, 8U);
+        const auto hash_size = (2U + num_buckets + num_symbols) * sizeof(std::uint32_t);
+        const auto dynsym_offset = align_up(hash_offset + hash_size, 8U);
+        const auto dynsym_size = num_symbols * symbol_size;
+        const auto dynstr_offset = dynsym_offset + dynsym_size;
+        const auto dynstr_size = dynstr.data().size();
+
+        //executable segment
+        const auto text_offset = align_up(dynstr_offset + dynstr_size, page_size);
+        const auto text_size = text_.size();
+
+        //writable segment. The loader never writes to it, but this is where it expects the dynamic section
+        const auto dynamic_offset = align_up(text_offset + text_size, page_size);
+        const auto dynamic_size = num_dynamic_entries * dynamic_entry_size;
+
+        //not loaded
+        const auto shstrtab_offset = dynamic_offset + dynamic_size;
+        const auto shstrtab_size = shstrtab.data().size();
+        const auto section_headers_offset = align_up(shstrtab_offset + shstrtab_size, 8U);
+
+        Image image{};
+
+        //ELF header
+        image.put(std::string_view{"\x7F" "ELF"});
+        image.put<std::uint8_t>(2U); //64 bit
+        image.put<std::uint8_t>(1U); //little endian
+        image.put<std::uint8_t>(1U); //current version
+        image.put<std::uint8_t>(0U); //System V ABI
+        image.pad_to(16U);
+        image.put(et_dyn);
+        image.put(em_x86_64);
+        image.put<std::uint32_t>(1U);
+        image.put<std::uint64_t>(0U); //no entry point
+        image.put<std::uint64_t>(header_size);
+        image.put<std::uint64_t>(section_headers_offset);
+        image.put<std::uint32_t>(0U);
+        image.put<std::uint16_t>(header_size);
+        image.put<std::uint16_t>(program_header_size);
+        image.put<std::uint16_t>(num_program_headers);
+        image.put<std::uint16_t>(section_header_size);
+        image.put<std::uint16_t>(static_cast<std::uint16_t>(Section::num_sections));
+        image.put<std::uint16_t>(static_cast<std::uint16_t>(Section::shstrtab));
+
+        //program headers
+        put_program_header(image, pt_load, pf_r, 0U, dynstr_offset + dynstr_size, page_size);
+        put_program_header(image, pt_load, pf_r | pf_x, text_offset, text_size, page_size);
+        put_program_header(image, pt_load, pf_r | pf_w, dynamic_offset, dynamic_size, page_size);
+        put_program_header(image, pt_dynamic, pf_r | pf_w, dynamic_offset, dynamic_size, 8U);
+        //without this, the loader would make the stack executable
+        put_program_header(image, pt_gnu_stack, pf_r | pf_w, 0U, 0U, 16U);
+
+        //.hash
+        image.pad_to(hash_offset);
+        std::vector<std::uint32_t> buckets(num_buckets, 0U);
+        std::vector<std::uint32_t> chains(num_symbols, 0U);
+        for (std::size_t i = 1U; i < num_symbols; ++i) {
+            auto& bucket = buckets[elf_hash(symbols_[i - 1U].name) % num_buckets];
+            chains[i] = bucket;
+            bucket = static_cast<std::uint32_t>(i);
+        }
+        image.put(static_cast<std::uint32_t>(num_buckets));
+        image.put(static_cast<std::uint32_t>(num_symbols));
+        for (const auto bucket : buckets) {
+            image.put(bucket);
+        }
+        for (const auto chain : chains) {
+            image.put(chain);
+        }
+
+        //.dynsym
+        image.pad_to(dynsym_offset + symbol_size);
+        for (std::size_t i = 0U; i < symbols_.size(); ++i) {
+            const auto& symbol = symbols_[i];
+            image.put(symbol_names[i]);
+            image.put<std::uint8_t>((stb_global << 4U) | (symbol.is_object ? stt_object : stt_func));
+            image.put<std::uint8_t>(0U);
+            image.put(static_cast<std::uint16_t>(Section::text));
+            image.put<std::uint64_t>(text_offset + symbol.offset);
+            image.put<std::uint64_t>(symbol.size);
+        }
+
+        //.dynstr
+        image.put(std::string_view{dynstr.data()});
+
+        //.text
+        image.pad_to(text_offset);
+        image.put(std::span<const std::uint8_t>{text_});
+
+        //.dynamic
+        image.pad_to(dynamic_offset);
+        const std::array<std::pair<std::int64_t, std::size_t>, num_dynamic_entries> dynamic_entries{{
+            {dt_hash, hash_offset},
+            {dt_strtab, dynstr_offset},
+            {dt_symtab, dynsym_offset},
+            {dt_strsz, dynstr_size},
+            {dt_syment, symbol_size},
+            {dt_null, 0U},
+        }};
+        for (const auto& [tag, value] : dynamic_entries) {
+            image.put(tag);
+            image.put<std::uint64_t>(value);
+        }
+
+        //.shstrtab and section headers
+        image.put(std::string_view{shstrtab.data()});
+        image.pad_to(section_headers_offset);
+
+        const auto name = [&](Section section) {
+            return section_names[static_cast<std::size_t>(section)];
+        };
+        const std::array<SectionHeader, static_cast<std::size_t>(Section::num_sections)> section_headers{{
+            {},
+            {name(Section::hash), sht_hash, shf_alloc, hash_offset, hash_size, Section::dynsym, 0U, 8U, sizeof(std::uint32_t)},
+            {name(Section::dynsym), sht_dynsym, shf_alloc, dynsym_offset, dynsym_size, Section::dynstr, 1U, 8U, symbol_size},
+            {name(Section::dynstr), sht_strtab, shf_alloc, dynstr_offset, dynstr_size, Section::null, 0U, 1U, 0U},
+            {name(Section::text), sht_progbits, shf_alloc | shf_execinstr, text_offset, text_size, Section::null, 0U, 16U, 0U},
+            {name(Section::dynamic),
+             sht_dynamic,
+             shf_alloc | shf_write,
+             dynamic_offset,
+             dynamic_size,
+             Section::dynstr,
+             0U,
+             8U,
+             dynamic_entry_size},
+            {name(Section::shstrtab), sht_strtab, 0U, shstrtab_offset, shstrtab_size, Section::null, 0U, 1U, 0U},
+        }};
+        for (const auto& header : section_headers) {
+            put_section_header(image, header);
+        }
+
+        const auto& bytes = image.bytes();
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        output_stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(output_stream);
+    }
+
+} // namespace RaychelScript::NativeAssembler::X86_64
@@ -0,0 +1,176 @@
+/**
+* \file JIT.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the in-memory x86-64 JIT
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/JIT.h"
+#include "NativeAssembler/X86_64Encoder.h"
+#include "NativeAssembler/X86_64Lowering.h"
+
+#include "RaychelCore/Raychel_assert.h"
+#include "RaychelCore/compat.h"
+
+#include <cstring>
+
+#if RAYCHEL_ACTIVE_OS == RAYCHEL_OS_LINUX && defined(__x86_64__)
+    #define RAYCHELSCRIPT_NATIVE_ASSEMBLER_JIT_SUPPORTED 1
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace RaychelScript::NativeAssembler {
+
+    namespace {
+
+        using VM::VMErrorCode;
+
+        struct GeneratedCode
+        {
+            std::vector<std::uint8_t> code;
+            std::size_t batch_entry_offset;
+        };
+
+        std::variant<NativeAssemblerErrorCode, GeneratedCode>
+        generate_code(
+            const VM::VMData& data, std::size_t stack_size, std::size_t memory_size,
+            X86_64::InstructionSet instruction_set) noexcept
+        {
+            X86_64::Encoder encoder{};
+            const X86_64::LoweringOptions options{
+                .stack_size = stack_size, .memory_size = memory_size, .instruction_set = instruction_set};
+            if (const auto ec = X86_64::lower(data, encoder, options); ec != NativeAssemblerErrorCode::ok)
+                return ec;
+
+            const auto batch_entry_offset = encoder.symbol_offset(X86_64::batch_entry_point_name(instruction_set));
+            auto code = encoder.finish();
+            if (!code.has_value() || !batch_entry_offset.has_value())
+                return NativeAssemblerErrorCode::invalid_operand;
+            return GeneratedCode{std::move(code).value(), *batch_entry_offset};
+        }
+
+    } // namespace
+
+#ifdef RAYCHELSCRIPT_NATIVE_ASSEMBLER_JIT_SUPPORTED
+
+    namespace {
+
+        //The JIT only needs the variant for the CPU it is running on. __builtin_cpu_supports also checks for OS support
+        X86_64::InstructionSet host_instruction_set() noexcept
+        {
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+                return X86_64::InstructionSet::avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return X86_64::InstructionSet::avx2;
+            return X86_64::InstructionSet::sse2;
+        }
+
+    } // namespace
+
+    std::variant<NativeAssemblerErrorCode, CompiledScript>
+    jit_compile(const VM::VMData& data, std::size_t stack_size, std::size_t memory_size) noexcept
+    {
+        auto maybe_code = generate_code(data, stack_size, memory_size, host_instruction_set());
+        if (const auto* ec = std::get_if<NativeAssemblerErrorCode>(&maybe_code); ec != nullptr)
+            return *ec;
+        const auto& [code, batch_entry_offset] = std::get<GeneratedCode>(maybe_code);
+
+        const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const auto mapping_size = (code.size() + page_size - 1U) / page_size * page_size;
+
+        //Never map memory writable and executable at the same time
+        //NOLINTNEXTLINE(hicpp-signed-bitwise)
+        void* memory = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+            return NativeAssemblerErrorCode::code_allocation_error;
+
+        std::memcpy(memory, code.data(), code.size());
+
+        //NOLINTNEXTLINE(hicpp-signed-bitwise)
+        if (mprotect(memory, mapping_size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory, mapping_size);
+            return NativeAssemblerErrorCode::code_allocation_error;
+        }
+
+        return CompiledScript{memory, mapping_size, batch_entry_offset, data.num_input_identifiers, data.num_output_identifiers};
+    }
+
+    CompiledScript::~CompiledScript() noexcept
+    {
+        if (code_ == nullptr) {
+            return;
+        }
+        [[maybe_unused]] const auto result = munmap(code_, mapping_size_);
+        RAYCHEL_ASSERT(result == 0);
+    }
+
+#else
+
+    std::variant<NativeAssemblerErrorCode, CompiledScript>
+    jit_compile(const VM::VMData& /*unused*/, std::size_t /*unused*/, std::size_t /*unused*/) noexcept
+    {
+        return NativeAssemblerErrorCode::unsupported_platform;
+    }
+
+    CompiledScript::~CompiledScript() noexcept = default;
+
+#endif
+
+    CompiledScript::EntryPoint CompiledScript::entry_point() const noexcept
+    {
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<EntryPoint>(code_);
+    }
+
+    VM::VMErrorCode CompiledScript::run(std::span<const double> input_values, std::span<double> output_values) const noexcept
+    {
+        if (std::cmp_not_equal(input_values.size(), num_input_identifiers_))
+            return VMErrorCode::mismatched_inputs;
+
+        if (std::cmp_not_equal(output_values.size(), num_output_identifiers_))
+            return VMErrorCode::mismatched_outputs;
+
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto entry = reinterpret_cast<CheckedEntryPoint>(code_);
+        return static_cast<VMErrorCode>(entry(input_values.data(), output_values.data()));
+    }
+
+    VM::VMErrorCode CompiledScript::run_batch(
+        std::span<const double> input_values, std::span<double> output_values, std::size_t count) const noexcept
+    {
+        if (input_values.size() != num_input_identifiers_ * count)
+            return VMErrorCode::mismatched_inputs;
+
+        if (output_values.size() != num_output_identifiers_ * count)
+            return VMErrorCode::mismatched_outputs;
+
+        if (count == 0)
+            return VMErrorCode::ok;
+
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto entry = reinterpret_cast<BatchEntryPoint>(static_cast<std::uint8_t*>(code_) + batch_entry_offset_);
+        return static_cast<VMErrorCode>(entry(input_values.data(), output_values.data(), count));
+    }
+
+} // namespace RaychelScript::NativeAssembler
@@ -0,0 +1,627 @@
+/**
+* \file NasmWriter.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the NASM text backend of the x86-64 lowering
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/NasmWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iomanip>
+#include <string_view>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        constexpr std::array<std::string_view, 16> qword_register_names{
+            "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"};
+
+        constexpr std::array<std::string_view, 16> dword_register_names{
+            "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi", "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"};
+
+        constexpr std::array<std::string_view, 16> byte_register_names{
+            "al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil", "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b"};
+
+        constexpr std::array<std::string_view, 16> condition_suffixes{
+            "o", "no", "b", "ae", "e", "ne", "be", "a", "s", "ns", "p", "np", "l", "ge", "le", "g"};
+
+        constexpr std::string_view constant_pool_name = "raychelscript_constants";
+
+        //Operand wrappers. Each one knows how to print itself in NASM syntax
+        struct Q
+        {
+            Register reg;
+        };
+
+        struct D
+        {
+            Register reg;
+        };
+
+        struct B
+        {
+            Register reg;
+        };
+
+        struct X
+        {
+            XMMRegister reg;
+        };
+
+        //a ymm or zmm register
+        struct V
+        {
+            XMMRegister reg;
+            VectorLength length;
+        };
+
+        struct K
+        {
+            MaskRegister reg;
+        };
+
+        struct M
+        {
+            Address address;
+            std::string_view size{"qword "};
+        };
+
+        struct L
+        {
+            Label label;
+        };
+
+        struct Hex
+        {
+            std::uint64_t value;
+        };
+
+        std::ostream& operator<<(std::ostream& os, Q op)
+        {
+            return os << qword_register_names.at(static_cast<std::size_t>(op.reg));
+        }
+
+        std::ostream& operator<<(std::ostream& os, D op)
+        {
+            return os << dword_register_names.at(static_cast<std::size_t>(op.reg));
+        }
+
+        std::ostream& operator<<(std::ostream& os, B op)
+        {
+            return os << byte_register_names.at(static_cast<std::size_t>(op.reg));
+        }
+
+        std::ostream& operator<<(std::ostream& os, X op)
+        {
+            return os << "xmm" << static_cast<std::uint32_t>(op.reg);
+        }
+
+        std::ostream& operator<<(std::ostream& os, V op)
+        {
+            return os << (op.length == VectorLength::v512 ? "zmm" : "ymm") << static_cast<std::uint32_t>(op.reg);
+        }
+
+        std::ostream& operator<<(std::ostream& os, K op)
+        {
+            return os << 'k' << static_cast<std::uint32_t>(op.reg);
+        }
+
+        std::ostream& operator<<(std::ostream& os, L op)
+        {
+            return os << "raychelscript_label_" << op.label.id;
+        }
+
+        std::ostream& operator<<(std::ostream& os, Hex op)
+        {
+            return os << "0x" << std::hex << std::setw(16) << std::setfill('0') << op.value << std::dec << std::setfill(' ');
+        }
+
+        std::ostream& operator<<(std::ostream& os, M op)
+        {
+            os << op.size;
+            const auto& address = op.address;
+            if (address.is_constant()) {
+                return os << "[rel " << constant_pool_name << '+' << address.displacement() * 8 << ']';
+            }
+            os << '[' << Q{address.base()};
+            if (address.displacement() < 0) {
+                os << address.displacement();
+            } else if (address.displacement() > 0) {
+                os << '+' << address.displacement();
+            }
+            return os << ']';
+        }
+
+        M vector_word(Address address, VectorLength length) noexcept
+        {
+            return M{address, length == VectorLength::v512 ? "zword " : "yword "};
+        }
+
+        template <typename... Operands>
+        void write(std::ostream& os, std::string_view mnemonic, const Operands&... operands) noexcept
+        {
+            os << "    " << mnemonic;
+            [[maybe_unused]] std::string_view separator = " ";
+            ((os << separator << operands, separator = ", "), ...);
+            os << '\n';
+        }
+
+    } // namespace
+
+    Label NasmWriter::make_label() noexcept
+    {
+        return Label{number_of_labels_++};
+    }
+
+    void NasmWriter::bind(Label label) noexcept
+    {
+        output_stream_ << L{label} << ":\n";
+    }
+
+    std::uint32_t NasmWriter::add_constant(std::uint64_t bits) noexcept
+    {
+        if (const auto it = std::ranges::find(constants_, bits); it != constants_.end()) {
+            return static_cast<std::uint32_t>(std::distance(constants_.begin(), it));
+        }
+        constants_.push_back(bits);
+        return static_cast<std::uint32_t>(constants_.size() - 1U);
+    }
+
+    std::uint32_t NasmWriter::add_constant(double value) noexcept
+    {
+        return add_constant(std::bit_cast<std::uint64_t>(value));
+    }
+
+    void NasmWriter::global(std::string_view name) noexcept
+    {
+        output_stream_ << name << ":\n";
+    }
+
+    void NasmWriter::set_vector_length(VectorLength length) noexcept
+    {
+        vector_length_ = length;
+    }
+
+    void NasmWriter::movsd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "movsd", X{destination}, M{source});
+    }
+
+    void NasmWriter::movsd(Address destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "movsd", M{destination}, X{source});
+    }
+
+    void NasmWriter::movapd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "movapd", X{destination}, X{source});
+    }
+
+    void NasmWriter::addsd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "addsd", X{destination}, M{source});
+    }
+
+    void NasmWriter::addsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "addsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::subsd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "subsd", X{destination}, M{source});
+    }
+
+    void NasmWriter::subsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "subsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::mulsd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "mulsd", X{destination}, M{source});
+    }
+
+    void NasmWriter::mulsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "mulsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::divsd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "divsd", X{destination}, M{source});
+    }
+
+    void NasmWriter::divsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "divsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::ucomisd(XMMRegister lhs, Address rhs) noexcept
+    {
+        write(output_stream_, "ucomisd", X{lhs}, M{rhs});
+    }
+
+    void NasmWriter::ucomisd(XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "ucomisd", X{lhs}, X{rhs});
+    }
+
+    void NasmWriter::sqrtsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "sqrtsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::minsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "minsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::maxsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "maxsd", X{destination}, X{source});
+    }
+
+    void NasmWriter::andpd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "andpd", X{destination}, X{source});
+    }
+
+    void NasmWriter::xorpd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "xorpd", X{destination}, X{source});
+    }
+
+    void NasmWriter::paddq(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "paddq", X{destination}, X{source});
+    }
+
+    void NasmWriter::psllq(XMMRegister destination, std::uint8_t bits) noexcept
+    {
+        write(output_stream_, "psllq", X{destination}, static_cast<std::uint32_t>(bits));
+    }
+
+    void NasmWriter::psrlq(XMMRegister destination, std::uint8_t bits) noexcept
+    {
+        write(output_stream_, "psrlq", X{destination}, static_cast<std::uint32_t>(bits));
+    }
+
+    void NasmWriter::vmovupd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "vmovupd", V{destination, vector_length_}, vector_word(source, vector_length_));
+    }
+
+    void NasmWriter::vmovupd(Address destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "vmovupd", vector_word(destination, vector_length_), V{source, vector_length_});
+    }
+
+    void NasmWriter::vmovapd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "vmovapd", V{destination, vector_length_}, V{source, vector_length_});
+    }
+
+    void NasmWriter::vbroadcastsd(XMMRegister destination, Address source) noexcept
+    {
+        write(output_stream_, "vbroadcastsd", V{destination, vector_length_}, M{source});
+    }
+
+    void NasmWriter::vaddpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        write(output_stream_, "vaddpd", V{destination, vector_length_}, V{lhs, vector_length_}, vector_word(rhs, vector_length_));
+    }
+
+    void NasmWriter::vaddpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vaddpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vsubpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        write(output_stream_, "vsubpd", V{destination, vector_length_}, V{lhs, vector_length_}, vector_word(rhs, vector_length_));
+    }
+
+    void NasmWriter::vsubpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vsubpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vmulpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        write(output_stream_, "vmulpd", V{destination, vector_length_}, V{lhs, vector_length_}, vector_word(rhs, vector_length_));
+    }
+
+    void NasmWriter::vmulpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vmulpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vdivpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        write(output_stream_, "vdivpd", V{destination, vector_length_}, V{lhs, vector_length_}, vector_word(rhs, vector_length_));
+    }
+
+    void NasmWriter::vdivpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vdivpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vsqrtpd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "vsqrtpd", V{destination, vector_length_}, V{source, vector_length_});
+    }
+
+    void NasmWriter::vminpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vminpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vmaxpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vmaxpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vandpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vandpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vxorpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vxorpd", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vcmppd(XMMRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept
+    {
+        write(
+            output_stream_,
+            "vcmppd",
+            V{destination, vector_length_},
+            V{lhs, vector_length_},
+            vector_word(rhs, vector_length_),
+            static_cast<std::uint32_t>(predicate));
+    }
+
+    void NasmWriter::vcmppd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept
+    {
+        write(
+            output_stream_,
+            "vcmppd",
+            V{destination, vector_length_},
+            V{lhs, vector_length_},
+            V{rhs, vector_length_},
+            static_cast<std::uint32_t>(predicate));
+    }
+
+    void NasmWriter::vmovmskpd(Register destination, XMMRegister source) noexcept
+    {
+        write(output_stream_, "vmovmskpd", D{destination}, V{source, vector_length_});
+    }
+
+    void NasmWriter::vzeroupper() noexcept
+    {
+        write(output_stream_, "vzeroupper");
+    }
+
+    void NasmWriter::vpaddq(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        write(output_stream_, "vpaddq", V{destination, vector_length_}, V{lhs, vector_length_}, V{rhs, vector_length_});
+    }
+
+    void NasmWriter::vpsllq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+    {
+        write(
+            output_stream_, "vpsllq", V{destination, vector_length_}, V{source, vector_length_},
+            static_cast<std::uint32_t>(bits));
+    }
+
+    void NasmWriter::vpsrlq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+    {
+        write(
+            output_stream_, "vpsrlq", V{destination, vector_length_}, V{source, vector_length_},
+            static_cast<std::uint32_t>(bits));
+    }
+
+    void NasmWriter::vcmppd(MaskRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept
+    {
+        write(
+            output_stream_,
+            "vcmppd",
+            K{destination},
+            V{lhs, vector_length_},
+            vector_word(rhs, vector_length_),
+            static_cast<std::uint32_t>(predicate));
+    }
+
+    void NasmWriter::vcmppd(MaskRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept
+    {
+        write(
+            output_stream_,
+            "vcmppd",
+            K{destination},
+            V{lhs, vector_length_},
+            V{rhs, vector_length_},
+            static_cast<std::uint32_t>(predicate));
+    }
+
+    void NasmWriter::kmovw(Register destination, MaskRegister source) noexcept
+    {
+        write(output_stream_, "kmovw", D{destination}, K{source});
+    }
+
+    void NasmWriter::mov(Register destination, Address source) noexcept
+    {
+        write(output_stream_, "mov", Q{destination}, M{source});
+    }
+
+    void NasmWriter::mov(Address destination, Register source) noexcept
+    {
+        write(output_stream_, "mov", M{destination}, Q{source});
+    }
+
+    void NasmWriter::mov(Register destination, Register source) noexcept
+    {
+        write(output_stream_, "mov", Q{destination}, Q{source});
+    }
+
+    void NasmWriter::mov(Register destination, std::uint64_t immediate) noexcept
+    {
+        write(output_stream_, "mov", Q{destination}, Hex{immediate});
+    }
+
+    void NasmWriter::mov(Address destination, std::int32_t immediate) noexcept
+    {
+        write(output_stream_, "mov", M{destination}, immediate);
+    }
+
+    void NasmWriter::mov32(Register destination, std::uint32_t immediate) noexcept
+    {
+        write(output_stream_, "mov", D{destination}, immediate);
+    }
+
+    void NasmWriter::lea(Register destination, Address source) noexcept
+    {
+        write(output_stream_, "lea", Q{destination}, M{source, ""});
+    }
+
+    void NasmWriter::add(Register destination, std::int32_t immediate) noexcept
+    {
+        write(output_stream_, "add", Q{destination}, immediate);
+    }
+
+    void NasmWriter::add(Register destination, Register source) noexcept
+    {
+        write(output_stream_, "add", Q{destination}, Q{source});
+    }
+
+    void NasmWriter::sub(Register destination, std::int32_t immediate) noexcept
+    {
+        write(output_stream_, "sub", Q{destination}, immediate);
+    }
+
+    void NasmWriter::cmp(Register lhs, Register rhs) noexcept
+    {
+        write(output_stream_, "cmp", Q{lhs}, Q{rhs});
+    }
+
+    void NasmWriter::cmp(Register lhs, std::int32_t immediate) noexcept
+    {
+        write(output_stream_, "cmp", Q{lhs}, immediate);
+    }
+
+    void NasmWriter::test32(Register lhs, Register rhs) noexcept
+    {
+        write(output_stream_, "test", D{lhs}, D{rhs});
+    }
+
+    void NasmWriter::xor32(Register destination, Register source) noexcept
+    {
+        write(output_stream_, "xor", D{destination}, D{source});
+    }
+
+    void NasmWriter::btr(Register destination, std::uint8_t bit) noexcept
+    {
+        write(output_stream_, "btr", Q{destination}, static_cast<std::uint32_t>(bit));
+    }
+
+    void NasmWriter::shl(Register destination, std::uint8_t bits) noexcept
+    {
+        write(output_stream_, "shl", Q{destination}, static_cast<std::uint32_t>(bits));
+    }
+
+    void NasmWriter::setcc(Condition condition, Register destination) noexcept
+    {
+        const auto suffix = condition_suffixes.at(static_cast<std::size_t>(condition));
+        output_stream_ << "    set" << suffix << ' ' << B{destination} << '\n';
+    }
+
+    void NasmWriter::movzx8(Register destination, Register source) noexcept
+    {
+        write(output_stream_, "movzx", D{destination}, B{source});
+    }
+
+    void NasmWriter::and8(Register destination, Register source) noexcept
+    {
+        write(output_stream_, "and", B{destination}, B{source});
+    }
+
+    void NasmWriter::or8(Register destination, Register source) noexcept
+    {
+        write(output_stream_, "or", B{destination}, B{source});
+    }
+
+    void NasmWriter::push(Register source) noexcept
+    {
+        write(output_stream_, "push", Q{source});
+    }
+
+    void NasmWriter::pop(Register destination) noexcept
+    {
+        write(output_stream_, "pop", Q{destination});
+    }
+
+    void NasmWriter::rep_stosq() noexcept
+    {
+        write(output_stream_, "rep stosq");
+    }
+
+    void NasmWriter::jmp(Label target) noexcept
+    {
+        write(output_stream_, "jmp", L{target});
+    }
+
+    void NasmWriter::jcc(Condition condition, Label target) noexcept
+    {
+        output_stream_ << "    j" << condition_suffixes.at(static_cast<std::size_t>(condition)) << ' ' << L{target} << '\n';
+    }
+
+    void NasmWriter::call(Label target) noexcept
+    {
+        write(output_stream_, "call", L{target});
+    }
+
+    void NasmWriter::call(Register target) noexcept
+    {
+        write(output_stream_, "call", Q{target});
+    }
+
+    void NasmWriter::ret() noexcept
+    {
+        write(output_stream_, "ret");
+    }
+
+    bool NasmWriter::finish() noexcept
+    {
+        output_stream_ << "\nsection .rodata\nalign 8\n" << constant_pool_name << ":\n";
+        for (const auto constant : constants_) {
+            output_stream_ << "    dq " << Hex{constant} << " ; " << std::bit_cast<double>(constant) << '\n';
+        }
+        return static_cast<bool>(output_stream_);
+    }
+
+} // namespace RaychelScript::NativeAssembler::X86_64
@@ -27,9 +27,13 @@
 */
 
 #include "NativeAssembler/NativeAssembler.h"
-#include <cstring>
-#include <iomanip>
-#include <set>
+#include "NativeAssembler/ElfWriter.h"
+#include "NativeAssembler/NasmWriter.h"
+#include "NativeAssembler/X86_64Encoder.h"
+#include "NativeAssembler/X86_64Lowering.h"
+
+#include <array>
+#include <bit>
 
 #define RAYCHELSCRIPT_NATIVE_ASSEMBLER_DEFINE_ASSEMBLER_FUNCTION(_tag)                                                           \
     NativeAssemblerErrorCode assemble(const VM::VMData& data, _tag##_Tag tag, std::ostream& output_stream) noexcept              \
@@ -37,23 +41,9 @@
         if (!output_stream) {                                                                                                    \
             return NativeAssemblerErrorCode::stream_write_error;                                                                 \
         }                                                                                                                        \
-        NativeAssemblerState state{output_stream};                                                                               \
-        if (const auto ec = write_boilerplate_begin(tag, data, state); ec != NativeAssemblerErrorCode::ok) {                     \
-            return ec;                                                                                                           \
-        }                                                                                                                        \
-        /*We have to do this pass to ensure that every JMP will always have a valid jump target*/                                \
-        for (const auto instr : data.instructions) {                                                                             \
-            if (instr.op_code() == Assembly::OpCode::jmp || instr.op_code() == Assembly::OpCode::jpz)                            \
-                state.jump_indecies.emplace(instr.data1());                                                                      \
-        }                                                                                                                        \
-                                                                                                                                 \
-        for (; state.instruction_index != data.instructions.size(); ++state.instruction_index) {                                 \
-            const auto instruction = data.instructions.at(state.instruction_index);                                              \
-            TRY(assemble_instruction(tag, instruction, state));                                                                  \
-        }                                                                                                                        \
-        if (const auto ec = write_boilerplate_end(tag, data, state); ec != NativeAssemblerErrorCode::ok) {                       \
-            return ec;                                                                                                           \
-        }                                                                                                                        \
+        TRY(write_boilerplate_begin(tag, data, output_stream));                                                                  \
+        TRY(write_code(tag, data, output_stream));                                                                               \
+        TRY(write_boilerplate_end(tag, data, output_stream));                                                                    \
         return NativeAssemblerErrorCode::ok;                                                                                     \
     }
 
@@ -61,7 +51,7 @@
     #undef TRY_WRITE
 #endif
 #define TRY_WRITE(exp)                                                                                                           \
-    if (!(state.output_stream << exp << '\n')) {                                                                                 \
+    if (!(output_stream << exp << '\n')) {                                                                                       \
         return NativeAssemblerErrorCode::stream_write_error;                                                                     \
     }
 #ifdef TRY
@@ -74,209 +64,95 @@
 
 namespace RaychelScript::NativeAssembler {
 
-    struct NativeAssemblerState
-    {
-        std::ostream& output_stream;
-        std::size_t instruction_index{0};
-        std::set<std::size_t> jump_indecies{};
-    };
+    namespace {
 
-    inline namespace X86_64 {
+        constexpr std::array instruction_sets{
+            X86_64::InstructionSet::sse2, X86_64::InstructionSet::avx2, X86_64::InstructionSet::avx512};
 
-        [[nodiscard]] static std::uint64_t get_double_bit_representation(double value) noexcept
+        [[nodiscard]] NativeAssemblerErrorCode
+        write_boilerplate_begin(X86_64_Tag /*unused*/, const VM::VMData& /*unused*/, std::ostream& output_stream) noexcept
         {
-            static_assert(sizeof(std::uint64_t) == sizeof(double));
-            std::uint64_t bits{};
-            std::memcpy(&bits, &value, sizeof(double));
-            return bits;
+            TRY_WRITE("section .text\n");
+            for (const auto instruction_set : instruction_sets) {
+                TRY_WRITE("global " << X86_64::entry_point_name(instruction_set));
+                TRY_WRITE("global " << X86_64::batch_entry_point_name(instruction_set));
+            }
+            TRY_WRITE(R"_asm_(global raychelscript_input_vector_size
+global raychelscript_output_vector_size
+)_asm_");
+            return NativeAssemblerErrorCode::ok;
         }
 
-        [[nodiscard]] static std::string memory_index_to_native(X86_64_Tag /*unused*/, std::uint8_t memory_index) noexcept
+        //The code is the same the JIT runs, the entry points return a VM::VMErrorCode.
+        //The runtime picks the best variant for the CPU it runs on
+        [[nodiscard]] NativeAssemblerErrorCode
+        write_code(X86_64_Tag /*unused*/, const VM::VMData& data, std::ostream& output_stream) noexcept
         {
-            std::stringstream ss;
-            ss << "qword [rsp+" << static_cast<std::uint32_t>(memory_index - 1) * 8 << ']';
-            return ss.str();
+            X86_64::NasmWriter writer{output_stream};
+            for (const auto instruction_set : instruction_sets) {
+                TRY(X86_64::lower(data, writer, {.instruction_set = instruction_set}));
+            }
+            if (!writer.finish() || !output_stream) {
+                return NativeAssemblerErrorCode::stream_write_error;
+            }
+            return NativeAssemblerErrorCode::ok;
         }
 
-        [[nodiscard]] static auto
-        write_boilerplate_begin(X86_64_Tag tag, const VM::VMData& data, NativeAssemblerState& state) noexcept
+        [[nodiscard]] NativeAssemblerErrorCode
+        write_boilerplate_end(X86_64_Tag /*unused*/, const VM::VMData& data, std::ostream& output_stream) noexcept
         {
-            TRY_WRITE(R"_asm_(
-section .text
-
-global raychelscript_entry
-global raychelscript_input_vector_size
-global raychelscript_output_vector_size
-
-extern pow
-
-raychelscript_entry:
-    push r12)_asm_");
-            TRY_WRITE("sub rsp, " << static_cast<std::uint32_t>(data.num_memory_locations - 1) * 8);
-            TRY_WRITE(R"_asm_(
-    mov r12, rdi
-    mov rdi, rsp
-    xor rax, rax
-    mov rcx, )_asm_" << static_cast<std::uint32_t>(data.num_memory_locations - 1));
-            TRY_WRITE(R"_asm_(
-    rep stosq
-    mov rdi, r12
-                )_asm_");
-
-            for (const auto& [_, address] : data.config_block.input_identifiers) {
-                TRY_WRITE("mov rax, qword[rdi+" << static_cast<std::uint32_t>(address.value() - 1) * 8 << ']');
-                TRY_WRITE("mov " << memory_index_to_native(tag, address.value()) << ", rax");
-            }
-            for (const auto& [value, address] : data.immediate_values) {
-                TRY_WRITE("mov rax, " << get_double_bit_representation(value) << "; = " << value);
-                TRY_WRITE("mov " << memory_index_to_native(tag, address.value()) << ", rax");
-            }
-            TRY_WRITE(R"_asm_(
-    xor rax, rax
-                )_asm_");
+            TRY_WRITE("raychelscript_input_vector_size: dd " << static_cast<std::uint32_t>(data.num_input_identifiers));
+            TRY_WRITE("raychelscript_output_vector_size: dd " << static_cast<std::uint32_t>(data.num_output_identifiers));
             return NativeAssemblerErrorCode::ok;
         }
 
-        [[nodiscard]] static NativeAssemblerErrorCode
-        assemble_instruction(X86_64_Tag tag, const Assembly::Instruction& instruction, NativeAssemblerState& state)
+        [[nodiscard]] NativeAssemblerErrorCode
+        write_boilerplate_begin(X86_64_ELF_Tag /*unused*/, const VM::VMData& /*unused*/, std::ostream& /*unused*/) noexcept
         {
-            using Op = Assembly::OpCode;
+            return NativeAssemblerErrorCode::ok;
+        }
 
-            if (state.jump_indecies.contains(state.instruction_index)) {
-                TRY_WRITE("label" << state.instruction_index << ':');
-                state.jump_indecies.erase(state.instruction_index);
+        //Same code and symbols as the NASM output, encoded directly so no assembler or linker is needed
+        [[nodiscard]] NativeAssemblerErrorCode
+        write_code(X86_64_ELF_Tag /*unused*/, const VM::VMData& data, std::ostream& output_stream) noexcept
+        {
+            X86_64::Encoder encoder{};
+            for (const auto instruction_set : instruction_sets) {
+                TRY(X86_64::lower(data, encoder, {.instruction_set = instruction_set}));
+            }
+            const auto symbols = encoder.symbols();
+            auto code = encoder.finish();
+            if (!code.has_value()) {
+                return NativeAssemblerErrorCode::invalid_operand;
             }
 
-            switch (instruction.op_code()) {
-                case Op::mov:
-                    if (instruction.data1() == 0) {
-                        TRY_WRITE("movsd " << memory_index_to_native(tag, instruction.data2()) << ", xmm0");
-                    } else {
-                        TRY_WRITE("mov rax, " << memory_index_to_native(tag, instruction.data1()))
-                        TRY_WRITE("mov " << memory_index_to_native(tag, instruction.data2()) << ", rax");
-                    }
-                    return NativeAssemblerErrorCode::ok;
-                case Op::add:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("addsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    return NativeAssemblerErrorCode::ok;
-                case Op::sub:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("subsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    return NativeAssemblerErrorCode::ok;
-                case Op::mul:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("mulsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    return NativeAssemblerErrorCode::ok;
-                case Op::div:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("divsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    return NativeAssemblerErrorCode::ok;
-                case Op::mag:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("movsd xmm1, qword [rel raychelscript_mag_op]");
-                    TRY_WRITE("pand xmm0, xmm1");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::fac:
-                    return NativeAssemblerErrorCode::unknown_instruction;
-                case Op::pow:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("movsd xmm1, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("push rsi");
-                    TRY_WRITE("call pow wrt ..plt");
-                    TRY_WRITE("pop rsi");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::inc:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("addsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("movsd " << memory_index_to_native(tag, instruction.data1()) << ", xmm0");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::dec:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("subsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("movsd " << memory_index_to_native(tag, instruction.data1()) << ", xmm0");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::mas:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("mulsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("movsd " << memory_index_to_native(tag, instruction.data1()) << ", xmm0");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::das:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("divsd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("movsd " << memory_index_to_native(tag, instruction.data1()) << ", xmm0");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::pas:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("movsd xmm1, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("push rsi");
-                    TRY_WRITE("call pow wrt ..plt");
-                    TRY_WRITE("pop rsi");
-                    TRY_WRITE("movsd " << memory_index_to_native(tag, instruction.data1()) << ", xmm0");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::clt:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("comisd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("setb al");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::cgt:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("comisd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("seta al");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::ceq:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("comisd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("sete al");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::cne:
-                    TRY_WRITE("movsd xmm0, " << memory_index_to_native(tag, instruction.data1()));
-                    TRY_WRITE("comisd xmm0, " << memory_index_to_native(tag, instruction.data2()));
-                    TRY_WRITE("setne al");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::jpz:
-                    TRY_WRITE("test rax, rax");
-                    TRY_WRITE("jz label" << static_cast<std::uint32_t>(instruction.data1()));
-                    TRY_WRITE("xor rax, rax");
-                    return NativeAssemblerErrorCode::ok;
-                case Op::jmp:
-                    TRY_WRITE("jmp label" << static_cast<std::uint32_t>(instruction.data1()));
-                    return NativeAssemblerErrorCode::ok;
-                case Op::hlt:
-                    return NativeAssemblerErrorCode::ok;
-                case Op::jsr:
-                case Op::ret:
-                case Op::put:
-                    return NativeAssemblerErrorCode::unknown_instruction;
-                case Op::num_op_codes:
-                    return NativeAssemblerErrorCode::ok;
+            X86_64::ElfWriter writer{std::move(code).value()};
+            for (const auto& [name, offset] : symbols) {
+                writer.add_function(name, offset);
+            }
+            const auto input_vector_size = std::bit_cast<std::array<std::uint8_t, sizeof(std::uint32_t)>>(
+                static_cast<std::uint32_t>(data.num_input_identifiers));
+            const auto output_vector_size = std::bit_cast<std::array<std::uint8_t, sizeof(std::uint32_t)>>(
+                static_cast<std::uint32_t>(data.num_output_identifiers));
+            writer.add_object("raychelscript_input_vector_size", input_vector_size);
+            writer.add_object("raychelscript_output_vector_size", output_vector_size);
+
+            if (!writer.write(output_stream)) {
+                return NativeAssemblerErrorCode::stream_write_error;
             }
-            return NativeAssemblerErrorCode::unknown_instruction;
+            return NativeAssemblerErrorCode::ok;
         }
 
-        static auto write_boilerplate_end(X86_64_Tag tag, const VM::VMData& data, NativeAssemblerState& state) noexcept
+        [[nodiscard]] NativeAssemblerErrorCode
+        write_boilerplate_end(X86_64_ELF_Tag /*unused*/, const VM::VMData& /*unused*/, std::ostream& /*unused*/) noexcept
         {
-            std::size_t output_index{0};
-            for (const auto& [_, address] : data.config_block.output_identifiers) {
-                TRY_WRITE("mov rax, " << memory_index_to_native(tag, address.value()));
-                TRY_WRITE("mov qword[rsi+" << output_index << "], rax");
-                output_index += 8;
-            }
-            TRY_WRITE("add rsp, " << static_cast<std::uint32_t>(data.num_memory_locations - 1) * 8);
-            TRY_WRITE("pop r12");
-            TRY_WRITE(R"_asm_(    ret
-section .rodata)_asm_");
-            TRY_WRITE(
-                "raychelscript_input_vector_size: dd " << static_cast<std::uint32_t>(data.config_block.input_identifiers.size()));
-            TRY_WRITE(
-                "raychelscript_output_vector_size: dd "
-                << static_cast<std::uint32_t>(data.config_block.output_identifiers.size()));
-            TRY_WRITE("raychelscript_mag_op: dq 0x7FFFFFFFFFFFFFFF");
-
             return NativeAssemblerErrorCode::ok;
         }
-    } // namespace X86_64
+
+    } // namespace
 
     RAYCHELSCRIPT_NATIVE_ASSEMBLER_DEFINE_ASSEMBLER_FUNCTION(X86_64)
 
+    RAYCHELSCRIPT_NATIVE_ASSEMBLER_DEFINE_ASSEMBLER_FUNCTION(X86_64_ELF)
+
 } //namespace RaychelScript::NativeAssembler
@@ -0,0 +1,984 @@
+/**
+* \file X86_64BatchLowering.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the vectorised batch entry point of the x86-64 lowering
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/X86_64Lowering.h"
+#include "NativeAssembler/X86_64Math.h"
+#include "NativeAssembler/X86_64RegisterAllocator.h"
+
+#include "RaychelCore/Raychel_assert.h"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        using Assembly::Instruction;
+        using Assembly::MemoryIndex;
+        using Assembly::OpCode;
+
+        /*
+        The vector code mirrors the scalar lowering, except that every slot holds one double per lane.
+        Because the lanes of a group only run together while they agree on every branch, the flag stays a single bit.
+        Anything the vector code can't handle (diverging lanes, runtime errors, calling a frame that doesn't fit) jumps to the
+        bailout handler, which drops the group and runs it through the scalar entry point instead.
+        */
+
+        constexpr auto frame_base = Register::rbx;
+        constexpr auto call_budget = Register::rbp;
+        constexpr auto memory_in_use = Register::r12;
+        constexpr auto flag = Register::r14;
+        constexpr auto batch_stack_pointer = Register::r15; //native stack pointer of the batch entry point
+
+        constexpr std::array saved_registers{
+            Register::rbx, Register::rbp, Register::r12, Register::r13, Register::r14, Register::r15};
+
+        constexpr auto accumulator = XMMRegister::xmm0;
+        constexpr auto scratch = XMMRegister::xmm1;
+
+
+        template <typename Writer>
+        struct BatchContext
+        {
+            const VM::VMData& data;
+            Writer& writer;
+            LoweringOptions options;
+            Label scalar_entry;
+            MathRoutines math;
+
+            //AVX-512 uses 8 lanes and compares into opmask registers, AVX uses 4 lanes
+            VectorLength vector_length{};
+            std::size_t lane_count{};
+            std::int32_t vector_size{};
+
+            std::vector<Label> frame_labels{};
+            std::vector<std::uint32_t> immediate_constants{};
+            std::uint32_t one{};
+            std::uint32_t magnitude_mask{};
+
+            Label halt{};
+            Label bailout{};
+            Label vector_pow{};
+            bool uses_vector_pow{false};
+
+            //Offsets from the batch stack pointer
+            std::int32_t global_frame_offset{};
+            std::int32_t locals{};
+
+            std::size_t frame_index{};
+            std::size_t frame_size{};
+            std::int32_t outgoing_bytes{};
+            std::size_t instruction_index{};
+            std::vector<Label> instruction_labels{};
+            RegisterAllocation allocation{};
+        };
+
+        //offset into the buffers of the scalar entry point
+        std::int32_t scalar_slot_offset(std::size_t index) noexcept
+        {
+            return static_cast<std::int32_t>(index * sizeof(double));
+        }
+
+        //The batch entry point keeps its arguments and loop state in memory, calls into the scalar code clobber everything
+        template <typename Writer>
+        Address input_pointer(const BatchContext<Writer>& ctx) noexcept
+        {
+            return Address::at(batch_stack_pointer, ctx.locals);
+        }
+
+        template <typename Writer>
+        Address output_pointer(const BatchContext<Writer>& ctx) noexcept
+        {
+            return Address::at(batch_stack_pointer, ctx.locals + 8);
+        }
+
+        //distance in bytes between two inputs (or outputs) of the same invocation
+        template <typename Writer>
+        Address column_stride(const BatchContext<Writer>& ctx) noexcept
+        {
+            return Address::at(batch_stack_pointer, ctx.locals + 16);
+        }
+
+        //byte offset of the first invocation that has not been run yet
+        template <typename Writer>
+        Address invocation_offset(const BatchContext<Writer>& ctx) noexcept
+        {
+            return Address::at(batch_stack_pointer, ctx.locals + 24);
+        }
+
+        //the scalar fallback runs invocations until invocation_offset reaches this
+        template <typename Writer>
+        Address scalar_end_offset(const BatchContext<Writer>& ctx) noexcept
+        {
+            return Address::at(batch_stack_pointer, ctx.locals + 32);
+        }
+
+        template <typename Writer>
+        std::int32_t scalar_inputs(const BatchContext<Writer>& ctx) noexcept
+        {
+            return ctx.locals + 40;
+        }
+
+        template <typename Writer>
+        std::int32_t scalar_outputs(const BatchContext<Writer>& ctx) noexcept
+        {
+            return scalar_inputs(ctx) + scalar_slot_offset(ctx.data.num_input_identifiers);
+        }
+
+        template <typename Writer>
+        std::int32_t slot_offset(const BatchContext<Writer>& ctx, std::size_t index) noexcept
+        {
+            return static_cast<std::int32_t>(index) * ctx.vector_size;
+        }
+
+        //bits of a lane mask if the comparison held in every lane
+        template <typename Writer>
+        std::int32_t all_lanes(const BatchContext<Writer>& ctx) noexcept
+        {
+            return (1 << ctx.lane_count) - 1;
+        }
+
+        //every vector frame has room to spill two vectors for the per-lane calls into the scalar math routines right above its
+        //outgoing area
+        template <typename Writer>
+        std::int32_t lane_scratch_bytes(const BatchContext<Writer>& ctx) noexcept
+        {
+            return 2 * ctx.vector_size;
+        }
+
+        std::int32_t align_stack(std::size_t bytes) noexcept
+        {
+            return static_cast<std::int32_t>((bytes + 15U) & ~std::size_t{15U});
+        }
+
+        template <typename Writer>
+        Address slot(const BatchContext<Writer>& ctx, std::size_t index) noexcept
+        {
+            return Address::at(frame_base, slot_offset(ctx, index));
+        }
+
+        template <typename Writer>
+        Address outgoing_slot(const BatchContext<Writer>& ctx, std::size_t index) noexcept
+        {
+            return Address::at(Register::rsp, slot_offset(ctx, index));
+        }
+
+        template <typename Writer>
+        Address lane_scratch(const BatchContext<Writer>& ctx, std::int32_t offset) noexcept
+        {
+            return Address::at(Register::rsp, ctx.outgoing_bytes + offset);
+        }
+
+        bool is_immediate(MemoryIndex index) noexcept
+        {
+            return index.type() == MemoryIndex::ValueType::immediate;
+        }
+
+        template <typename Writer>
+        std::int32_t outgoing_area_size(const BatchContext<Writer>& ctx, const VM::CallFrameDescriptor& frame) noexcept
+        {
+            std::size_t size{};
+            for (const auto& instruction : frame.instructions) {
+                if (instruction.op_code() == OpCode::put) {
+                    size = std::max<std::size_t>(size, instruction.index2().value() + 1U);
+                } else if (instruction.op_code() == OpCode::jsr) {
+                    size = std::max<std::size_t>(size, ctx.data.call_frames[instruction.index1().value()].size);
+                }
+            }
+            return align_stack(size * static_cast<std::size_t>(ctx.vector_size));
+        }
+
+        /**
+        * \brief Where the lanes of a MemoryIndex live for use as the right hand side of an instruction
+        *
+        * Allocated slots are registers, all other slots are memory. Immediates are broadcast into the fallback register first,
+        * because the constant pool only holds a single double per immediate.
+        */
+        class VectorOperand
+        {
+            VectorOperand(std::optional<XMMRegister> reg, Address address) noexcept : reg_{reg}, address_{address}
+            {}
+
+        public:
+            [[nodiscard]] static VectorOperand in_register(XMMRegister reg) noexcept
+            {
+                return VectorOperand{reg, Address::at(Register::rax)};
+            }
+
+            [[nodiscard]] static VectorOperand in_memory(Address address) noexcept
+            {
+                return VectorOperand{std::nullopt, address};
+            }
+
+            [[nodiscard]] bool is_register() const noexcept
+            {
+                return reg_.has_value();
+            }
+
+            [[nodiscard]] bool is_register(XMMRegister reg) const noexcept
+            {
+                return reg_ == reg;
+            }
+
+            [[nodiscard]] XMMRegister reg() const noexcept
+            {
+                RAYCHEL_ASSERT(is_register());
+                return *reg_;
+            }
+
+            [[nodiscard]] Address address() const noexcept
+            {
+                RAYCHEL_ASSERT(!is_register());
+                return address_;
+            }
+
+            template <typename F>
+            void visit(F&& f) const noexcept
+            {
+                if (is_register()) {
+                    std::forward<F>(f)(*reg_);
+                } else {
+                    std::forward<F>(f)(address_);
+                }
+            }
+
+        private:
+            std::optional<XMMRegister> reg_;
+            Address address_;
+        };
+
+        template <typename Writer>
+        VectorOperand location(const BatchContext<Writer>& ctx, std::size_t index) noexcept
+        {
+            if (const auto reg = ctx.allocation.registers[index]; reg.has_value())
+                return VectorOperand::in_register(*reg);
+            return VectorOperand::in_memory(slot(ctx, index));
+        }
+
+        //a register or a slot in memory. Immediates end up in fallback
+        template <typename Writer>
+        VectorOperand value(BatchContext<Writer>& ctx, MemoryIndex index, XMMRegister fallback) noexcept
+        {
+            if (is_immediate(index)) {
+                ctx.writer.vbroadcastsd(fallback, Address::constant(ctx.immediate_constants[index.value()]));
+                return VectorOperand::in_register(fallback);
+            }
+            return location(ctx, index.value());
+        }
+
+        //the value in a register. Slots in memory are loaded into fallback
+        template <typename Writer>
+        XMMRegister value_in_register(BatchContext<Writer>& ctx, MemoryIndex index, XMMRegister fallback) noexcept
+        {
+            const auto operand = value(ctx, index, fallback);
+            if (operand.is_register())
+                return operand.reg();
+            ctx.writer.vmovupd(fallback, operand.address());
+            return fallback;
+        }
+
+        template <typename Writer>
+        void store(BatchContext<Writer>& ctx, VectorOperand destination, XMMRegister source) noexcept
+        {
+            if (destination.is_register(source))
+                return;
+            if (destination.is_register()) {
+                ctx.writer.vmovapd(destination.reg(), source);
+            } else {
+                ctx.writer.vmovupd(destination.address(), source);
+            }
+        }
+
+        template <typename Writer>
+        void spill(BatchContext<Writer>& ctx, const SlotSet& slots) noexcept
+        {
+            for (std::size_t i{}; i != std::min(ctx.frame_size, number_of_tracked_slots); ++i) {
+                if (slots.test(i))
+                    ctx.writer.vmovupd(slot(ctx, i), *ctx.allocation.registers[i]);
+            }
+        }
+
+        template <typename Writer>
+        void reload(BatchContext<Writer>& ctx, const SlotSet& slots) noexcept
+        {
+            for (std::size_t i{}; i != std::min(ctx.frame_size, number_of_tracked_slots); ++i) {
+                if (slots.test(i))
+                    ctx.writer.vmovupd(*ctx.allocation.registers[i], slot(ctx, i));
+            }
+        }
+
+        //bail out unless the lane mask in eax is either empty or full. Jumps to target if it matches jump_if_all
+        template <typename Writer>
+        void emit_uniform_branch(BatchContext<Writer>& ctx, bool jump_if_all, Label target) noexcept
+        {
+            auto& w = ctx.writer;
+            if (jump_if_all) {
+                w.cmp(Register::rax, all_lanes(ctx));
+                w.jcc(Condition::equal, target);
+                w.test32(Register::rax, Register::rax);
+                w.jcc(Condition::not_equal, ctx.bailout);
+            } else {
+                w.test32(Register::rax, Register::rax);
+                w.jcc(Condition::equal, target);
+                w.cmp(Register::rax, all_lanes(ctx));
+                w.jcc(Condition::not_equal, ctx.bailout);
+            }
+        }
+
+        //destination = lane mask of lhs <predicate> rhs. Without opmask registers, the comparison result goes through temporary
+        template <typename Writer, typename Rhs>
+        void emit_lane_mask(
+            BatchContext<Writer>& ctx, Register destination, XMMRegister lhs, Rhs rhs, ComparisonPredicate predicate,
+            XMMRegister temporary) noexcept
+        {
+            auto& w = ctx.writer;
+            if (ctx.vector_length == VectorLength::v512) {
+                w.vcmppd(MaskRegister::k1, lhs, rhs, predicate);
+                w.kmovw(destination, MaskRegister::k1);
+                return;
+            }
+            w.vcmppd(temporary, lhs, rhs, predicate);
+            w.vmovmskpd(destination, temporary);
+        }
+
+        //eax = lane mask of lhs <predicate> rhs
+        template <typename Writer>
+        void emit_compare(BatchContext<Writer>& ctx, MemoryIndex lhs, MemoryIndex rhs, ComparisonPredicate predicate) noexcept
+        {
+            const auto left = value_in_register(ctx, lhs, accumulator);
+            value(ctx, rhs, scratch).visit(
+                [&](auto right) { emit_lane_mask(ctx, Register::rax, left, right, predicate, accumulator); });
+        }
+
+        template <typename Writer>
+        void emit_set_flag(BatchContext<Writer>& ctx, MemoryIndex a, MemoryIndex b, ComparisonPredicate predicate) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto done = w.make_label();
+            emit_compare(ctx, a, b, predicate);
+            w.xor32(flag, flag);
+            emit_uniform_branch(ctx, false, done);
+            w.mov32(flag, 1U);
+            w.bind(done);
+        }
+
+        //Call a scalar routine once per lane. The arguments are read from the lane scratch area and replaced by the results
+        template <typename Writer>
+        void emit_per_lane_call(BatchContext<Writer>& ctx, Label routine) noexcept
+        {
+            auto& w = ctx.writer;
+            //the scalar routines use legacy SSE encodings, mixing those with dirty upper halves is slow
+            w.vzeroupper();
+            for (std::size_t lane{}; lane != ctx.lane_count; ++lane) {
+                const auto lane_offset = static_cast<std::int32_t>(lane * sizeof(double));
+                w.movsd(accumulator, lane_scratch(ctx, lane_offset));
+                w.call(routine);
+                w.movsd(lane_scratch(ctx, lane_offset), accumulator);
+            }
+            w.vmovupd(accumulator, lane_scratch(ctx, 0));
+        }
+
+        //the preserved slots of the current instruction that live in registers the math routines clobber
+        template <typename Writer>
+        SlotSet clobbered_by_math(const BatchContext<Writer>& ctx) noexcept
+        {
+            const auto& preserved = ctx.allocation.preserved[ctx.instruction_index];
+            SlotSet slots{};
+            for (std::size_t i{}; i != std::min(ctx.frame_size, number_of_tracked_slots); ++i) {
+                if (preserved.test(i) && is_math_temporary(*ctx.allocation.registers[i]))
+                    slots.set(i);
+            }
+            return slots;
+        }
+
+        //accumulator = pow(a, b). The vector routine only takes positive normal bases and finite exponents, the scalar code
+        //handles everything else
+        template <typename Writer>
+        void emit_vector_pow_call(BatchContext<Writer>& ctx, MemoryIndex a, MemoryIndex b) noexcept
+        {
+            auto& w = ctx.writer;
+            constexpr auto limit = XMMRegister::xmm15;
+            constexpr auto temporary = XMMRegister::xmm14;
+            constexpr auto magnitude = XMMRegister::xmm13;
+
+            spill(ctx, clobbered_by_math(ctx));
+            if (const auto base = value_in_register(ctx, a, accumulator); base != accumulator)
+                w.vmovapd(accumulator, base);
+            if (const auto exponent = value_in_register(ctx, b, scratch); exponent != scratch)
+                w.vmovapd(scratch, exponent);
+
+            w.vbroadcastsd(limit, Address::constant(w.add_constant(0x1p-1022)));
+            emit_lane_mask(ctx, Register::rax, accumulator, limit, ComparisonPredicate::greater_or_equal_ordered, temporary);
+            w.vbroadcastsd(limit, Address::constant(w.add_constant(std::numeric_limits<double>::max())));
+            emit_lane_mask(ctx, Register::rcx, accumulator, limit, ComparisonPredicate::less_or_equal_ordered, temporary);
+            w.and8(Register::rax, Register::rcx);
+            w.vbroadcastsd(magnitude, Address::constant(ctx.magnitude_mask));
+            w.vandpd(magnitude, scratch, magnitude);
+            emit_lane_mask(ctx, Register::rcx, magnitude, limit, ComparisonPredicate::less_or_equal_ordered, temporary);
+            w.and8(Register::rax, Register::rcx);
+            w.cmp(Register::rax, all_lanes(ctx));
+            w.jcc(Condition::not_equal, ctx.bailout);
+
+            w.call(ctx.vector_pow);
+            ctx.uses_vector_pow = true;
+        }
+
+        template <typename Writer>
+        XMMRegister
+        emit_arithmetic(BatchContext<Writer>& ctx, OpCode op, MemoryIndex a, MemoryIndex b, VectorOperand destination) noexcept
+        {
+            auto& w = ctx.writer;
+
+            if (op == OpCode::pow || op == OpCode::pas) {
+                if (const auto chain = power_chain(ctx.data, b); chain.has_value()) {
+                    if (const auto base = value_in_register(ctx, a, scratch); base != scratch)
+                        w.vmovapd(scratch, base);
+                    emit_vector_power_chain(w, *chain, accumulator, scratch);
+                    store(ctx, destination, accumulator);
+                    return accumulator;
+                }
+                emit_vector_pow_call(ctx, a, b);
+                store(ctx, destination, accumulator);
+                reload(ctx, clobbered_by_math(ctx));
+                return accumulator;
+            }
+
+            if (op == OpCode::div || op == OpCode::das || op == OpCode::dvt) {
+                if (is_immediate(b)) {
+                    if (ctx.data.immediate_values[b.value()] == 0.0) {
+                        w.jmp(ctx.bailout);
+                        return accumulator;
+                    }
+                } else {
+                    //the ordered comparison leaves NaN divisors alone, like the scalar VM
+                    w.vxorpd(scratch, scratch, scratch);
+                    location(ctx, b.value()).visit([&](auto divisor) {
+                        emit_lane_mask(ctx, Register::rax, scratch, divisor, ComparisonPredicate::equal_ordered, scratch);
+                    });
+                    w.test32(Register::rax, Register::rax);
+                    w.jcc(Condition::not_equal, ctx.bailout);
+                }
+            }
+
+            const auto lhs = value_in_register(ctx, a, accumulator);
+            const auto rhs = value(ctx, b, scratch);
+            const auto result = destination.is_register() ? destination.reg() : accumulator;
+            rhs.visit([&](auto source) {
+                switch (op) {
+                    case OpCode::add:
+                    case OpCode::inc:
+                    case OpCode::adt:
+                        w.vaddpd(result, lhs, source);
+                        break;
+                    case OpCode::sub:
+                    case OpCode::dec:
+                    case OpCode::sbt:
+                        w.vsubpd(result, lhs, source);
+                        break;
+                    case OpCode::mul:
+                    case OpCode::mas:
+                    case OpCode::mlt:
+                        w.vmulpd(result, lhs, source);
+                        break;
+                    case OpCode::div:
+                    case OpCode::das:
+                    case OpCode::dvt:
+                        w.vdivpd(result, lhs, source);
+                        break;
+                    default:
+                        RAYCHEL_ASSERT_NOT_REACHED;
+                }
+            });
+            store(ctx, destination, result);
+            return result;
+        }
+
+        //the per-lane version of the checks in the scalar lowering
+        template <typename Writer>
+        void emit_factorial(BatchContext<Writer>& ctx, MemoryIndex a) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto& preserved = ctx.allocation.preserved[ctx.instruction_index];
+
+            const auto argument = value_in_register(ctx, a, accumulator);
+            w.vbroadcastsd(scratch, Address::constant(ctx.one));
+            w.vaddpd(accumulator, argument, scratch);
+
+            w.vxorpd(scratch, scratch, scratch);
+            emit_lane_mask(ctx, Register::rax, accumulator, scratch, ComparisonPredicate::equal_ordered, scratch);
+            w.test32(Register::rax, Register::rax);
+            w.jcc(Condition::not_equal, ctx.bailout);
+
+            w.vmovupd(lane_scratch(ctx, 0), accumulator);
+            w.vmovupd(lane_scratch(ctx, ctx.vector_size), accumulator);
+            //vzeroupper clears the upper lanes of every register, so everything that is still needed has to be spilled
+            spill(ctx, preserved);
+            emit_per_lane_call(ctx, ctx.math.tgamma);
+
+            //every register but the accumulator is free until the reload
+            w.vmovupd(scratch, lane_scratch(ctx, ctx.vector_size));
+            constexpr auto temporary = XMMRegister::xmm2;
+            emit_lane_mask(ctx, Register::rax, accumulator, accumulator, ComparisonPredicate::not_equal_unordered, temporary);
+            emit_lane_mask(ctx, Register::rcx, scratch, scratch, ComparisonPredicate::equal_ordered, temporary);
+            w.and8(Register::rax, Register::rcx);
+            w.test32(Register::rax, Register::rax);
+            w.jcc(Condition::not_equal, ctx.bailout);
+
+            store(ctx, location(ctx, 0U), accumulator);
+            reload(ctx, preserved);
+        }
+
+        template <typename Writer>
+        void emit_move(BatchContext<Writer>& ctx, MemoryIndex a, MemoryIndex b) noexcept
+        {
+            const auto destination = location(ctx, b.value());
+            const auto source = value(ctx, a, destination.is_register() ? destination.reg() : accumulator);
+            if (source.is_register()) {
+                store(ctx, destination, source.reg());
+                return;
+            }
+            const auto temporary = destination.is_register() ? destination.reg() : accumulator;
+            ctx.writer.vmovupd(temporary, source.address());
+            store(ctx, destination, temporary);
+        }
+
+        template <typename Writer>
+        void emit_call(BatchContext<Writer>& ctx, MemoryIndex frame) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto& preserved = ctx.allocation.preserved[ctx.instruction_index];
+
+            //the memory limits are the same as in the scalar code, which reports the error
+            const auto callee_size = std::max<std::size_t>(ctx.data.call_frames[frame.value()].size, 1U);
+            if (callee_size > ctx.options.memory_size) {
+                w.jmp(ctx.bailout);
+                return;
+            }
+            const auto frame_bytes = static_cast<std::int32_t>(ctx.frame_size * sizeof(double));
+            w.add(memory_in_use, frame_bytes);
+            w.cmp(memory_in_use, static_cast<std::int32_t>((ctx.options.memory_size - callee_size) * sizeof(double)));
+            w.jcc(Condition::above, ctx.bailout);
+            w.sub(call_budget, 1);
+            w.jcc(Condition::below, ctx.bailout);
+
+            spill(ctx, preserved);
+            w.call(ctx.frame_labels[frame.value()]);
+
+            w.add(call_budget, 1);
+            w.sub(memory_in_use, frame_bytes);
+            store(ctx, location(ctx, 0U), accumulator);
+            reload(ctx, preserved);
+        }
+
+        template <typename Writer>
+        void emit_return(BatchContext<Writer>& ctx) noexcept
+        {
+            auto& w = ctx.writer;
+            if (ctx.frame_index == 0U) {
+                w.jmp(ctx.bailout);
+                return;
+            }
+            const auto result = location(ctx, 0U);
+            if (result.is_register()) {
+                w.vmovapd(accumulator, result.reg());
+            } else {
+                w.vmovupd(accumulator, result.address());
+            }
+            w.add(Register::rsp, ctx.outgoing_bytes + lane_scratch_bytes(ctx));
+            w.pop(frame_base);
+            w.ret();
+        }
+
+        template <typename Writer>
+        void emit_halt(BatchContext<Writer>& ctx) noexcept
+        {
+            if (ctx.frame_index == 0U) {
+                const auto first_output = 1U + std::size_t{ctx.data.num_input_identifiers};
+                const auto end_of_outputs = std::min(first_output + ctx.data.num_output_identifiers, ctx.frame_size);
+                for (auto i = first_output; i < end_of_outputs; ++i) {
+                    if (const auto reg = ctx.allocation.registers[i]; reg.has_value())
+                        ctx.writer.vmovupd(slot(ctx, i), *reg);
+                }
+            }
+            ctx.writer.jmp(ctx.halt);
+        }
+
+        template <typename Writer>
+        std::optional<Label> jump_target(const BatchContext<Writer>& ctx, MemoryIndex offset) noexcept
+        {
+            const auto target = static_cast<std::ptrdiff_t>(ctx.instruction_index) + static_cast<std::ptrdiff_t>(offset.offset());
+            return ctx.instruction_labels[static_cast<std::size_t>(target)];
+        }
+
+        template <typename Writer>
+        void emit_instruction(BatchContext<Writer>& ctx, const Instruction& instruction) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto a = instruction.index1();
+            const auto b = instruction.index2();
+            const auto c = instruction.index3();
+
+            switch (const auto op = instruction.op_code()) {
+                case OpCode::mov:
+                    emit_move(ctx, a, b);
+                    return;
+                case OpCode::add:
+                case OpCode::sub:
+                case OpCode::mul:
+                case OpCode::div:
+                case OpCode::pow:
+                    emit_arithmetic(ctx, op, a, b, location(ctx, 0U));
+                    return;
+                case OpCode::mag: {
+                    const auto destination = location(ctx, 0U);
+                    const auto result = destination.is_register() ? destination.reg() : accumulator;
+                    const auto source = value_in_register(ctx, a, accumulator);
+                    w.vbroadcastsd(scratch, Address::constant(ctx.magnitude_mask));
+                    w.vandpd(result, source, scratch);
+                    store(ctx, destination, result);
+                    return;
+                }
+                case OpCode::fac:
+                    emit_factorial(ctx, a);
+                    return;
+                case OpCode::inc:
+                case OpCode::dec:
+                case OpCode::mas:
+                case OpCode::das:
+                case OpCode::pas:
+                    emit_arithmetic(ctx, op, a, b, location(ctx, a.value()));
+                    return;
+                case OpCode::clt:
+                    emit_set_flag(ctx, a, b, ComparisonPredicate::less_than_ordered);
+                    return;
+                case OpCode::cgt:
+                    emit_set_flag(ctx, a, b, ComparisonPredicate::greater_than_ordered);
+                    return;
+                case OpCode::ceq:
+                    emit_set_flag(ctx, a, b, ComparisonPredicate::equal_ordered);
+                    return;
+                case OpCode::cne:
+                    emit_set_flag(ctx, a, b, ComparisonPredicate::not_equal_unordered);
+                    return;
+                case OpCode::jpz:
+                    w.test32(flag, flag);
+                    w.jcc(Condition::equal, *jump_target(ctx, a));
+                    return;
+                case OpCode::jmp:
+                    w.jmp(*jump_target(ctx, a));
+                    return;
+                case OpCode::hlt:
+                    emit_halt(ctx);
+                    return;
+                case OpCode::jsr:
+                    emit_call(ctx, a);
+                    return;
+                case OpCode::ret:
+                    emit_return(ctx);
+                    return;
+                case OpCode::put:
+                    w.vmovupd(outgoing_slot(ctx, b.value()), value_in_register(ctx, a, accumulator));
+                    return;
+                //the scalar branches jump if the comparison does not hold, and unordered operands never compare equal
+                case OpCode::jnl:
+                    emit_compare(ctx, a, b, ComparisonPredicate::less_than_ordered);
+                    emit_uniform_branch(ctx, false, *jump_target(ctx, c));
+                    return;
+                case OpCode::jng:
+                    emit_compare(ctx, a, b, ComparisonPredicate::greater_than_ordered);
+                    emit_uniform_branch(ctx, false, *jump_target(ctx, c));
+                    return;
+                case OpCode::jne:
+                    emit_compare(ctx, a, b, ComparisonPredicate::equal_ordered);
+                    emit_uniform_branch(ctx, false, *jump_target(ctx, c));
+                    return;
+                case OpCode::jeq:
+                    emit_compare(ctx, a, b, ComparisonPredicate::equal_ordered);
+                    emit_uniform_branch(ctx, true, *jump_target(ctx, c));
+                    return;
+                case OpCode::mad: {
+                    const auto product = value_in_register(ctx, a, accumulator);
+                    value(ctx, b, scratch).visit([&](auto factor) { w.vmulpd(accumulator, product, factor); });
+                    value(ctx, c, scratch).visit([&](auto summand) { w.vaddpd(accumulator, accumulator, summand); });
+                    store(ctx, location(ctx, 0U), accumulator);
+                    return;
+                }
+                case OpCode::adt:
+                case OpCode::sbt:
+                case OpCode::mlt:
+                case OpCode::dvt:
+                    store(ctx, location(ctx, c.value()), emit_arithmetic(ctx, op, a, b, location(ctx, 0U)));
+                    return;
+                case OpCode::num_op_codes:
+                    break;
+            }
+            RAYCHEL_ASSERT_NOT_REACHED;
+        }
+
+        template <typename Writer>
+        void emit_call_frame(BatchContext<Writer>& ctx, const VM::CallFrameDescriptor& frame) noexcept
+        {
+            auto& w = ctx.writer;
+            ctx.frame_size = frame.size;
+            ctx.outgoing_bytes = outgoing_area_size(ctx, frame);
+            ctx.allocation = allocate_registers(ctx.data, ctx.frame_index);
+            ctx.instruction_labels.clear();
+            std::generate_n(
+                std::back_inserter(ctx.instruction_labels), frame.instructions.size(), [&] { return w.make_label(); });
+
+            //the global frame is entered from the group loop, which sets up the frame base
+            if (ctx.frame_index != 0U) {
+                w.bind(ctx.frame_labels[ctx.frame_index]);
+                w.push(frame_base);
+                w.lea(frame_base, Address::at(Register::rsp, 2 * static_cast<std::int32_t>(sizeof(std::uint64_t))));
+                w.sub(Register::rsp, ctx.outgoing_bytes + lane_scratch_bytes(ctx));
+            }
+            reload(ctx, ctx.allocation.live_on_entry);
+
+            for (ctx.instruction_index = 0U; ctx.instruction_index != frame.instructions.size(); ++ctx.instruction_index) {
+                w.bind(ctx.instruction_labels[ctx.instruction_index]);
+                emit_instruction(ctx, frame.instructions[ctx.instruction_index]);
+            }
+            emit_halt(ctx);
+        }
+
+        //one group of invocations through the vector code
+        template <typename Writer>
+        void emit_group_prologue(BatchContext<Writer>& ctx, std::size_t global_frame_size) noexcept
+        {
+            auto& w = ctx.writer;
+            w.lea(frame_base, Address::at(batch_stack_pointer, ctx.global_frame_offset));
+            w.xor32(memory_in_use, memory_in_use);
+            w.xor32(flag, flag);
+            w.mov32(call_budget, static_cast<std::uint32_t>(ctx.options.stack_size == 0U ? 0U : ctx.options.stack_size - 1U));
+
+            w.xor32(Register::rax, Register::rax);
+            w.mov(Register::rdi, frame_base);
+            w.mov32(Register::rcx, static_cast<std::uint32_t>(global_frame_size * ctx.lane_count));
+            w.rep_stosq();
+
+            //input #i of the group starts at inputs + i * stride + offset
+            w.mov(Register::rdx, input_pointer(ctx));
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.add(Register::rdx, Register::rax);
+            w.mov(Register::rcx, column_stride(ctx));
+            for (std::size_t i{}; i != ctx.data.num_input_identifiers; ++i) {
+                w.vmovupd(accumulator, Address::at(Register::rdx));
+                w.vmovupd(slot(ctx, i + 1U), accumulator);
+                w.add(Register::rdx, Register::rcx);
+            }
+        }
+
+        template <typename Writer>
+        void emit_group_epilogue(BatchContext<Writer>& ctx, Label group_loop) noexcept
+        {
+            auto& w = ctx.writer;
+            w.bind(ctx.halt);
+            w.mov(Register::rsp, batch_stack_pointer);
+            w.mov(Register::rdx, output_pointer(ctx));
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.add(Register::rdx, Register::rax);
+            w.mov(Register::rcx, column_stride(ctx));
+            const auto first_output = 1U + std::size_t{ctx.data.num_input_identifiers};
+            for (std::size_t i{}; i != ctx.data.num_output_identifiers; ++i) {
+                const auto output_slot = ctx.global_frame_offset + slot_offset(ctx, first_output + i);
+                w.vmovupd(accumulator, Address::at(batch_stack_pointer, output_slot));
+                w.vmovupd(Address::at(Register::rdx), accumulator);
+                w.add(Register::rdx, Register::rcx);
+            }
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.add(Register::rax, ctx.vector_size);
+            w.mov(invocation_offset(ctx), Register::rax);
+            w.jmp(group_loop);
+        }
+
+        //Runs the invocations up to scalar_end_offset one by one through the scalar entry point
+        template <typename Writer>
+        void emit_scalar_fallback(BatchContext<Writer>& ctx, Label scalar_loop, Label group_loop, Label exit) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto stride = [&] { w.mov(Register::rcx, column_stride(ctx)); };
+
+            w.bind(scalar_loop);
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.mov(Register::rcx, scalar_end_offset(ctx));
+            w.cmp(Register::rax, Register::rcx);
+            w.jcc(Condition::above_or_equal, group_loop);
+
+            w.mov(Register::rdx, input_pointer(ctx));
+            w.add(Register::rdx, Register::rax);
+            stride();
+            for (std::size_t i{}; i != ctx.data.num_input_identifiers; ++i) {
+                w.mov(Register::rax, Address::at(Register::rdx));
+                w.mov(Address::at(batch_stack_pointer, scalar_inputs(ctx) + scalar_slot_offset(i)), Register::rax);
+                w.add(Register::rdx, Register::rcx);
+            }
+
+            w.lea(Register::rdi, Address::at(batch_stack_pointer, scalar_inputs(ctx)));
+            w.lea(Register::rsi, Address::at(batch_stack_pointer, scalar_outputs(ctx)));
+            w.call(ctx.scalar_entry);
+            w.test32(Register::rax, Register::rax);
+            w.jcc(Condition::not_equal, exit);
+
+            w.mov(Register::rdx, output_pointer(ctx));
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.add(Register::rdx, Register::rax);
+            stride();
+            for (std::size_t i{}; i != ctx.data.num_output_identifiers; ++i) {
+                w.mov(Register::rax, Address::at(batch_stack_pointer, scalar_outputs(ctx) + scalar_slot_offset(i)));
+                w.mov(Address::at(Register::rdx), Register::rax);
+                w.add(Register::rdx, Register::rcx);
+            }
+
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.add(Register::rax, static_cast<std::int32_t>(sizeof(double)));
+            w.mov(invocation_offset(ctx), Register::rax);
+            w.jmp(scalar_loop);
+        }
+
+    } // namespace
+
+    template <typename Writer>
+    NativeAssemblerErrorCode
+    lower_batch(
+        const VM::VMData& data, Writer& writer, const LoweringOptions& options, Label scalar_entry,
+        const MathRoutines& math) noexcept
+    {
+        auto& w = writer;
+        BatchContext<Writer> ctx{
+            .data = data, .writer = writer, .options = options, .scalar_entry = scalar_entry, .math = math};
+
+        const auto group_loop = w.make_label();
+        const auto tail = w.make_label();
+        const auto scalar_loop = w.make_label();
+        const auto done = w.make_label();
+        const auto exit = w.make_label();
+
+        //the batch stack frame: outgoing area and lane scratch of the global frame, its slots, and the locals
+        const auto& global_frame = data.call_frames.front();
+        const auto global_frame_size =
+            std::max<std::size_t>(global_frame.size, 1U + std::size_t{data.num_input_identifiers} + data.num_output_identifiers);
+        const auto vectorised = options.instruction_set != InstructionSet::sse2;
+        if (vectorised) {
+            ctx.vector_length = options.instruction_set == InstructionSet::avx512 ? VectorLength::v512 : VectorLength::v256;
+            ctx.lane_count = ctx.vector_length == VectorLength::v512 ? 8U : 4U;
+            ctx.vector_size = static_cast<std::int32_t>(ctx.lane_count * sizeof(double));
+            w.set_vector_length(ctx.vector_length);
+
+            for (const auto immediate : data.immediate_values) {
+                ctx.immediate_constants.push_back(w.add_constant(immediate));
+            }
+            ctx.one = w.add_constant(1.0);
+            ctx.magnitude_mask = w.add_constant(std::uint64_t{0x7FFF'FFFF'FFFF'FFFFU});
+            ctx.halt = w.make_label();
+            ctx.bailout = w.make_label();
+            ctx.vector_pow = w.make_label();
+            std::generate_n(std::back_inserter(ctx.frame_labels), data.call_frames.size(), [&] { return w.make_label(); });
+
+            ctx.outgoing_bytes = outgoing_area_size(ctx, global_frame);
+            ctx.global_frame_offset = ctx.outgoing_bytes + lane_scratch_bytes(ctx);
+            ctx.locals = ctx.global_frame_offset + slot_offset(ctx, global_frame_size);
+        }
+        const auto scalar_buffer_bytes = (std::size_t{data.num_input_identifiers} + data.num_output_identifiers) * sizeof(double);
+        //6 pushes and the return address leave the stack 8 bytes off
+        const auto batch_frame_bytes = align_stack(static_cast<std::size_t>(scalar_inputs(ctx)) + scalar_buffer_bytes) + 8;
+
+        w.global(batch_entry_point_name(options.instruction_set));
+        for (const auto reg : saved_registers) {
+            w.push(reg);
+        }
+        w.sub(Register::rsp, batch_frame_bytes);
+        w.mov(batch_stack_pointer, Register::rsp);
+        w.mov(input_pointer(ctx), Register::rdi);
+        w.mov(output_pointer(ctx), Register::rsi);
+        w.shl(Register::rdx, 3U);
+        w.mov(column_stride(ctx), Register::rdx);
+        w.mov(invocation_offset(ctx), 0);
+
+        if (vectorised) {
+            w.bind(group_loop);
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.mov(Register::rcx, column_stride(ctx));
+            w.cmp(Register::rax, Register::rcx);
+            w.jcc(Condition::above_or_equal, done);
+            w.add(Register::rax, ctx.vector_size);
+            w.cmp(Register::rax, Register::rcx);
+            w.jcc(Condition::above, tail);
+
+            emit_group_prologue(ctx, global_frame_size);
+            for (ctx.frame_index = 0U; ctx.frame_index != data.call_frames.size(); ++ctx.frame_index) {
+                emit_call_frame(ctx, data.call_frames[ctx.frame_index]);
+            }
+            emit_group_epilogue(ctx, group_loop);
+
+            //fewer invocations than lanes are left
+            w.bind(tail);
+            w.mov(scalar_end_offset(ctx), Register::rcx);
+            w.jmp(scalar_loop);
+
+            w.bind(ctx.bailout);
+            w.mov(Register::rsp, batch_stack_pointer);
+            w.vzeroupper();
+            w.mov(Register::rax, invocation_offset(ctx));
+            w.add(Register::rax, ctx.vector_size);
+            w.mov(scalar_end_offset(ctx), Register::rax);
+            emit_scalar_fallback(ctx, scalar_loop, group_loop, exit);
+        } else {
+            //the SSE2 variant has no vector path, every invocation goes through the scalar entry point
+            w.mov(scalar_end_offset(ctx), Register::rdx);
+            emit_scalar_fallback(ctx, scalar_loop, done, exit);
+        }
+
+        w.bind(done);
+        w.xor32(Register::rax, Register::rax);
+        w.bind(exit);
+        if (vectorised) {
+            w.vzeroupper();
+        }
+        w.add(Register::rsp, batch_frame_bytes);
+        for (const auto reg : std::ranges::reverse_view(saved_registers)) {
+            w.pop(reg);
+        }
+        w.ret();
+
+        if (ctx.uses_vector_pow)
+            emit_vector_pow(w, ctx.vector_pow);
+
+        return NativeAssemblerErrorCode::ok;
+    }
+
+    template NativeAssemblerErrorCode
+    lower_batch<Encoder>(const VM::VMData&, Encoder&, const LoweringOptions&, Label, const MathRoutines&) noexcept;
+    template NativeAssemblerErrorCode
+    lower_batch<NasmWriter>(const VM::VMData&, NasmWriter&, const LoweringOptions&, Label, const MathRoutines&) noexcept;
+
+} // namespace RaychelScript::NativeAssembler::X86_64
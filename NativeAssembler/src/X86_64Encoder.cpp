@@ -0,0 +1,811 @@
+/**
+* \file X86_64Encoder.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the x86-64 machine code encoder
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/X86_64Encoder.h"
+
+#include "RaychelCore/Raychel_assert.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        constexpr auto unbound_label = std::numeric_limits<std::size_t>::max();
+
+        constexpr std::uint8_t number(Register reg) noexcept
+        {
+            return static_cast<std::uint8_t>(reg);
+        }
+
+        constexpr std::uint8_t number(XMMRegister reg) noexcept
+        {
+            return static_cast<std::uint8_t>(reg);
+        }
+
+        constexpr std::uint8_t number(MaskRegister reg) noexcept
+        {
+            return static_cast<std::uint8_t>(reg);
+        }
+
+        constexpr std::int32_t vector_bytes(VectorLength length) noexcept
+        {
+            return length == VectorLength::v512 ? 64 : 32;
+        }
+
+        //spl, bpl, sil and dil can only be addressed with a REX prefix. Without one, these encodings select ah, ch, dh and bh
+        constexpr bool needs_rex_for_byte_access(Register reg) noexcept
+        {
+            return reg >= Register::rsp && reg <= Register::rdi;
+        }
+
+        constexpr bool fits_in_int8(std::int32_t value) noexcept
+        {
+            return value >= std::numeric_limits<std::int8_t>::min() && value <= std::numeric_limits<std::int8_t>::max();
+        }
+
+        void patch32(std::vector<std::uint8_t>& code, std::size_t position, std::uint32_t value) noexcept
+        {
+            for (std::size_t i = 0; i < 4U; ++i) {
+                code[position + i] = static_cast<std::uint8_t>(value >> (8U * i));
+            }
+        }
+
+        std::uint32_t relative_displacement(std::size_t from, std::size_t to) noexcept
+        {
+            //displacements are relative to the end of the 32-bit field
+            return static_cast<std::uint32_t>(static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from + 4U));
+        }
+
+    } // namespace
+
+    Label Encoder::make_label() noexcept
+    {
+        label_positions_.push_back(unbound_label);
+        return Label{static_cast<std::uint32_t>(label_positions_.size() - 1U)};
+    }
+
+    void Encoder::bind(Label label) noexcept
+    {
+        RAYCHEL_ASSERT(label.id < label_positions_.size());
+        label_positions_[label.id] = code_.size();
+    }
+
+    std::uint32_t Encoder::add_constant(std::uint64_t bits) noexcept
+    {
+        if (const auto it = std::ranges::find(constants_, bits); it != constants_.end()) {
+            return static_cast<std::uint32_t>(std::distance(constants_.begin(), it));
+        }
+        constants_.push_back(bits);
+        return static_cast<std::uint32_t>(constants_.size() - 1U);
+    }
+
+    std::uint32_t Encoder::add_constant(double value) noexcept
+    {
+        return add_constant(std::bit_cast<std::uint64_t>(value));
+    }
+
+    void Encoder::global(std::string_view name) noexcept
+    {
+        symbols_.emplace_back(name, code_.size());
+    }
+
+    void Encoder::set_vector_length(VectorLength length) noexcept
+    {
+        vector_length_ = length;
+    }
+
+    std::optional<std::size_t> Encoder::symbol_offset(std::string_view name) const noexcept
+    {
+        const auto it = std::ranges::find(symbols_, name, &std::pair<std::string, std::size_t>::first);
+        if (it == symbols_.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void Encoder::movsd(XMMRegister destination, Address source) noexcept
+    {
+        _sse(0xF2U, 0x10U, destination, source);
+    }
+
+    void Encoder::movsd(Address destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x11U, source, destination);
+    }
+
+    void Encoder::movapd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0x66U, 0x28U, destination, source);
+    }
+
+    void Encoder::addsd(XMMRegister destination, Address source) noexcept
+    {
+        _sse(0xF2U, 0x58U, destination, source);
+    }
+
+    void Encoder::addsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x58U, destination, source);
+    }
+
+    void Encoder::subsd(XMMRegister destination, Address source) noexcept
+    {
+        _sse(0xF2U, 0x5CU, destination, source);
+    }
+
+    void Encoder::subsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x5CU, destination, source);
+    }
+
+    void Encoder::mulsd(XMMRegister destination, Address source) noexcept
+    {
+        _sse(0xF2U, 0x59U, destination, source);
+    }
+
+    void Encoder::mulsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x59U, destination, source);
+    }
+
+    void Encoder::divsd(XMMRegister destination, Address source) noexcept
+    {
+        _sse(0xF2U, 0x5EU, destination, source);
+    }
+
+    void Encoder::divsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x5EU, destination, source);
+    }
+
+    void Encoder::ucomisd(XMMRegister lhs, Address rhs) noexcept
+    {
+        _sse(0x66U, 0x2EU, lhs, rhs);
+    }
+
+    void Encoder::ucomisd(XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _sse(0x66U, 0x2EU, lhs, rhs);
+    }
+
+    void Encoder::sqrtsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x51U, destination, source);
+    }
+
+    void Encoder::minsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x5DU, destination, source);
+    }
+
+    void Encoder::maxsd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0xF2U, 0x5FU, destination, source);
+    }
+
+    void Encoder::andpd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0x66U, 0x54U, destination, source);
+    }
+
+    void Encoder::xorpd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0x66U, 0x57U, destination, source);
+    }
+
+    void Encoder::paddq(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _sse(0x66U, 0xD4U, destination, source);
+    }
+
+    void Encoder::psllq(XMMRegister destination, std::uint8_t bits) noexcept
+    {
+        _sse_shift(6U, destination, bits);
+    }
+
+    void Encoder::psrlq(XMMRegister destination, std::uint8_t bits) noexcept
+    {
+        _sse_shift(2U, destination, bits);
+    }
+
+    void Encoder::vmovupd(XMMRegister destination, Address source) noexcept
+    {
+        _avx(1U, 0x10U, destination, XMMRegister::xmm0, source);
+    }
+
+    void Encoder::vmovupd(Address destination, XMMRegister source) noexcept
+    {
+        _avx(1U, 0x11U, source, XMMRegister::xmm0, destination);
+    }
+
+    void Encoder::vmovapd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _avx(1U, 0x28U, destination, XMMRegister::xmm0, source);
+    }
+
+    void Encoder::vbroadcastsd(XMMRegister destination, Address source) noexcept
+    {
+        _avx(2U, 0x19U, destination, XMMRegister::xmm0, source, true);
+    }
+
+    void Encoder::vaddpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        _avx(1U, 0x58U, destination, lhs, rhs);
+    }
+
+    void Encoder::vaddpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x58U, destination, lhs, rhs);
+    }
+
+    void Encoder::vsubpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        _avx(1U, 0x5CU, destination, lhs, rhs);
+    }
+
+    void Encoder::vsubpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x5CU, destination, lhs, rhs);
+    }
+
+    void Encoder::vmulpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        _avx(1U, 0x59U, destination, lhs, rhs);
+    }
+
+    void Encoder::vmulpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x59U, destination, lhs, rhs);
+    }
+
+    void Encoder::vdivpd(XMMRegister destination, XMMRegister lhs, Address rhs) noexcept
+    {
+        _avx(1U, 0x5EU, destination, lhs, rhs);
+    }
+
+    void Encoder::vdivpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x5EU, destination, lhs, rhs);
+    }
+
+    void Encoder::vsqrtpd(XMMRegister destination, XMMRegister source) noexcept
+    {
+        _avx(1U, 0x51U, destination, XMMRegister::xmm0, source);
+    }
+
+    void Encoder::vminpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x5DU, destination, lhs, rhs);
+    }
+
+    void Encoder::vmaxpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x5FU, destination, lhs, rhs);
+    }
+
+    void Encoder::vandpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x54U, destination, lhs, rhs);
+    }
+
+    void Encoder::vxorpd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0x57U, destination, lhs, rhs);
+    }
+
+    void Encoder::vcmppd(XMMRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept
+    {
+        //the predicate byte follows the displacement, so RIP-relative fixups would be off by one
+        RAYCHEL_ASSERT(!rhs.is_constant());
+        RAYCHEL_ASSERT(vector_length_ == VectorLength::v256);
+        _avx(1U, 0xC2U, destination, lhs, rhs);
+        _emit(static_cast<std::uint8_t>(predicate));
+    }
+
+    void Encoder::vcmppd(XMMRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept
+    {
+        RAYCHEL_ASSERT(vector_length_ == VectorLength::v256);
+        _avx(1U, 0xC2U, destination, lhs, rhs);
+        _emit(static_cast<std::uint8_t>(predicate));
+    }
+
+    void Encoder::vmovmskpd(Register destination, XMMRegister source) noexcept
+    {
+        RAYCHEL_ASSERT(vector_length_ == VectorLength::v256);
+        _vex(1U, number(destination), 0U, number(source));
+        _emit(0x50U);
+        _modrm(number(destination), number(source));
+    }
+
+    void Encoder::vzeroupper() noexcept
+    {
+        _emit(0xC5U);
+        _emit(0xF8U);
+        _emit(0x77U);
+    }
+
+    void Encoder::vpaddq(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+    {
+        _avx(1U, 0xD4U, destination, lhs, rhs);
+    }
+
+    void Encoder::vpsllq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+    {
+        _avx_shift(6U, destination, source, bits);
+    }
+
+    void Encoder::vpsrlq(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+    {
+        _avx_shift(2U, destination, source, bits);
+    }
+
+    void Encoder::vcmppd(MaskRegister destination, XMMRegister lhs, Address rhs, ComparisonPredicate predicate) noexcept
+    {
+        RAYCHEL_ASSERT(!rhs.is_constant());
+        RAYCHEL_ASSERT(vector_length_ == VectorLength::v512);
+        _evex(1U, number(destination), number(lhs), number(rhs.base()));
+        _emit(0xC2U);
+        _modrm(number(destination), rhs, vector_bytes(vector_length_));
+        _emit(static_cast<std::uint8_t>(predicate));
+    }
+
+    void Encoder::vcmppd(MaskRegister destination, XMMRegister lhs, XMMRegister rhs, ComparisonPredicate predicate) noexcept
+    {
+        RAYCHEL_ASSERT(vector_length_ == VectorLength::v512);
+        _evex(1U, number(destination), number(lhs), number(rhs));
+        _emit(0xC2U);
+        _modrm(number(destination), number(rhs));
+        _emit(static_cast<std::uint8_t>(predicate));
+    }
+
+    void Encoder::kmovw(Register destination, MaskRegister source) noexcept
+    {
+        //VEX.L0.0F.W0 93 /r, the only register field that can need an extension is the destination
+        _emit(0xC5U);
+        _emit(static_cast<std::uint8_t>(((number(destination) & 8U) == 0U ? 0x80U : 0U) | 0x78U));
+        _emit(0x93U);
+        _modrm(number(destination), number(source));
+    }
+
+    void Encoder::mov(Register destination, Address source) noexcept
+    {
+        _op(true, 0x8BU, number(destination), source);
+    }
+
+    void Encoder::mov(Address destination, Register source) noexcept
+    {
+        _op(true, 0x89U, number(source), destination);
+    }
+
+    void Encoder::mov(Register destination, Register source) noexcept
+    {
+        _op(true, 0x89U, number(source), destination);
+    }
+
+    void Encoder::mov(Register destination, std::uint64_t immediate) noexcept
+    {
+        _rex(true, 0U, number(destination));
+        _emit(static_cast<std::uint8_t>(0xB8U + (number(destination) & 7U)));
+        _emit64(immediate);
+    }
+
+    void Encoder::mov(Address destination, std::int32_t immediate) noexcept
+    {
+        //the immediate would follow the displacement, which breaks the RIP-relative fixup. Constants are read-only anyways
+        RAYCHEL_ASSERT(!destination.is_constant());
+        _op(true, 0xC7U, 0U, destination);
+        _emit32(static_cast<std::uint32_t>(immediate));
+    }
+
+    void Encoder::mov32(Register destination, std::uint32_t immediate) noexcept
+    {
+        _rex(false, 0U, number(destination));
+        _emit(static_cast<std::uint8_t>(0xB8U + (number(destination) & 7U)));
+        _emit32(immediate);
+    }
+
+    void Encoder::lea(Register destination, Address source) noexcept
+    {
+        _op(true, 0x8DU, number(destination), source);
+    }
+
+    void Encoder::add(Register destination, std::int32_t immediate) noexcept
+    {
+        _op(0U, destination, immediate);
+    }
+
+    void Encoder::add(Register destination, Register source) noexcept
+    {
+        _op(true, 0x01U, number(source), destination);
+    }
+
+    void Encoder::sub(Register destination, std::int32_t immediate) noexcept
+    {
+        _op(5U, destination, immediate);
+    }
+
+    void Encoder::cmp(Register lhs, Register rhs) noexcept
+    {
+        _op(true, 0x39U, number(rhs), lhs);
+    }
+
+    void Encoder::cmp(Register lhs, std::int32_t immediate) noexcept
+    {
+        _op(7U, lhs, immediate);
+    }
+
+    void Encoder::test32(Register lhs, Register rhs) noexcept
+    {
+        _op(false, 0x85U, number(rhs), lhs);
+    }
+
+    void Encoder::xor32(Register destination, Register source) noexcept
+    {
+        _op(false, 0x31U, number(source), destination);
+    }
+
+    void Encoder::btr(Register destination, std::uint8_t bit) noexcept
+    {
+        _rex(true, 0U, number(destination));
+        _emit(0x0FU);
+        _emit(0xBAU);
+        _modrm(6U, number(destination));
+        _emit(bit);
+    }
+
+    void Encoder::shl(Register destination, std::uint8_t bits) noexcept
+    {
+        _rex(true, 0U, number(destination));
+        _emit(0xC1U);
+        _modrm(4U, number(destination));
+        _emit(bits);
+    }
+
+    void Encoder::setcc(Condition condition, Register destination) noexcept
+    {
+        _rex(false, 0U, number(destination), needs_rex_for_byte_access(destination));
+        _emit(0x0FU);
+        _emit(static_cast<std::uint8_t>(0x90U + static_cast<std::uint8_t>(condition)));
+        _modrm(0U, number(destination));
+    }
+
+    void Encoder::movzx8(Register destination, Register source) noexcept
+    {
+        _rex(false, number(destination), number(source), needs_rex_for_byte_access(source));
+        _emit(0x0FU);
+        _emit(0xB6U);
+        _modrm(number(destination), number(source));
+    }
+
+    void Encoder::and8(Register destination, Register source) noexcept
+    {
+        _rex(false,
+             number(source),
+             number(destination),
+             needs_rex_for_byte_access(source) || needs_rex_for_byte_access(destination));
+        _emit(0x20U);
+        _modrm(number(source), number(destination));
+    }
+
+    void Encoder::or8(Register destination, Register source) noexcept
+    {
+        _rex(false,
+             number(source),
+             number(destination),
+             needs_rex_for_byte_access(source) || needs_rex_for_byte_access(destination));
+        _emit(0x08U);
+        _modrm(number(source), number(destination));
+    }
+
+    void Encoder::push(Register source) noexcept
+    {
+        _rex(false, 0U, number(source));
+        _emit(static_cast<std::uint8_t>(0x50U + (number(source) & 7U)));
+    }
+
+    void Encoder::pop(Register destination) noexcept
+    {
+        _rex(false, 0U, number(destination));
+        _emit(static_cast<std::uint8_t>(0x58U + (number(destination) & 7U)));
+    }
+
+    void Encoder::rep_stosq() noexcept
+    {
+        _emit(0xF3U);
+        _emit(0x48U);
+        _emit(0xABU);
+    }
+
+    void Encoder::jmp(Label target) noexcept
+    {
+        _emit(0xE9U);
+        _branch(target);
+    }
+
+    void Encoder::jcc(Condition condition, Label target) noexcept
+    {
+        _emit(0x0FU);
+        _emit(static_cast<std::uint8_t>(0x80U + static_cast<std::uint8_t>(condition)));
+        _branch(target);
+    }
+
+    void Encoder::call(Label target) noexcept
+    {
+        _emit(0xE8U);
+        _branch(target);
+    }
+
+    void Encoder::call(Register target) noexcept
+    {
+        _rex(false, 0U, number(target));
+        _emit(0xFFU);
+        _modrm(2U, number(target));
+    }
+
+    void Encoder::ret() noexcept
+    {
+        _emit(0xC3U);
+    }
+
+    std::optional<std::vector<std::uint8_t>> Encoder::finish() noexcept
+    {
+        for (const auto& [position, target] : label_fixups_) {
+            const auto target_position = label_positions_[target];
+            if (target_position == unbound_label) {
+                return std::nullopt;
+            }
+            patch32(code_, position, relative_displacement(position, target_position));
+        }
+
+        //keep the constants naturally aligned. The padding is never executed, but int3 makes stray jumps trap
+        while (code_.size() % sizeof(std::uint64_t) != 0U) {
+            _emit(0xCCU);
+        }
+        const auto pool_begin = code_.size();
+        for (const auto constant : constants_) {
+            _emit64(constant);
+        }
+
+        for (const auto& [position, index] : constant_fixups_) {
+            patch32(code_, position, relative_displacement(position, pool_begin + index * sizeof(std::uint64_t)));
+        }
+
+        label_fixups_.clear();
+        constant_fixups_.clear();
+        return std::move(code_);
+    }
+
+    void Encoder::_emit(std::uint8_t byte) noexcept
+    {
+        code_.push_back(byte);
+    }
+
+    void Encoder::_emit32(std::uint32_t value) noexcept
+    {
+        for (std::uint32_t i = 0; i < 4U; ++i) {
+            _emit(static_cast<std::uint8_t>(value >> (8U * i)));
+        }
+    }
+
+    void Encoder::_emit64(std::uint64_t value) noexcept
+    {
+        for (std::uint32_t i = 0; i < 8U; ++i) {
+            _emit(static_cast<std::uint8_t>(value >> (8U * i)));
+        }
+    }
+
+    void Encoder::_rex(bool wide, std::uint8_t reg, std::uint8_t base, bool force) noexcept
+    {
+        const auto prefix = static_cast<std::uint8_t>(0x40U | (wide ? 0x08U : 0U) | ((reg & 8U) >> 1U) | ((base & 8U) >> 3U));
+        if (prefix != 0x40U || force) {
+            _emit(prefix);
+        }
+    }
+
+    //EVEX instructions scale 8-bit displacements by disp8_scale, the size of their memory operand
+    void Encoder::_modrm(std::uint8_t reg, Address address, std::int32_t disp8_scale) noexcept
+    {
+        if (address.is_constant()) {
+            //mod=00 rm=101 is [rip + disp32]
+            _emit(static_cast<std::uint8_t>(((reg & 7U) << 3U) | 5U));
+            constant_fixups_.push_back(Fixup{code_.size(), static_cast<std::uint32_t>(address.displacement())});
+            _emit32(0U);
+            return;
+        }
+
+        const auto base = static_cast<std::uint8_t>(number(address.base()) & 7U);
+        const auto displacement = address.displacement();
+
+        //rbp and r13 can't be encoded without displacement since that encoding means RIP-relative
+        std::uint8_t mod = 2U;
+        if (displacement == 0 && base != 5U) {
+            mod = 0U;
+        } else if (displacement % disp8_scale == 0 && fits_in_int8(displacement / disp8_scale)) {
+            mod = 1U;
+        }
+
+        _emit(static_cast<std::uint8_t>((mod << 6U) | ((reg & 7U) << 3U) | base));
+        //rsp and r12 need a SIB byte
+        if (base == 4U) {
+            _emit(0x24U);
+        }
+        if (mod == 1U) {
+            _emit(static_cast<std::uint8_t>(displacement / disp8_scale));
+        } else if (mod == 2U) {
+            _emit32(static_cast<std::uint32_t>(displacement));
+        }
+    }
+
+    void Encoder::_modrm(std::uint8_t reg, std::uint8_t rm) noexcept
+    {
+        _emit(static_cast<std::uint8_t>(0xC0U | ((reg & 7U) << 3U) | (rm & 7U)));
+    }
+
+    void Encoder::_sse(std::uint8_t prefix, std::uint8_t op_code, XMMRegister reg, Address address) noexcept
+    {
+        _emit(prefix);
+        _rex(false, number(reg), address.is_constant() ? 0U : number(address.base()));
+        _emit(0x0FU);
+        _emit(op_code);
+        _modrm(number(reg), address);
+    }
+
+    void Encoder::_sse(std::uint8_t prefix, std::uint8_t op_code, XMMRegister reg, XMMRegister rm) noexcept
+    {
+        _emit(prefix);
+        _rex(false, number(reg), number(rm));
+        _emit(0x0FU);
+        _emit(op_code);
+        _modrm(number(reg), number(rm));
+    }
+
+    void Encoder::_op(bool wide, std::uint8_t op_code, std::uint8_t reg, Address address) noexcept
+    {
+        _rex(wide, reg, address.is_constant() ? 0U : number(address.base()));
+        _emit(op_code);
+        _modrm(reg, address);
+    }
+
+    void Encoder::_op(bool wide, std::uint8_t op_code, std::uint8_t reg, Register rm) noexcept
+    {
+        _rex(wide, reg, number(rm));
+        _emit(op_code);
+        _modrm(reg, number(rm));
+    }
+
+    //the group 1 arithmetic instructions (add, or, adc, sbb, and, sub, xor, cmp) with an immediate operand
+    void Encoder::_op(std::uint8_t extension, Register destination, std::int32_t immediate) noexcept
+    {
+        _rex(true, 0U, number(destination));
+        if (fits_in_int8(immediate)) {
+            _emit(0x83U);
+            _modrm(extension, number(destination));
+            _emit(static_cast<std::uint8_t>(immediate));
+            return;
+        }
+        _emit(0x81U);
+        _modrm(extension, number(destination));
+        _emit32(static_cast<std::uint32_t>(immediate));
+    }
+
+    void Encoder::_branch(Label target) noexcept
+    {
+        label_fixups_.push_back(Fixup{code_.size(), target.id});
+        _emit32(0U);
+    }
+
+    //VEX.256.66 prefix. The register fields are stored inverted, unused source fields are encoded as register 0
+    void Encoder::_vex(std::uint8_t map, std::uint8_t reg, std::uint8_t source, std::uint8_t base) noexcept
+    {
+        const auto r = (reg & 8U) == 0U ? 0x80U : 0U;
+        const auto b = (base & 8U) == 0U ? 0x20U : 0U;
+        const auto vvvv = static_cast<unsigned>(~source & 0xFU) << 3U;
+        constexpr auto length_and_prefix = 0x04U | 0x01U;
+
+        //the two byte form implies the 0F map, W=0 and can't extend the base register
+        if (map == 1U && b != 0U) {
+            _emit(0xC5U);
+            _emit(static_cast<std::uint8_t>(r | vvvv | length_and_prefix));
+            return;
+        }
+        _emit(0xC4U);
+        _emit(static_cast<std::uint8_t>(r | 0x40U | b | map));
+        _emit(static_cast<std::uint8_t>(vvvv | length_and_prefix));
+    }
+
+    //EVEX.512.66.W1 prefix. Like in _vex(), the register fields are inverted. Only the registers 0 to 15 are used
+    void Encoder::_evex(std::uint8_t map, std::uint8_t reg, std::uint8_t source, std::uint8_t base) noexcept
+    {
+        const auto r = (reg & 8U) == 0U ? 0x80U : 0U;
+        const auto b = (base & 8U) == 0U ? 0x20U : 0U;
+        const auto vvvv = static_cast<unsigned>(~source & 0xFU) << 3U;
+        //the inverted X and R' bits
+        constexpr auto high_registers = 0x40U | 0x10U;
+        constexpr auto wide_and_prefix = 0x80U | 0x04U | 0x01U;
+        //L'L = 10 selects 512 bits, V' is stored inverted as well. No masking, broadcasting or rounding control
+        constexpr auto length = 0x40U | 0x08U;
+
+        _emit(0x62U);
+        _emit(static_cast<std::uint8_t>(r | high_registers | b | map));
+        _emit(static_cast<std::uint8_t>(vvvv | wide_and_prefix));
+        _emit(static_cast<std::uint8_t>(length));
+    }
+
+    void Encoder::_avx(
+        std::uint8_t map, std::uint8_t op_code, XMMRegister reg, XMMRegister source, Address address,
+        bool scalar_memory_operand) noexcept
+    {
+        const auto base = address.is_constant() ? std::uint8_t{0U} : number(address.base());
+        if (vector_length_ == VectorLength::v512) {
+            _evex(map, number(reg), number(source), base);
+            _emit(op_code);
+            _modrm(number(reg), address, scalar_memory_operand ? std::int32_t{sizeof(double)} : vector_bytes(vector_length_));
+            return;
+        }
+        _vex(map, number(reg), number(source), base);
+        _emit(op_code);
+        _modrm(number(reg), address);
+    }
+
+    void Encoder::_avx(std::uint8_t map, std::uint8_t op_code, XMMRegister reg, XMMRegister source, XMMRegister rm) noexcept
+    {
+        if (vector_length_ == VectorLength::v512) {
+            _evex(map, number(reg), number(source), number(rm));
+        } else {
+            _vex(map, number(reg), number(source), number(rm));
+        }
+        _emit(op_code);
+        _modrm(number(reg), number(rm));
+    }
+
+    //66 0F 73 /extension ib, the shifts by an immediate
+    void Encoder::_sse_shift(std::uint8_t extension, XMMRegister destination, std::uint8_t bits) noexcept
+    {
+        _emit(0x66U);
+        _rex(false, 0U, number(destination));
+        _emit(0x0FU);
+        _emit(0x73U);
+        _modrm(extension, number(destination));
+        _emit(bits);
+    }
+
+    //The VEX and EVEX forms of the shifts encode the destination in vvvv and the source in r/m
+    void Encoder::_avx_shift(std::uint8_t extension, XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+    {
+        if (vector_length_ == VectorLength::v512) {
+            _evex(1U, extension, number(destination), number(source));
+        } else {
+            _vex(1U, extension, number(destination), number(source));
+        }
+        _emit(0x73U);
+        _modrm(extension, number(source));
+        _emit(bits);
+    }
+
+} // namespace RaychelScript::NativeAssembler::X86_64
@@ -0,0 +1,950 @@
+/**
+* \file X86_64Lowering.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the lowering of RASM call frames to x86-64
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/X86_64Lowering.h"
+#include "NativeAssembler/X86_64Math.h"
+#include "NativeAssembler/X86_64RegisterAllocator.h"
+
+#include "VM/VMErrorCode.h"
+
+#include "RaychelCore/Raychel_assert.h"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <utility>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        using Assembly::Instruction;
+        using Assembly::MemoryIndex;
+        using Assembly::OpCode;
+        using VM::VMErrorCode;
+
+        //The VM state lives in general purpose registers, which the math routines don't touch
+        constexpr auto frame_base = Register::rbx; //slot 0 of the current call frame
+        constexpr auto call_budget = Register::rbp; //number of calls that can still be made before the call stack overflows
+        constexpr auto memory_in_use = Register::r12; //VM memory offset of the current call frame in bytes
+        constexpr auto input_vector = Register::r13;
+        constexpr auto flag = Register::r14;
+        constexpr auto entry_stack_pointer = Register::r15; //native stack pointer of the global frame
+
+        //rsi holds the output vector pointer. It is pushed last and sits right above the global frame
+        constexpr std::array saved_registers{
+            Register::rbx, Register::rbp, Register::r12, Register::r13, Register::r14, Register::r15, Register::rsi};
+
+        //xmm0 and xmm1 are never allocated to slots. xmm0 is the accumulator, xmm1 holds temporaries
+        constexpr auto accumulator = XMMRegister::xmm0;
+        constexpr auto scratch = XMMRegister::xmm1;
+
+        /**
+        * \brief Where the value of a MemoryIndex lives: in an allocated register or in memory
+        */
+        class Operand
+        {
+            Operand(std::optional<XMMRegister> reg, Address address) noexcept : reg_{reg}, address_{address}
+            {}
+
+        public:
+            [[nodiscard]] static Operand in_register(XMMRegister reg) noexcept
+            {
+                return Operand{reg, Address::at(Register::rax)};
+            }
+
+            [[nodiscard]] static Operand in_memory(Address address) noexcept
+            {
+                return Operand{std::nullopt, address};
+            }
+
+            [[nodiscard]] bool is_register() const noexcept
+            {
+                return reg_.has_value();
+            }
+
+            [[nodiscard]] bool is_register(XMMRegister reg) const noexcept
+            {
+                return reg_ == reg;
+            }
+
+            [[nodiscard]] XMMRegister reg() const noexcept
+            {
+                RAYCHEL_ASSERT(is_register());
+                return *reg_;
+            }
+
+            [[nodiscard]] Address address() const noexcept
+            {
+                RAYCHEL_ASSERT(!is_register());
+                return address_;
+            }
+
+            //call f with either the register or the address, so both overloads of an instruction can be reached
+            template <typename F>
+            void visit(F&& f) const noexcept
+            {
+                if (is_register()) {
+                    std::forward<F>(f)(*reg_);
+                } else {
+                    std::forward<F>(f)(address_);
+                }
+            }
+
+        private:
+            std::optional<XMMRegister> reg_;
+            Address address_;
+        };
+
+        template <typename Writer>
+        struct LoweringContext
+        {
+            const VM::VMData& data;
+            Writer& writer;
+            LoweringOptions options;
+
+            std::vector<Label> frame_labels{};
+            std::vector<std::uint32_t> immediate_constants{};
+            std::uint32_t one{};
+            std::uint32_t magnitude_mask{};
+
+            Label halt{};
+            Label exit{};
+            Label error{}; //expects the error code in eax
+            Label divide_by_zero{};
+            Label invalid_operand{};
+            Label stack_overflow{};
+            Label stack_underflow{};
+            Label memory_overflow{};
+
+            MathRoutines math{};
+            bool uses_pow{false};
+            bool uses_tgamma{false};
+
+            std::int32_t global_frame_bytes{};
+
+            std::size_t frame_index{};
+            std::size_t frame_size{};
+            std::int32_t outgoing_bytes{};
+            std::size_t instruction_index{};
+            std::vector<Label> instruction_labels{};
+            RegisterAllocation allocation{};
+
+            NativeAssemblerErrorCode error_code{NativeAssemblerErrorCode::ok};
+        };
+
+        template <typename Writer>
+        void fail(LoweringContext<Writer>& ctx, NativeAssemblerErrorCode error_code) noexcept
+        {
+            if (ctx.error_code == NativeAssemblerErrorCode::ok) {
+                ctx.error_code = error_code;
+            }
+        }
+
+        std::int32_t slot_offset(std::size_t index) noexcept
+        {
+            return static_cast<std::int32_t>(index * sizeof(double));
+        }
+
+        std::int32_t align_stack(std::size_t bytes) noexcept
+        {
+            return static_cast<std::int32_t>((bytes + 15U) & ~std::size_t{15U});
+        }
+
+        //memory slot of the current call frame. Allocated slots only live here around calls
+        Address slot(std::size_t index) noexcept
+        {
+            return Address::at(frame_base, slot_offset(index));
+        }
+
+        //slot of the next call frame. This is the bottom of the current native stack frame
+        Address outgoing_slot(std::size_t index) noexcept
+        {
+            return Address::at(Register::rsp, slot_offset(index));
+        }
+
+        bool is_immediate(MemoryIndex index) noexcept
+        {
+            return index.type() == MemoryIndex::ValueType::immediate;
+        }
+
+        template <typename Writer>
+        bool is_valid_location(const LoweringContext<Writer>& ctx, MemoryIndex index) noexcept
+        {
+            using enum MemoryIndex::ValueType;
+            return (index.type() == stack || index.type() == intermediate) && index.value() < ctx.frame_size;
+        }
+
+        template <typename Writer>
+        bool is_valid_value(const LoweringContext<Writer>& ctx, MemoryIndex index) noexcept
+        {
+            if (is_immediate(index))
+                return index.value() < ctx.data.immediate_values.size();
+            return is_valid_location(ctx, index);
+        }
+
+        template <typename Writer>
+        Operand location(const LoweringContext<Writer>& ctx, std::size_t index) noexcept
+        {
+            if (const auto reg = ctx.allocation.registers[index]; reg.has_value())
+                return Operand::in_register(*reg);
+            return Operand::in_memory(slot(index));
+        }
+
+        //Operands are validated before any code for the instruction is emitted, so value() can't see an invalid index
+        template <typename Writer>
+        Operand value(const LoweringContext<Writer>& ctx, MemoryIndex index) noexcept
+        {
+            if (is_immediate(index))
+                return Operand::in_memory(Address::constant(ctx.immediate_constants[index.value()]));
+            return location(ctx, index.value());
+        }
+
+        template <typename Writer>
+        void load(LoweringContext<Writer>& ctx, XMMRegister destination, Operand source) noexcept
+        {
+            if (source.is_register(destination))
+                return;
+            if (source.is_register()) {
+                ctx.writer.movapd(destination, source.reg());
+            } else {
+                ctx.writer.movsd(destination, source.address());
+            }
+        }
+
+        template <typename Writer>
+        void store(LoweringContext<Writer>& ctx, Operand destination, XMMRegister source) noexcept
+        {
+            if (destination.is_register(source))
+                return;
+            if (destination.is_register()) {
+                ctx.writer.movapd(destination.reg(), source);
+            } else {
+                ctx.writer.movsd(destination.address(), source);
+            }
+        }
+
+        //Every xmm register is caller-saved, so the allocated slots that are still needed after a call go to memory
+        template <typename Writer>
+        void spill(LoweringContext<Writer>& ctx, const SlotSet& slots) noexcept
+        {
+            for (std::size_t i{}; i != std::min(ctx.frame_size, number_of_tracked_slots); ++i) {
+                if (slots.test(i))
+                    ctx.writer.movsd(slot(i), *ctx.allocation.registers[i]);
+            }
+        }
+
+        template <typename Writer>
+        void reload(LoweringContext<Writer>& ctx, const SlotSet& slots) noexcept
+        {
+            for (std::size_t i{}; i != std::min(ctx.frame_size, number_of_tracked_slots); ++i) {
+                if (slots.test(i))
+                    ctx.writer.movsd(*ctx.allocation.registers[i], slot(i));
+            }
+        }
+
+        //the preserved slots of the current instruction that live in registers the math routines clobber
+        template <typename Writer>
+        SlotSet clobbered_by_math(const LoweringContext<Writer>& ctx) noexcept
+        {
+            const auto& preserved = ctx.allocation.preserved[ctx.instruction_index];
+            SlotSet slots{};
+            for (std::size_t i{}; i != std::min(ctx.frame_size, number_of_tracked_slots); ++i) {
+                if (preserved.test(i) && is_math_temporary(*ctx.allocation.registers[i]))
+                    slots.set(i);
+            }
+            return slots;
+        }
+
+        template <typename Writer>
+        bool check_values(LoweringContext<Writer>& ctx, std::initializer_list<MemoryIndex> indices) noexcept
+        {
+            if (std::ranges::all_of(indices, [&](MemoryIndex index) { return is_valid_value(ctx, index); }))
+                return true;
+            fail(ctx, NativeAssemblerErrorCode::invalid_operand);
+            return false;
+        }
+
+        template <typename Writer>
+        bool check_location(LoweringContext<Writer>& ctx, MemoryIndex index) noexcept
+        {
+            if (is_valid_location(ctx, index))
+                return true;
+            fail(ctx, NativeAssemblerErrorCode::invalid_operand);
+            return false;
+        }
+
+        template <typename Writer>
+        std::optional<Label> jump_target(LoweringContext<Writer>& ctx, MemoryIndex offset) noexcept
+        {
+            const auto target = static_cast<std::ptrdiff_t>(ctx.instruction_index) + static_cast<std::ptrdiff_t>(offset.offset());
+            //the last label marks the end of the frame, which is not a valid jump target
+            if (offset.type() != MemoryIndex::ValueType::jump_offset || target < 0 ||
+                std::cmp_greater_equal(target, ctx.instruction_labels.size() - 1U)) {
+                fail(ctx, NativeAssemblerErrorCode::invalid_operand);
+                return std::nullopt;
+            }
+            return ctx.instruction_labels[static_cast<std::size_t>(target)];
+        }
+
+        //The outgoing area holds the call frame of every callee. put writes into it directly
+        template <typename Writer>
+        std::optional<std::int32_t>
+        outgoing_area_size(LoweringContext<Writer>& ctx, const VM::CallFrameDescriptor& frame) noexcept
+        {
+            std::size_t size{};
+            for (const auto& instruction : frame.instructions) {
+                if (instruction.op_code() == OpCode::put) {
+                    size = std::max<std::size_t>(size, instruction.index2().value() + 1U);
+                } else if (instruction.op_code() == OpCode::jsr) {
+                    const auto callee = instruction.index1().value();
+                    if (callee >= ctx.data.call_frames.size()) {
+                        fail(ctx, NativeAssemblerErrorCode::invalid_operand);
+                        return std::nullopt;
+                    }
+                    size = std::max<std::size_t>(size, ctx.data.call_frames[callee].size);
+                }
+            }
+            return align_stack(size * sizeof(double));
+        }
+
+        template <typename Writer>
+        void emit_division_check(LoweringContext<Writer>& ctx, MemoryIndex divisor) noexcept
+        {
+            auto& w = ctx.writer;
+            if (is_immediate(divisor)) {
+                if (ctx.data.immediate_values[divisor.value()] == 0.0) {
+                    w.jmp(ctx.divide_by_zero);
+                }
+                return;
+            }
+            //ucomisd reports NaN as equal, but NaN is not a zero divisor
+            const auto nonzero = w.make_label();
+            w.xorpd(scratch, scratch);
+            value(ctx, divisor).visit([&](auto rhs) { w.ucomisd(scratch, rhs); });
+            w.jcc(Condition::parity, nonzero);
+            w.jcc(Condition::equal, ctx.divide_by_zero);
+            w.bind(nonzero);
+        }
+
+        //destination = a op b. Division jumps to the error handler if the divisor is zero
+        //Returns the register that holds the result
+        template <typename Writer>
+        XMMRegister
+        emit_arithmetic(LoweringContext<Writer>& ctx, OpCode op, MemoryIndex a, MemoryIndex b, Operand destination) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto lhs = value(ctx, a);
+            const auto rhs = value(ctx, b);
+
+            if (op == OpCode::pow || op == OpCode::pas) {
+                if (const auto chain = power_chain(ctx.data, b); chain.has_value()) {
+                    load(ctx, scratch, lhs);
+                    emit_scalar_power_chain(w, *chain, accumulator, scratch);
+                    store(ctx, destination, accumulator);
+                    return accumulator;
+                }
+                const auto clobbered = clobbered_by_math(ctx);
+                spill(ctx, clobbered);
+                load(ctx, accumulator, lhs);
+                load(ctx, scratch, rhs);
+                w.call(ctx.math.pow);
+                ctx.uses_pow = true;
+                store(ctx, destination, accumulator);
+                reload(ctx, clobbered);
+                return accumulator;
+            }
+
+            if (op == OpCode::div || op == OpCode::das || op == OpCode::dvt) {
+                emit_division_check(ctx, b);
+            }
+
+            //compute straight into the destination register, unless loading a into it would overwrite b
+            auto result = destination.is_register() ? destination.reg() : accumulator;
+            if (rhs.is_register(result) && !lhs.is_register(result)) {
+                result = accumulator;
+            }
+
+            load(ctx, result, lhs);
+            rhs.visit([&](auto source) {
+                switch (op) {
+                    case OpCode::add:
+                    case OpCode::inc:
+                    case OpCode::adt:
+                        w.addsd(result, source);
+                        break;
+                    case OpCode::sub:
+                    case OpCode::dec:
+                    case OpCode::sbt:
+                        w.subsd(result, source);
+                        break;
+                    case OpCode::mul:
+                    case OpCode::mas:
+                    case OpCode::mlt:
+                        w.mulsd(result, source);
+                        break;
+                    case OpCode::div:
+                    case OpCode::das:
+                    case OpCode::dvt:
+                        w.divsd(result, source);
+                        break;
+                    default:
+                        RAYCHEL_ASSERT_NOT_REACHED;
+                }
+            });
+            store(ctx, destination, result);
+            return result;
+        }
+
+        //a! = tgamma(a + 1). The checks give the same errors as the floating-point exceptions the VM tests for
+        template <typename Writer>
+        void emit_factorial(LoweringContext<Writer>& ctx, MemoryIndex a) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto not_a_pole = w.make_label();
+            const auto done = w.make_label();
+            const auto clobbered = clobbered_by_math(ctx);
+
+            load(ctx, accumulator, value(ctx, a));
+            w.addsd(accumulator, Address::constant(ctx.one));
+
+            //tgamma has its poles at zero and the negative integers. The VM reports division by zero only for zero
+            w.xorpd(scratch, scratch);
+            w.ucomisd(accumulator, scratch);
+            w.jcc(Condition::parity, not_a_pole);
+            w.jcc(Condition::equal, ctx.divide_by_zero);
+            w.bind(not_a_pole);
+
+            //the A register is overwritten by the result anyways, so its memory slot can hold the argument across the call
+            spill(ctx, clobbered);
+            w.movsd(slot(0U), accumulator);
+            w.call(ctx.math.tgamma);
+            ctx.uses_tgamma = true;
+
+            //a NaN result from a non-NaN argument is a domain error
+            w.ucomisd(accumulator, accumulator);
+            w.jcc(Condition::no_parity, done);
+            w.movsd(scratch, slot(0U));
+            w.ucomisd(scratch, scratch);
+            w.jcc(Condition::no_parity, ctx.invalid_operand);
+            w.bind(done);
+            store(ctx, location(ctx, 0U), accumulator);
+            reload(ctx, clobbered);
+        }
+
+        template <typename Writer>
+        void emit_magnitude(LoweringContext<Writer>& ctx, MemoryIndex a) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto source = value(ctx, a);
+            const auto destination = location(ctx, 0U);
+
+            if (!source.is_register() && !destination.is_register()) {
+                w.mov(Register::rax, source.address());
+                w.btr(Register::rax, 63U);
+                w.mov(destination.address(), Register::rax);
+                return;
+            }
+            const auto result = destination.is_register() ? destination.reg() : accumulator;
+            w.movsd(scratch, Address::constant(ctx.magnitude_mask));
+            load(ctx, result, source);
+            w.andpd(result, scratch);
+            store(ctx, destination, result);
+        }
+
+        //sets the CPU flags so that 'above' means lhs > rhs. Unordered operands set ZF, PF and CF
+        template <typename Writer>
+        void emit_compare(LoweringContext<Writer>& ctx, MemoryIndex lhs, MemoryIndex rhs) noexcept
+        {
+            auto lhs_register = accumulator;
+            if (const auto left = value(ctx, lhs); left.is_register()) {
+                lhs_register = left.reg();
+            } else {
+                ctx.writer.movsd(accumulator, left.address());
+            }
+            value(ctx, rhs).visit([&](auto right) { ctx.writer.ucomisd(lhs_register, right); });
+        }
+
+        template <typename Writer>
+        void emit_set_flag(LoweringContext<Writer>& ctx, OpCode op, MemoryIndex a, MemoryIndex b) noexcept
+        {
+            auto& w = ctx.writer;
+            switch (op) {
+                case OpCode::clt:
+                    emit_compare(ctx, b, a);
+                    w.setcc(Condition::above, Register::rax);
+                    break;
+                case OpCode::cgt:
+                    emit_compare(ctx, a, b);
+                    w.setcc(Condition::above, Register::rax);
+                    break;
+                case OpCode::ceq:
+                    emit_compare(ctx, a, b);
+                    w.setcc(Condition::equal, Register::rax);
+                    w.setcc(Condition::no_parity, Register::rcx);
+                    w.and8(Register::rax, Register::rcx);
+                    break;
+                case OpCode::cne:
+                    emit_compare(ctx, a, b);
+                    w.setcc(Condition::not_equal, Register::rax);
+                    w.setcc(Condition::parity, Register::rcx);
+                    w.or8(Register::rax, Register::rcx);
+                    break;
+                default:
+                    RAYCHEL_ASSERT_NOT_REACHED;
+            }
+            w.movzx8(flag, Register::rax);
+        }
+
+        //jump to target if the comparison of a and b does not hold. Like the VM, this does not touch the flag
+        template <typename Writer>
+        void emit_branch(LoweringContext<Writer>& ctx, OpCode op, MemoryIndex a, MemoryIndex b, Label target) noexcept
+        {
+            auto& w = ctx.writer;
+            switch (op) {
+                case OpCode::jnl:
+                    emit_compare(ctx, b, a);
+                    w.jcc(Condition::below_or_equal, target);
+                    break;
+                case OpCode::jng:
+                    emit_compare(ctx, a, b);
+                    w.jcc(Condition::below_or_equal, target);
+                    break;
+                case OpCode::jne:
+                    emit_compare(ctx, a, b);
+                    w.jcc(Condition::parity, target);
+                    w.jcc(Condition::not_equal, target);
+                    break;
+                case OpCode::jeq: {
+                    const auto unordered = w.make_label();
+                    emit_compare(ctx, a, b);
+                    w.jcc(Condition::parity, unordered);
+                    w.jcc(Condition::equal, target);
+                    w.bind(unordered);
+                    break;
+                }
+                default:
+                    RAYCHEL_ASSERT_NOT_REACHED;
+            }
+        }
+
+        template <typename Writer>
+        void emit_move(LoweringContext<Writer>& ctx, MemoryIndex a, MemoryIndex b) noexcept
+        {
+            const auto source = value(ctx, a);
+            const auto destination = location(ctx, b.value());
+            if (source.is_register()) {
+                store(ctx, destination, source.reg());
+            } else if (destination.is_register()) {
+                load(ctx, destination.reg(), source);
+            } else {
+                ctx.writer.mov(Register::rax, source.address());
+                ctx.writer.mov(destination.address(), Register::rax);
+            }
+        }
+
+        template <typename Writer>
+        void emit_put(LoweringContext<Writer>& ctx, MemoryIndex a, MemoryIndex b) noexcept
+        {
+            if (const auto source = value(ctx, a); source.is_register()) {
+                ctx.writer.movsd(outgoing_slot(b.value()), source.reg());
+            } else {
+                ctx.writer.mov(Register::rax, source.address());
+                ctx.writer.mov(outgoing_slot(b.value()), Register::rax);
+            }
+        }
+
+        template <typename Writer>
+        void emit_call(LoweringContext<Writer>& ctx, MemoryIndex frame) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto& preserved = ctx.allocation.preserved[ctx.instruction_index];
+
+            //same limits as the VM: the callee frame must fit into memory and the call stack must have room for another frame
+            const auto callee_size = std::max<std::size_t>(ctx.data.call_frames[frame.value()].size, 1U);
+            if (callee_size > ctx.options.memory_size) {
+                w.jmp(ctx.memory_overflow);
+                return;
+            }
+            w.add(memory_in_use, slot_offset(ctx.frame_size));
+            w.cmp(memory_in_use, slot_offset(ctx.options.memory_size - callee_size));
+            w.jcc(Condition::above, ctx.memory_overflow);
+            w.sub(call_budget, 1);
+            w.jcc(Condition::below, ctx.stack_overflow);
+
+            spill(ctx, preserved);
+            w.call(ctx.frame_labels[frame.value()]);
+
+            //the callee returns its A register in xmm0
+            w.add(call_budget, 1);
+            w.sub(memory_in_use, slot_offset(ctx.frame_size));
+            store(ctx, location(ctx, 0U), accumulator);
+            reload(ctx, preserved);
+        }
+
+        template <typename Writer>
+        void emit_return(LoweringContext<Writer>& ctx) noexcept
+        {
+            auto& w = ctx.writer;
+            if (ctx.frame_index == 0U) {
+                w.jmp(ctx.stack_underflow);
+                return;
+            }
+            load(ctx, accumulator, location(ctx, 0U));
+            if (ctx.outgoing_bytes != 0) {
+                w.add(Register::rsp, ctx.outgoing_bytes);
+            }
+            w.pop(frame_base);
+            w.ret();
+        }
+
+        //The halt stub copies the outputs from memory. Callers spill them before every call, so only the global frame has to
+        template <typename Writer>
+        void emit_halt(LoweringContext<Writer>& ctx) noexcept
+        {
+            if (ctx.frame_index == 0U) {
+                const auto first_output = 1U + std::size_t{ctx.data.num_input_identifiers};
+                const auto end_of_outputs = std::min(first_output + ctx.data.num_output_identifiers, ctx.frame_size);
+                for (auto i = first_output; i < end_of_outputs; ++i) {
+                    if (const auto reg = ctx.allocation.registers[i]; reg.has_value())
+                        ctx.writer.movsd(slot(i), *reg);
+                }
+            }
+            ctx.writer.jmp(ctx.halt);
+        }
+
+        template <typename Writer>
+        void emit_instruction(LoweringContext<Writer>& ctx, const Instruction& instruction) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto a = instruction.index1();
+            const auto b = instruction.index2();
+            const auto c = instruction.index3();
+
+            switch (const auto op = instruction.op_code()) {
+                case OpCode::mov:
+                    if (!check_values(ctx, {a}) || !check_location(ctx, b))
+                        return;
+                    emit_move(ctx, a, b);
+                    return;
+                case OpCode::add:
+                case OpCode::sub:
+                case OpCode::mul:
+                case OpCode::div:
+                case OpCode::pow:
+                    if (!check_values(ctx, {a, b}))
+                        return;
+                    emit_arithmetic(ctx, op, a, b, location(ctx, 0U));
+                    return;
+                case OpCode::mag:
+                    if (!check_values(ctx, {a}))
+                        return;
+                    emit_magnitude(ctx, a);
+                    return;
+                case OpCode::fac:
+                    if (!check_values(ctx, {a}))
+                        return;
+                    emit_factorial(ctx, a);
+                    return;
+                case OpCode::inc:
+                case OpCode::dec:
+                case OpCode::mas:
+                case OpCode::das:
+                case OpCode::pas:
+                    if (!check_location(ctx, a) || !check_values(ctx, {b}))
+                        return;
+                    emit_arithmetic(ctx, op, a, b, location(ctx, a.value()));
+                    return;
+                case OpCode::clt:
+                case OpCode::cgt:
+                case OpCode::ceq:
+                case OpCode::cne:
+                    if (!check_values(ctx, {a, b}))
+                        return;
+                    emit_set_flag(ctx, op, a, b);
+                    return;
+                case OpCode::jpz:
+                    if (const auto target = jump_target(ctx, a); target.has_value()) {
+                        w.test32(flag, flag);
+                        w.jcc(Condition::equal, *target);
+                    }
+                    return;
+                case OpCode::jmp:
+                    if (const auto target = jump_target(ctx, a); target.has_value()) {
+                        w.jmp(*target);
+                    }
+                    return;
+                case OpCode::hlt:
+                    emit_halt(ctx);
+                    return;
+                case OpCode::jsr:
+                    emit_call(ctx, a);
+                    return;
+                case OpCode::ret:
+                    emit_return(ctx);
+                    return;
+                case OpCode::put:
+                    if (!check_values(ctx, {a}))
+                        return;
+                    emit_put(ctx, a, b);
+                    return;
+                case OpCode::jnl:
+                case OpCode::jng:
+                case OpCode::jne:
+                case OpCode::jeq:
+                    if (!check_values(ctx, {a, b}))
+                        return;
+                    if (const auto target = jump_target(ctx, c); target.has_value()) {
+                        emit_branch(ctx, op, a, b, *target);
+                    }
+                    return;
+                case OpCode::mad:
+                    if (!check_values(ctx, {a, b, c}))
+                        return;
+                    //no FMA: the product is rounded before the addition, just like in the VM
+                    load(ctx, accumulator, value(ctx, a));
+                    value(ctx, b).visit([&](auto factor) { w.mulsd(accumulator, factor); });
+                    value(ctx, c).visit([&](auto summand) { w.addsd(accumulator, summand); });
+                    store(ctx, location(ctx, 0U), accumulator);
+                    return;
+                case OpCode::adt:
+                case OpCode::sbt:
+                case OpCode::mlt:
+                case OpCode::dvt:
+                    if (!check_values(ctx, {a, b}) || !check_location(ctx, c))
+                        return;
+                    store(ctx, location(ctx, c.value()), emit_arithmetic(ctx, op, a, b, location(ctx, 0U)));
+                    return;
+                case OpCode::num_op_codes:
+                    break;
+            }
+            fail(ctx, NativeAssemblerErrorCode::unknown_instruction);
+        }
+
+        template <typename Writer>
+        void emit_global_prologue(LoweringContext<Writer>& ctx, std::size_t global_frame_size) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto& data = ctx.data;
+
+            for (const auto reg : saved_registers) {
+                w.push(reg);
+            }
+            //7 pushes and the return address keep the native stack 16-byte aligned
+            w.sub(Register::rsp, ctx.global_frame_bytes);
+            w.mov(entry_stack_pointer, Register::rsp);
+            w.lea(frame_base, Address::at(Register::rsp, ctx.outgoing_bytes));
+            w.mov(input_vector, Register::rdi);
+            w.xor32(memory_in_use, memory_in_use);
+            w.xor32(flag, flag);
+            w.mov32(call_budget, static_cast<std::uint32_t>(ctx.options.stack_size == 0U ? 0U : ctx.options.stack_size - 1U));
+
+            //Only the global frame is cleared. Like in the VM, callee frames see whatever earlier calls left behind
+            w.xor32(Register::rax, Register::rax);
+            w.mov(Register::rdi, frame_base);
+            w.mov32(Register::rcx, static_cast<std::uint32_t>(global_frame_size));
+            w.rep_stosq();
+
+            for (std::size_t i = 0; i != data.num_input_identifiers; ++i) {
+                w.mov(Register::rax, Address::at(input_vector, slot_offset(i)));
+                w.mov(slot(i + 1U), Register::rax);
+            }
+        }
+
+        template <typename Writer>
+        void emit_call_frame(LoweringContext<Writer>& ctx, const VM::CallFrameDescriptor& frame) noexcept
+        {
+            auto& w = ctx.writer;
+            ctx.frame_size = frame.size;
+            ctx.instruction_labels.clear();
+            std::generate_n(
+                std::back_inserter(ctx.instruction_labels), frame.instructions.size() + 1U, [&] { return w.make_label(); });
+
+            const auto outgoing_bytes = outgoing_area_size(ctx, frame);
+            if (!outgoing_bytes.has_value())
+                return;
+            ctx.outgoing_bytes = *outgoing_bytes;
+            ctx.allocation = allocate_registers(ctx.data, ctx.frame_index);
+
+            w.bind(ctx.frame_labels[ctx.frame_index]);
+            if (ctx.frame_index == 0U) {
+                //slots, inputs and outputs of the global frame. The VM clears all of its memory
+                const auto global_frame_size = std::max<std::size_t>(
+                    frame.size, 1U + std::size_t{ctx.data.num_input_identifiers} + ctx.data.num_output_identifiers);
+                ctx.global_frame_bytes = ctx.outgoing_bytes + align_stack(global_frame_size * sizeof(double));
+                emit_global_prologue(ctx, global_frame_size);
+            } else {
+                //our slots are the outgoing area of the caller, right above the return address and the saved frame base
+                w.push(frame_base);
+                w.lea(frame_base, Address::at(Register::rsp, 2 * static_cast<std::int32_t>(sizeof(std::uint64_t))));
+                if (ctx.outgoing_bytes != 0) {
+                    w.sub(Register::rsp, ctx.outgoing_bytes);
+                }
+            }
+            reload(ctx, ctx.allocation.live_on_entry);
+
+            for (ctx.instruction_index = 0U; ctx.instruction_index != frame.instructions.size(); ++ctx.instruction_index) {
+                w.bind(ctx.instruction_labels[ctx.instruction_index]);
+                emit_instruction(ctx, frame.instructions[ctx.instruction_index]);
+                if (ctx.error_code != NativeAssemblerErrorCode::ok)
+                    return;
+            }
+
+            //running off the end of a frame halts, like the padding in a linked code segment
+            w.bind(ctx.instruction_labels.back());
+            emit_halt(ctx);
+        }
+
+        template <typename Writer>
+        void emit_epilogue(LoweringContext<Writer>& ctx, std::int32_t global_outgoing_bytes) noexcept
+        {
+            auto& w = ctx.writer;
+            const auto& data = ctx.data;
+
+            const auto raise = [&](Label label, VMErrorCode error_code) {
+                w.bind(label);
+                w.mov32(Register::rax, static_cast<std::uint32_t>(error_code));
+                w.jmp(ctx.error);
+            };
+            raise(ctx.divide_by_zero, VMErrorCode::divide_by_zero);
+            raise(ctx.invalid_operand, VMErrorCode::invalid_operand);
+            raise(ctx.stack_overflow, VMErrorCode::stack_overflow);
+            raise(ctx.stack_underflow, VMErrorCode::stack_underflow);
+            raise(ctx.memory_overflow, VMErrorCode::memory_overflow);
+
+            //errors and halts can happen at any call depth, so the native stack pointer has to be reset first
+            w.bind(ctx.error);
+            w.mov(Register::rsp, entry_stack_pointer);
+            w.jmp(ctx.exit);
+
+            w.bind(ctx.halt);
+            w.mov(Register::rsp, entry_stack_pointer);
+            w.mov(Register::rsi, Address::at(entry_stack_pointer, ctx.global_frame_bytes));
+            const auto first_output = global_outgoing_bytes + slot_offset(1U + std::size_t{data.num_input_identifiers});
+            for (std::size_t i = 0; i != data.num_output_identifiers; ++i) {
+                w.mov(Register::rax, Address::at(entry_stack_pointer, first_output + slot_offset(i)));
+                w.mov(Address::at(Register::rsi, slot_offset(i)), Register::rax);
+            }
+            w.xor32(Register::rax, Register::rax);
+
+            w.bind(ctx.exit);
+            w.add(Register::rsp, ctx.global_frame_bytes);
+            for (const auto reg : std::ranges::reverse_view(saved_registers)) {
+                w.pop(reg);
+            }
+            w.ret();
+        }
+
+        //The memory of the call frames lives on the native stack, and the code may run on threads with a small native stack
+        constexpr auto max_native_stack_bytes = std::size_t{4} << 20U;
+
+        //Upper bound for the native stack of the scalar and the batch code. The memory limit does not bound this, because every
+        //native frame holds the largest callee of its call frame, not just the one that is being called. So every level of the
+        //call stack is assumed to hold the largest frame of the script, two vectors of lane scratch, the return address and the
+        //saved frame base
+        bool fits_native_stack(const VM::VMData& data, const LoweringOptions& options) noexcept
+        {
+            std::size_t lanes{1U};
+            if (options.instruction_set == InstructionSet::avx2)
+                lanes = 4U;
+            else if (options.instruction_set == InstructionSet::avx512)
+                lanes = 8U;
+            const auto slot_bytes = lanes * sizeof(double);
+
+            std::size_t largest_frame{};
+            for (const auto& frame : data.call_frames) {
+                largest_frame = std::max<std::size_t>(largest_frame, frame.size);
+                for (const auto& instruction : frame.instructions) {
+                    if (instruction.op_code() == OpCode::put)
+                        largest_frame = std::max<std::size_t>(largest_frame, instruction.index2().value() + 1U);
+                }
+            }
+            const auto level_bytes = (largest_frame + 2U) * slot_bytes + 2U * sizeof(std::uint64_t) + 15U;
+            return std::max<std::size_t>(options.stack_size, 1U) <= max_native_stack_bytes / level_bytes;
+        }
+
+    } // namespace
+
+    template <typename Writer>
+    NativeAssemblerErrorCode lower(const VM::VMData& data, Writer& writer, const LoweringOptions& options) noexcept
+    {
+        if (data.call_frames.empty())
+            return NativeAssemblerErrorCode::invalid_operand;
+
+        //keep all offsets in the range of 32-bit displacements
+        constexpr auto max_memory_size = std::size_t{1} << 24U;
+        const auto& global_frame = data.call_frames.front();
+        if (options.memory_size > max_memory_size || global_frame.size > options.memory_size ||
+            1U + std::size_t{data.num_input_identifiers} + data.num_output_identifiers > options.memory_size ||
+            !fits_native_stack(data, options))
+            return NativeAssemblerErrorCode::memory_overflow;
+
+        LoweringContext<Writer> ctx{.data = data, .writer = writer, .options = options};
+
+        for (const auto immediate : data.immediate_values) {
+            ctx.immediate_constants.push_back(writer.add_constant(immediate));
+        }
+        ctx.one = writer.add_constant(1.0);
+        ctx.magnitude_mask = writer.add_constant(std::uint64_t{0x7FFF'FFFF'FFFF'FFFFU});
+        for (auto* label : {&ctx.halt, &ctx.exit, &ctx.error}) {
+            *label = writer.make_label();
+        }
+        for (auto* label :
+             {&ctx.divide_by_zero, &ctx.invalid_operand, &ctx.stack_overflow, &ctx.stack_underflow, &ctx.memory_overflow}) {
+            *label = writer.make_label();
+        }
+        std::generate_n(std::back_inserter(ctx.frame_labels), data.call_frames.size(), [&] { return writer.make_label(); });
+        ctx.math = MathRoutines{.pow = writer.make_label(), .tgamma = writer.make_label()};
+
+        //The global frame comes first, so the entry point is at the start of the code
+        writer.global(entry_point_name(options.instruction_set));
+        std::int32_t global_outgoing_bytes{};
+        for (ctx.frame_index = 0U; ctx.frame_index != data.call_frames.size(); ++ctx.frame_index) {
+            emit_call_frame(ctx, data.call_frames[ctx.frame_index]);
+            if (ctx.error_code != NativeAssemblerErrorCode::ok)
+                return ctx.error_code;
+            if (ctx.frame_index == 0U)
+                global_outgoing_bytes = ctx.outgoing_bytes;
+        }
+        emit_epilogue(ctx, global_outgoing_bytes);
+
+        //the batch code only needs the scalar routines for calls the scalar code makes as well
+        if (ctx.uses_pow)
+            emit_scalar_pow(writer, ctx.math.pow);
+        if (ctx.uses_tgamma)
+            emit_scalar_tgamma(writer, ctx.math.tgamma);
+
+        return lower_batch(data, writer, options, ctx.frame_labels.front(), ctx.math);
+    }
+
+    template NativeAssemblerErrorCode lower<Encoder>(const VM::VMData&, Encoder&, const LoweringOptions&) noexcept;
+    template NativeAssemblerErrorCode lower<NasmWriter>(const VM::VMData&, NasmWriter&, const LoweringOptions&) noexcept;
+
+} // namespace RaychelScript::NativeAssembler::X86_64
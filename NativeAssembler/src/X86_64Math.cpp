@@ -0,0 +1,933 @@
+/**
+* \file X86_64Math.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the math routines of the x86-64 backends
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/X86_64Math.h"
+
+#include "RaychelCore/Raychel_assert.h"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        constexpr auto x = XMMRegister::xmm0;
+        constexpr auto y = XMMRegister::xmm1;
+        constexpr auto t0 = XMMRegister::xmm8;
+        constexpr auto t1 = XMMRegister::xmm9;
+        constexpr auto t2 = XMMRegister::xmm10;
+        constexpr auto t3 = XMMRegister::xmm11;
+        constexpr auto t4 = XMMRegister::xmm12;
+        constexpr auto t5 = XMMRegister::xmm13;
+        constexpr auto t6 = XMMRegister::xmm14;
+        //holds constants for the instructions that can't take them from memory
+        constexpr auto constant_register = XMMRegister::xmm15;
+
+        //adding and subtracting this rounds a double below 2^51 to an integer, which then sits in the low bits of the sum
+        constexpr double magic = 0x1.8p52;
+        constexpr std::uint64_t magic_bits = std::bit_cast<std::uint64_t>(magic);
+        //exponent of a double with a biased exponent of 1023 + k, if its low bits hold k
+        constexpr std::uint64_t exponent_from_magic = 1023U - magic_bits;
+        //subtracting this from a double with magic_bits plus a biased exponent in its low bits gives the unbiased exponent
+        constexpr double exponent_bias = magic + 1023.0;
+
+        constexpr std::uint64_t sign_bit = 0x8000'0000'0000'0000U;
+        constexpr std::uint64_t magnitude_mask = 0x7FFF'FFFF'FFFF'FFFFU;
+        constexpr std::uint64_t mantissa_mask = 0x000F'FFFF'FFFF'FFFFU;
+        //clears the low word, which leaves 21 significant bits. The product of two such doubles is exact
+        constexpr std::uint64_t high_word_mask = 0xFFFF'FFFF'0000'0000U;
+
+        constexpr double ln2_hi = 6.93147180369123816490e-01;
+        constexpr double ln2_lo = 1.90821492927058770002e-10;
+        constexpr double inverse_ln2 = 1.44269504088896338700e+00;
+
+        //ln(2) and 2 / (3 * ln(2)) split into a short high part and the rest, for the extended precision pow
+        constexpr double ln2 = 6.93147180559945286227e-01;
+        constexpr double ln2_short = 6.93147182464599609375e-01;
+        constexpr double ln2_short_lo = -1.90465429995776804525e-09;
+        constexpr double log2_factor = 9.61796693925975554329e-01;
+        constexpr double log2_factor_short = 9.61796700954437255859e-01;
+        constexpr double log2_factor_short_lo = -7.02846165095275826516e-09;
+
+        constexpr std::array exp_coefficients{
+            1.66666666666666019037e-01,
+            -2.77777777770155933842e-03,
+            6.61375632143793436117e-05,
+            -1.65339022054652515390e-06,
+            4.13813679705723846039e-08,
+        };
+
+        constexpr std::array log_coefficients{
+            6.666666666666735130e-01,
+            3.999999999940941908e-01,
+            2.857142874366239149e-01,
+            2.222219843214978396e-01,
+            1.818357216161805012e-01,
+            1.531383769920937332e-01,
+            1.479819860511658591e-01,
+        };
+
+        //3 / (2n + 5): Taylor coefficients of 3 / 2 * ln((1 + s) / (1 - s)) = 3s + s^3 + s^5 * (3 / 5 + 3 / 7 * s^2 + ...)
+        constexpr std::array log2_coefficients{
+            3.0 / 5.0,
+            3.0 / 7.0,
+            3.0 / 9.0,
+            3.0 / 11.0,
+            3.0 / 13.0,
+            3.0 / 15.0,
+            3.0 / 17.0,
+            3.0 / 19.0,
+            3.0 / 21.0,
+            3.0 / 23.0,
+        };
+
+        //Lanczos coefficients for g = 7
+        constexpr std::array lanczos_coefficients{
+            0.99999999999980993,
+            676.5203681218851,
+            -1259.1392167224028,
+            771.32342877765313,
+            -176.61502916214059,
+            12.507343278686905,
+            -0.13857109526572012,
+            9.9843695780195716e-6,
+            1.5056327351493116e-7,
+        };
+        constexpr double lanczos_g = 7.0;
+        constexpr double sqrt_two_pi = 2.5066282746310002;
+
+        //tgamma(x) overflows above this and underflows to zero below the negative one
+        constexpr double tgamma_overflow = 171.625;
+        constexpr double tgamma_underflow = -184.0;
+
+        /*
+        The operations log and exp are written in. They have three operands, like the AVX instructions, and take constants by
+        value. The scalar ones have to copy the first operand into the destination first, so the destination may only be the
+        second operand if it is the first one as well.
+        */
+        template <typename Writer>
+        class ScalarOperations
+        {
+        public:
+            explicit ScalarOperations(Writer& writer) noexcept : w_{writer}
+            {}
+
+            void move(XMMRegister destination, XMMRegister source) noexcept
+            {
+                if (destination != source)
+                    w_.movapd(destination, source);
+            }
+
+            template <typename T>
+            void constant(XMMRegister destination, T value) noexcept
+            {
+                w_.movsd(destination, Address::constant(w_.add_constant(value)));
+            }
+
+            template <typename Rhs>
+            void add(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                _commutative(destination, lhs, rhs, [this](auto dst, auto src) { w_.addsd(dst, src); });
+            }
+
+            template <typename Rhs>
+            void sub(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                _prepare(destination, lhs, rhs);
+                w_.subsd(destination, _operand(rhs));
+            }
+
+            template <typename Rhs>
+            void mul(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                _commutative(destination, lhs, rhs, [this](auto dst, auto src) { w_.mulsd(dst, src); });
+            }
+
+            template <typename Rhs>
+            void div(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                _prepare(destination, lhs, rhs);
+                w_.divsd(destination, _operand(rhs));
+            }
+
+            //destination = lhs < rhs ? lhs : rhs, so rhs wins if either is NaN
+            void min(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+            {
+                _prepare(destination, lhs, rhs);
+                w_.minsd(destination, rhs);
+            }
+
+            //destination = lhs > rhs ? lhs : rhs
+            void max(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+            {
+                _prepare(destination, lhs, rhs);
+                w_.maxsd(destination, rhs);
+            }
+
+            void sqrt(XMMRegister destination, XMMRegister source) noexcept
+            {
+                w_.sqrtsd(destination, source);
+            }
+
+            void bitwise_and(XMMRegister destination, XMMRegister lhs, std::uint64_t mask) noexcept
+            {
+                constant(constant_register, mask);
+                move(destination, lhs);
+                w_.andpd(destination, constant_register);
+            }
+
+            //integer addition of the bit patterns
+            void add_bits(XMMRegister destination, XMMRegister lhs, std::uint64_t bits) noexcept
+            {
+                constant(constant_register, bits);
+                move(destination, lhs);
+                w_.paddq(destination, constant_register);
+            }
+
+            void shift_left(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+            {
+                move(destination, source);
+                w_.psllq(destination, bits);
+            }
+
+            void shift_right(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+            {
+                move(destination, source);
+                w_.psrlq(destination, bits);
+            }
+
+        private:
+            void _prepare(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+            {
+                RAYCHEL_ASSERT(destination != rhs || destination == lhs);
+                move(destination, lhs);
+            }
+
+            void _prepare(XMMRegister destination, XMMRegister lhs, double /*rhs*/) noexcept
+            {
+                move(destination, lhs);
+            }
+
+            XMMRegister _operand(XMMRegister rhs) noexcept
+            {
+                return rhs;
+            }
+
+            Address _operand(double rhs) noexcept
+            {
+                return Address::constant(w_.add_constant(rhs));
+            }
+
+            template <typename Rhs, typename F>
+            void _commutative(XMMRegister destination, XMMRegister lhs, Rhs rhs, F&& f) noexcept
+            {
+                if constexpr (std::is_same_v<Rhs, XMMRegister>) {
+                    if (destination == rhs)
+                        std::swap(lhs, rhs);
+                }
+                move(destination, lhs);
+                std::forward<F>(f)(destination, _operand(rhs));
+            }
+
+            Writer& w_;
+        };
+
+        //The same operations on every lane with AVX instructions. Constants are broadcast into the constant register first
+        template <typename Writer>
+        class VectorOperations
+        {
+        public:
+            explicit VectorOperations(Writer& writer) noexcept : w_{writer}
+            {}
+
+            void move(XMMRegister destination, XMMRegister source) noexcept
+            {
+                if (destination != source)
+                    w_.vmovapd(destination, source);
+            }
+
+            template <typename T>
+            void constant(XMMRegister destination, T value) noexcept
+            {
+                w_.vbroadcastsd(destination, Address::constant(w_.add_constant(value)));
+            }
+
+            template <typename Rhs>
+            void add(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                w_.vaddpd(destination, lhs, _operand(rhs));
+            }
+
+            template <typename Rhs>
+            void sub(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                w_.vsubpd(destination, lhs, _operand(rhs));
+            }
+
+            template <typename Rhs>
+            void mul(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                w_.vmulpd(destination, lhs, _operand(rhs));
+            }
+
+            template <typename Rhs>
+            void div(XMMRegister destination, XMMRegister lhs, Rhs rhs) noexcept
+            {
+                w_.vdivpd(destination, lhs, _operand(rhs));
+            }
+
+            void min(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+            {
+                w_.vminpd(destination, lhs, rhs);
+            }
+
+            void max(XMMRegister destination, XMMRegister lhs, XMMRegister rhs) noexcept
+            {
+                w_.vmaxpd(destination, lhs, rhs);
+            }
+
+            void sqrt(XMMRegister destination, XMMRegister source) noexcept
+            {
+                w_.vsqrtpd(destination, source);
+            }
+
+            void bitwise_and(XMMRegister destination, XMMRegister lhs, std::uint64_t mask) noexcept
+            {
+                constant(constant_register, mask);
+                w_.vandpd(destination, lhs, constant_register);
+            }
+
+            void add_bits(XMMRegister destination, XMMRegister lhs, std::uint64_t bits) noexcept
+            {
+                constant(constant_register, bits);
+                w_.vpaddq(destination, lhs, constant_register);
+            }
+
+            void shift_left(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+            {
+                w_.vpsllq(destination, source, bits);
+            }
+
+            void shift_right(XMMRegister destination, XMMRegister source, std::uint8_t bits) noexcept
+            {
+                w_.vpsrlq(destination, source, bits);
+            }
+
+        private:
+            XMMRegister _operand(XMMRegister rhs) noexcept
+            {
+                return rhs;
+            }
+
+            XMMRegister _operand(double rhs) noexcept
+            {
+                constant(constant_register, rhs);
+                return constant_register;
+            }
+
+            Writer& w_;
+        };
+
+        //result = base^chain. Used by both the scalar and the vector version
+        template <typename Operations>
+        void emit_power_chain(Operations& ops, PowerChain chain, XMMRegister result, XMMRegister base, XMMRegister zero) noexcept
+        {
+            bool have_result{false};
+            if (chain.square_root) {
+                //pow(-0, n + 0.5) is +0 or +inf, but sqrt(-0) is -0 and so is (-0)^n for odd n. Adding +0 turns -0 into +0
+                ops.add(base, base, zero);
+                ops.sqrt(result, base);
+                have_result = true;
+            }
+            for (auto power = chain.power; power != 0U; power >>= 1U) {
+                if ((power & 1U) != 0U) {
+                    if (have_result) {
+                        ops.mul(result, result, base);
+                    } else {
+                        ops.move(result, base);
+                    }
+                    have_result = true;
+                }
+                if (power > 1U)
+                    ops.mul(base, base, base);
+            }
+            if (!have_result)
+                ops.constant(result, 1.0);
+            if (chain.reciprocal) {
+                ops.constant(base, 1.0);
+                ops.div(base, base, result);
+                ops.move(result, base);
+            }
+        }
+
+        /*
+        x = log(x) for positive normal x. t6 holds the exponent bias on entry, which is larger for arguments that have been
+        scaled up from subnormals. Clobbers t0 to t6 and the constant register.
+        */
+        template <typename Operations>
+        void emit_log(Operations& ops) noexcept
+        {
+            //x = 2^k * m with m in [sqrt(2)/2, sqrt(2)). Adding this to the bits moves mantissas above sqrt(2) to the next
+            //exponent
+            ops.add_bits(t0, x, 0x0009'5F62'0000'0000U);
+            ops.shift_right(t1, t0, 52U);
+            ops.add_bits(t1, t1, magic_bits);
+            ops.sub(t1, t1, t6); //k
+            ops.bitwise_and(t0, t0, mantissa_mask);
+            ops.add_bits(t0, t0, 0x3FE6'A09E'0000'0000U); //m
+            ops.sub(t0, t0, 1.0); //f
+
+            ops.mul(t2, t0, 0.5);
+            ops.mul(t2, t2, t0); //f^2 / 2
+            ops.add(t4, t0, 2.0);
+            ops.div(t3, t0, t4); //s = f / (2 + f)
+            ops.mul(t4, t3, t3); //z = s^2
+            ops.mul(t5, t4, t4); //w = s^4
+
+            ops.mul(t6, t5, log_coefficients[5]);
+            ops.add(t6, t6, log_coefficients[3]);
+            ops.mul(t6, t6, t5);
+            ops.add(t6, t6, log_coefficients[1]);
+            ops.mul(t6, t6, t5);
+
+            ops.mul(x, t5, log_coefficients[6]);
+            ops.add(x, x, log_coefficients[4]);
+            ops.mul(x, x, t5);
+            ops.add(x, x, log_coefficients[2]);
+            ops.mul(x, x, t5);
+            ops.add(x, x, log_coefficients[0]);
+            ops.mul(x, x, t4);
+            ops.add(x, t6, x); //R
+
+            //k * ln2_hi - ((f^2 / 2 - (s * (f^2 / 2 + R) + k * ln2_lo)) - f)
+            ops.add(x, t2, x);
+            ops.mul(x, t3, x);
+            ops.mul(t6, t1, ln2_lo);
+            ops.add(t6, x, t6);
+            ops.sub(x, t2, t6);
+            ops.sub(x, x, t0);
+            ops.mul(t2, t1, ln2_hi);
+            ops.sub(t2, t2, x);
+            ops.move(x, t2);
+        }
+
+        //x = x * 2^k for an integer k in [-2000, 2000] held in t1. Clobbers t2 to t4 and the constant register
+        template <typename Operations>
+        void emit_scale(Operations& ops) noexcept
+        {
+            //2^k is not always a normal number, so it is applied as 2^k1 * 2^k2 with the final multiplication rounding once
+            ops.mul(t2, t1, 0.5);
+            ops.add(t2, t2, magic);
+            ops.sub(t3, t2, magic); //k1
+            ops.sub(t4, t1, t3);
+            ops.add(t4, t4, magic); //k2
+            ops.add_bits(t2, t2, exponent_from_magic);
+            ops.shift_left(t2, t2, 52U);
+            ops.add_bits(t4, t4, exponent_from_magic);
+            ops.shift_left(t4, t4, 52U);
+            ops.mul(x, x, t2);
+            ops.mul(x, x, t4);
+        }
+
+        //x = exp(x) for any x but NaN. Clobbers t0 to t6 and the constant register
+        template <typename Operations>
+        void emit_exp(Operations& ops) noexcept
+        {
+            //exp overflows above 709.8 and underflows below -745.2. The clamped arguments still do, but keep k in range
+            ops.constant(t0, 710.0);
+            ops.min(t0, t0, x);
+            ops.constant(x, -746.0);
+            ops.max(x, x, t0);
+
+            //x = k * ln(2) + r with r in [-ln(2)/2, ln(2)/2]. r is represented as hi - lo
+            ops.mul(t0, x, inverse_ln2);
+            ops.add(t0, t0, magic);
+            ops.sub(t1, t0, magic); //k
+            ops.mul(t2, t1, ln2_hi);
+            ops.sub(x, x, t2); //hi
+            ops.mul(t3, t1, ln2_lo); //lo
+            ops.sub(t4, x, t3); //r
+
+            ops.mul(t5, t4, t4);
+            ops.mul(t6, t5, exp_coefficients[4]);
+            for (auto i = exp_coefficients.size() - 1U; i-- != 0U;) {
+                ops.add(t6, t6, exp_coefficients[i]);
+                ops.mul(t6, t6, t5);
+            }
+            ops.sub(t2, t4, t6); //c
+
+            //exp(r) = 1 - ((lo - r * c / (2 - c)) - hi)
+            ops.mul(t5, t4, t2);
+            ops.constant(t6, 2.0);
+            ops.sub(t6, t6, t2);
+            ops.div(t5, t5, t6);
+            ops.sub(t6, t3, t5);
+            ops.sub(t6, t6, x);
+            ops.constant(x, 1.0);
+            ops.sub(x, x, t6);
+
+            emit_scale(ops);
+        }
+
+        /*
+        x = x^y for positive normal x and y that is not NaN, after fdlibm's pow. t6 holds the exponent bias on entry, like for
+        emit_log. log2(x) and y * log2(x) are carried as a sum of a short high part and a low part, which keeps the result
+        within 1 ulp and makes it exact for integer powers that are representable. Clobbers y, t0 to t6 and the constant
+        register
+        */
+        template <typename Operations>
+        void emit_pow(Operations& ops) noexcept
+        {
+            //x = 2^k * m with m in [sqrt(2)/2, sqrt(2)), like in emit_log
+            ops.add_bits(t0, x, 0x0009'5F62'0000'0000U);
+            ops.shift_right(t1, t0, 52U);
+            ops.add_bits(t1, t1, magic_bits);
+            ops.sub(t1, t1, t6); //k
+            ops.bitwise_and(t0, t0, mantissa_mask);
+            ops.add_bits(t0, t0, 0x3FE6'A09E'0000'0000U); //m
+
+            //s = (m - 1) / (m + 1) = s_h + s_l
+            ops.sub(t2, t0, 1.0);
+            ops.add(t3, t0, 1.0);
+            ops.div(t4, t2, t3); //s
+            ops.bitwise_and(t5, t4, high_word_mask); //s_h
+            ops.bitwise_and(t6, t3, high_word_mask);
+            ops.sub(x, t6, 1.0);
+            ops.sub(t0, t0, x); //m + 1 - high part of it, exactly
+            ops.mul(t6, t5, t6);
+            ops.sub(x, t2, t6);
+            ops.mul(t2, t5, t0);
+            ops.sub(x, x, t2);
+            ops.div(x, x, t3); //s_l
+
+            //r = s^4 * (3 / 5 + 3 / 7 * s^2 + ...) + s_l * (s_h + s)
+            ops.mul(t0, t4, t4);
+            ops.mul(t2, t0, log2_coefficients.back());
+            for (auto i = log2_coefficients.size() - 1U; i-- != 0U;) {
+                ops.add(t2, t2, log2_coefficients[i]);
+                ops.mul(t2, t2, t0);
+            }
+            ops.mul(t2, t2, t0);
+            ops.add(t3, t5, t4);
+            ops.mul(t3, x, t3);
+            ops.add(t2, t2, t3); //r
+
+            //3 / 2 * ln(m) = s * (3 + s^2 + r) = p_h + p_l
+            ops.mul(t0, t5, t5);
+            ops.add(t3, t0, 3.0);
+            ops.add(t3, t3, t2);
+            ops.bitwise_and(t3, t3, high_word_mask); //t_h
+            ops.sub(t6, t3, 3.0);
+            ops.sub(t6, t6, t0);
+            ops.sub(t2, t2, t6); //t_l
+            ops.mul(t0, t5, t3); //u = s_h * t_h
+            ops.mul(t3, x, t3);
+            ops.mul(t2, t2, t4);
+            ops.add(t2, t3, t2); //v = s_l * t_h + t_l * s
+            ops.add(t3, t0, t2);
+            ops.bitwise_and(t3, t3, high_word_mask); //p_h
+            ops.sub(t4, t3, t0);
+            ops.sub(t2, t2, t4); //p_l
+
+            //log2(x) = k + p * 2 / (3 * ln(2)) = x + t0
+            ops.mul(t0, t3, log2_factor_short);
+            ops.mul(t3, t3, log2_factor_short_lo);
+            ops.mul(t2, t2, log2_factor);
+            ops.add(t2, t3, t2);
+            ops.add(x, t0, t2);
+            ops.add(x, x, t1);
+            ops.bitwise_and(x, x, high_word_mask);
+            ops.sub(t3, x, t1);
+            ops.sub(t3, t3, t0);
+            ops.sub(t0, t2, t3);
+
+            //y * log2(x) = x + t0 with a short x again
+            ops.bitwise_and(t1, y, high_word_mask);
+            ops.sub(t2, y, t1);
+            ops.mul(t2, t2, x);
+            ops.mul(t3, y, t0);
+            ops.add(t0, t2, t3);
+            ops.mul(x, t1, x);
+
+            //2^x overflows from 1024 on and underflows below -1075. The clamped sum still does, but keeps k in range. The low
+            //part is far below 1 unless the high part was clamped, and NaN for infinite y, where the high part decides alone
+            ops.constant(t1, 1100.0);
+            ops.min(x, x, t1);
+            ops.constant(t1, -1100.0);
+            ops.max(x, x, t1);
+            ops.constant(t1, 1.0);
+            ops.min(t0, t0, t1);
+            ops.constant(t1, -1.0);
+            ops.max(t0, t0, t1);
+
+            //x + t0 = k + z with z in [-1/2, 1/2], where z * ln(2) = z_h + z_l
+            ops.add(t1, x, magic);
+            ops.sub(t1, t1, magic); //k
+            ops.sub(x, x, t1);
+            ops.add(t2, t0, x);
+            ops.bitwise_and(t2, t2, high_word_mask);
+            ops.mul(t3, t2, ln2_short);
+            ops.sub(t4, t2, x);
+            ops.sub(t0, t0, t4);
+            ops.mul(t0, t0, ln2);
+            ops.mul(t4, t2, ln2_short_lo);
+            ops.add(t0, t0, t4);
+            ops.add(x, t3, t0); //z_h
+            ops.sub(t4, x, t3);
+            ops.sub(t0, t0, t4); //z_l
+
+            //exp(z_h + z_l) = 1 - ((z_h * c / (c - 2) - (z_l + z_h * z_l)) - z_h), like in emit_exp
+            ops.mul(t2, x, x);
+            ops.mul(t3, t2, exp_coefficients[4]);
+            for (auto i = exp_coefficients.size() - 1U; i-- != 0U;) {
+                ops.add(t3, t3, exp_coefficients[i]);
+                ops.mul(t3, t3, t2);
+            }
+            ops.sub(t2, x, t3); //c
+            ops.mul(t4, x, t2);
+            ops.sub(t3, t2, 2.0);
+            ops.div(t4, t4, t3);
+            ops.mul(t5, x, t0);
+            ops.add(t5, t0, t5);
+            ops.sub(t4, t4, t5);
+            ops.sub(t4, t4, x);
+            ops.constant(x, 1.0);
+            ops.sub(x, x, t4);
+
+            emit_scale(ops);
+        }
+
+    } // namespace
+
+    std::optional<PowerChain> power_chain(double exponent) noexcept
+    {
+        const auto twice = 2.0 * std::abs(exponent);
+        //this also rejects NaN
+        if (!(twice <= 2.0 * max_power_chain_exponent) || twice != std::floor(twice))
+            return std::nullopt;
+        const auto half_powers = static_cast<std::uint32_t>(twice);
+        return PowerChain{.power = half_powers / 2U, .square_root = (half_powers % 2U) != 0U, .reciprocal = exponent < 0.0};
+    }
+
+    std::optional<PowerChain> power_chain(const VM::VMData& data, Assembly::MemoryIndex exponent) noexcept
+    {
+        if (exponent.type() != Assembly::MemoryIndex::ValueType::immediate || exponent.value() >= data.immediate_values.size())
+            return std::nullopt;
+        return power_chain(data.immediate_values[exponent.value()]);
+    }
+
+    template <typename Writer>
+    void emit_scalar_power_chain(Writer& writer, PowerChain chain, XMMRegister result, XMMRegister base) noexcept
+    {
+        ScalarOperations ops{writer};
+        if (chain.square_root)
+            writer.xorpd(result, result);
+        emit_power_chain(ops, chain, result, base, result);
+    }
+
+    template <typename Writer>
+    void emit_vector_power_chain(Writer& writer, PowerChain chain, XMMRegister result, XMMRegister base) noexcept
+    {
+        VectorOperations ops{writer};
+        if (chain.square_root)
+            writer.vxorpd(result, result, result);
+        emit_power_chain(ops, chain, result, base, result);
+    }
+
+    template <typename Writer>
+    void emit_scalar_pow(Writer& writer, Label entry) noexcept
+    {
+        auto& w = writer;
+        ScalarOperations ops{writer};
+        const auto constant = [&](auto value) { return Address::constant(w.add_constant(value)); };
+
+        const auto y_is_not_zero = w.make_label();
+        const auto x_is_not_one = w.make_label();
+        const auto integer = w.make_label();
+        const auto classified = w.make_label();
+        const auto not_negative = w.make_label();
+        const auto normal = w.make_label();
+        const auto apply_sign = w.make_label();
+        const auto zero = w.make_label();
+        const auto infinite = w.make_label();
+        const auto return_one = w.make_label();
+        const auto return_sum = w.make_label();
+        const auto return_nan = w.make_label();
+
+        w.bind(entry);
+        //pow(x, 0) is 1 and so is pow(1, y), even if the other argument is NaN
+        w.xorpd(t0, t0);
+        w.ucomisd(y, t0);
+        w.jcc(Condition::parity, y_is_not_zero);
+        w.jcc(Condition::equal, return_one);
+        w.bind(y_is_not_zero);
+        w.ucomisd(x, constant(1.0));
+        w.jcc(Condition::parity, x_is_not_one);
+        w.jcc(Condition::equal, return_one);
+        w.bind(x_is_not_one);
+        w.ucomisd(x, y);
+        w.jcc(Condition::parity, return_sum);
+
+        //t1 = the sign bit if y is an odd integer, t2 = nonzero if y is not an integer. Doubles from 2^53 on are even integers
+        ops.bitwise_and(t0, y, magnitude_mask);
+        w.xorpd(t1, t1);
+        w.xorpd(t2, t2);
+        w.ucomisd(t0, constant(0x1p53));
+        w.jcc(Condition::above_or_equal, classified);
+        w.ucomisd(t0, constant(0x1p52));
+        w.jcc(Condition::above_or_equal, integer);
+        ops.add(t3, t0, 0x1p52);
+        ops.sub(t3, t3, 0x1p52);
+        w.ucomisd(t3, t0);
+        w.jcc(Condition::equal, integer);
+        ops.constant(t2, 1.0);
+        w.jmp(classified);
+        w.bind(integer);
+        ops.mul(t3, t0, 0.5);
+        ops.add(t4, t3, 0x1p52);
+        ops.sub(t4, t4, 0x1p52);
+        w.ucomisd(t4, t3);
+        w.jcc(Condition::equal, classified);
+        ops.constant(t1, sign_bit);
+        w.bind(classified);
+
+        //the result is negative if x is and y is an odd integer. Finite negative x with non-integer y have no real result
+        w.andpd(t1, x);
+        w.xorpd(t0, t0);
+        w.ucomisd(x, t0);
+        w.jcc(Condition::above_or_equal, not_negative);
+        w.ucomisd(x, constant(-std::numeric_limits<double>::infinity()));
+        w.jcc(Condition::equal, not_negative);
+        w.ucomisd(t2, t0);
+        w.jcc(Condition::not_equal, return_nan);
+        w.bind(not_negative);
+
+        ops.bitwise_and(x, x, magnitude_mask);
+        w.ucomisd(x, constant(1.0));
+        w.jcc(Condition::equal, apply_sign);
+        w.ucomisd(x, t0);
+        w.jcc(Condition::equal, zero);
+        w.ucomisd(x, constant(std::numeric_limits<double>::infinity()));
+        w.jcc(Condition::equal, infinite);
+        ops.constant(t6, exponent_bias);
+        w.ucomisd(x, constant(0x1p-1022));
+        w.jcc(Condition::above_or_equal, normal);
+        //subnormals are scaled into the normal range first
+        ops.mul(x, x, 0x1p54);
+        ops.constant(t6, exponent_bias + 54.0);
+        w.bind(normal);
+
+        w.sub(Register::rsp, 8);
+        w.movsd(Address::at(Register::rsp), t1);
+        emit_pow(ops);
+        w.movsd(t1, Address::at(Register::rsp));
+        w.add(Register::rsp, 8);
+
+        w.bind(apply_sign);
+        w.xorpd(x, t1);
+        w.ret();
+
+        //x is +0 or +inf here. Only the sign of y matters
+        w.bind(zero);
+        w.ucomisd(y, t0);
+        w.jcc(Condition::above, apply_sign);
+        ops.constant(x, std::numeric_limits<double>::infinity());
+        w.jmp(apply_sign);
+        w.bind(infinite);
+        w.ucomisd(y, t0);
+        w.jcc(Condition::above, apply_sign);
+        w.xorpd(x, x);
+        w.jmp(apply_sign);
+
+        w.bind(return_one);
+        ops.constant(x, 1.0);
+        w.ret();
+        w.bind(return_sum);
+        w.addsd(x, y);
+        w.ret();
+        w.bind(return_nan);
+        w.xorpd(x, x);
+        w.divsd(x, x);
+        w.ret();
+    }
+
+    template <typename Writer>
+    void emit_scalar_tgamma(Writer& writer, Label entry) noexcept
+    {
+        auto& w = writer;
+        ScalarOperations ops{writer};
+        const auto constant = [&](auto value) { return Address::constant(w.add_constant(value)); };
+        const auto saved = [](std::int32_t index) { return Address::at(Register::rsp, index * 8); };
+
+        const auto factorial_loop = w.make_label();
+        const auto factorial_done = w.make_label();
+        const auto non_integer = w.make_label();
+        const auto scaled = w.make_label();
+        const auto shift_loop = w.make_label();
+        const auto lanczos = w.make_label();
+        const auto underflow = w.make_label();
+        const auto return_argument = w.make_label();
+        const auto return_pole = w.make_label();
+        const auto return_infinity = w.make_label();
+        const auto return_nan = w.make_label();
+
+        w.bind(entry);
+        w.ucomisd(x, x);
+        w.jcc(Condition::parity, return_argument);
+        w.ucomisd(x, constant(tgamma_overflow));
+        w.jcc(Condition::above_or_equal, return_infinity);
+        //what is left from 2^52 on are -inf and negative integers
+        ops.bitwise_and(t0, x, magnitude_mask);
+        w.ucomisd(t0, constant(0x1p52));
+        w.jcc(Condition::above_or_equal, return_nan);
+        ops.add(t1, t0, 0x1p52);
+        ops.sub(t1, t1, 0x1p52);
+        w.ucomisd(t1, t0);
+        w.jcc(Condition::not_equal, non_integer);
+
+        //integers: poles at zero and the negative integers, (x - 1)! for the positive ones
+        w.xorpd(t1, t1);
+        w.ucomisd(x, t1);
+        w.jcc(Condition::below, return_nan);
+        w.jcc(Condition::equal, return_pole);
+        ops.constant(t1, 1.0);
+        ops.constant(t2, 1.0);
+        w.bind(factorial_loop);
+        w.ucomisd(t2, x);
+        w.jcc(Condition::above_or_equal, factorial_done);
+        ops.mul(t1, t1, t2);
+        ops.add(t2, t2, 1.0);
+        w.jmp(factorial_loop);
+        w.bind(factorial_done);
+        ops.move(x, t1);
+        w.ret();
+
+        //tgamma(x) = tgamma(x + n) / (x * (x + 1) * ... * (x + n - 1)). The product would overflow for very negative x, so it
+        //starts out scaled down. The scale is applied again at the very end, where the result may become subnormal
+        w.bind(non_integer);
+        w.ucomisd(x, constant(tgamma_underflow));
+        w.jcc(Condition::below, underflow);
+        w.sub(Register::rsp, 32);
+        ops.constant(t1, 1.0);
+        w.ucomisd(x, constant(-128.0));
+        w.jcc(Condition::above_or_equal, scaled);
+        ops.constant(t1, 0x1p-600);
+        w.bind(scaled);
+        w.movsd(saved(3), t1);
+        w.bind(shift_loop);
+        w.ucomisd(x, constant(0.5));
+        w.jcc(Condition::above_or_equal, lanczos);
+        ops.mul(t1, t1, x);
+        ops.add(x, x, 1.0);
+        w.jmp(shift_loop);
+
+        //tgamma(x) = sqrt(2 pi) * a * t^(x - 0.5) * e^-t with t = x + g - 0.5.
+        //The power is computed as a square so it doesn't overflow before the result does
+        w.bind(lanczos);
+        w.movsd(saved(0), x);
+        w.movsd(saved(2), t1);
+        ops.constant(t0, lanczos_coefficients[0]);
+        for (std::size_t i = 1U; i != lanczos_coefficients.size(); ++i) {
+            ops.add(t2, x, static_cast<double>(i - 1U));
+            ops.constant(t3, lanczos_coefficients[i]);
+            ops.div(t3, t3, t2);
+            ops.add(t0, t0, t3);
+        }
+        w.movsd(saved(1), t0);
+        ops.add(y, x, lanczos_g - 0.5);
+        ops.move(x, y);
+        ops.constant(t6, exponent_bias);
+        emit_log(ops);
+        w.movsd(t0, saved(0));
+        ops.sub(t0, t0, 0.5);
+        ops.mul(x, x, t0);
+        ops.sub(x, x, y);
+        ops.mul(x, x, 0.5);
+        emit_exp(ops);
+        ops.constant(t0, sqrt_two_pi);
+        w.mulsd(t0, saved(1));
+        ops.mul(t0, t0, x);
+        ops.mul(t0, t0, x);
+        w.divsd(t0, saved(2));
+        w.mulsd(t0, saved(3));
+        ops.move(x, t0);
+        w.add(Register::rsp, 32);
+        w.ret();
+
+        //zero with the sign of tgamma(x), which is negative if the integer part of |x| is even
+        w.bind(underflow);
+        ops.mul(t0, t0, 0.5);
+        ops.add(t1, t0, magic);
+        ops.sub(t1, t1, magic);
+        ops.sub(t0, t0, t1);
+        w.xorpd(x, x);
+        w.ucomisd(t0, x);
+        w.jcc(Condition::below_or_equal, return_argument);
+        ops.constant(x, -0.0);
+        w.bind(return_argument);
+        w.ret();
+
+        w.bind(return_pole);
+        ops.constant(t0, 1.0);
+        ops.div(t0, t0, x);
+        ops.move(x, t0);
+        w.ret();
+        w.bind(return_infinity);
+        ops.constant(x, std::numeric_limits<double>::infinity());
+        w.ret();
+        w.bind(return_nan);
+        w.xorpd(x, x);
+        w.divsd(x, x);
+        w.ret();
+    }
+
+    template <typename Writer>
+    void emit_vector_pow(Writer& writer, Label entry) noexcept
+    {
+        VectorOperations ops{writer};
+        writer.bind(entry);
+        ops.constant(t6, exponent_bias);
+        emit_pow(ops);
+        writer.ret();
+    }
+
+    template void emit_scalar_power_chain<Encoder>(Encoder&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    template void emit_scalar_power_chain<NasmWriter>(NasmWriter&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    template void emit_vector_power_chain<Encoder>(Encoder&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    template void emit_vector_power_chain<NasmWriter>(NasmWriter&, PowerChain, XMMRegister, XMMRegister) noexcept;
+    template void emit_scalar_pow<Encoder>(Encoder&, Label) noexcept;
+    template void emit_scalar_pow<NasmWriter>(NasmWriter&, Label) noexcept;
+    template void emit_scalar_tgamma<Encoder>(Encoder&, Label) noexcept;
+    template void emit_scalar_tgamma<NasmWriter>(NasmWriter&, Label) noexcept;
+    template void emit_vector_pow<Encoder>(Encoder&, Label) noexcept;
+    template void emit_vector_pow<NasmWriter>(NasmWriter&, Label) noexcept;
+
+} // namespace RaychelScript::NativeAssembler::X86_64
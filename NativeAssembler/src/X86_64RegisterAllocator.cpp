@@ -0,0 +1,362 @@
+/**
+* \file X86_64RegisterAllocator.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the linear-scan register allocator of the x86-64 lowering
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "NativeAssembler/X86_64RegisterAllocator.h"
+#include "NativeAssembler/X86_64Math.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace RaychelScript::NativeAssembler::X86_64 {
+
+    namespace {
+
+        using Assembly::Instruction;
+        using Assembly::MemoryIndex;
+        using Assembly::OpCode;
+
+        //xmm0 and xmm1 are scratch registers of the lowering and carry the arguments and results of calls.
+        //The math routines clobber the registers from xmm8 on, so they are handed out last
+        constexpr std::array allocatable_registers{
+            XMMRegister::xmm2,
+            XMMRegister::xmm3,
+            XMMRegister::xmm4,
+            XMMRegister::xmm5,
+            XMMRegister::xmm6,
+            XMMRegister::xmm7,
+            XMMRegister::xmm8,
+            XMMRegister::xmm9,
+            XMMRegister::xmm10,
+            XMMRegister::xmm11,
+            XMMRegister::xmm12,
+            XMMRegister::xmm13,
+            XMMRegister::xmm14,
+            XMMRegister::xmm15,
+        };
+
+        struct InstructionEffects
+        {
+            SlotSet uses{};
+            SlotSet defs{};
+            //the index one past the last instruction stands for running off the end of the frame
+            std::array<std::optional<std::size_t>, 2> successors{};
+            bool calls{false};
+        };
+
+        struct Interval
+        {
+            std::size_t slot;
+            std::size_t start;
+            std::size_t end;
+            //number of instructions that read or write the slot
+            std::size_t references;
+
+            //references per instruction the interval covers. Cheap intervals are kept in memory first
+            [[nodiscard]] double spill_cost() const noexcept
+            {
+                return static_cast<double>(references) / static_cast<double>(end - start + 1U);
+            }
+        };
+
+        struct FrameInfo
+        {
+            //number of slots that are tracked, see number_of_tracked_slots
+            std::size_t frame_size;
+            std::size_t number_of_instructions;
+            bool is_global_frame;
+            //the outputs are read when the script halts. Every call might halt, too
+            SlotSet outputs;
+        };
+
+        bool is_location(MemoryIndex index, const FrameInfo& info) noexcept
+        {
+            using enum MemoryIndex::ValueType;
+            return (index.type() == stack || index.type() == intermediate) && index.value() < info.frame_size;
+        }
+
+        std::optional<std::size_t> jump_target(MemoryIndex offset, std::size_t index, const FrameInfo& info) noexcept
+        {
+            const auto target = static_cast<std::ptrdiff_t>(index) + static_cast<std::ptrdiff_t>(offset.offset());
+            if (offset.type() != MemoryIndex::ValueType::jump_offset || target < 0 ||
+                std::cmp_greater_equal(target, info.number_of_instructions)) {
+                return std::nullopt;
+            }
+            return static_cast<std::size_t>(target);
+        }
+
+        InstructionEffects
+        effects_of(const VM::VMData& data, const Instruction& instruction, std::size_t index, const FrameInfo& info) noexcept
+        {
+            InstructionEffects effects{.successors = {index + 1U, std::nullopt}};
+            const auto use = [&](MemoryIndex location) {
+                if (is_location(location, info))
+                    effects.uses.set(location.value());
+            };
+            const auto def = [&](MemoryIndex location) {
+                if (is_location(location, info))
+                    effects.defs.set(location.value());
+            };
+            const auto a = instruction.index1();
+            const auto b = instruction.index2();
+            const auto c = instruction.index3();
+
+            switch (instruction.op_code()) {
+                case OpCode::mov:
+                    use(a);
+                    def(b);
+                    break;
+                case OpCode::add:
+                case OpCode::sub:
+                case OpCode::mul:
+                case OpCode::div:
+                    use(a);
+                    use(b);
+                    effects.defs.set(0U);
+                    break;
+                case OpCode::pow:
+                    use(a);
+                    use(b);
+                    effects.defs.set(0U);
+                    //constant powers are multiplied out in xmm0 and xmm1
+                    effects.calls = !power_chain(data, b).has_value();
+                    break;
+                case OpCode::mag:
+                    use(a);
+                    effects.defs.set(0U);
+                    break;
+                case OpCode::fac:
+                    use(a);
+                    effects.defs.set(0U);
+                    effects.calls = true;
+                    break;
+                case OpCode::inc:
+                case OpCode::dec:
+                case OpCode::mas:
+                case OpCode::das:
+                    use(a);
+                    use(b);
+                    def(a);
+                    break;
+                case OpCode::pas:
+                    use(a);
+                    use(b);
+                    def(a);
+                    effects.calls = !power_chain(data, b).has_value();
+                    break;
+                case OpCode::clt:
+                case OpCode::cgt:
+                case OpCode::ceq:
+                case OpCode::cne:
+                    use(a);
+                    use(b);
+                    break;
+                case OpCode::jpz:
+                    effects.successors[1] = jump_target(a, index, info);
+                    break;
+                case OpCode::jmp:
+                    effects.successors = {jump_target(a, index, info), std::nullopt};
+                    break;
+                case OpCode::hlt:
+                    effects.uses = info.outputs;
+                    effects.successors = {};
+                    break;
+                case OpCode::jsr:
+                    effects.uses = info.outputs;
+                    effects.defs.set(0U);
+                    effects.calls = true;
+                    break;
+                case OpCode::ret:
+                    effects.uses.set(0U);
+                    effects.successors = {};
+                    break;
+                case OpCode::put:
+                    use(a);
+                    break;
+                case OpCode::jnl:
+                case OpCode::jng:
+                case OpCode::jne:
+                case OpCode::jeq:
+                    use(a);
+                    use(b);
+                    effects.successors[1] = jump_target(c, index, info);
+                    break;
+                case OpCode::mad:
+                    use(a);
+                    use(b);
+                    use(c);
+                    effects.defs.set(0U);
+                    break;
+                case OpCode::adt:
+                case OpCode::sbt:
+                case OpCode::mlt:
+                case OpCode::dvt:
+                    use(a);
+                    use(b);
+                    effects.defs.set(0U);
+                    def(c);
+                    break;
+                case OpCode::num_op_codes:
+                    break;
+            }
+            return effects;
+        }
+
+        //backwards dataflow until nothing changes. live_in has one extra entry for the end of the frame
+        std::vector<SlotSet> compute_live_in(const std::vector<InstructionEffects>& effects, const FrameInfo& info) noexcept
+        {
+            std::vector<SlotSet> live_in(effects.size() + 1U);
+            live_in.back() = info.outputs;
+
+            bool changed{true};
+            while (changed) {
+                changed = false;
+                for (auto i = effects.size(); i-- != 0U;) {
+                    SlotSet live_out{};
+                    for (const auto successor : effects[i].successors) {
+                        if (successor.has_value())
+                            live_out |= live_in[*successor];
+                    }
+                    const auto new_live_in = effects[i].uses | (live_out & ~effects[i].defs);
+                    if (new_live_in != live_in[i]) {
+                        live_in[i] = new_live_in;
+                        changed = true;
+                    }
+                }
+            }
+            return live_in;
+        }
+
+        std::vector<Interval> build_intervals(
+            const std::vector<InstructionEffects>& effects, const std::vector<SlotSet>& live_in, const FrameInfo& info) noexcept
+        {
+            std::vector<Interval> intervals{};
+            for (std::size_t slot{}; slot != info.frame_size; ++slot) {
+                std::optional<Interval> interval{};
+                std::size_t references{};
+                for (std::size_t point{}; point != live_in.size(); ++point) {
+                    const auto referenced =
+                        point < effects.size() && (effects[point].uses.test(slot) || effects[point].defs.test(slot));
+                    if (referenced)
+                        ++references;
+                    if (!live_in[point].test(slot) && !referenced)
+                        continue;
+                    if (!interval.has_value())
+                        interval = Interval{slot, point, point, 0U};
+                    interval->end = point;
+                }
+                if (interval.has_value())
+                    interval->references = references;
+                if (interval.has_value())
+                    intervals.push_back(*interval);
+            }
+            std::ranges::stable_sort(intervals, {}, &Interval::start);
+            return intervals;
+        }
+
+        void linear_scan(const std::vector<Interval>& intervals, RegisterAllocation& allocation) noexcept
+        {
+            std::vector<XMMRegister> free_registers{allocatable_registers.rbegin(), allocatable_registers.rend()};
+            std::vector<Interval> active{};
+
+            for (const auto& interval : intervals) {
+                //an interval that ended before this one started gives its register back
+                std::erase_if(active, [&](const Interval& other) {
+                    if (other.end >= interval.start)
+                        return false;
+                    free_registers.push_back(*allocation.registers[other.slot]);
+                    return true;
+                });
+
+                if (!free_registers.empty()) {
+                    allocation.registers[interval.slot] = free_registers.back();
+                    free_registers.pop_back();
+                    active.push_back(interval);
+                    continue;
+                }
+
+                //out of registers: whichever interval is used least often per instruction stays in memory
+                const auto cheapest = std::ranges::min_element(active, {}, &Interval::spill_cost);
+                if (cheapest == active.end() || cheapest->spill_cost() >= interval.spill_cost())
+                    continue;
+                allocation.registers[interval.slot] = allocation.registers[cheapest->slot];
+                allocation.registers[cheapest->slot] = std::nullopt;
+                *cheapest = interval;
+            }
+        }
+
+    } // namespace
+
+    RegisterAllocation allocate_registers(const VM::VMData& data, std::size_t frame_index) noexcept
+    {
+        const auto& frame = data.call_frames.at(frame_index);
+        FrameInfo info{
+            .frame_size = std::min<std::size_t>(frame.size, number_of_tracked_slots),
+            .number_of_instructions = frame.instructions.size(),
+            .is_global_frame = frame_index == 0U,
+            .outputs = {}};
+        if (info.is_global_frame) {
+            const auto first_output = 1U + std::size_t{data.num_input_identifiers};
+            for (auto slot = first_output; slot < first_output + data.num_output_identifiers && slot < info.frame_size; ++slot) {
+                info.outputs.set(slot);
+            }
+        }
+
+        std::vector<InstructionEffects> effects{};
+        effects.reserve(frame.instructions.size());
+        for (std::size_t i{}; i != frame.instructions.size(); ++i) {
+            effects.push_back(effects_of(data, frame.instructions[i], i, info));
+        }
+        const auto live_in = compute_live_in(effects, info);
+
+        RegisterAllocation allocation{.registers = std::vector<std::optional<XMMRegister>>(frame.size)};
+        linear_scan(build_intervals(effects, live_in, info), allocation);
+
+        SlotSet allocated{};
+        for (std::size_t slot{}; slot != info.frame_size; ++slot) {
+            allocated.set(slot, allocation.registers[slot].has_value());
+        }
+
+        allocation.live_on_entry = live_in.front() & allocated;
+        allocation.preserved.resize(effects.size());
+        for (std::size_t i{}; i != effects.size(); ++i) {
+            if (!effects[i].calls)
+                continue;
+            SlotSet live_out{};
+            for (const auto successor : effects[i].successors) {
+                if (successor.has_value())
+                    live_out |= live_in[*successor];
+            }
+            //the uses of a call are its operands and, for jsr, the outputs. Only the outputs have to be in memory, unless the
+            //instruction overwrites them anyways
+            allocation.preserved[i] = ((live_out | (effects[i].uses & info.outputs)) & ~effects[i].defs) & allocated;
+        }
+
+        return allocation;
+    }
+
+} // namespace RaychelScript::NativeAssembler::X86_64
@@ -1,11 +1,41 @@
+#include "NativeAssembler/JIT.h"
 #include "NativeAssembler/NativeAssembler.h"
 
 #include "Assembler/AssemblerPipe.h"
 #include "Lexer/LexerPipe.h"
 #include "Parser/ParserPipe.h"
+#include "VM/VM.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <string_view>
+
+//The VM's limits the compiled code has to keep as well
+constexpr std::size_t stack_size = 32U;
+constexpr std::size_t memory_size = 1'024U;
+
+//Every input runs through these values. They include negative bases, integer exponents and powers beyond the double range
+constexpr std::array input_values{-3.0, -2.0, -1.5, -0.5, 0.0, 0.5, 1.0, 2.0, 3.0, 7.0, 10.0, 16.0, 1023.0, 1024.0, -1075.0, 2.5};
+
+/*
+Native math routines are not rounded the same way as the C library. Integers that fit into the mantissa, infinities and zeros
+have to match exactly, other results may be off by a few ulp.
+*/
+[[nodiscard]] static bool matches_vm(double vm_value, double native_value) noexcept
+{
+    if (std::memcmp(&vm_value, &native_value, sizeof(double)) == 0 || (std::isnan(vm_value) && std::isnan(native_value))) {
+        return true;
+    }
+    if (!std::isfinite(vm_value) || vm_value == 0.0 || (std::abs(vm_value) <= 0x1p53 && std::trunc(vm_value) == vm_value)) {
+        return false;
+    }
+    return std::abs(vm_value - native_value) <= 0x1p-48 * std::abs(vm_value);
+}
 
 int main(int argc, char** argv)
 {
@@ -22,11 +52,106 @@ int main(int argc, char** argv)
 
     const auto data = data_or_error.value();
 
-    std::ofstream output_stream{argv[2]};
-    const auto ec = assemble(data, RaychelScript::NativeAssembler::assemble_x86_64, output_stream);
+    //Write a shared object directly if the output file asks for one, NASM source otherwise
+    const std::string_view output_file{argv[2]};
+    const auto ec = [&] {
+        if (output_file.ends_with(".so")) {
+            std::ofstream output_stream{argv[2], std::ios::binary};
+            return assemble(data, RaychelScript::NativeAssembler::assemble_x86_64_elf, output_stream);
+        }
+        std::ofstream output_stream{argv[2]};
+        return assemble(data, RaychelScript::NativeAssembler::assemble_x86_64, output_stream);
+    }();
 
     if (ec != RaychelScript::NativeAssembler::NativeAssemblerErrorCode::ok) {
         Logger::error(ec, '\n');
     }
+
+    //The compiled code has to compute what the VM computes, one invocation at a time and in batches
+    const auto script_or_error = RaychelScript::NativeAssembler::jit_compile(data, stack_size, memory_size);
+    if (const auto* jit_ec = std::get_if<RaychelScript::NativeAssembler::NativeAssemblerErrorCode>(&script_or_error);
+        jit_ec != nullptr) {
+        Logger::info("Skipping the native check: ", *jit_ec, '\n');
+        return 0;
+    }
+    const auto& script = std::get<RaychelScript::NativeAssembler::CompiledScript>(script_or_error);
+
+    //The memory lives on the native stack, so limits that could overflow it must be rejected instead of crashing at runtime
+    constexpr auto huge_limit = std::size_t{1} << 20U;
+    if (const auto huge_script_or_error = RaychelScript::NativeAssembler::jit_compile(data, huge_limit, huge_limit);
+        !std::holds_alternative<RaychelScript::NativeAssembler::NativeAssemblerErrorCode>(huge_script_or_error) ||
+        std::get<RaychelScript::NativeAssembler::NativeAssemblerErrorCode>(huge_script_or_error) !=
+            RaychelScript::NativeAssembler::NativeAssemblerErrorCode::memory_overflow) {
+        Logger::error("Compiling with a call depth and memory of ", huge_limit, " did not fail with memory_overflow!\n");
+        return 1;
+    }
+
+    auto count = std::size_t{1U};
+    //Only the first two inputs run through every combination of values, the others follow the first one
+    for (std::uint32_t input_index{}; input_index != std::min(data.num_input_identifiers, 2U); ++input_index) {
+        count *= input_values.size();
+    }
+    std::vector<double> inputs(data.num_input_identifiers * count);
+    for (std::size_t k{}; k != count; ++k) {
+        auto digits = k;
+        for (std::size_t input_index{}; input_index != data.num_input_identifiers; ++input_index) {
+            inputs[input_index * count + k] = input_values.at(digits % input_values.size());
+            digits /= input_values.size();
+        }
+    }
+
+    std::vector<double> invocation_inputs(data.num_input_identifiers);
+    std::vector<double> vm_outputs(data.num_output_identifiers);
+    std::vector<double> native_outputs(data.num_output_identifiers);
+    std::vector<double> scalar_outputs(data.num_output_identifiers * count);
+    bool every_invocation_succeeded{true};
+    for (std::size_t k{}; k != count; ++k) {
+        for (std::size_t input_index{}; input_index != data.num_input_identifiers; ++input_index) {
+            invocation_inputs[input_index] = inputs[input_index * count + k];
+        }
+        const auto vm_ec = RaychelScript::VM::execute(
+            data, invocation_inputs, vm_outputs, stack_size, memory_size, std::pmr::get_default_resource());
+        const auto native_ec = script.run(invocation_inputs, native_outputs);
+        if (vm_ec != RaychelScript::VM::VMErrorCode::ok || native_ec != RaychelScript::VM::VMErrorCode::ok) {
+            //The native code may report a different error, but it must not fail where the VM succeeds
+            if (vm_ec == RaychelScript::VM::VMErrorCode::ok) {
+                Logger::error("Invocation #", k, " failed natively with '", native_ec, "'!\n");
+                return 1;
+            }
+            every_invocation_succeeded = false;
+            continue;
+        }
+        for (std::size_t output_index{}; output_index != data.num_output_identifiers; ++output_index) {
+            if (!matches_vm(vm_outputs[output_index], native_outputs[output_index])) {
+                Logger::error(
+                    "Output #",
+                    output_index + 1U,
+                    " of invocation #",
+                    k,
+                    " is ",
+                    native_outputs[output_index],
+                    " natively, but ",
+                    vm_outputs[output_index],
+                    " in the VM!\n");
+                return 1;
+            }
+            scalar_outputs[output_index * count + k] = native_outputs[output_index];
+        }
+    }
+
+    if (!every_invocation_succeeded) {
+        Logger::info("Skipping the native batch check: some invocations fail\n");
+        return 0;
+    }
+    std::vector<double> batch_outputs(data.num_output_identifiers * count);
+    if (const auto batch_ec = script.run_batch(inputs, batch_outputs, count); batch_ec != RaychelScript::VM::VMErrorCode::ok) {
+        Logger::error("Native batch execution failed with '", batch_ec, "'!\n");
+        return 1;
+    }
+    if (std::memcmp(batch_outputs.data(), scalar_outputs.data(), batch_outputs.size() * sizeof(double)) != 0) {
+        Logger::error("Native batch execution does not match native scalar execution!\n");
+        return 1;
+    }
+    Logger::info("Native execution of ", count, " invocations matches the VM\n");
     return 0;
 }
@@ -42,6 +42,7 @@ namespace RaychelScript::Runtime {
         entry_point_not_found,
         input_vector_length_not_found,
         output_vector_length_not_found,
+        script_error,
     };
 
     constexpr std::string_view error_code_to_reason_string(RuntimeErrorCode ec)
@@ -63,6 +64,8 @@ namespace RaychelScript::Runtime {
                 return "Input vector length not found in script binary!";
             case RuntimeErrorCode::output_vector_length_not_found:
                 return "Output vector length not found in script binary!";
+            case RuntimeErrorCode::script_error:
+                return "Script execution failed!";
         }
         return "Unknown error code!";
     }
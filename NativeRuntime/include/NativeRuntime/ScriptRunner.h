@@ -29,24 +29,54 @@
 #define RAYCHELSCRIPT_NATIVE_RUNTIME_SCRIPT_RUNNER_H
 
 #include "RuntimeErrorCode.h"
+#include "shared/Misc/BatchExecutor.h"
 
 #include "RaychelCore/ClassMacros.h"
 #include "RaychelCore/Raychel_assert.h"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <span>
+#include <string_view>
 #include <utility>
 
 namespace RaychelScript::Runtime {
 
+    /**
+    * \brief Loads a compiled script and runs it
+    *
+    * Running does not modify the runner and the generated code has no writable data, so one runner may be used from several
+    * threads at once.
+    */
     class ScriptRunner
     {
-        using EntryPoint = void (*)(double const* const input_vector, double* const output_vector) noexcept;
+        //Returns 0 on success or the VM::VMErrorCode of the runtime error the script ran into
+        using EntryPoint = std::uint32_t (*)(double const* const input_vector, double* const output_vector) noexcept;
+
+        //Structure-of-arrays inputs and outputs for count invocations. Returns like EntryPoint
+        using BatchEntryPoint =
+            std::uint32_t (*)(double const* const input_values, double* const output_values, std::size_t count) noexcept;
+
+        //Scripts never have more inputs or outputs than this
+        static constexpr std::size_t max_vector_size = 255U;
 
         template <std::uint32_t NumOutputs>
         struct Result
         {
             RuntimeErrorCode error_code{};
             std::array<double, NumOutputs> values{};
+            //if error_code is script_error, this holds the VM::VMErrorCode the script returned
+            std::uint32_t script_error_code{};
+        };
+
+        struct BatchResult
+        {
+            RuntimeErrorCode error_code{};
+            //if error_code is script_error, this holds the VM::VMErrorCode of the first invocation that failed
+            std::uint32_t script_error_code{};
+
+            bool operator==(const BatchResult&) const noexcept = default;
         };
 
     public:
@@ -90,11 +120,83 @@ namespace RaychelScript::Runtime {
             std::array<double, NumOutputs> outputs{};
 
             RAYCHEL_ASSERT(entry_point_ != nullptr);
-            entry_point_(inputs.data(), outputs.data());
+            if (const auto ec = entry_point_(inputs.data(), outputs.data()); ec != 0U) {
+                return {.error_code = RuntimeErrorCode::script_error, .script_error_code = ec};
+            }
 
             return {.values = outputs};
         }
 
+        /**
+        * \brief Run the script for count input vectors at once
+        *
+        * Input #i of invocation #k is read from inputs[i * count + k] and output #j is written to outputs[j * count + k].
+        * Uses the batch entry point of the best variant for this CPU. Binaries without one run every invocation separately.
+        */
+        BatchResult run_batch(std::span<const double> inputs, std::span<double> outputs, std::size_t count) const noexcept
+        {
+            if (!initialized()) {
+                return {initialization_error_code_};
+            }
+            if (outputs.size() != script_output_vector_size_ * count) {
+                return {RuntimeErrorCode::mismatched_output_vector_size};
+            }
+            if (inputs.size() != script_input_vector_size_ * count) {
+                return {RuntimeErrorCode::mismatched_input_vector_size};
+            }
+
+            if (batch_entry_point_ != nullptr) {
+                if (const auto ec = batch_entry_point_(inputs.data(), outputs.data(), count); ec != 0U) {
+                    return {.error_code = RuntimeErrorCode::script_error, .script_error_code = ec};
+                }
+                return {};
+            }
+
+            if (script_input_vector_size_ > max_vector_size || script_output_vector_size_ > max_vector_size) {
+                return {RuntimeErrorCode::mismatched_input_vector_size};
+            }
+            std::array<double, max_vector_size> input_vector{};
+            std::array<double, max_vector_size> output_vector{};
+            RAYCHEL_ASSERT(entry_point_ != nullptr);
+            for (std::size_t k{}; k != count; ++k) {
+                for (std::size_t i{}; i != script_input_vector_size_; ++i) {
+                    input_vector.at(i) = inputs[i * count + k];
+                }
+                if (const auto ec = entry_point_(input_vector.data(), output_vector.data()); ec != 0U) {
+                    return {.error_code = RuntimeErrorCode::script_error, .script_error_code = ec};
+                }
+                for (std::size_t j{}; j != script_output_vector_size_; ++j) {
+                    outputs[j * count + k] = output_vector.at(j);
+                }
+            }
+            return {};
+        }
+
+        /**
+        * \brief Like run_batch(), but split into chunks that run on the threads of executor
+        */
+        BatchResult
+        run_parallel(std::span<const double> inputs, std::span<double> outputs, std::size_t count, BatchExecutor& executor) const noexcept
+        {
+            if (!initialized()) {
+                return {initialization_error_code_};
+            }
+            if (outputs.size() != script_output_vector_size_ * count) {
+                return {RuntimeErrorCode::mismatched_output_vector_size};
+            }
+            if (inputs.size() != script_input_vector_size_ * count) {
+                return {RuntimeErrorCode::mismatched_input_vector_size};
+            }
+
+            const auto kernel = [this](
+                                    std::span<const double> chunk_inputs, std::span<double> chunk_outputs, std::size_t chunk_count,
+                                    std::pmr::memory_resource* /*arena*/) {
+                return run_batch(chunk_inputs, chunk_outputs, chunk_count);
+            };
+
+            return executor.run(kernel, inputs, outputs, script_input_vector_size_, script_output_vector_size_, count);
+        }
+
         ~ScriptRunner() noexcept
         {
             _destroy();
@@ -107,6 +209,7 @@ namespace RaychelScript::Runtime {
 
         RuntimeErrorCode initialization_error_code_{RuntimeErrorCode::unit_not_initialized};
         EntryPoint entry_point_{};
+        BatchEntryPoint batch_entry_point_{};
         std::uint32_t script_input_vector_size_{};
         std::uint32_t script_output_vector_size_{};
 
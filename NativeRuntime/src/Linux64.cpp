@@ -28,10 +28,73 @@
 
 #include "../include/NativeRuntime/ScriptRunner.h"
 
+#include <array>
+#include <cpuid.h>
 #include <dlfcn.h>
 
 namespace RaychelScript::Runtime {
 
+    namespace {
+
+        enum class CPULevel : std::uint8_t {
+            baseline,
+            avx2, //AVX2 and FMA
+            avx512, //AVX-512F and AVX-512DQ
+        };
+
+        //Variants of the generated code, most demanding first
+        struct Variant
+        {
+            CPULevel required_level;
+            const char* entry_point;
+            const char* batch_entry_point;
+        };
+
+        constexpr std::array variants{
+            Variant{CPULevel::avx512, "raychelscript_entry_avx512", "raychelscript_entry_batch_avx512"},
+            Variant{CPULevel::avx2, "raychelscript_entry_avx2", "raychelscript_entry_batch_avx2"},
+            Variant{CPULevel::baseline, "raychelscript_entry_sse2", "raychelscript_entry_batch_sse2"},
+        };
+
+        std::uint64_t read_xcr0() noexcept
+        {
+            std::uint32_t low{};
+            std::uint32_t high{};
+            asm volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0U));
+            return (std::uint64_t{high} << 32U) | low;
+        }
+
+        //The CPU has to support the instructions and the OS has to save the larger registers on context switches
+        CPULevel detect_cpu_level() noexcept
+        {
+            std::uint32_t eax{};
+            std::uint32_t ebx{};
+            std::uint32_t ecx{};
+            std::uint32_t edx{};
+            if (__get_cpuid(1U, &eax, &ebx, &ecx, &edx) == 0 || (ecx & bit_OSXSAVE) == 0U || (ecx & bit_AVX) == 0U) {
+                return CPULevel::baseline;
+            }
+            const auto has_fma = (ecx & bit_FMA) != 0U;
+
+            //XCR0 bits for the SSE and AVX state, and additionally the opmask and zmm state
+            constexpr std::uint64_t ymm_state = 0x06U;
+            constexpr std::uint64_t zmm_state = 0xE6U;
+            const auto xcr0 = read_xcr0();
+            if ((xcr0 & ymm_state) != ymm_state || __get_cpuid_count(7U, 0U, &eax, &ebx, &ecx, &edx) == 0) {
+                return CPULevel::baseline;
+            }
+
+            if ((ebx & bit_AVX512F) != 0U && (ebx & bit_AVX512DQ) != 0U && (xcr0 & zmm_state) == zmm_state) {
+                return CPULevel::avx512;
+            }
+            if ((ebx & bit_AVX2) != 0U && has_fma) {
+                return CPULevel::avx2;
+            }
+            return CPULevel::baseline;
+        }
+
+    } // namespace
+
     void ScriptRunner::_try_initialize(std::string_view path_to_binary) noexcept
     {
         //NOLINTNEXTLINE(hicpp-signed-bitwise)
@@ -43,7 +106,26 @@ namespace RaychelScript::Runtime {
 
         //NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
 
-        entry_point_ = reinterpret_cast<EntryPoint>(dlsym(platform_specific_data_, "raychelscript_entry"));
+        const auto cpu_level = detect_cpu_level();
+        for (const auto& variant : variants) {
+            if (variant.required_level > cpu_level) {
+                continue;
+            }
+            entry_point_ = reinterpret_cast<EntryPoint>(dlsym(platform_specific_data_, variant.entry_point));
+            if (entry_point_ != nullptr) {
+                batch_entry_point_ = reinterpret_cast<BatchEntryPoint>(dlsym(platform_specific_data_, variant.batch_entry_point));
+                break;
+            }
+        }
+
+        //Binaries from before the variants only have an SSE2 entry point and an AVX batch entry point
+        if (entry_point_ == nullptr) {
+            entry_point_ = reinterpret_cast<EntryPoint>(dlsym(platform_specific_data_, "raychelscript_entry"));
+            if (cpu_level != CPULevel::baseline) {
+                batch_entry_point_ =
+                    reinterpret_cast<BatchEntryPoint>(dlsym(platform_specific_data_, "raychelscript_entry_batch"));
+            }
+        }
         if (entry_point_ == nullptr) {
             initialization_error_code_ = RuntimeErrorCode::entry_point_not_found;
             return;
@@ -1,7 +1,9 @@
 #include "NativeRuntime/ScriptRunner.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -31,11 +33,14 @@ int main(int argc, char** argv)
     }
 
     const auto start = std::chrono::high_resolution_clock::now();
-    const auto [error_code, values] = runner.run<1>(input_vector);
+    const auto [error_code, values, script_error_code] = runner.run<1>(input_vector);
     const auto end = std::chrono::high_resolution_clock::now();
 
     if (error_code != RaychelScript::Runtime::RuntimeErrorCode::ok) {
         std::cout << "Runtime error: " << error_code << '\n';
+        if (error_code == RaychelScript::Runtime::RuntimeErrorCode::script_error) {
+            std::cout << "Script error code: " << script_error_code << '\n';
+        }
         return 1;
     }
 
@@ -45,5 +50,64 @@ int main(int argc, char** argv)
 
     std::cout << "runner.run took " << duration_cast<std::chrono::nanoseconds>(end - start).count() << "ns\n";
 
+    //The same runner is used by all threads at once. Every invocation has to match a single threaded run
+    constexpr std::size_t count = 20'000U;
+    std::vector<double> inputs(input_vector.size() * count);
+    for (std::size_t i{}; i != input_vector.size(); ++i) {
+        for (std::size_t k{}; k != count; ++k) {
+            inputs[i * count + k] = input_vector[i] + static_cast<double>(k % 4U);
+        }
+    }
+
+    //Batched and parallel runs have to report the first error a single run reports, in invocation order
+    std::vector<double> scalar_outputs(count);
+    using BatchResult = decltype(runner.run_batch(inputs, scalar_outputs, count));
+    const auto scalar_result = [&]() -> BatchResult {
+        std::vector<double> invocation_inputs(input_vector.size());
+        for (std::size_t k{}; k != count; ++k) {
+            for (std::size_t i{}; i != input_vector.size(); ++i) {
+                invocation_inputs[i] = inputs[i * count + k];
+            }
+            const auto result = runner.run<1>(invocation_inputs);
+            if (result.error_code != RaychelScript::Runtime::RuntimeErrorCode::ok) {
+                return {.error_code = result.error_code, .script_error_code = result.script_error_code};
+            }
+            scalar_outputs[k] = result.values[0];
+        }
+        return {};
+    }();
+
+    std::vector<double> serial_outputs(count);
+    std::vector<double> parallel_outputs(count);
+
+    //At least four workers, so the chunks run concurrently and get stolen even on a single core
+    RaychelScript::BatchExecutor executor{std::max<std::size_t>(RaychelScript::BatchExecutor::default_number_of_threads(), 4U)};
+
+    const auto serial_start = std::chrono::high_resolution_clock::now();
+    const auto serial_result = runner.run_batch(inputs, serial_outputs, count);
+    const auto parallel_start = std::chrono::high_resolution_clock::now();
+    const auto parallel_result = runner.run_parallel(inputs, parallel_outputs, count, executor);
+    const auto parallel_end = std::chrono::high_resolution_clock::now();
+
+    const auto matches_scalar_run = [&](const std::vector<double>& outputs) {
+        return std::memcmp(scalar_outputs.data(), outputs.data(), count * sizeof(double)) == 0;
+    };
+    if (serial_result != scalar_result ||
+        (serial_result.error_code == RaychelScript::Runtime::RuntimeErrorCode::ok && !matches_scalar_run(serial_outputs))) {
+        std::cout << "Batched execution returned " << serial_result.error_code << " (script error " << serial_result.script_error_code
+                  << ") and does not match single runs, which returned " << scalar_result.error_code << " (script error "
+                  << scalar_result.script_error_code << ")!\n";
+        return 1;
+    }
+    if (parallel_result != serial_result ||
+        (parallel_result.error_code == RaychelScript::Runtime::RuntimeErrorCode::ok && !matches_scalar_run(parallel_outputs))) {
+        std::cout << "Parallel execution on " << executor.number_of_threads() << " threads does not match serial execution!\n";
+        return 1;
+    }
+
+    std::cout << count << " invocations took " << duration_cast<std::chrono::microseconds>(parallel_start - serial_start).count()
+              << "us on one thread and " << duration_cast<std::chrono::microseconds>(parallel_end - parallel_start).count()
+              << "us on " << executor.number_of_threads() << " threads\n";
+
     return 0;
 }
@@ -0,0 +1,68 @@
+/**
+* \file Optimizer.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the AST optimizer
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_OPTIMIZER_H
+#define RAYCHELSCRIPT_OPTIMIZER_H
+
+#ifdef _WIN32
+    #ifdef RaychelScriptOptimizer_EXPORTS
+        #define RAYCHELSCRIPT_OPTIMIZER_API __declspec(dllexport)
+    #else
+        #define RAYCHELSCRIPT_OPTIMIZER_API __declspec(dllimport)
+    #endif
+#else
+    #define RAYCHELSCRIPT_OPTIMIZER_API
+#endif
+
+#include "OptimizerErrorCode.h"
+#include "shared/AST/AST.h"
+
+#include <variant>
+
+namespace RaychelScript::Optimizer {
+
+    using OptimizeResult = std::variant<OptimizerErrorCode, AST>;
+
+    /**
+    * \brief Rewrite an AST into an equivalent, smaller one
+    *
+    * The following passes run until nothing changes anymore:
+    *   - constant folding of arithmetic and unary operators with numeric constant operands
+    *   - algebraic identities: x*1, 1*x, x+0, 0+x, x-0, x/1 and x^1 become x
+    *   - propagation of variables that are initialized with a constant and never written to again
+    *   - removal of conditionals and loops whose condition is known, of statements without side effects,
+    *     of code after a return statement and of variables that are never read
+    *   - removal of functions that are never called
+    *
+    * Constant expressions that would fail at runtime, like divisions by zero, are left alone so the backends still report them.
+    * Removing an unused variable removes its initializer as well, including any runtime error it would have raised.
+    */
+    RAYCHELSCRIPT_OPTIMIZER_API [[nodiscard]] OptimizeResult optimize(const AST& ast) noexcept;
+
+} //namespace RaychelScript::Optimizer
+
+#endif //!RAYCHELSCRIPT_OPTIMIZER_H
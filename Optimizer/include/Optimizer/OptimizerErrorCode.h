@@ -0,0 +1,68 @@
+/**
+* \file OptimizerErrorCode.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for OptimizerErrorCode enum
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_OPTIMIZER_ERROR_CODE_H
+#define RAYCHELSCRIPT_OPTIMIZER_ERROR_CODE_H
+
+#include <ostream>
+#include <string_view>
+
+namespace RaychelScript::Optimizer {
+
+    enum class OptimizerErrorCode {
+        ok,
+        duplicate_name,
+        unresolved_identifier,
+        invalid_scope_pop,
+    };
+
+    constexpr std::string_view error_code_to_reason_string(OptimizerErrorCode ec) noexcept
+    {
+        using namespace std::string_view_literals;
+        using enum OptimizerErrorCode;
+
+        switch (ec) {
+            case ok:
+                return "Everything's fine :)"sv;
+            case duplicate_name:
+                return "Duplicate identifier"sv;
+            case unresolved_identifier:
+                return "Unable to resolve identifier to a declaration"sv;
+            case invalid_scope_pop:
+                return "Inline scope pop without matching push"sv;
+        }
+        return "<Unknown reason>"sv;
+    }
+
+    inline std::ostream& operator<<(std::ostream& os, OptimizerErrorCode obj) noexcept
+    {
+        return os << error_code_to_reason_string(obj);
+    }
+
+} //namespace RaychelScript::Optimizer
+
+#endif //!RAYCHELSCRIPT_OPTIMIZER_ERROR_CODE_H
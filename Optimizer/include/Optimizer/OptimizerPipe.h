@@ -0,0 +1,52 @@
+/**
+* \file OptimizerPipe.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the Optimize pipe
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_OPTIMIZER_PIPE_H
+#define RAYCHELSCRIPT_OPTIMIZER_PIPE_H
+
+#include "Optimizer.h"
+#include "shared/Pipes/PipeResult.h"
+
+namespace RaychelScript::Pipes {
+
+    struct Optimize
+    {
+        Optimizer::OptimizeResult operator()(const AST& ast) const noexcept
+        {
+            return Optimizer::optimize(ast);
+        }
+    };
+
+    inline PipeResult<AST> operator|(const PipeResult<AST>& input, const Optimize& optimizer) noexcept
+    {
+        RAYCHELSCRIPT_PIPES_RETURN_IF_ERROR(input);
+        return optimizer(input.value());
+    }
+
+} //namespace RaychelScript::Pipes
+
+#endif //!RAYCHELSCRIPT_OPTIMIZER_PIPE_H
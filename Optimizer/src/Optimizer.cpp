@@ -0,0 +1,812 @@
+/**
+* \file Optimizer.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the AST optimizer
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+
+#include "Optimizer/Optimizer.h"
+
+#include "shared/AST/NodeData.h"
+#include "shared/AST/NodeHasValue.h"
+#include "shared/Misc/Scope.h"
+#include "shared/Misc/WalkAST.h"
+
+#include "RaychelCore/Raychel_assert.h"
+#include "RaychelCore/ScopedTimer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <vector>
+
+#define TRY(expression)                                                                                                          \
+    if (const auto ec = (expression); ec != OptimizerErrorCode::ok) {                                                            \
+        return ec;                                                                                                               \
+    }
+
+namespace RaychelScript::Optimizer {
+
+    //Every round can only enable more rewrites in the next one, so this is just a safety net
+    constexpr std::size_t max_number_of_rounds = 16U;
+
+    using DeclarationId = std::size_t;
+
+    struct DeclarationInfo
+    {
+        //inputs, outputs and function arguments are visible from the outside and can never be removed
+        bool is_fixed{};
+        std::size_t reads{};
+        //assignments and update expressions, not counting the initializer
+        std::size_t writes{};
+        //true if the initializer or any later write has to be kept for its side effects or because it may fail
+        bool writes_have_side_effects{};
+        std::optional<long double> initial_value{};
+    };
+
+    /**
+    * Resolves identifiers the same way the Assembler does: every block opens a scope that can see its parent and function bodies only
+    * see their arguments. Declarations are numbered in the order they are encountered. The rewrite relies on getting the same
+    * numbers as the analysis, so it has to skip() every piece of code it drops without visiting it.
+    */
+    class Scopes
+    {
+        using Scope = BasicScope<DeclarationId>;
+
+    public:
+        Scopes()
+        {
+            push_function();
+        }
+
+        void push_function() noexcept
+        {
+            scopes_.push_back(Scope{false});
+        }
+
+        void pop_function() noexcept
+        {
+            RAYCHEL_ASSERT(!scopes_.back().inherits_from_parent_scope);
+            scopes_.pop_back();
+        }
+
+        void push() noexcept
+        {
+            scopes_.push_back(Scope{true});
+        }
+
+        [[nodiscard]] bool pop() noexcept
+        {
+            if (!scopes_.back().inherits_from_parent_scope) {
+                return false;
+            }
+            scopes_.pop_back();
+            return true;
+        }
+
+        [[nodiscard]] std::optional<DeclarationId> declare(const std::string& name) noexcept
+        {
+            if (has_identifier(scopes_, name)) {
+                return std::nullopt;
+            }
+            const auto id = next_id_++;
+            scopes_.back().lookup_table.emplace(name, id);
+            return id;
+        }
+
+        [[nodiscard]] std::optional<DeclarationId> resolve(const std::string& name) const noexcept
+        {
+            return find_identifier(scopes_, name);
+        }
+
+        void skip(std::span<const AST_Node> nodes) noexcept
+        {
+            for (const auto& node : nodes) {
+                details::handle_node(node, [this](const AST_Node& child) {
+                    if (child.type() == NodeType::variable_decl) {
+                        ++next_id_;
+                    }
+                });
+            }
+        }
+
+    private:
+        std::vector<Scope> scopes_;
+        DeclarationId next_id_{};
+    };
+
+    [[nodiscard]] static bool has_side_effects(const AST_Node& node) noexcept
+    {
+        bool result{false};
+        details::handle_node(node, [&result](const AST_Node& child) { result = result || child.has_side_effect(); });
+        return result;
+    }
+
+    [[nodiscard]] static bool may_fail(const AST_Node& node) noexcept;
+
+    [[nodiscard]] static const std::string& name_of(AST_Node& node) noexcept
+    {
+        if (node.type() == NodeType::variable_decl) {
+            return node.to_ref<VariableDeclarationData>().name;
+        }
+        return node.to_ref<VariableReferenceData>().name;
+    }
+
+    [[nodiscard]] static double value_of(const AST_Node& node) noexcept
+    {
+        return static_cast<double>(node.to_node_data<NumericConstantData>().value);
+    }
+
+    [[nodiscard]] static AST_Node make_constant(double value) noexcept
+    {
+        return AST_Node{NumericConstantData{{}, static_cast<long double>(value)}};
+    }
+
+    //Analysis
+
+    struct AnalysisContext
+    {
+        Scopes scopes;
+        std::vector<DeclarationInfo> declarations;
+    };
+
+    [[nodiscard]] static OptimizerErrorCode declare(AnalysisContext& ctx, AST_Node& node, bool is_fixed = false) noexcept
+    {
+        const auto& name = name_of(node);
+        if (!ctx.scopes.declare(name).has_value()) {
+            Logger::error("An identifier with name '", name, "' already exists!\n");
+            return OptimizerErrorCode::duplicate_name;
+        }
+        ctx.declarations.push_back(DeclarationInfo{.is_fixed = is_fixed});
+        return OptimizerErrorCode::ok;
+    }
+
+    [[nodiscard]] static OptimizerErrorCode declare_fixed(AnalysisContext& ctx, const std::string& name) noexcept
+    {
+        AST_Node node{VariableDeclarationData{{}, name, false}};
+        return declare(ctx, node, true);
+    }
+
+    [[nodiscard]] static OptimizerErrorCode resolve(AnalysisContext& ctx, AST_Node& node, DeclarationInfo*& info) noexcept
+    {
+        const auto& name = name_of(node);
+        const auto id = ctx.scopes.resolve(name);
+        if (!id.has_value()) {
+            Logger::error("Unable to resolve identifier '", name, "'\n");
+            return OptimizerErrorCode::unresolved_identifier;
+        }
+        info = &ctx.declarations.at(*id);
+        return OptimizerErrorCode::ok;
+    }
+
+    [[nodiscard]] static OptimizerErrorCode analyze_expression(AnalysisContext& ctx, const AST_Node& node) noexcept
+    {
+        auto result = OptimizerErrorCode::ok;
+        details::handle_node(node, [&](const AST_Node& child) {
+            if (child.type() != NodeType::variable_ref || result != OptimizerErrorCode::ok) {
+                return;
+            }
+            AST_Node reference = child;
+            DeclarationInfo* info{};
+            result = resolve(ctx, reference, info);
+            if (info != nullptr) {
+                ++info->reads;
+            }
+        });
+        return result;
+    }
+
+    //Assignments and update expressions: the right-hand side is evaluated before the left-hand side is declared
+    [[nodiscard]] static OptimizerErrorCode
+    analyze_write(AnalysisContext& ctx, const AST_Node& statement, AST_Node& lhs, const AST_Node& rhs) noexcept
+    {
+        const auto is_update = statement.type() == NodeType::update_expression;
+
+        TRY(analyze_expression(ctx, rhs));
+
+        DeclarationInfo* info{};
+        if (lhs.type() == NodeType::variable_decl) {
+            TRY(declare(ctx, lhs));
+            info = &ctx.declarations.back();
+            if (!is_update && node_has_known_value(rhs)) {
+                info->initial_value = rhs.to_node_data<NumericConstantData>().value;
+            }
+        } else {
+            TRY(resolve(ctx, lhs, info));
+            ++info->writes;
+        }
+
+        info->writes_have_side_effects = info->writes_have_side_effects || has_side_effects(rhs) || may_fail(statement);
+        return OptimizerErrorCode::ok;
+    }
+
+    [[nodiscard]] static OptimizerErrorCode analyze_block(AnalysisContext& ctx, std::vector<AST_Node>& nodes) noexcept;
+
+    [[nodiscard]] static OptimizerErrorCode analyze_scoped_block(AnalysisContext& ctx, std::vector<AST_Node>& nodes) noexcept
+    {
+        ctx.scopes.push();
+        TRY(analyze_block(ctx, nodes));
+        (void)ctx.scopes.pop();
+        return OptimizerErrorCode::ok;
+    }
+
+    [[nodiscard]] static OptimizerErrorCode analyze_statement(AnalysisContext& ctx, AST_Node& node) noexcept
+    {
+        switch (node.type()) {
+            case NodeType::assignment: {
+                auto& data = node.to_ref<AssignmentExpressionData>();
+                return analyze_write(ctx, node, data.lhs, data.rhs);
+            }
+            case NodeType::update_expression: {
+                auto& data = node.to_ref<UpdateExpressionData>();
+                return analyze_write(ctx, node, data.lhs, data.rhs);
+            }
+            case NodeType::variable_decl:
+                return declare(ctx, node);
+            case NodeType::conditional_construct: {
+                auto& data = node.to_ref<ConditionalConstructData>();
+                TRY(analyze_expression(ctx, data.condition_node));
+                TRY(analyze_scoped_block(ctx, data.body));
+                return analyze_scoped_block(ctx, data.else_body);
+            }
+            case NodeType::loop: {
+                auto& data = node.to_ref<LoopData>();
+                TRY(analyze_expression(ctx, data.condition_node));
+                return analyze_scoped_block(ctx, data.body);
+            }
+            case NodeType::inline_state_push:
+                ctx.scopes.push();
+                return OptimizerErrorCode::ok;
+            case NodeType::inline_state_pop:
+                return ctx.scopes.pop() ? OptimizerErrorCode::ok : OptimizerErrorCode::invalid_scope_pop;
+            default:
+                return analyze_expression(ctx, node);
+        }
+    }
+
+    [[nodiscard]] static OptimizerErrorCode analyze_block(AnalysisContext& ctx, std::vector<AST_Node>& nodes) noexcept
+    {
+        for (auto& node : nodes) {
+            TRY(analyze_statement(ctx, node));
+        }
+        return OptimizerErrorCode::ok;
+    }
+
+    [[nodiscard]] static OptimizerErrorCode analyze(AnalysisContext& ctx, AST& ast) noexcept
+    {
+        for (const auto& name : ast.config_block.input_identifiers) {
+            TRY(declare_fixed(ctx, name));
+        }
+        for (const auto& name : ast.config_block.output_identifiers) {
+            TRY(declare_fixed(ctx, name));
+        }
+        TRY(analyze_block(ctx, ast.nodes));
+
+        for (auto& [_, function] : ast.functions) {
+            ctx.scopes.push_function();
+            for (const auto& name : function.arguments) {
+                TRY(declare_fixed(ctx, name));
+            }
+            TRY(analyze_block(ctx, function.body));
+            ctx.scopes.pop_function();
+        }
+
+        return OptimizerErrorCode::ok;
+    }
+
+    //Rewriting
+
+    struct RewriteContext
+    {
+        Scopes scopes;
+        const std::vector<DeclarationInfo>& declarations;
+        bool changed{};
+    };
+
+    [[nodiscard]] static bool is_removable(const DeclarationInfo& info) noexcept
+    {
+        return !info.is_fixed && info.reads == 0U && !info.writes_have_side_effects;
+    }
+
+    [[nodiscard]] static std::optional<long double> known_value(const DeclarationInfo& info) noexcept
+    {
+        if (info.is_fixed || info.writes != 0U) {
+            return std::nullopt;
+        }
+        return info.initial_value;
+    }
+
+    //Declares or resolves the target of an assignment or update expression
+    [[nodiscard]] static const DeclarationInfo& write_target(RewriteContext& ctx, AST_Node& lhs) noexcept
+    {
+        const auto id = lhs.type() == NodeType::variable_decl ? ctx.scopes.declare(name_of(lhs)) : ctx.scopes.resolve(name_of(lhs));
+        RAYCHEL_ASSERT(id.has_value());
+        return ctx.declarations.at(*id);
+    }
+
+    //Results that the backends would report as an error, or that are not finite, are not folded
+    [[nodiscard]] static std::optional<double> fold(const ArithmeticExpressionData& data) noexcept
+    {
+        using enum ArithmeticExpressionData::Operation;
+
+        if (!node_has_known_value(data.lhs) || !node_has_known_value(data.rhs)) {
+            return std::nullopt;
+        }
+
+        const auto lhs = value_of(data.lhs);
+        const auto rhs = value_of(data.rhs);
+        double result{};
+        switch (data.operation) {
+            case add:
+                result = lhs + rhs;
+                break;
+            case subtract:
+                result = lhs - rhs;
+                break;
+            case multiply:
+                result = lhs * rhs;
+                break;
+            case divide:
+                if (rhs == 0.0) {
+                    return std::nullopt;
+                }
+                result = lhs / rhs;
+                break;
+            case power:
+                result = std::pow(lhs, rhs);
+                break;
+            default:
+                return std::nullopt;
+        }
+
+        if (!std::isfinite(result)) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    [[nodiscard]] static std::optional<double> fold(const UnaryExpressionData& data) noexcept
+    {
+        using enum UnaryExpressionData::Operation;
+
+        if (!node_has_known_value(data.value_node)) {
+            return std::nullopt;
+        }
+
+        const auto value = value_of(data.value_node);
+        double result{};
+        switch (data.operation) {
+            case minus:
+                result = -value;
+                break;
+            case plus:
+                result = value;
+                break;
+            case magnitude:
+                result = std::abs(value);
+                break;
+            case factorial:
+                //the gamma function has poles at the negative integers
+                if (value < 0.0 && std::floor(value) == value) {
+                    return std::nullopt;
+                }
+                result = std::tgamma(value + 1.0);
+                break;
+            default:
+                return std::nullopt;
+        }
+
+        if (!std::isfinite(result)) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+    //Division, pow and factorial are the operations the backends can report an error for. Unless they fold to a constant, they
+    //have to be executed even if their result is never used
+    [[nodiscard]] static bool may_fail(const AST_Node& node) noexcept
+    {
+        using Operation = ArithmeticExpressionData::Operation;
+
+        bool result{false};
+        details::handle_node(node, [&result](const AST_Node& child) {
+            switch (child.type()) {
+                case NodeType::arithmetic_operator: {
+                    const auto data = child.to_node_data<ArithmeticExpressionData>();
+                    const auto can_fail = data.operation == Operation::divide || data.operation == Operation::power;
+                    result = result || (can_fail && !fold(data).has_value());
+                    return;
+                }
+                case NodeType::update_expression: {
+                    //the target of an update is never a constant
+                    const auto data = child.to_node_data<UpdateExpressionData>();
+                    const auto is_safe_division = data.operation == Operation::divide && node_has_known_value(data.rhs) &&
+                                                  value_of(data.rhs) != 0.0;
+                    const auto can_fail = data.operation == Operation::divide || data.operation == Operation::power;
+                    result = result || (can_fail && !is_safe_division);
+                    return;
+                }
+                case NodeType::unary_operator: {
+                    const auto data = child.to_node_data<UnaryExpressionData>();
+                    result = result || (data.operation == UnaryExpressionData::Operation::factorial && !fold(data).has_value());
+                    return;
+                }
+                default:
+                    return;
+            }
+        });
+        return result;
+    }
+
+    //Zeros only match if their signs do
+    [[nodiscard]] static bool is_constant(const AST_Node& node, double value) noexcept
+    {
+        return node_has_known_value(node) && value_of(node) == value && std::signbit(value_of(node)) == std::signbit(value);
+    }
+
+    //Returns the operand an arithmetic expression reduces to, if it is one of x*1, 1*x, x+(-0), (-0)+x, x-0, x/1 or x^1.
+    //x+0 is not one of them because -0 + 0 is +0, which 1/x or x^-1 can tell apart from -0
+    [[nodiscard]] static AST_Node* identity_operand(ArithmeticExpressionData& data) noexcept
+    {
+        using enum ArithmeticExpressionData::Operation;
+
+        switch (data.operation) {
+            case add:
+                if (is_constant(data.rhs, -0.0)) {
+                    return &data.lhs;
+                }
+                if (is_constant(data.lhs, -0.0)) {
+                    return &data.rhs;
+                }
+                break;
+            case multiply:
+                if (is_constant(data.rhs, 1.0)) {
+                    return &data.lhs;
+                }
+                if (is_constant(data.lhs, 1.0)) {
+                    return &data.rhs;
+                }
+                break;
+            case subtract:
+                if (is_constant(data.rhs, 0.0)) {
+                    return &data.lhs;
+                }
+                break;
+            case divide:
+            case power:
+                if (is_constant(data.rhs, 1.0)) {
+                    return &data.lhs;
+                }
+                break;
+        }
+        return nullptr;
+    }
+
+    static void replace(RewriteContext& ctx, AST_Node& node, AST_Node replacement) noexcept
+    {
+        node = std::move(replacement);
+        ctx.changed = true;
+    }
+
+    static void rewrite_expression(RewriteContext& ctx, AST_Node& node) noexcept
+    {
+        switch (node.type()) {
+            case NodeType::arithmetic_operator: {
+                auto& data = node.to_ref<ArithmeticExpressionData>();
+                rewrite_expression(ctx, data.lhs);
+                rewrite_expression(ctx, data.rhs);
+                if (const auto value = fold(data); value.has_value()) {
+                    return replace(ctx, node, make_constant(*value));
+                }
+                if (const auto* operand = identity_operand(data); operand != nullptr) {
+                    return replace(ctx, node, *operand);
+                }
+                return;
+            }
+            case NodeType::unary_operator: {
+                auto& data = node.to_ref<UnaryExpressionData>();
+                rewrite_expression(ctx, data.value_node);
+                if (const auto value = fold(data); value.has_value()) {
+                    return replace(ctx, node, make_constant(*value));
+                }
+                if (data.operation == UnaryExpressionData::Operation::plus) {
+                    return replace(ctx, node, data.value_node);
+                }
+                return;
+            }
+            case NodeType::relational_operator: {
+                auto& data = node.to_ref<RelationalOperatorData>();
+                rewrite_expression(ctx, data.lhs);
+                rewrite_expression(ctx, data.rhs);
+                return;
+            }
+            case NodeType::variable_ref: {
+                const auto id = ctx.scopes.resolve(name_of(node));
+                RAYCHEL_ASSERT(id.has_value());
+                if (const auto value = known_value(ctx.declarations.at(*id)); value.has_value()) {
+                    return replace(ctx, node, make_constant(static_cast<double>(*value)));
+                }
+                return;
+            }
+            case NodeType::function_call: {
+                for (auto& argument : node.to_ref<FunctionCallData>().argument_expressions) {
+                    rewrite_expression(ctx, argument);
+                }
+                return;
+            }
+            case NodeType::function_return:
+                return rewrite_expression(ctx, node.to_ref<FunctionReturnData>().return_value);
+            default:
+                return;
+        }
+    }
+
+    [[nodiscard]] static std::optional<bool> known_condition(const AST_Node& node) noexcept
+    {
+        using enum RelationalOperatorData::Operation;
+
+        if (node.type() != NodeType::relational_operator) {
+            return std::nullopt;
+        }
+        const auto data = node.to_node_data<RelationalOperatorData>();
+        if (!node_has_known_value(data.lhs) || !node_has_known_value(data.rhs)) {
+            return std::nullopt;
+        }
+
+        const auto lhs = value_of(data.lhs);
+        const auto rhs = value_of(data.rhs);
+        switch (data.operation) {
+            case equals:
+                return lhs == rhs;
+            case not_equals:
+                return lhs != rhs;
+            case less_than:
+                return lhs < rhs;
+            case greater_than:
+                return lhs > rhs;
+        }
+        return std::nullopt;
+    }
+
+    static void rewrite_block(RewriteContext& ctx, std::vector<AST_Node>& nodes) noexcept;
+
+    static void rewrite_scoped_block(RewriteContext& ctx, std::vector<AST_Node>& nodes) noexcept
+    {
+        ctx.scopes.push();
+        rewrite_block(ctx, nodes);
+        (void)ctx.scopes.pop();
+    }
+
+    [[nodiscard]] static bool is_declaration(const AST_Node& node) noexcept
+    {
+        return node.type() == NodeType::variable_decl ||
+               (node.type() == NodeType::assignment &&
+                node.to_node_data<AssignmentExpressionData>().lhs.type() == NodeType::variable_decl);
+    }
+
+    //Splice the body of a conditional whose condition is known into the surrounding block
+    static void inline_block(RewriteContext& ctx, std::vector<AST_Node>& body, std::vector<AST_Node>& output) noexcept
+    {
+        rewrite_scoped_block(ctx, body);
+
+        //the declarations of the body must not be visible after it
+        const auto declares_variables = std::ranges::any_of(body, is_declaration);
+
+        if (declares_variables) {
+            output.emplace_back(InlinePushData{});
+        }
+        std::ranges::move(body, std::back_inserter(output));
+        if (declares_variables) {
+            output.emplace_back(InlinePopData{});
+        }
+    }
+
+    //Returns false if the statement can be dropped. Statements that expand into several others write them to output themselves
+    [[nodiscard]] static bool rewrite_statement(RewriteContext& ctx, AST_Node& node, std::vector<AST_Node>& output) noexcept
+    {
+        switch (node.type()) {
+            case NodeType::assignment: {
+                auto& data = node.to_ref<AssignmentExpressionData>();
+                rewrite_expression(ctx, data.rhs);
+                return !is_removable(write_target(ctx, data.lhs));
+            }
+            case NodeType::update_expression: {
+                auto& data = node.to_ref<UpdateExpressionData>();
+                rewrite_expression(ctx, data.rhs);
+                return !is_removable(write_target(ctx, data.lhs));
+            }
+            case NodeType::variable_decl:
+                return !is_removable(write_target(ctx, node));
+            case NodeType::conditional_construct: {
+                auto& data = node.to_ref<ConditionalConstructData>();
+                rewrite_expression(ctx, data.condition_node);
+
+                if (const auto condition = known_condition(data.condition_node); condition.has_value()) {
+                    if (*condition) {
+                        inline_block(ctx, data.body, output);
+                        ctx.scopes.skip(data.else_body);
+                    } else {
+                        ctx.scopes.skip(data.body);
+                        inline_block(ctx, data.else_body, output);
+                    }
+                    return false;
+                }
+
+                rewrite_scoped_block(ctx, data.body);
+                rewrite_scoped_block(ctx, data.else_body);
+                return !data.body.empty() || !data.else_body.empty() || has_side_effects(data.condition_node) ||
+                       may_fail(data.condition_node);
+            }
+            case NodeType::loop: {
+                auto& data = node.to_ref<LoopData>();
+                rewrite_expression(ctx, data.condition_node);
+
+                if (known_condition(data.condition_node) == false) {
+                    ctx.scopes.skip(data.body);
+                    return false;
+                }
+
+                rewrite_scoped_block(ctx, data.body);
+                return true;
+            }
+            case NodeType::inline_state_push:
+                ctx.scopes.push();
+                return true;
+            case NodeType::inline_state_pop:
+                (void)ctx.scopes.pop();
+                return true;
+            case NodeType::function_return:
+            case NodeType::function_call:
+                rewrite_expression(ctx, node);
+                return true;
+            default:
+                //the value of an expression statement is never used
+                return has_side_effects(node) || may_fail(node);
+        }
+    }
+
+    static void rewrite_block(RewriteContext& ctx, std::vector<AST_Node>& nodes) noexcept
+    {
+        std::vector<AST_Node> output;
+        output.reserve(nodes.size());
+
+        //Position of every inline scope that is still open in output and whether anything declared in it was kept
+        struct OpenScope
+        {
+            std::size_t push_index{};
+            bool declares_variables{};
+        };
+        std::vector<OpenScope> open_scopes;
+
+        bool returned{false};
+        for (auto& node : nodes) {
+            const auto is_scope_change = node.type() == NodeType::inline_state_push || node.type() == NodeType::inline_state_pop;
+
+            //Nothing after a return statement is ever executed, but the scopes still have to be balanced
+            if (returned && !is_scope_change) {
+                ctx.scopes.skip(std::span{&node, 1U});
+                ctx.changed = true;
+                continue;
+            }
+
+            const auto type = node.type();
+            if (!rewrite_statement(ctx, node, output)) {
+                ctx.changed = true;
+                continue;
+            }
+            returned = returned || type == NodeType::function_return;
+
+            if (type == NodeType::inline_state_push) {
+                open_scopes.push_back(OpenScope{.push_index = output.size()});
+            } else if (type == NodeType::inline_state_pop && !open_scopes.empty()) {
+                //an inline scope whose declarations were all removed does nothing, but its contents still have to run
+                const auto scope = open_scopes.back();
+                open_scopes.pop_back();
+                if (!scope.declares_variables) {
+                    output.erase(std::next(output.begin(), static_cast<std::ptrdiff_t>(scope.push_index)));
+                    ctx.changed = true;
+                    continue;
+                }
+            } else if (!open_scopes.empty() && is_declaration(node)) {
+                open_scopes.back().declares_variables = true;
+            }
+            output.push_back(std::move(node));
+        }
+
+        nodes = std::move(output);
+    }
+
+    static void collect_calls(const std::vector<AST_Node>& nodes, std::vector<std::string>& callees) noexcept
+    {
+        for_each_node(nodes, [&callees](const AST_Node& node) {
+            if (node.type() == NodeType::function_call) {
+                callees.push_back(node.to_node_data<FunctionCallData>().mangled_callee_name);
+            }
+        });
+    }
+
+    static void remove_unused_functions(RewriteContext& ctx, AST& ast) noexcept
+    {
+        std::set<std::string> reachable;
+        std::vector<std::string> pending;
+        collect_calls(ast.nodes, pending);
+
+        while (!pending.empty()) {
+            auto name = std::move(pending.back());
+            pending.pop_back();
+            if (const auto it = ast.functions.find(name); it != ast.functions.end() && reachable.insert(name).second) {
+                collect_calls(it->second.body, pending);
+            }
+        }
+
+        ctx.changed = std::erase_if(ast.functions, [&](const auto& entry) { return !reachable.contains(entry.first); }) != 0U ||
+                      ctx.changed;
+    }
+
+    static void rewrite(RewriteContext& ctx, AST& ast) noexcept
+    {
+        for (const auto& name : ast.config_block.input_identifiers) {
+            (void)ctx.scopes.declare(name);
+        }
+        for (const auto& name : ast.config_block.output_identifiers) {
+            (void)ctx.scopes.declare(name);
+        }
+        rewrite_block(ctx, ast.nodes);
+
+        for (auto& [_, function] : ast.functions) {
+            ctx.scopes.push_function();
+            for (const auto& name : function.arguments) {
+                (void)ctx.scopes.declare(name);
+            }
+            rewrite_block(ctx, function.body);
+            ctx.scopes.pop_function();
+        }
+
+        remove_unused_functions(ctx, ast);
+    }
+
+    OptimizeResult optimize(const AST& input) noexcept
+    {
+        [[maybe_unused]] Raychel::ScopedTimer<std::chrono::microseconds> timer{"Optimizing time"};
+
+        AST ast = input;
+
+        for (std::size_t round{}; round != max_number_of_rounds; ++round) {
+            AnalysisContext analysis{};
+            TRY(analyze(analysis, ast));
+
+            RewriteContext ctx{.scopes = {}, .declarations = analysis.declarations};
+            rewrite(ctx, ast);
+            if (!ctx.changed) {
+                break;
+            }
+        }
+
+        return ast;
+    }
+
+} //namespace RaychelScript::Optimizer
@@ -0,0 +1,109 @@
+/**
+* \file ExecutionContext.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the reusable VM execution context
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_VM_EXECUTION_CONTEXT_H
+#define RAYCHELSCRIPT_VM_EXECUTION_CONTEXT_H
+
+#include "VMErrorCode.h"
+#include "VMState.h"
+
+#include "RaychelCore/ClassMacros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+namespace RaychelScript::VM {
+
+    /**
+    * \brief Persistent call stack and memory for repeatedly executing the same script
+    *
+    * All allocations happen when the context is constructed. Every call to run() only clears the memory locations the
+    * previous run could have touched, so executing small scripts many times does not pay for setting up the VM each time.
+    */
+    class ExecutionContext
+    {
+    public:
+        explicit ExecutionContext(
+            std::size_t stack_size = 128U, std::size_t memory_size = 1'024U,
+            std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource());
+
+        explicit ExecutionContext(
+            const VMData& data, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U,
+            std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource());
+
+        explicit ExecutionContext(
+            const LinkedVMData& data, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U,
+            std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource());
+
+        explicit ExecutionContext(
+            const VMDataView& data, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U,
+            std::pmr::memory_resource* memory_resource = std::pmr::get_default_resource());
+
+        RAYCHEL_MAKE_NONCOPY(ExecutionContext)
+        RAYCHEL_MAKE_DEFAULT_MOVE(ExecutionContext)
+
+        /**
+        * \brief Bind the context to a script. The script data must outlive the binding.
+        */
+        void bind(const VMData& data) noexcept;
+
+        void bind(const LinkedVMData& data) noexcept;
+
+        void bind(const VMDataView& data) noexcept;
+
+        [[nodiscard]] bool is_bound() const noexcept
+        {
+            return !frame_table_.empty();
+        }
+
+        /**
+        * \brief Execute the bound script once
+        *
+        * \param input_values Must contain exactly one value per script input
+        * \param output_values Must provide exactly one slot per script output
+        */
+        [[nodiscard]] VMErrorCode run(std::span<const double> input_values, std::span<double> output_values) noexcept;
+
+        ~ExecutionContext() = default;
+
+    private:
+        std::uint32_t num_input_identifiers_{};
+        std::uint32_t num_output_identifiers_{};
+        std::span<const double> immediate_values_;
+        DynamicArray<VMState::FrameTableEntry> frame_table_;
+        DynamicArray<VMState::CallFrame> call_stack_;
+        DynamicArray<double> memory_;
+
+        //Number of memory locations (starting at the bottom) that may be non-zero
+        std::size_t dirty_size_{};
+    };
+
+} //namespace RaychelScript::VM
+
+#endif //!RAYCHELSCRIPT_VM_EXECUTION_CONTEXT_H
@@ -0,0 +1,187 @@
+/**
+* \file PreparedVMData.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the operand-specialised VM instruction stream
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_VM_PREPARED_VM_DATA_H
+#define RAYCHELSCRIPT_VM_PREPARED_VM_DATA_H
+
+#include "VMErrorCode.h"
+#include "shared/VM/VMData.h"
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace RaychelScript::VM {
+
+    /**
+    * \brief Op codes of the prepared instruction stream
+    *
+    * Every op code of the rasm instruction set is split up by the kinds of its operands. The suffix names the kind of each
+    * value operand in order: 's' for stack (or intermediate) locations, 'i' for immediate values.
+    * Instructions with only immediate operands are evaluated while preparing and replaced by lda/sfl/trp.
+    */
+    enum class PreparedOpCode : std::uint8_t {
+        mov_s, //move stack location a into b
+        mov_i, //move immediate a into b
+
+        add_ss,
+        add_si,
+        add_is,
+        sub_ss,
+        sub_si,
+        sub_is,
+        mul_ss,
+        mul_si,
+        mul_is,
+        div_ss,
+        div_si,
+        div_is,
+        pow_ss,
+        pow_si,
+        pow_is,
+
+        mag_s,
+        fac_s,
+        fac_i,
+
+        inc_s,
+        inc_i,
+        dec_s,
+        dec_i,
+        mas_s,
+        mas_i,
+        das_s,
+        das_i,
+        pas_s,
+        pas_i,
+
+        clt_ss,
+        clt_si,
+        clt_is,
+        cgt_ss,
+        cgt_si,
+        cgt_is,
+        ceq_ss,
+        ceq_si,
+        ceq_is,
+        cne_ss,
+        cne_si,
+        cne_is,
+
+        //fused compare-and-branch instructions. The jump offset is in c
+        jnl_ss,
+        jnl_si,
+        jnl_is,
+        jng_ss,
+        jng_si,
+        jng_is,
+        jne_ss,
+        jne_si,
+        jne_is,
+        jeq_ss,
+        jeq_si,
+        jeq_is,
+
+        //multiply-add with a third value operand c
+        mad_sss,
+        mad_ssi,
+        mad_sis,
+        mad_sii,
+        mad_iss,
+        mad_isi,
+        mad_iis,
+
+        //arithmetic that also stores the result in slot c
+        adt_ss,
+        adt_si,
+        adt_is,
+        sbt_ss,
+        sbt_si,
+        sbt_is,
+        mlt_ss,
+        mlt_si,
+        mlt_is,
+        dvt_ss,
+        dvt_si,
+        dvt_is,
+
+        lda, //load immediate b into the A register
+        ldt, //load immediate b into the A register and slot c
+        sfl, //set the flag to a
+        trp, //raise the error code a
+
+        jpz,
+        jmp,
+        hlt,
+        jsr,
+        ret,
+        put_s,
+        put_i,
+
+        num_op_codes
+    };
+
+    /**
+    * \brief Decoded instruction. Stack operands are frame-relative slots, immediate operands index PreparedVMData::immediate_values
+    */
+    struct PreparedInstruction
+    {
+        PreparedOpCode op_code{PreparedOpCode::num_op_codes};
+        std::uint32_t a{};
+        std::uint32_t b{};
+        std::uint32_t c{}; //only used by fused instructions
+    };
+
+    struct PreparedCallFrameDescriptor
+    {
+        std::uint32_t size{1};
+
+        std::vector<PreparedInstruction> instructions{};
+    };
+
+    /**
+    * \brief Load-time form of VMData. Can be kept around next to the VMData it was prepared from
+    */
+    struct PreparedVMData
+    {
+        std::uint32_t num_input_identifiers{};
+        std::uint32_t num_output_identifiers{};
+
+        std::vector<double> immediate_values{};
+        std::vector<PreparedCallFrameDescriptor> call_frames{};
+    };
+
+    /**
+    * \brief Resolve the operand kinds of every instruction in data and fold instructions that only use immediate values
+    *
+    * Jump offsets and call targets are validated here, so the prepared VM does not need to check them while executing.
+    */
+    [[nodiscard]] std::variant<VMErrorCode, PreparedVMData> prepare(const VMData& data) noexcept;
+
+} //namespace RaychelScript::VM
+
+#endif //!RAYCHELSCRIPT_VM_PREPARED_VM_DATA_H
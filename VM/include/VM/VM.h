@@ -28,10 +28,12 @@
 #ifndef RAYCHELSCRIPT_VM_H
 #define RAYCHELSCRIPT_VM_H
 
+#include "PreparedVMData.h"
 #include "VMErrorCode.h"
 #include "VMState.h"
 
 #include "RaychelCore/Finally.h"
+#include "shared/Misc/BatchExecutor.h"
 
 #include <algorithm>
 #include <array>
@@ -45,10 +47,106 @@
 
 namespace RaychelScript::VM {
 
+    /**
+    * \brief Execute a script
+    *
+    * data is only read and all mutable state is allocated from memory_resource, so the same VMData may be executed on several
+    * threads at once as long as every thread uses its own memory_resource. The same goes for the other data types below except
+    * LazyVMData, whose loader is not synchronized.
+    */
     [[nodiscard]] VMErrorCode execute(
         const VMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
         std::size_t memory_size, std::pmr::memory_resource* memory_resource) noexcept;
 
+    /**
+    * \brief Execute a script with memoisation of pure functions enabled
+    *
+    * Calls to frames that call_cache caches are looked up before jumping into the callee, and their results are recorded once
+    * they return. The cache keeps its entries between runs, so it should be created with make_call_cache() for exactly this
+    * data. Only call frames produced by the Assembler are known to be pure.
+    */
+    [[nodiscard]] VMErrorCode execute(
+        const VMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* memory_resource, CallCache& call_cache) noexcept;
+
+    /**
+    * \brief Create a memoisation cache with capacity entries for every pure call frame of data
+    *
+    * Calls are only memoised up to a nesting depth of max_pending_calls, which should match the stack size passed to execute()
+    */
+    [[nodiscard]] CallCache make_call_cache(
+        const VMData& data, std::size_t capacity = CallCache::default_capacity,
+        std::size_t max_pending_calls = CallCache::default_max_pending_calls) noexcept;
+
+    /**
+    * \brief Execute a script whose call frames have been linked into a single code segment (see link())
+    */
+    [[nodiscard]] VMErrorCode execute(
+        const LinkedVMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* memory_resource) noexcept;
+
+    /**
+    * \brief Execute a script straight from a view, for example into a memory mapped RSBF file
+    */
+    [[nodiscard]] VMErrorCode execute(
+        const VMDataView& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* memory_resource) noexcept;
+
+    /**
+    * \brief Execute a script whose call frames are loaded the first time they are called
+    */
+    [[nodiscard]] VMErrorCode execute(
+        const LazyVMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* memory_resource) noexcept;
+
+    /**
+    * \brief Execute a script that has been run through prepare()
+    */
+    [[nodiscard]] VMErrorCode execute(
+        const PreparedVMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* memory_resource) noexcept;
+
+    /**
+    * \brief Execute a script for count input vectors at once
+    *
+    * Inputs and outputs are laid out as structure-of-arrays: input #i of invocation #k lives at input_values[i * count + k]
+    * and output #j of invocation #k is written to output_values[j * count + k].
+    * The invocations are run in groups of batch_lane_count(), so every instruction is only dispatched once per group.
+    */
+    [[nodiscard]] VMErrorCode execute_batch(
+        const VMData& data, std::span<const double> input_values, std::span<double> output_values, std::size_t count,
+        std::size_t stack_size, std::size_t memory_size, std::pmr::memory_resource* memory_resource) noexcept;
+
+    /**
+    * \brief Number of invocations execute_batch() runs side by side, set by RAYCHELSCRIPT_VM_BATCH_LANE_COUNT
+    */
+    [[nodiscard]] std::size_t batch_lane_count() noexcept;
+
+    /**
+    * \brief Execute a script for count input vectors, split into chunks that run on the threads of executor
+    *
+    * Uses the same layout as execute_batch(). Every chunk allocates its stack and memory from the arena of its worker.
+    */
+    [[nodiscard]] inline VMErrorCode execute_parallel(
+        const VMData& data, std::span<const double> input_values, std::span<double> output_values, std::size_t count,
+        std::size_t stack_size, std::size_t memory_size, BatchExecutor& executor) noexcept
+    {
+        if (input_values.size() != data.num_input_identifiers * count)
+            return VMErrorCode::mismatched_inputs;
+
+        if (output_values.size() != data.num_output_identifiers * count)
+            return VMErrorCode::mismatched_outputs;
+
+        const auto kernel = [&data, stack_size, memory_size](
+                                std::span<const double> chunk_inputs, std::span<double> chunk_outputs, std::size_t chunk_count,
+                                std::pmr::memory_resource* arena) {
+            return execute_batch(data, chunk_inputs, chunk_outputs, chunk_count, stack_size, memory_size, arena);
+        };
+
+        return executor.run(
+            kernel, input_values, output_values, data.num_input_identifiers, data.num_output_identifiers, count);
+    }
+
     namespace details {
 
         void debug_log_vm_memory(const auto& buf, std::size_t stack_size)
@@ -70,7 +168,7 @@ namespace RaychelScript::VM {
                             std::cout << "| ";
                     }
                     std::cout << "= CallFrame{ip=0x" << std::setw(16)
-                              << reinterpret_cast<const uintptr_t>(frame.instruction_pointer.base()) << ", size=0x" << frame.size
+                              << reinterpret_cast<const uintptr_t>(frame.instruction_pointer) << ", size=0x" << frame.size
                               << '}';
                     i += 8U;
                 } else {
@@ -92,12 +190,14 @@ namespace RaychelScript::VM {
 #endif
         }
 
-        template <typename OutputContainer, std::size_t stack_size, std::size_t memory_size, typename Init>
+        template <typename OutputContainer, std::size_t stack_size, std::size_t memory_size, typename Data, typename Init>
         std::variant<VMErrorCode, OutputContainer>
-        do_execute(const VMData& data, std::span<const double> input_values, Init&& init)
+        do_execute(const Data& data, std::span<const double> input_values, Init&& init)
         {
-            std::array<std::byte, stack_size * sizeof(VMState::CallFrame) + memory_size * sizeof(double)> buf{};
-            std::pmr::monotonic_buffer_resource resource{buf.data(), buf.size(), std::pmr::null_memory_resource()};
+            //Room for the frame tables of most scripts. Larger ones spill onto the heap
+            constexpr auto frame_table_size = 256U * sizeof(VMState::FrameTableEntry);
+            std::array<std::byte, stack_size * sizeof(VMState::CallFrame) + frame_table_size + memory_size * sizeof(double)> buf;
+            std::pmr::monotonic_buffer_resource resource{buf.data(), buf.size(), std::pmr::get_default_resource()};
             OutputContainer outputs{};
             init(outputs);
 
@@ -112,7 +212,8 @@ namespace RaychelScript::VM {
         template <std::size_t NumOutputs, std::size_t stack_size, std::size_t memory_size>
         struct DoExecute
         {
-            auto operator()(const VMData& data, std::span<const double> input_values) const noexcept
+            template <typename Data>
+            auto operator()(const Data& data, std::span<const double> input_values) const noexcept
             {
                 return do_execute<std::array<double, NumOutputs>, stack_size, memory_size>(data, input_values, [](auto&) {});
             }
@@ -121,7 +222,8 @@ namespace RaychelScript::VM {
         template <::std::size_t stack_size, ::std::size_t memory_size>
         struct DoExecute<std::dynamic_extent, stack_size, memory_size>
         {
-            auto operator()(const VMData& data, std::span<const double> input_values) const noexcept
+            template <typename Data>
+            auto operator()(const Data& data, std::span<const double> input_values) const noexcept
             {
                 return do_execute<std::vector<double>, stack_size, memory_size>(
                     data, input_values, [cap = data.num_output_identifiers](auto& v) { v.resize(cap); });
@@ -135,6 +237,45 @@ namespace RaychelScript::VM {
         return details::DoExecute<NumOutputs, stack_size, memory_size>{}(data, input_values);
     }
 
+    template <std::size_t NumOutputs, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U>
+    [[nodiscard]] auto execute(const LinkedVMData& data, std::span<const double> input_values) noexcept
+    {
+        return details::DoExecute<NumOutputs, stack_size, memory_size>{}(data, input_values);
+    }
+
+    template <std::size_t NumOutputs, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U>
+    [[nodiscard]] auto execute(const VMDataView& data, std::span<const double> input_values) noexcept
+    {
+        return details::DoExecute<NumOutputs, stack_size, memory_size>{}(data, input_values);
+    }
+
+    template <std::size_t NumOutputs, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U>
+    [[nodiscard]] auto execute(const LazyVMData& data, std::span<const double> input_values) noexcept
+    {
+        return details::DoExecute<NumOutputs, stack_size, memory_size>{}(data, input_values);
+    }
+
+    template <std::size_t NumOutputs, std::size_t stack_size = 128U, std::size_t memory_size = 1'024U>
+    [[nodiscard]] auto execute(const PreparedVMData& data, std::span<const double> input_values) noexcept
+    {
+        return details::DoExecute<NumOutputs, stack_size, memory_size>{}(data, input_values);
+    }
+
+    template <std::size_t stack_size = 128U, std::size_t memory_size = 1'024U>
+    [[nodiscard]] VMErrorCode
+    execute_batch(const VMData& data, std::span<const double> input_values, std::span<double> output_values, std::size_t count) noexcept
+    {
+        return execute_batch(data, input_values, output_values, count, stack_size, memory_size, std::pmr::get_default_resource());
+    }
+
+    template <std::size_t stack_size = 128U, std::size_t memory_size = 1'024U>
+    [[nodiscard]] VMErrorCode execute_parallel(
+        const VMData& data, std::span<const double> input_values, std::span<double> output_values, std::size_t count,
+        BatchExecutor& executor) noexcept
+    {
+        return execute_parallel(data, input_values, output_values, count, stack_size, memory_size, executor);
+    }
+
 } // namespace RaychelScript::VM
 
 #endif //!RAYCHELSCRIPT_VM_H
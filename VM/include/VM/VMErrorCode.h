@@ -44,6 +44,8 @@ namespace RaychelScript::VM {
         divide_by_zero,
         invalid_operand,
         memory_overflow,
+        unbound_context,
+        call_frame_not_loaded,
     };
 
     inline std::string_view error_code_to_reason_string(VMErrorCode code) noexcept
@@ -70,6 +72,10 @@ namespace RaychelScript::VM {
                 return "Invalid oprand to arithmetic operation";
             case memory_overflow:
                 return "Memory Overflow";
+            case unbound_context:
+                return "Execution context is not bound to a script";
+            case call_frame_not_loaded:
+                return "Call frame could not be loaded";
         }
 
         return "<unkown>";
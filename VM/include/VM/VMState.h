@@ -29,12 +29,17 @@
 #define RAYCHELSCRIPT_VM_STATE_H
 
 #include "VMErrorCode.h"
+#include "shared/Misc/CallCache.h"
+#include "shared/VM/LazyVMData.h"
+#include "shared/VM/LinkedVMData.h"
 #include "shared/VM/VMData.h"
+#include "shared/VM/VMDataView.h"
 
 #include <array>
 #include <concepts>
 #include <cstdint>
 #include <memory_resource>
+#include <span>
 #include <stack>
 #include <vector>
 
@@ -83,7 +88,7 @@ namespace RaychelScript::VM {
     struct VMState
     {
         struct CallFrame;
-        using InstructionPointer = std::vector<Assembly::Instruction>::const_iterator;
+        using InstructionPointer = const Assembly::Instruction*;
         using StackPointer = DynamicArray<double>::iterator;
         using FramePointer = CallFrame*;
 
@@ -93,11 +98,20 @@ namespace RaychelScript::VM {
             std::ptrdiff_t size{};
         };
 
-        explicit VMState(details::Range<StackPointer> memory, details::Range<FramePointer> stack, const VMData& data) noexcept;
+        //Call frame descriptors with their code resolved to a pointer. jsr indexes into a table of these.
+        //Entries without code belong to frames that have not been loaded yet (see FrameLoader)
+        using FrameTableEntry = CallFrame;
+
+        explicit VMState(
+            details::Range<StackPointer> memory, details::Range<FramePointer> stack, std::span<const double> immediate_values,
+            std::span<FrameTableEntry> frame_table, const FrameLoader* frame_loader = nullptr) noexcept;
 
         FramePointer frame_pointer;
         StackPointer stack_pointer;
 
+        //One past the highest memory location any call frame has reached so far
+        StackPointer high_water_mark;
+
         VMErrorCode error{};
         bool halt_flag : 1 {false};
         bool flag : 1 {false};
@@ -106,15 +120,32 @@ namespace RaychelScript::VM {
         std::size_t instruction_count{};
         std::size_t function_call_count{};
 
+        //Consulted by jsr if memoisation is enabled
+        CallCache* call_cache{};
+
         //NOLINTBEGIN(misc-misplaced-const)
         const FramePointer beginning_of_stack;
         const FramePointer end_of_stack;
         const StackPointer end_of_memory;
         //NOLINTEND(misc-misplaced-const)
 
-        const VMData& data;
+        const double* const immediate_values;
+        FrameTableEntry* const frame_table;
+        const std::size_t frame_table_size;
+        const FrameLoader* const frame_loader;
     };
 
+    /**
+    * \brief Fill out with the first out.size() call frames of data
+    */
+    void resolve_frame_table(const VMData& data, std::span<VMState::FrameTableEntry> out) noexcept;
+
+    void resolve_frame_table(const LinkedVMData& data, std::span<VMState::FrameTableEntry> out) noexcept;
+
+    void resolve_frame_table(const VMDataView& data, std::span<VMState::FrameTableEntry> out) noexcept;
+
+    void resolve_frame_table(const LazyVMData& data, std::span<VMState::FrameTableEntry> out) noexcept;
+
     std::vector<double> get_output_values(const VMState& state, const VM::VMData& data) noexcept;
 
     void dump_state(const VMState& state, const VMData& data) noexcept;
@@ -0,0 +1,475 @@
+/**
+* \file BatchVM.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the batched (SIMD) VM execution mode
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "VM/VM.h"
+
+#include "Lanes.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace RaychelScript::VM {
+
+    using Assembly::MemoryIndex;
+    using details::all_lanes;
+    using details::lane_count;
+    using details::LaneMask;
+    using details::Lanes;
+
+    namespace {
+
+        //Program counter of a lane that has returned from the current frame or halted
+        constexpr std::int32_t parked = std::numeric_limits<std::int32_t>::max();
+
+        /*
+        The batch VM runs lane_count script invocations side by side. Every lane has its own program counter, so lanes can
+        diverge at conditional jumps. At each step, the lanes with the lowest program counter execute the instruction at that
+        address together while all other lanes are masked off. For the structured control flow the assembler generates
+        (if/else and while), this makes diverged lanes meet up again at the end of the construct.
+        Function calls are made by all active lanes at once and the frame is popped once every lane in it has returned.
+        */
+        struct LaneFrame
+        {
+            const Assembly::Instruction* code{};
+            std::ptrdiff_t base{};
+            std::ptrdiff_t size{};
+            std::array<std::int32_t, lane_count> pc{};
+            LaneMask participating{};
+        };
+
+        struct BatchState
+        {
+            std::span<Lanes> memory;
+            std::span<const Lanes> immediates;
+            DynamicArray<LaneFrame>& frames;
+            std::size_t stack_size{};
+            std::ptrdiff_t high_water_mark{};
+            LaneMask flag{};
+            LaneMask halted{};
+        };
+
+        void set_pc(LaneFrame& frame, LaneMask lanes, std::int32_t pc) noexcept
+        {
+            for (std::size_t lane{}; lane != lane_count; ++lane) {
+                if (((lanes >> lane) & 1U) != 0)
+                    frame.pc[lane] = pc;
+            }
+        }
+
+        Lanes& location(BatchState& state, const LaneFrame& frame, MemoryIndex index) noexcept
+        {
+            return state.memory[static_cast<std::size_t>(frame.base + index.value())];
+        }
+
+        Lanes value(BatchState& state, const LaneFrame& frame, MemoryIndex index) noexcept
+        {
+            if (index.type() == MemoryIndex::ValueType::immediate)
+                return state.immediates[index.value()];
+            return location(state, frame, index);
+        }
+
+        //Only lanes in the active mask may be written to, all others are waiting for their turn at another address
+        void assign(Lanes& destination, Lanes value, LaneMask active) noexcept
+        {
+            if (active == all_lanes) [[likely]] {
+                destination = value;
+                return;
+            }
+            destination = details::select(active, value, destination);
+        }
+
+        template <typename F>
+        Lanes per_lane(Lanes a, Lanes b, F&& f) noexcept
+        {
+            const auto xs = details::to_array(a);
+            const auto ys = details::to_array(b);
+            std::array<double, lane_count> res{};
+            for (std::size_t i{}; i != lane_count; ++i) {
+                res[i] = f(xs[i], ys[i]);
+            }
+            return details::from_array(res);
+        }
+
+        bool any_zero(Lanes x, LaneMask active) noexcept
+        {
+            return (details::equal(x, details::broadcast(0.0)) & active) != 0;
+        }
+
+        VMErrorCode factorial(Lanes x, LaneMask active, Lanes& result) noexcept
+        {
+            const auto xs = details::to_array(x);
+            std::array<double, lane_count> res{};
+            for (std::size_t i{}; i != lane_count; ++i) {
+                res[i] = std::tgamma(xs[i] + 1);
+                if (((active >> i) & 1U) == 0)
+                    continue;
+                //These mirror the pole and domain errors the scalar VM reports
+                if (xs[i] + 1 == 0.0) [[unlikely]]
+                    return VMErrorCode::divide_by_zero;
+                if (std::isnan(res[i]) && !std::isnan(xs[i])) [[unlikely]]
+                    return VMErrorCode::invalid_operand;
+            }
+            result = details::from_array(res);
+            return VMErrorCode::ok;
+        }
+
+        VMErrorCode push_frame(BatchState& state, const CallFrameDescriptor& descriptor, LaneMask active) noexcept
+        {
+            if (state.frames.size() == state.stack_size) [[unlikely]]
+                return VMErrorCode::stack_overflow;
+
+            const auto& caller = state.frames.back();
+            const auto base = caller.base + caller.size;
+            const auto size = static_cast<std::ptrdiff_t>(descriptor.size);
+
+            if (std::cmp_greater(base + size, state.memory.size())) [[unlikely]]
+                return VMErrorCode::memory_overflow;
+
+            LaneFrame frame{.code = descriptor.instructions.data(), .base = base, .size = size, .pc = {}, .participating = active};
+            frame.pc.fill(parked);
+            set_pc(frame, active, 0);
+
+            state.frames.push_back(frame);
+            state.high_water_mark = std::max(state.high_water_mark, base + size);
+            return VMErrorCode::ok;
+        }
+
+        void pop_frame(BatchState& state) noexcept
+        {
+            const auto callee = state.frames.back();
+            state.frames.pop_back();
+            auto& caller = state.frames.back();
+
+            const auto returned = callee.participating & ~state.halted;
+            //Like in the scalar VM, the result of the call is transferred through the zero location
+            assign(
+                state.memory[static_cast<std::size_t>(caller.base)],
+                state.memory[static_cast<std::size_t>(callee.base)],
+                returned);
+            set_pc(caller, callee.participating & state.halted, parked);
+        }
+
+        //NOLINTNEXTLINE(readability-function-cognitive-complexity): this is the main interpreter loop
+        VMErrorCode run_lane_group(BatchState& state, const VMData& data) noexcept
+        {
+            using enum Assembly::OpCode;
+
+            while (true) {
+                auto& frame = state.frames.back();
+
+                //Schedule the lanes with the lowest program counter
+                std::int32_t pc{parked};
+                LaneMask active{};
+                for (std::size_t lane{}; lane != lane_count; ++lane) {
+                    const auto lane_pc = frame.pc[lane];
+                    if (lane_pc < pc) {
+                        pc = lane_pc;
+                        active = 1U << lane;
+                    } else if (lane_pc == pc && lane_pc != parked) {
+                        active |= 1U << lane;
+                    }
+                }
+
+                if (active == 0) {
+                    //Every lane in this frame has returned or halted
+                    if (state.frames.size() == 1)
+                        return VMErrorCode::ok;
+                    pop_frame(state);
+                    continue;
+                }
+
+                const auto& instruction = frame.code[pc]; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                const auto a = instruction.index1();
+                const auto b = instruction.index2();
+                const auto c = instruction.index3();
+                auto& result = state.memory[static_cast<std::size_t>(frame.base)];
+
+                std::int32_t next_pc{pc + 1};
+
+                switch (instruction.op_code()) {
+                    case mov:
+                        assign(location(state, frame, b), value(state, frame, a), active);
+                        break;
+                    case add:
+                        assign(result, value(state, frame, a) + value(state, frame, b), active);
+                        break;
+                    case sub:
+                        assign(result, value(state, frame, a) - value(state, frame, b), active);
+                        break;
+                    case mul:
+                        assign(result, value(state, frame, a) * value(state, frame, b), active);
+                        break;
+                    case div: {
+                        const auto divisor = value(state, frame, b);
+                        if (any_zero(divisor, active)) [[unlikely]]
+                            return VMErrorCode::divide_by_zero;
+                        assign(result, value(state, frame, a) / divisor, active);
+                        break;
+                    }
+                    case mag:
+                        assign(result, details::abs(value(state, frame, a)), active);
+                        break;
+                    case fac: {
+                        Lanes res{};
+                        if (const auto ec = factorial(value(state, frame, a), active, res); ec != VMErrorCode::ok) [[unlikely]]
+                            return ec;
+                        assign(result, res, active);
+                        break;
+                    }
+                    case pow:
+                        assign(
+                            result,
+                            per_lane(value(state, frame, a), value(state, frame, b), [](double x, double y) { return std::pow(x, y); }),
+                            active);
+                        break;
+                    case inc: {
+                        auto& loc = location(state, frame, a);
+                        assign(loc, loc + value(state, frame, b), active);
+                        break;
+                    }
+                    case dec: {
+                        auto& loc = location(state, frame, a);
+                        assign(loc, loc - value(state, frame, b), active);
+                        break;
+                    }
+                    case mas: {
+                        auto& loc = location(state, frame, a);
+                        assign(loc, loc * value(state, frame, b), active);
+                        break;
+                    }
+                    case das: {
+                        const auto divisor = value(state, frame, b);
+                        if (any_zero(divisor, active)) [[unlikely]]
+                            return VMErrorCode::divide_by_zero;
+                        auto& loc = location(state, frame, a);
+                        assign(loc, loc / divisor, active);
+                        break;
+                    }
+                    case pas: {
+                        auto& loc = location(state, frame, a);
+                        assign(loc, per_lane(loc, value(state, frame, b), [](double x, double y) { return std::pow(x, y); }), active);
+                        break;
+                    }
+                    case clt:
+                        state.flag = (state.flag & ~active) | (details::less_than(value(state, frame, a), value(state, frame, b)) & active);
+                        break;
+                    case cgt:
+                        state.flag =
+                            (state.flag & ~active) | (details::greater_than(value(state, frame, a), value(state, frame, b)) & active);
+                        break;
+                    case ceq:
+                        state.flag = (state.flag & ~active) | (details::equal(value(state, frame, a), value(state, frame, b)) & active);
+                        break;
+                    case cne:
+                        state.flag =
+                            (state.flag & ~active) | (details::not_equal(value(state, frame, a), value(state, frame, b)) & active);
+                        break;
+                    case jpz: {
+                        const auto taken = active & ~state.flag;
+                        set_pc(frame, taken, pc + a.offset());
+                        set_pc(frame, active & ~taken, pc + 1);
+                        continue;
+                    }
+                    case jmp:
+                        next_pc = pc + a.offset();
+                        break;
+                    case hlt:
+                        state.halted |= active;
+                        next_pc = parked;
+                        break;
+                    case jsr: {
+                        if (a.value() >= data.call_frames.size()) [[unlikely]]
+                            return VMErrorCode::invalid_operand;
+                        set_pc(frame, active, pc + 1);
+                        if (const auto ec = push_frame(state, data.call_frames[a.value()], active); ec != VMErrorCode::ok)
+                            [[unlikely]]
+                            return ec;
+                        continue;
+                    }
+                    case ret:
+                        if (state.frames.size() == 1) [[unlikely]]
+                            return VMErrorCode::stack_underflow;
+                        next_pc = parked;
+                        break;
+                    case put: {
+                        const auto index = static_cast<std::size_t>(frame.base + frame.size + b.value());
+                        if (index >= state.memory.size()) [[unlikely]]
+                            return VMErrorCode::memory_overflow;
+                        assign(state.memory[index], value(state, frame, a), active);
+                        break;
+                    }
+                    case jnl:
+                    case jng:
+                    case jne:
+                    case jeq: {
+                        //Lanes for which the comparison holds fall through, all others jump
+                        const auto x = value(state, frame, a);
+                        const auto y = value(state, frame, b);
+                        LaneMask holds{};
+                        switch (instruction.op_code()) {
+                            case jnl:
+                                holds = details::less_than(x, y);
+                                break;
+                            case jng:
+                                holds = details::greater_than(x, y);
+                                break;
+                            case jne:
+                                holds = details::equal(x, y);
+                                break;
+                            default:
+                                holds = details::not_equal(x, y);
+                                break;
+                        }
+                        const auto taken = active & ~holds;
+                        set_pc(frame, taken, pc + c.offset());
+                        set_pc(frame, active & ~taken, pc + 1);
+                        continue;
+                    }
+                    case mad: {
+                        const auto product = value(state, frame, a) * value(state, frame, b);
+                        assign(result, product + value(state, frame, c), active);
+                        break;
+                    }
+                    case adt:
+                        assign(result, value(state, frame, a) + value(state, frame, b), active);
+                        assign(location(state, frame, c), result, active);
+                        break;
+                    case sbt:
+                        assign(result, value(state, frame, a) - value(state, frame, b), active);
+                        assign(location(state, frame, c), result, active);
+                        break;
+                    case mlt:
+                        assign(result, value(state, frame, a) * value(state, frame, b), active);
+                        assign(location(state, frame, c), result, active);
+                        break;
+                    case dvt: {
+                        const auto divisor = value(state, frame, b);
+                        if (any_zero(divisor, active)) [[unlikely]]
+                            return VMErrorCode::divide_by_zero;
+                        assign(result, value(state, frame, a) / divisor, active);
+                        assign(location(state, frame, c), result, active);
+                        break;
+                    }
+                    default:
+                        return VMErrorCode::unknown_opcode;
+                }
+
+                set_pc(frame, active, next_pc);
+            }
+        }
+
+        //Copy up to lane_count values that are count elements apart from the SoA column
+        Lanes load_column(std::span<const double> column, std::size_t first, std::size_t num_lanes) noexcept
+        {
+            if (num_lanes == lane_count)
+                return details::load(&column[first]);
+            std::array<double, lane_count> values{};
+            std::copy_n(&column[first], num_lanes, values.begin());
+            return details::from_array(values);
+        }
+
+        void store_column(std::span<double> column, std::size_t first, std::size_t num_lanes, Lanes x) noexcept
+        {
+            if (num_lanes == lane_count) {
+                details::store(&column[first], x);
+                return;
+            }
+            const auto values = details::to_array(x);
+            std::copy_n(values.begin(), num_lanes, &column[first]);
+        }
+
+    } // namespace
+
+    std::size_t batch_lane_count() noexcept
+    {
+        return lane_count;
+    }
+
+    VMErrorCode execute_batch(
+        const VMData& data, std::span<const double> input_values, std::span<double> output_values, std::size_t count,
+        std::size_t stack_size, std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    {
+        if (input_values.size() != data.num_input_identifiers * count)
+            return VMErrorCode::mismatched_inputs;
+
+        if (output_values.size() != data.num_output_identifiers * count)
+            return VMErrorCode::mismatched_outputs;
+
+        if (count == 0)
+            return VMErrorCode::ok;
+
+        const auto& global_frame = data.call_frames.front();
+        const auto first_output = 1U + static_cast<std::size_t>(data.num_input_identifiers);
+        if (std::cmp_greater(global_frame.size, memory_size) || first_output + data.num_output_identifiers > memory_size)
+            return VMErrorCode::memory_overflow;
+
+        DynamicArray<Lanes> memory(memory_size, details::broadcast(0.0), resource);
+        DynamicArray<LaneFrame> frames{resource};
+        frames.reserve(stack_size);
+
+        DynamicArray<Lanes> immediates{resource};
+        immediates.reserve(data.immediate_values.size());
+        for (const auto value : data.immediate_values) {
+            immediates.push_back(details::broadcast(value));
+        }
+
+        BatchState state{.memory = memory, .immediates = immediates, .frames = frames, .stack_size = stack_size};
+
+        for (std::size_t first{}; first < count; first += lane_count) {
+            const auto num_lanes = std::min(lane_count, count - first);
+            const auto valid_lanes = (1U << num_lanes) - 1U;
+
+            //Only the part of memory touched by the previous group has to be cleared
+            std::fill_n(memory.begin(), state.high_water_mark, details::broadcast(0.0));
+            state.high_water_mark = global_frame.size;
+            state.flag = 0;
+            state.halted = all_lanes & ~valid_lanes;
+
+            frames.clear();
+            LaneFrame frame{
+                .code = global_frame.instructions.data(), .base = 0, .size = global_frame.size, .pc = {}, .participating = valid_lanes};
+            frame.pc.fill(parked);
+            set_pc(frame, valid_lanes, 0);
+            frames.push_back(frame);
+
+            for (std::size_t i{}; i != data.num_input_identifiers; ++i) {
+                memory[1U + i] = load_column(input_values.subspan(i * count, count), first, num_lanes);
+            }
+
+            if (const auto ec = run_lane_group(state, data); ec != VMErrorCode::ok) [[unlikely]]
+                return ec;
+
+            for (std::size_t j{}; j != data.num_output_identifiers; ++j) {
+                store_column(output_values.subspan(j * count, count), first, num_lanes, memory[first_output + j]);
+            }
+        }
+
+        return VMErrorCode::ok;
+    }
+
+} // namespace RaychelScript::VM
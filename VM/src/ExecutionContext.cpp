@@ -0,0 +1,132 @@
+/**
+* \file ExecutionContext.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the reusable VM execution context
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "VM/ExecutionContext.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace RaychelScript::VM {
+
+    //defined in VM.cpp
+    VMErrorCode do_execute(VMState& state);
+
+    ExecutionContext::ExecutionContext(std::size_t stack_size, std::size_t memory_size, std::pmr::memory_resource* memory_resource)
+        : frame_table_(memory_resource), call_stack_(stack_size, memory_resource), memory_(memory_size, 0.0, memory_resource)
+    {}
+
+    ExecutionContext::ExecutionContext(
+        const VMData& data, std::size_t stack_size, std::size_t memory_size, std::pmr::memory_resource* memory_resource)
+        : ExecutionContext{stack_size, memory_size, memory_resource}
+    {
+        bind(data);
+    }
+
+    ExecutionContext::ExecutionContext(
+        const LinkedVMData& data, std::size_t stack_size, std::size_t memory_size, std::pmr::memory_resource* memory_resource)
+        : ExecutionContext{stack_size, memory_size, memory_resource}
+    {
+        bind(data);
+    }
+
+    ExecutionContext::ExecutionContext(
+        const VMDataView& data, std::size_t stack_size, std::size_t memory_size, std::pmr::memory_resource* memory_resource)
+        : ExecutionContext{stack_size, memory_size, memory_resource}
+    {
+        bind(data);
+    }
+
+    void ExecutionContext::bind(const VMData& data) noexcept
+    {
+        num_input_identifiers_ = data.num_input_identifiers;
+        num_output_identifiers_ = data.num_output_identifiers;
+        immediate_values_ = data.immediate_values;
+
+        frame_table_.resize(data.call_frames.size());
+        resolve_frame_table(data, frame_table_);
+    }
+
+    void ExecutionContext::bind(const LinkedVMData& data) noexcept
+    {
+        bind(view_of(data));
+    }
+
+    void ExecutionContext::bind(const VMDataView& data) noexcept
+    {
+        num_input_identifiers_ = data.num_input_identifiers;
+        num_output_identifiers_ = data.num_output_identifiers;
+        immediate_values_ = data.immediate_values;
+
+        frame_table_.resize(data.call_frames.size());
+        resolve_frame_table(data, frame_table_);
+    }
+
+    VMErrorCode ExecutionContext::run(std::span<const double> input_values, std::span<double> output_values) noexcept
+    {
+        if (!is_bound()) [[unlikely]]
+            return VMErrorCode::unbound_context;
+
+        if (std::cmp_not_equal(input_values.size(), num_input_identifiers_))
+            return VMErrorCode::mismatched_inputs;
+
+        if (std::cmp_not_equal(output_values.size(), num_output_identifiers_))
+            return VMErrorCode::mismatched_outputs;
+
+        //The global frame is placed at the bottom of memory without any further checks, so it has to fit entirely
+        if (call_stack_.empty() || memory_.size() < input_values.size() + output_values.size() + 1U ||
+            std::cmp_greater(frame_table_.front().size, memory_.size())) [[unlikely]]
+            return VMErrorCode::memory_overflow;
+
+        //Only the part of memory the previous run could have written to needs to be cleared
+        std::fill_n(memory_.begin(), dirty_size_, 0.0);
+
+        std::copy(input_values.begin(), input_values.end(), std::next(memory_.begin()));
+
+        VMState state{
+            details::Range{memory_},
+            details::Range{call_stack_.data(), call_stack_.data() + call_stack_.size()},
+            immediate_values_,
+            frame_table_};
+
+        const auto ec = do_execute(state);
+
+        if (ec != VMErrorCode::ok) [[unlikely]] {
+            //Failed runs may have written past the high water mark (arguments to a call that overflowed, for example)
+            dirty_size_ = memory_.size();
+            return ec;
+        }
+
+        dirty_size_ = std::max(
+            static_cast<std::size_t>(state.high_water_mark - memory_.begin()), input_values.size() + output_values.size() + 1U);
+
+        const auto outputs_begin = std::next(memory_.begin(), static_cast<std::ptrdiff_t>(input_values.size() + 1U));
+        std::copy_n(outputs_begin, output_values.size(), output_values.begin());
+
+        return VMErrorCode::ok;
+    }
+
+} //namespace RaychelScript::VM
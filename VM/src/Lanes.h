@@ -0,0 +1,414 @@
+/**
+* \file Lanes.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for SIMD lane helpers used by the batch VM
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_VM_LANES_H
+#define RAYCHELSCRIPT_VM_LANES_H
+
+//This header is private to the VM library: its layout depends on the instruction set the library is compiled for
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+    #define RAYCHELSCRIPT_VM_LANES_AVX2 1
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #define RAYCHELSCRIPT_VM_LANES_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+#ifndef RAYCHELSCRIPT_VM_BATCH_LANE_COUNT
+    #define RAYCHELSCRIPT_VM_BATCH_LANE_COUNT 4
+#endif
+
+namespace RaychelScript::VM::details {
+
+    /**
+    * \brief Number of script invocations that are executed side by side by the batch VM
+    */
+    constexpr std::size_t lane_count = RAYCHELSCRIPT_VM_BATCH_LANE_COUNT;
+
+    static_assert(lane_count == 4U || lane_count == 8U, "The batch VM supports 4 or 8 lanes");
+
+    /**
+    * \brief Bit mask with one bit per lane. Bit N is set if lane N is active
+    */
+    using LaneMask = std::uint32_t;
+
+    constexpr LaneMask all_lanes = (1U << lane_count) - 1U;
+
+    /*
+    Every target provides a native register type holding register_width doubles and the primitive operations on it.
+    Lanes is made up of as many registers as it takes to hold lane_count doubles, so 8 lanes are two AVX2 registers, four SSE2
+    registers or eight plain doubles.
+    */
+#if RAYCHELSCRIPT_VM_LANES_AVX2
+
+    using Register = __m256d;
+    constexpr std::size_t register_width = 4U;
+
+    inline Register register_broadcast(double x) noexcept
+    {
+        return _mm256_set1_pd(x);
+    }
+
+    inline Register register_load(const double* ptr) noexcept
+    {
+        return _mm256_loadu_pd(ptr);
+    }
+
+    inline void register_store(double* ptr, Register x) noexcept
+    {
+        _mm256_storeu_pd(ptr, x);
+    }
+
+    inline Register register_add(Register a, Register b) noexcept
+    {
+        return _mm256_add_pd(a, b);
+    }
+
+    inline Register register_sub(Register a, Register b) noexcept
+    {
+        return _mm256_sub_pd(a, b);
+    }
+
+    inline Register register_mul(Register a, Register b) noexcept
+    {
+        return _mm256_mul_pd(a, b);
+    }
+
+    inline Register register_div(Register a, Register b) noexcept
+    {
+        return _mm256_div_pd(a, b);
+    }
+
+    inline Register register_abs(Register a) noexcept
+    {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+    }
+
+    inline LaneMask register_less_than(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+    }
+
+    inline LaneMask register_greater_than(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)));
+    }
+
+    inline LaneMask register_equal(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+    }
+
+    inline LaneMask register_not_equal(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ)));
+    }
+
+    //Take lanes from a where the mask bit is set, b otherwise
+    inline Register register_select(LaneMask mask, Register a, Register b) noexcept
+    {
+        const auto m = _mm256_castsi256_pd(_mm256_set_epi64x(
+            -static_cast<std::int64_t>((mask >> 3U) & 1U),
+            -static_cast<std::int64_t>((mask >> 2U) & 1U),
+            -static_cast<std::int64_t>((mask >> 1U) & 1U),
+            -static_cast<std::int64_t>(mask & 1U)));
+        return _mm256_blendv_pd(b, a, m);
+    }
+
+#elif RAYCHELSCRIPT_VM_LANES_SSE2
+
+    using Register = __m128d;
+    constexpr std::size_t register_width = 2U;
+
+    inline Register register_broadcast(double x) noexcept
+    {
+        return _mm_set1_pd(x);
+    }
+
+    inline Register register_load(const double* ptr) noexcept
+    {
+        return _mm_loadu_pd(ptr);
+    }
+
+    inline void register_store(double* ptr, Register x) noexcept
+    {
+        _mm_storeu_pd(ptr, x);
+    }
+
+    inline Register register_add(Register a, Register b) noexcept
+    {
+        return _mm_add_pd(a, b);
+    }
+
+    inline Register register_sub(Register a, Register b) noexcept
+    {
+        return _mm_sub_pd(a, b);
+    }
+
+    inline Register register_mul(Register a, Register b) noexcept
+    {
+        return _mm_mul_pd(a, b);
+    }
+
+    inline Register register_div(Register a, Register b) noexcept
+    {
+        return _mm_div_pd(a, b);
+    }
+
+    inline Register register_abs(Register a) noexcept
+    {
+        return _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+    }
+
+    inline LaneMask register_less_than(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm_movemask_pd(_mm_cmplt_pd(a, b)));
+    }
+
+    inline LaneMask register_greater_than(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm_movemask_pd(_mm_cmpgt_pd(a, b)));
+    }
+
+    inline LaneMask register_equal(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm_movemask_pd(_mm_cmpeq_pd(a, b)));
+    }
+
+    inline LaneMask register_not_equal(Register a, Register b) noexcept
+    {
+        return static_cast<LaneMask>(_mm_movemask_pd(_mm_cmpneq_pd(a, b)));
+    }
+
+    //Take lanes from a where the mask bit is set, b otherwise
+    inline Register register_select(LaneMask mask, Register a, Register b) noexcept
+    {
+        const auto m = _mm_castsi128_pd(
+            _mm_set_epi64x(-static_cast<std::int64_t>((mask >> 1U) & 1U), -static_cast<std::int64_t>(mask & 1U)));
+        return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+    }
+
+#else
+
+    using Register = double;
+    constexpr std::size_t register_width = 1U;
+
+    inline Register register_broadcast(double x) noexcept
+    {
+        return x;
+    }
+
+    inline Register register_load(const double* ptr) noexcept
+    {
+        return *ptr;
+    }
+
+    inline void register_store(double* ptr, Register x) noexcept
+    {
+        *ptr = x;
+    }
+
+    inline Register register_add(Register a, Register b) noexcept
+    {
+        return a + b;
+    }
+
+    inline Register register_sub(Register a, Register b) noexcept
+    {
+        return a - b;
+    }
+
+    inline Register register_mul(Register a, Register b) noexcept
+    {
+        return a * b;
+    }
+
+    inline Register register_div(Register a, Register b) noexcept
+    {
+        return a / b;
+    }
+
+    inline Register register_abs(Register a) noexcept
+    {
+        return a < 0.0 ? -a : a;
+    }
+
+    inline LaneMask register_less_than(Register a, Register b) noexcept
+    {
+        return a < b ? 1U : 0U;
+    }
+
+    inline LaneMask register_greater_than(Register a, Register b) noexcept
+    {
+        return a > b ? 1U : 0U;
+    }
+
+    inline LaneMask register_equal(Register a, Register b) noexcept
+    {
+        return a == b ? 1U : 0U;
+    }
+
+    inline LaneMask register_not_equal(Register a, Register b) noexcept
+    {
+        return a != b ? 1U : 0U;
+    }
+
+    //Take lanes from a where the mask bit is set, b otherwise
+    inline Register register_select(LaneMask mask, Register a, Register b) noexcept
+    {
+        return (mask & 1U) != 0 ? a : b;
+    }
+
+#endif
+
+    constexpr std::size_t registers_per_lanes = lane_count / register_width;
+
+    //One double per lane. std::array would drop the alignment attributes of the vector types, so use a plain array
+    struct Lanes
+    {
+        Register registers[registers_per_lanes]; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    };
+
+    template <typename F>
+    inline Lanes for_each_register(Lanes a, Lanes b, F&& f) noexcept
+    {
+        Lanes res{};
+        for (std::size_t i{}; i != registers_per_lanes; ++i) {
+            res.registers[i] = f(a.registers[i], b.registers[i]);
+        }
+        return res;
+    }
+
+    template <typename F>
+    inline LaneMask for_each_register_mask(Lanes a, Lanes b, F&& f) noexcept
+    {
+        LaneMask res{};
+        for (std::size_t i{}; i != registers_per_lanes; ++i) {
+            res |= f(a.registers[i], b.registers[i]) << (i * register_width);
+        }
+        return res;
+    }
+
+    inline Lanes broadcast(double x) noexcept
+    {
+        Lanes res{};
+        for (auto& reg : res.registers) {
+            reg = register_broadcast(x);
+        }
+        return res;
+    }
+
+    inline Lanes load(const double* ptr) noexcept
+    {
+        Lanes res{};
+        for (std::size_t i{}; i != registers_per_lanes; ++i) {
+            res.registers[i] = register_load(ptr + i * register_width); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+        return res;
+    }
+
+    inline void store(double* ptr, Lanes x) noexcept
+    {
+        for (std::size_t i{}; i != registers_per_lanes; ++i) {
+            register_store(ptr + i * register_width, x.registers[i]); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    }
+
+    inline Lanes operator+(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register(a, b, register_add);
+    }
+
+    inline Lanes operator-(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register(a, b, register_sub);
+    }
+
+    inline Lanes operator*(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register(a, b, register_mul);
+    }
+
+    inline Lanes operator/(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register(a, b, register_div);
+    }
+
+    inline Lanes abs(Lanes a) noexcept
+    {
+        return for_each_register(a, a, [](Register x, Register) { return register_abs(x); });
+    }
+
+    inline LaneMask less_than(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register_mask(a, b, register_less_than);
+    }
+
+    inline LaneMask greater_than(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register_mask(a, b, register_greater_than);
+    }
+
+    inline LaneMask equal(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register_mask(a, b, register_equal);
+    }
+
+    inline LaneMask not_equal(Lanes a, Lanes b) noexcept
+    {
+        return for_each_register_mask(a, b, register_not_equal);
+    }
+
+    //Take lanes from a where the mask bit is set, b otherwise
+    inline Lanes select(LaneMask mask, Lanes a, Lanes b) noexcept
+    {
+        Lanes res{};
+        for (std::size_t i{}; i != registers_per_lanes; ++i) {
+            res.registers[i] = register_select(mask >> (i * register_width), a.registers[i], b.registers[i]);
+        }
+        return res;
+    }
+
+    inline std::array<double, lane_count> to_array(Lanes x) noexcept
+    {
+        std::array<double, lane_count> res{};
+        store(res.data(), x);
+        return res;
+    }
+
+    inline Lanes from_array(const std::array<double, lane_count>& values) noexcept
+    {
+        return load(values.data());
+    }
+
+} // namespace RaychelScript::VM::details
+
+#endif //!RAYCHELSCRIPT_VM_LANES_H
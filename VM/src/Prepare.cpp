@@ -0,0 +1,392 @@
+/**
+* \file Prepare.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the VM load-time preparation step
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "VM/PreparedVMData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+namespace RaychelScript::VM {
+
+    namespace {
+
+        using Assembly::Instruction;
+        using Assembly::MemoryIndex;
+        using Assembly::OpCode;
+
+        struct PreparingContext
+        {
+            const VMData& data;
+            PreparedVMData& prepared;
+            std::size_t frame_size{};
+            std::size_t max_frame_size{};
+            std::size_t number_of_instructions{};
+            std::size_t instruction_index{};
+            VMErrorCode error{VMErrorCode::ok};
+        };
+
+        PreparedInstruction fail(PreparingContext& ctx, VMErrorCode error) noexcept
+        {
+            ctx.error = error;
+            return PreparedInstruction{};
+        }
+
+        PreparedInstruction make_instruction(PreparedOpCode code, std::size_t a = 0U, std::size_t b = 0U, std::size_t c = 0U) noexcept
+        {
+            return PreparedInstruction{code, static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(c)};
+        }
+
+        //The specialised variants of an op code are laid out next to each other in the order ss, si, is (or s, i)
+        PreparedOpCode variant_of(PreparedOpCode base, std::uint8_t offset) noexcept
+        {
+            return static_cast<PreparedOpCode>(static_cast<std::uint8_t>(base) + offset);
+        }
+
+        bool is_immediate(MemoryIndex index) noexcept
+        {
+            return index.type() == MemoryIndex::ValueType::immediate;
+        }
+
+        bool is_valid_location(const PreparingContext& ctx, MemoryIndex index) noexcept
+        {
+            using enum MemoryIndex::ValueType;
+            return (index.type() == stack || index.type() == intermediate) && index.value() < ctx.frame_size;
+        }
+
+        bool is_valid_value(const PreparingContext& ctx, MemoryIndex index) noexcept
+        {
+            if (is_immediate(index))
+                return index.value() < ctx.data.immediate_values.size();
+            return is_valid_location(ctx, index);
+        }
+
+        double immediate_value(const PreparingContext& ctx, MemoryIndex index) noexcept
+        {
+            return ctx.data.immediate_values[index.value()];
+        }
+
+        PreparedInstruction load_immediate(PreparingContext& ctx, double value) noexcept
+        {
+            auto& immediates = ctx.prepared.immediate_values;
+            if (immediates.size() > std::numeric_limits<std::uint32_t>::max())
+                return fail(ctx, VMErrorCode::memory_overflow);
+
+            immediates.push_back(value);
+            return make_instruction(PreparedOpCode::lda, 0U, immediates.size() - 1U);
+        }
+
+        template <typename Operation>
+        PreparedInstruction prepare_binary(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base, Operation&& op)
+        {
+            const auto a = instruction.index1();
+            const auto b = instruction.index2();
+
+            if (!is_valid_value(ctx, a) || !is_valid_value(ctx, b))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            if (is_immediate(a) && is_immediate(b))
+                return std::invoke(op, immediate_value(ctx, a), immediate_value(ctx, b));
+
+            if (is_immediate(a))
+                return make_instruction(variant_of(base, 2U), a.value(), b.value());
+            if (is_immediate(b))
+                return make_instruction(variant_of(base, 1U), a.value(), b.value());
+            return make_instruction(base, a.value(), b.value());
+        }
+
+        template <typename Operation>
+        PreparedInstruction prepare_arithmetic(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base, Operation&& op)
+        {
+            return prepare_binary(ctx, instruction, base, [&](double a, double b) { return load_immediate(ctx, op(a, b)); });
+        }
+
+        template <typename Comparison>
+        PreparedInstruction prepare_comparison(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base, Comparison&& cmp)
+        {
+            return prepare_binary(ctx, instruction, base, [&](double a, double b) {
+                return make_instruction(PreparedOpCode::sfl, cmp(a, b) ? 1U : 0U);
+            });
+        }
+
+        PreparedInstruction prepare_division(PreparingContext& ctx, const Instruction& instruction)
+        {
+            const auto b = instruction.index2();
+            if (is_immediate(b) && is_valid_value(ctx, b) && immediate_value(ctx, b) == 0.0)
+                return make_instruction(PreparedOpCode::trp, static_cast<std::size_t>(VMErrorCode::divide_by_zero));
+
+            return prepare_arithmetic(ctx, instruction, PreparedOpCode::div_ss, std::divides{});
+        }
+
+        PreparedInstruction prepare_assignment(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base)
+        {
+            const auto a = instruction.index1();
+            const auto b = instruction.index2();
+
+            if (!is_valid_location(ctx, a) || !is_valid_value(ctx, b))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            if (base == PreparedOpCode::das_s && is_immediate(b) && immediate_value(ctx, b) == 0.0)
+                return make_instruction(PreparedOpCode::trp, static_cast<std::size_t>(VMErrorCode::divide_by_zero));
+
+            return make_instruction(variant_of(base, is_immediate(b) ? 1U : 0U), a.value(), b.value());
+        }
+
+        PreparedInstruction prepare_move(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base)
+        {
+            const auto from = instruction.index1();
+            const auto to = instruction.index2();
+
+            if (!is_valid_value(ctx, from))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            //put writes into the next call frame which we know nothing about yet, but it has to fit into the largest one
+            if (base == PreparedOpCode::mov_s ? !is_valid_location(ctx, to) : to.value() >= ctx.max_frame_size)
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            return make_instruction(variant_of(base, is_immediate(from) ? 1U : 0U), from.value(), to.value());
+        }
+
+        PreparedInstruction prepare_unary(PreparingContext& ctx, const Instruction& instruction)
+        {
+            const auto a = instruction.index1();
+            if (!is_valid_value(ctx, a))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            if (instruction.op_code() == OpCode::fac)
+                return make_instruction(is_immediate(a) ? PreparedOpCode::fac_i : PreparedOpCode::fac_s, a.value());
+
+            if (is_immediate(a))
+                return load_immediate(ctx, std::abs(immediate_value(ctx, a)));
+            return make_instruction(PreparedOpCode::mag_s, a.value());
+        }
+
+        bool is_valid_jump(const PreparingContext& ctx, MemoryIndex offset) noexcept
+        {
+            if (offset.type() != MemoryIndex::ValueType::jump_offset)
+                return false;
+
+            const auto target = static_cast<std::ptrdiff_t>(ctx.instruction_index) + static_cast<std::ptrdiff_t>(offset.offset());
+            return target >= 0 && std::cmp_less(target, ctx.number_of_instructions);
+        }
+
+        //Jump offsets are stored in two's complement. The prepared VM casts them back to std::int32_t
+        std::uint32_t prepared_offset(MemoryIndex offset) noexcept
+        {
+            return static_cast<std::uint32_t>(offset.offset());
+        }
+
+        PreparedInstruction prepare_jump(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode code)
+        {
+            const auto offset = instruction.index1();
+            if (!is_valid_jump(ctx, offset))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            return make_instruction(code, prepared_offset(offset));
+        }
+
+        template <typename Comparison>
+        PreparedInstruction prepare_branch(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base, Comparison&& cmp)
+        {
+            const auto offset = instruction.index3();
+            if (!is_valid_jump(ctx, offset))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            //A branch on two immediate values either always falls through or always jumps
+            auto prepared = prepare_binary(ctx, instruction, base, [&](double a, double b) {
+                return make_instruction(PreparedOpCode::jmp, cmp(a, b) ? 1U : prepared_offset(offset));
+            });
+            prepared.c = prepared_offset(offset);
+            return prepared;
+        }
+
+        PreparedInstruction prepare_multiply_add(PreparingContext& ctx, const Instruction& instruction)
+        {
+            const auto a = instruction.index1();
+            const auto b = instruction.index2();
+            const auto c = instruction.index3();
+
+            if (!is_valid_value(ctx, a) || !is_valid_value(ctx, b) || !is_valid_value(ctx, c))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            //The variants are ordered like a binary number where every immediate operand is a one bit
+            const auto kinds = (is_immediate(a) ? 4U : 0U) | (is_immediate(b) ? 2U : 0U) | (is_immediate(c) ? 1U : 0U);
+            if (kinds == 7U) {
+                const auto product = immediate_value(ctx, a) * immediate_value(ctx, b);
+                return load_immediate(ctx, product + immediate_value(ctx, c));
+            }
+
+            return make_instruction(variant_of(PreparedOpCode::mad_sss, static_cast<std::uint8_t>(kinds)), a.value(), b.value(), c.value());
+        }
+
+        template <typename Operation>
+        PreparedInstruction prepare_store(PreparingContext& ctx, const Instruction& instruction, PreparedOpCode base, Operation&& op)
+        {
+            const auto c = instruction.index3();
+            if (!is_valid_location(ctx, c))
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            if (base == PreparedOpCode::dvt_ss) {
+                const auto b = instruction.index2();
+                if (is_immediate(b) && is_valid_value(ctx, b) && immediate_value(ctx, b) == 0.0)
+                    return make_instruction(PreparedOpCode::trp, static_cast<std::size_t>(VMErrorCode::divide_by_zero));
+            }
+
+            auto prepared = prepare_binary(ctx, instruction, base, [&](double a, double b) {
+                auto load = load_immediate(ctx, op(a, b));
+                load.op_code = PreparedOpCode::ldt;
+                return load;
+            });
+            prepared.c = c.value();
+            return prepared;
+        }
+
+        PreparedInstruction prepare_call(PreparingContext& ctx, const Instruction& instruction)
+        {
+            const auto frame_index = instruction.index1().value();
+            if (frame_index >= ctx.data.call_frames.size())
+                return fail(ctx, VMErrorCode::invalid_operand);
+
+            return make_instruction(PreparedOpCode::jsr, frame_index);
+        }
+
+        PreparedInstruction prepare_instruction(PreparingContext& ctx, const Instruction& instruction)
+        {
+            using enum PreparedOpCode;
+
+            switch (instruction.op_code()) {
+                case OpCode::mov:
+                    return prepare_move(ctx, instruction, mov_s);
+                case OpCode::add:
+                    return prepare_arithmetic(ctx, instruction, add_ss, std::plus{});
+                case OpCode::sub:
+                    return prepare_arithmetic(ctx, instruction, sub_ss, std::minus{});
+                case OpCode::mul:
+                    return prepare_arithmetic(ctx, instruction, mul_ss, std::multiplies{});
+                case OpCode::div:
+                    return prepare_division(ctx, instruction);
+                case OpCode::mag:
+                case OpCode::fac:
+                    return prepare_unary(ctx, instruction);
+                case OpCode::pow:
+                    return prepare_arithmetic(ctx, instruction, pow_ss, [](double a, double b) { return std::pow(a, b); });
+                case OpCode::inc:
+                    return prepare_assignment(ctx, instruction, inc_s);
+                case OpCode::dec:
+                    return prepare_assignment(ctx, instruction, dec_s);
+                case OpCode::mas:
+                    return prepare_assignment(ctx, instruction, mas_s);
+                case OpCode::das:
+                    return prepare_assignment(ctx, instruction, das_s);
+                case OpCode::pas:
+                    return prepare_assignment(ctx, instruction, pas_s);
+                case OpCode::clt:
+                    return prepare_comparison(ctx, instruction, clt_ss, std::less{});
+                case OpCode::cgt:
+                    return prepare_comparison(ctx, instruction, cgt_ss, std::greater{});
+                case OpCode::ceq:
+                    return prepare_comparison(ctx, instruction, ceq_ss, std::equal_to{});
+                case OpCode::cne:
+                    return prepare_comparison(ctx, instruction, cne_ss, std::not_equal_to{});
+                case OpCode::jpz:
+                    return prepare_jump(ctx, instruction, jpz);
+                case OpCode::jmp:
+                    return prepare_jump(ctx, instruction, jmp);
+                case OpCode::hlt:
+                    return make_instruction(hlt);
+                case OpCode::jsr:
+                    return prepare_call(ctx, instruction);
+                case OpCode::ret:
+                    return make_instruction(ret);
+                case OpCode::put:
+                    return prepare_move(ctx, instruction, put_s);
+                case OpCode::jnl:
+                    return prepare_branch(ctx, instruction, jnl_ss, std::less{});
+                case OpCode::jng:
+                    return prepare_branch(ctx, instruction, jng_ss, std::greater{});
+                case OpCode::jne:
+                    return prepare_branch(ctx, instruction, jne_ss, std::equal_to{});
+                case OpCode::jeq:
+                    return prepare_branch(ctx, instruction, jeq_ss, std::not_equal_to{});
+                case OpCode::mad:
+                    return prepare_multiply_add(ctx, instruction);
+                case OpCode::adt:
+                    return prepare_store(ctx, instruction, adt_ss, std::plus{});
+                case OpCode::sbt:
+                    return prepare_store(ctx, instruction, sbt_ss, std::minus{});
+                case OpCode::mlt:
+                    return prepare_store(ctx, instruction, mlt_ss, std::multiplies{});
+                case OpCode::dvt:
+                    return prepare_store(ctx, instruction, dvt_ss, std::divides{});
+                case OpCode::num_op_codes:
+                    break;
+            }
+            return fail(ctx, VMErrorCode::unknown_opcode);
+        }
+
+    } // namespace
+
+    std::variant<VMErrorCode, PreparedVMData> prepare(const VMData& data) noexcept
+    {
+        if (data.call_frames.empty())
+            return VMErrorCode::invalid_operand;
+
+        PreparedVMData prepared{
+            .num_input_identifiers = data.num_input_identifiers,
+            .num_output_identifiers = data.num_output_identifiers,
+            .immediate_values = data.immediate_values,
+            .call_frames = {},
+        };
+        prepared.call_frames.reserve(data.call_frames.size());
+
+        PreparingContext ctx{data, prepared};
+        for (const auto& descriptor : data.call_frames) {
+            ctx.max_frame_size = std::max<std::size_t>(ctx.max_frame_size, descriptor.size);
+        }
+
+        for (const auto& descriptor : data.call_frames) {
+            ctx.frame_size = descriptor.size;
+            ctx.number_of_instructions = descriptor.instructions.size();
+
+            PreparedCallFrameDescriptor prepared_frame{descriptor.size, {}};
+            prepared_frame.instructions.reserve(descriptor.instructions.size());
+
+            for (ctx.instruction_index = 0U; ctx.instruction_index != ctx.number_of_instructions; ++ctx.instruction_index) {
+                prepared_frame.instructions.emplace_back(prepare_instruction(ctx, descriptor.instructions[ctx.instruction_index]));
+                if (ctx.error != VMErrorCode::ok)
+                    return ctx.error;
+            }
+
+            prepared.call_frames.emplace_back(std::move(prepared_frame));
+        }
+
+        return prepared;
+    }
+
+} //namespace RaychelScript::VM
@@ -0,0 +1,331 @@
+/**
+* \file PreparedVM.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for executing prepared VM data
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "VM/VM.h"
+
+#include <cerrno>
+#include <cfenv>
+#include <cmath>
+#include <utility>
+
+//GCC does not know this pragma and warns about it
+#ifdef __clang__
+    #pragma STDC FENV_ACCESS ON
+#endif
+
+namespace RaychelScript::VM {
+
+    namespace {
+
+        struct PreparedCallFrame
+        {
+            const PreparedInstruction* instruction_pointer{};
+            std::ptrdiff_t size{};
+        };
+
+        VMErrorCode factorial(double value, double& result) noexcept
+        {
+            if constexpr (math_errhandling & MATH_ERREXCEPT) { // NOLINT(hicpp-signed-bitwise)
+                std::feclearexcept(FE_DIVBYZERO | FE_INVALID);
+                result = std::tgamma(value + 1);
+                if (std::fetestexcept(FE_DIVBYZERO) != 0) [[unlikely]]
+                    return VMErrorCode::divide_by_zero;
+                if (std::fetestexcept(FE_INVALID) != 0) [[unlikely]]
+                    return VMErrorCode::invalid_operand;
+            } else {
+                errno = 0;
+                result = std::tgamma(value + 1);
+                const auto _errno = errno;
+                if (_errno == EDOM) [[unlikely]]
+                    return VMErrorCode::invalid_operand;
+                if (_errno == ERANGE) [[unlikely]]
+                    return VMErrorCode::divide_by_zero;
+            }
+            return VMErrorCode::ok;
+        }
+
+        //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic): the operands have been validated by prepare(). Only the
+        //target of put depends on the memory left at runtime, so it is checked here
+        VMErrorCode run(
+            const PreparedVMData& data, double* memory, const double* end_of_memory, PreparedCallFrame* stack,
+            const PreparedCallFrame* end_of_stack) noexcept
+        {
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpedantic"
+
+            constexpr static std::array labels{
+                &&mov_s,  &&mov_i,
+
+                &&add_ss, &&add_si, &&add_is, &&sub_ss, &&sub_si, &&sub_is, &&mul_ss, &&mul_si, &&mul_is,
+                &&div_ss, &&div_si, &&div_is, &&pow_ss, &&pow_si, &&pow_is,
+
+                &&mag_s,  &&fac_s,  &&fac_i,
+
+                &&inc_s,  &&inc_i,  &&dec_s,  &&dec_i,  &&mas_s,  &&mas_i,  &&das_s,  &&das_i,  &&pas_s,  &&pas_i,
+
+                &&clt_ss, &&clt_si, &&clt_is, &&cgt_ss, &&cgt_si, &&cgt_is,
+                &&ceq_ss, &&ceq_si, &&ceq_is, &&cne_ss, &&cne_si, &&cne_is,
+
+                &&jnl_ss, &&jnl_si, &&jnl_is, &&jng_ss, &&jng_si, &&jng_is,
+                &&jne_ss, &&jne_si, &&jne_is, &&jeq_ss, &&jeq_si, &&jeq_is,
+
+                &&mad_sss, &&mad_ssi, &&mad_sis, &&mad_sii, &&mad_iss, &&mad_isi, &&mad_iis,
+
+                &&adt_ss, &&adt_si, &&adt_is, &&sbt_ss, &&sbt_si, &&sbt_is,
+                &&mlt_ss, &&mlt_si, &&mlt_is, &&dvt_ss, &&dvt_si, &&dvt_is,
+
+                &&lda,    &&ldt,    &&sfl,    &&trp,
+
+                &&jpz,    &&jmp,    &&hlt,    &&jsr,    &&ret,    &&put_s,  &&put_i,
+            };
+            static_assert(labels.size() == static_cast<std::size_t>(PreparedOpCode::num_op_codes));
+
+            const double* const immediates = data.immediate_values.data();
+
+            const auto& global_frame = data.call_frames.front();
+            const PreparedInstruction* instruction_pointer = global_frame.instructions.data();
+            PreparedCallFrame* frame_pointer = stack;
+            double* stack_pointer = memory;
+            *frame_pointer = PreparedCallFrame{instruction_pointer, global_frame.size};
+
+            PreparedInstruction instruction{};
+            bool flag{false};
+            double operand{};
+
+    #define RAYCHELSCRIPT_PREPARED_VM_DISPATCH()                                                                                 \
+        instruction = *(instruction_pointer++);                                                                                  \
+        goto* labels[static_cast<std::size_t>(instruction.op_code)]
+
+    #define RAYCHELSCRIPT_PREPARED_VM_S(_operand) stack_pointer[instruction._operand]
+    #define RAYCHELSCRIPT_PREPARED_VM_I(_operand) immediates[instruction._operand]
+
+    #define RAYCHELSCRIPT_PREPARED_VM_BINARY(_name, _expr)                                                                       \
+        _name##_ss : {                                                                                                           \
+            const double a = RAYCHELSCRIPT_PREPARED_VM_S(a);                                                                     \
+            const double b = RAYCHELSCRIPT_PREPARED_VM_S(b);                                                                     \
+            _expr;                                                                                                               \
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();                                                                                \
+        }                                                                                                                        \
+        _name##_si : {                                                                                                           \
+            const double a = RAYCHELSCRIPT_PREPARED_VM_S(a);                                                                     \
+            const double b = RAYCHELSCRIPT_PREPARED_VM_I(b);                                                                     \
+            _expr;                                                                                                               \
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();                                                                                \
+        }                                                                                                                        \
+        _name##_is : {                                                                                                           \
+            const double a = RAYCHELSCRIPT_PREPARED_VM_I(a);                                                                     \
+            const double b = RAYCHELSCRIPT_PREPARED_VM_S(b);                                                                     \
+            _expr;                                                                                                               \
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();                                                                                \
+        }
+
+    #define RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT(_name, _expr)                                                                   \
+        _name##_s : {                                                                                                            \
+            double& a = RAYCHELSCRIPT_PREPARED_VM_S(a);                                                                          \
+            const double b = RAYCHELSCRIPT_PREPARED_VM_S(b);                                                                     \
+            _expr;                                                                                                               \
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();                                                                                \
+        }                                                                                                                        \
+        _name##_i : {                                                                                                            \
+            double& a = RAYCHELSCRIPT_PREPARED_VM_S(a);                                                                          \
+            const double b = RAYCHELSCRIPT_PREPARED_VM_I(b);                                                                     \
+            _expr;                                                                                                               \
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();                                                                                \
+        }
+
+    #define RAYCHELSCRIPT_PREPARED_VM_JUMP(_offset)                                                                              \
+        instruction_pointer += static_cast<std::ptrdiff_t>(static_cast<std::int32_t>(_offset)) - 1
+
+    #define RAYCHELSCRIPT_PREPARED_VM_MAD(_kinds, _a, _b, _c)                                                                    \
+        mad_##_kinds : {                                                                                                         \
+            const double product = RAYCHELSCRIPT_PREPARED_VM_##_a(a) * RAYCHELSCRIPT_PREPARED_VM_##_b(b);                        \
+            *stack_pointer = product + RAYCHELSCRIPT_PREPARED_VM_##_c(c);                                                        \
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();                                                                                \
+        }
+
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+
+        mov_s:
+            RAYCHELSCRIPT_PREPARED_VM_S(b) = RAYCHELSCRIPT_PREPARED_VM_S(a);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        mov_i:
+            RAYCHELSCRIPT_PREPARED_VM_S(b) = RAYCHELSCRIPT_PREPARED_VM_I(a);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(add, *stack_pointer = a + b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(sub, *stack_pointer = a - b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(mul, *stack_pointer = a * b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(div, if (b == 0.0) [[unlikely]] return VMErrorCode::divide_by_zero; *stack_pointer = a / b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(pow, *stack_pointer = std::pow(a, b))
+
+        mag_s:
+            *stack_pointer = std::abs(RAYCHELSCRIPT_PREPARED_VM_S(a));
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        fac_s:
+            operand = RAYCHELSCRIPT_PREPARED_VM_S(a);
+            goto fac;
+        fac_i:
+            operand = RAYCHELSCRIPT_PREPARED_VM_I(a);
+        fac:
+            if (const auto ec = factorial(operand, *stack_pointer); ec != VMErrorCode::ok) [[unlikely]]
+                return ec;
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+
+            RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT(inc, a += b)
+            RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT(dec, a -= b)
+            RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT(mas, a *= b)
+            RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT(das, if (b == 0.0) [[unlikely]] return VMErrorCode::divide_by_zero; a /= b)
+            RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT(pas, a = std::pow(a, b))
+
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(clt, flag = a < b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(cgt, flag = a > b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(ceq, flag = a == b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(cne, flag = a != b)
+
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(jnl, if (!(a < b)) RAYCHELSCRIPT_PREPARED_VM_JUMP(instruction.c))
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(jng, if (!(a > b)) RAYCHELSCRIPT_PREPARED_VM_JUMP(instruction.c))
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(jne, if (!(a == b)) RAYCHELSCRIPT_PREPARED_VM_JUMP(instruction.c))
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(jeq, if (!(a != b)) RAYCHELSCRIPT_PREPARED_VM_JUMP(instruction.c))
+
+            RAYCHELSCRIPT_PREPARED_VM_MAD(sss, S, S, S)
+            RAYCHELSCRIPT_PREPARED_VM_MAD(ssi, S, S, I)
+            RAYCHELSCRIPT_PREPARED_VM_MAD(sis, S, I, S)
+            RAYCHELSCRIPT_PREPARED_VM_MAD(sii, S, I, I)
+            RAYCHELSCRIPT_PREPARED_VM_MAD(iss, I, S, S)
+            RAYCHELSCRIPT_PREPARED_VM_MAD(isi, I, S, I)
+            RAYCHELSCRIPT_PREPARED_VM_MAD(iis, I, I, S)
+
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(adt, *stack_pointer = RAYCHELSCRIPT_PREPARED_VM_S(c) = a + b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(sbt, *stack_pointer = RAYCHELSCRIPT_PREPARED_VM_S(c) = a - b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(mlt, *stack_pointer = RAYCHELSCRIPT_PREPARED_VM_S(c) = a * b)
+            RAYCHELSCRIPT_PREPARED_VM_BINARY(
+                dvt, if (b == 0.0) [[unlikely]] return VMErrorCode::divide_by_zero; *stack_pointer = RAYCHELSCRIPT_PREPARED_VM_S(c) = a / b)
+
+        lda:
+            *stack_pointer = RAYCHELSCRIPT_PREPARED_VM_I(b);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        ldt:
+            *stack_pointer = RAYCHELSCRIPT_PREPARED_VM_S(c) = RAYCHELSCRIPT_PREPARED_VM_I(b);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        sfl:
+            flag = instruction.a != 0U;
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        trp:
+            return static_cast<VMErrorCode>(instruction.a);
+
+        jpz:
+            if (flag) {
+                RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+            }
+        jmp:
+            RAYCHELSCRIPT_PREPARED_VM_JUMP(instruction.a);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        hlt:
+            return VMErrorCode::ok;
+        jsr : {
+            const auto& callee = data.call_frames[instruction.a];
+            if (frame_pointer == end_of_stack - 1) [[unlikely]]
+                return VMErrorCode::stack_overflow;
+            if (end_of_memory - stack_pointer - frame_pointer->size < static_cast<std::ptrdiff_t>(callee.size)) [[unlikely]]
+                return VMErrorCode::memory_overflow;
+
+            frame_pointer->instruction_pointer = instruction_pointer;
+            stack_pointer += frame_pointer->size;
+            *(++frame_pointer) = PreparedCallFrame{callee.instructions.data(), callee.size};
+            instruction_pointer = callee.instructions.data();
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        }
+        ret : {
+            if (frame_pointer == stack) [[unlikely]]
+                return VMErrorCode::stack_underflow;
+
+            //we need to transfer the zero location since it contains the result of the call
+            const auto result = *stack_pointer;
+            --frame_pointer;
+            stack_pointer -= frame_pointer->size;
+            *stack_pointer = result;
+            instruction_pointer = frame_pointer->instruction_pointer;
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        }
+        put_s:
+            if (end_of_memory - stack_pointer - frame_pointer->size <= static_cast<std::ptrdiff_t>(instruction.b)) [[unlikely]]
+                return VMErrorCode::memory_overflow;
+            stack_pointer[frame_pointer->size + instruction.b] = RAYCHELSCRIPT_PREPARED_VM_S(a);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+        put_i:
+            if (end_of_memory - stack_pointer - frame_pointer->size <= static_cast<std::ptrdiff_t>(instruction.b)) [[unlikely]]
+                return VMErrorCode::memory_overflow;
+            stack_pointer[frame_pointer->size + instruction.b] = RAYCHELSCRIPT_PREPARED_VM_I(a);
+            RAYCHELSCRIPT_PREPARED_VM_DISPATCH();
+
+    #undef RAYCHELSCRIPT_PREPARED_VM_MAD
+    #undef RAYCHELSCRIPT_PREPARED_VM_JUMP
+    #undef RAYCHELSCRIPT_PREPARED_VM_ASSIGNMENT
+    #undef RAYCHELSCRIPT_PREPARED_VM_BINARY
+    #undef RAYCHELSCRIPT_PREPARED_VM_I
+    #undef RAYCHELSCRIPT_PREPARED_VM_S
+    #undef RAYCHELSCRIPT_PREPARED_VM_DISPATCH
+    #pragma GCC diagnostic pop
+        }
+        //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    } // namespace
+
+    VMErrorCode execute(
+        const PreparedVMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    {
+        //Bail out early if the input sizes don't match up
+        if (std::cmp_not_equal(input_variables.size(), data.num_input_identifiers))
+            return VMErrorCode::mismatched_inputs;
+
+        if (std::cmp_not_equal(output_values.size(), data.num_output_identifiers))
+            return VMErrorCode::mismatched_outputs;
+
+        //The global frame is placed at the bottom of memory without any further checks, so it has to fit entirely
+        if (stack_size == 0U || memory_size < input_variables.size() + output_values.size() + 1U ||
+            std::cmp_greater(data.call_frames.front().size, memory_size))
+            return VMErrorCode::memory_overflow;
+
+        DynamicArray<PreparedCallFrame> call_stack(stack_size, resource);
+        DynamicArray<double> memory(memory_size, 0.0, resource);
+
+        std::copy(input_variables.begin(), input_variables.end(), std::next(memory.begin()));
+
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (const auto ec = run(
+                data, memory.data(), memory.data() + memory.size(), call_stack.data(), call_stack.data() + call_stack.size());
+            ec != VMErrorCode::ok) [[unlikely]]
+            return ec;
+
+        const auto outputs_begin = std::next(memory.begin(), static_cast<std::ptrdiff_t>(input_variables.size() + 1U));
+        std::copy_n(outputs_begin, output_values.size(), output_values.begin());
+
+        return VMErrorCode::ok;
+    }
+
+} // namespace RaychelScript::VM
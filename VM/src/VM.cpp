@@ -28,7 +28,9 @@
 #include "VM/VMErrorCode.h"
 #define RAYCHELSCRIPT_VM_ENABLE_DEBUG_TIMING 1
 #define RAYCHELSCRIPT_VM_SILENT 1
-#define RAYCHELSCRIPT_VM_EXECUTION_TYPE RAYCHELSCRIPT_VM_EXECUTION_TYPE_COMPUTED_GOTO
+#ifndef RAYCHELSCRIPT_VM_EXECUTION_TYPE
+    #define RAYCHELSCRIPT_VM_EXECUTION_TYPE RAYCHELSCRIPT_VM_EXECUTION_TYPE_COMPUTED_GOTO
+#endif
 
 #include "VM/VM.h"
 
@@ -38,6 +40,7 @@
 #include <cfenv>
 #include <cmath>
 #include <cstring>
+#include <type_traits>
 #include <utility>
 
 #pragma STDC FENV_ACCESS ON
@@ -57,6 +60,8 @@
 
 #define RAYCHELSCRIPT_VM_EXECUTION_TYPE_SWITCH 1
 #define RAYCHELSCRIPT_VM_EXECUTION_TYPE_COMPUTED_GOTO 2
+#define RAYCHELSCRIPT_VM_EXECUTION_TYPE_TAIL_CALL 3
+#define RAYCHELSCRIPT_VM_EXECUTION_TYPE_ACCUMULATOR 4
 
 #define RAYCHELSCRIPT_VM_EXECUTION_TYPE_DEFAULT RAYCHELSCRIPT_VM_EXECUTION_TYPE_SWITCH
 
@@ -64,7 +69,7 @@ namespace RaychelScript::VM {
 
     using Assembly::MemoryIndex;
 
-    static double& get_location(VMState& state, std::uint8_t index) noexcept
+    static double& get_location(VMState& state, std::uint32_t index) noexcept
     {
         return *(state.stack_pointer + static_cast<std::ptrdiff_t>(index));
     }
@@ -82,22 +87,21 @@ namespace RaychelScript::VM {
     static double get_value(VMState& state, MemoryIndex index) noexcept
     {
         if (index.type() == MemoryIndex::ValueType::immediate)
-            return state.data.immediate_values[index.value()];
+            return state.immediate_values[index.value()];
         return get_location(state, index);
     }
 
-    void push_frame(VMState& state, const CallFrameDescriptor& descriptor) noexcept
+    static void push_frame(VMState& state, const VMState::FrameTableEntry& entry) noexcept
     {
         if (state.frame_pointer == std::prev(state.end_of_stack)) [[unlikely]]
             RAYCHELSCRIPT_VM_THROW(VMErrorCode::stack_overflow);
 
-        new (std::to_address(++state.frame_pointer))
-            VMState::CallFrame{descriptor.instructions.begin(), static_cast<std::ptrdiff_t>(descriptor.size)};
+        new (std::to_address(++state.frame_pointer)) VMState::CallFrame{entry};
     }
 
     static void update_instruction_pointer(VMState& state, MemoryIndex offset)
     {
-        state.frame_pointer->instruction_pointer += static_cast<std::ptrdiff_t>(static_cast<std::int8_t>(offset.value()) - 1);
+        state.frame_pointer->instruction_pointer += static_cast<std::ptrdiff_t>(offset.offset() - 1);
     }
 
     [[maybe_unused]] static auto indent(VMState& state)
@@ -111,6 +115,13 @@ namespace RaychelScript::VM {
     // Instruction Handlers
     //NOLINTBEGIN(bugprone-easily-swappable-parameters)
 
+#if RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_TAIL_CALL ||                                          \
+    RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_ACCUMULATOR
+    //These execution types only fall back to some of the handlers
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+
     static void handle_mov(VMState& state, MemoryIndex from, MemoryIndex to) noexcept
     {
         RAYCHELSCRIPT_VM_DEBUG("handle_mov: ", from, " (", get_value(state, from), ") -> ", to);
@@ -161,6 +172,13 @@ namespace RaychelScript::VM {
     {
         RAYCHELSCRIPT_VM_DEBUG("handle_fac: ", a, " (", get_value(state, a), ')');
 
+        //Earlier instructions (or earlier scripts on this thread) may have left the flags set, which would fail valid inputs
+        if constexpr (math_errhandling & MATH_ERREXCEPT) { // NOLINT(hicpp-signed-bitwise)
+            std::feclearexcept(FE_DIVBYZERO | FE_INVALID);
+        } else {
+            errno = 0;
+        }
+
         result_location(state) = std::tgamma(get_value(state, a) + 1);
 
         if constexpr (math_errhandling & MATH_ERREXCEPT) { // NOLINT(hicpp-signed-bitwise)
@@ -274,17 +292,53 @@ namespace RaychelScript::VM {
     {
         RAYCHELSCRIPT_VM_DEBUG("handle_jsr: ", a);
 
-        const auto& descriptor = state.data.call_frames[a.value()];
+        if (a.value() >= state.frame_table_size) [[unlikely]]
+            RAYCHELSCRIPT_VM_THROW(VMErrorCode::invalid_operand);
+
+        auto& entry = state.frame_table[a.value()];
+
+        if (entry.instruction_pointer == nullptr) [[unlikely]] {
+            if (state.frame_loader == nullptr)
+                RAYCHELSCRIPT_VM_THROW(VMErrorCode::call_frame_not_loaded);
+
+            //Remember the loaded code so every later call into this frame takes the fast path
+            entry.instruction_pointer = state.frame_loader->load(state.frame_loader->context, a.value());
+            if (entry.instruction_pointer == nullptr)
+                RAYCHELSCRIPT_VM_THROW(VMErrorCode::call_frame_not_loaded);
+        }
+
+        const auto is_memoised = state.call_cache != nullptr && state.call_cache->is_cached(a.value());
+        std::span<const double> arguments;
+        if (is_memoised) {
+            //The arguments have already been put into the callee frame, right after its result location
+            const auto first_argument = state.stack_pointer + state.frame_pointer->size + 1;
+            const auto number_of_arguments = state.call_cache->number_of_arguments(a.value());
+            if (state.end_of_memory - first_argument < static_cast<std::ptrdiff_t>(number_of_arguments)) [[unlikely]]
+                RAYCHELSCRIPT_VM_THROW(VMErrorCode::memory_overflow);
+
+            arguments = std::span{std::to_address(first_argument), number_of_arguments};
+            if (const auto result = state.call_cache->find(a.value(), arguments); result.has_value()) {
+                result_location(state) = *result;
+                return;
+            }
+        }
 
         //It's ok to possibly corrput the stack pointer here because we will immediately bail out if we do
         state.stack_pointer += state.frame_pointer->size;
         if (state.stack_pointer >= state.end_of_memory) [[unlikely]]
             RAYCHELSCRIPT_VM_THROW(VMErrorCode::memory_overflow);
 
-        push_frame(state, descriptor);
+        if (state.end_of_memory - state.stack_pointer < entry.size) [[unlikely]]
+            RAYCHELSCRIPT_VM_THROW(VMErrorCode::memory_overflow);
+        state.high_water_mark = std::max(state.high_water_mark, state.stack_pointer + entry.size);
+
+        push_frame(state, entry);
 
         ++state.call_depth;
         ++state.function_call_count;
+
+        if (is_memoised)
+            state.call_cache->begin_call(a.value(), arguments, state.call_depth);
     }
 
     static void handle_ret(VMState& state) noexcept
@@ -296,6 +350,9 @@ namespace RaychelScript::VM {
 
         //we need to transfer the zero location since it contains the result of the call
         const auto result = result_location(state);
+        if (state.call_cache != nullptr)
+            state.call_cache->finish_call(state.call_depth, result);
+
         state.stack_pointer -= std::prev(state.frame_pointer)->size;
         --state.frame_pointer;
         result_location(state) = result;
@@ -312,7 +369,474 @@ namespace RaychelScript::VM {
         *(next_stack_pointer + static_cast<std::ptrdiff_t>(b.value())) = get_value(state, a);
     }
 
+    static void handle_jnl(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        RAYCHELSCRIPT_VM_DEBUG("handle_jnl: ", a, " (", get_value(state, a), ") < ", b, " (", get_value(state, b), ") else ", c);
+
+        if (get_value(state, a) < get_value(state, b))
+            return;
+        update_instruction_pointer(state, c);
+    }
+
+    static void handle_jng(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        RAYCHELSCRIPT_VM_DEBUG("handle_jng: ", a, " (", get_value(state, a), ") > ", b, " (", get_value(state, b), ") else ", c);
+
+        if (get_value(state, a) > get_value(state, b))
+            return;
+        update_instruction_pointer(state, c);
+    }
+
+    static void handle_jne(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        RAYCHELSCRIPT_VM_DEBUG("handle_jne: ", a, " (", get_value(state, a), ") == ", b, " (", get_value(state, b), ") else ", c);
+
+        if (get_value(state, a) == get_value(state, b))
+            return;
+        update_instruction_pointer(state, c);
+    }
+
+    static void handle_jeq(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        RAYCHELSCRIPT_VM_DEBUG("handle_jeq: ", a, " (", get_value(state, a), ") != ", b, " (", get_value(state, b), ") else ", c);
+
+        if (get_value(state, a) != get_value(state, b))
+            return;
+        update_instruction_pointer(state, c);
+    }
+
+    static void handle_mad(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        RAYCHELSCRIPT_VM_DEBUG(
+            "handle_mad: ", a, " (", get_value(state, a), ") * ", b, " (", get_value(state, b), ") + ", c, " (", get_value(state, c), ')');
+
+        //The product is rounded before the addition, so this gives the same result as the MUL/ADD pair it replaces
+        const auto product = get_value(state, a) * get_value(state, b);
+        result_location(state) = product + get_value(state, c);
+    }
+
+    static void handle_adt(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        handle_add(state, a, b);
+        get_location(state, c) = result_location(state);
+    }
+
+    static void handle_sbt(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        handle_sub(state, a, b);
+        get_location(state, c) = result_location(state);
+    }
+
+    static void handle_mlt(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        handle_mul(state, a, b);
+        get_location(state, c) = result_location(state);
+    }
+
+    static void handle_dvt(VMState& state, MemoryIndex a, MemoryIndex b, MemoryIndex c) noexcept
+    {
+        handle_div(state, a, b);
+        if (state.halt_flag) [[unlikely]]
+            return;
+        get_location(state, c) = result_location(state);
+    }
+
+#if RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_TAIL_CALL ||                                          \
+    RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_ACCUMULATOR
+    #pragma GCC diagnostic pop
+#endif
+
     //NOLINTEND(bugprone-easily-swappable-parameters)
+
+#if RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_TAIL_CALL
+
+    #if defined(__clang__)
+        #define RAYCHELSCRIPT_VM_MUSTTAIL [[clang::musttail]]
+    #elif defined(__GNUC__) && __GNUC__ >= 15
+        #define RAYCHELSCRIPT_VM_MUSTTAIL [[gnu::musttail]]
+    #else
+        #error "Tail-call dispatch needs a compiler with a musttail attribute. VM/CMakeLists.txt picks another strategy for other compilers"
+    #endif
+
+    // Tail-call threaded handlers
+    // The VM registers (instruction pointer, stack pointer and flag) are passed in arguments so they stay in machine registers.
+    // Every handler decodes the next instruction and jumps straight to its handler. Errors are returned directly, so there is
+    // no halt check between instructions. The instruction counter is not maintained in this mode.
+
+    #define RAYCHELSCRIPT_VM_TAIL_HANDLER(_name)                                                                                 \
+        static VMErrorCode tail_##_name(                                                                                         \
+            VMState& state, VMState::InstructionPointer instruction_pointer, VMState::StackPointer stack_pointer, bool flag) noexcept
+
+    #define RAYCHELSCRIPT_VM_TAIL_DISPATCH()                                                                                     \
+        RAYCHELSCRIPT_VM_MUSTTAIL return tail_handlers[static_cast<std::size_t>(instruction_pointer->op_code())](               \
+            state, instruction_pointer + 1, stack_pointer, flag)
+
+    //The instruction that is currently being executed. The instruction pointer already points past it
+    #define RAYCHELSCRIPT_VM_TAIL_CURRENT (*std::prev(instruction_pointer))
+
+    using TailHandler = VMErrorCode (*)(VMState&, VMState::InstructionPointer, VMState::StackPointer, bool) noexcept;
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(unknown_opcode);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mov);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(add);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(sub);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mul);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(div);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mag);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(fac);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(pow);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(inc);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(dec);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mas);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(das);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(pas);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(clt);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(cgt);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(ceq);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(cne);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jpz);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jmp);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(hlt);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jsr);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(ret);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(put);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jnl);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jng);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jne);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jeq);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mad);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(adt);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(sbt);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mlt);
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(dvt);
+
+    //Indexed by the raw op code byte so no range check is needed before dispatching
+    static constexpr auto tail_handlers = [] {
+        using enum Assembly::OpCode;
+
+        std::array<TailHandler, 256> handlers{};
+        handlers.fill(&tail_unknown_opcode);
+
+        const auto set = [&handlers](Assembly::OpCode code, TailHandler handler) {
+            handlers[static_cast<std::size_t>(code)] = handler;
+        };
+
+        set(mov, &tail_mov);
+        set(add, &tail_add);
+        set(sub, &tail_sub);
+        set(mul, &tail_mul);
+        set(div, &tail_div);
+        set(mag, &tail_mag);
+        set(fac, &tail_fac);
+        set(pow, &tail_pow);
+        set(inc, &tail_inc);
+        set(dec, &tail_dec);
+        set(mas, &tail_mas);
+        set(das, &tail_das);
+        set(pas, &tail_pas);
+        set(clt, &tail_clt);
+        set(cgt, &tail_cgt);
+        set(ceq, &tail_ceq);
+        set(cne, &tail_cne);
+        set(jpz, &tail_jpz);
+        set(jmp, &tail_jmp);
+        set(hlt, &tail_hlt);
+        set(jsr, &tail_jsr);
+        set(ret, &tail_ret);
+        set(put, &tail_put);
+        set(jnl, &tail_jnl);
+        set(jng, &tail_jng);
+        set(jne, &tail_jne);
+        set(jeq, &tail_jeq);
+        set(mad, &tail_mad);
+        set(adt, &tail_adt);
+        set(sbt, &tail_sbt);
+        set(mlt, &tail_mlt);
+        set(dvt, &tail_dvt);
+
+        return handlers;
+    }();
+
+    static double tail_value(const VMState& state, VMState::StackPointer stack_pointer, MemoryIndex index) noexcept
+    {
+        if (index.type() == MemoryIndex::ValueType::immediate)
+            return state.immediate_values[index.value()];
+        return stack_pointer[index.value()];
+    }
+
+    static double& tail_location(VMState::StackPointer stack_pointer, MemoryIndex index) noexcept
+    {
+        return stack_pointer[index.value()];
+    }
+
+    #define RAYCHELSCRIPT_VM_TAIL_A tail_value(state, stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index1())
+    #define RAYCHELSCRIPT_VM_TAIL_B tail_value(state, stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index2())
+    #define RAYCHELSCRIPT_VM_TAIL_C tail_value(state, stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index3())
+    #define RAYCHELSCRIPT_VM_TAIL_LOCATION_A tail_location(stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index1())
+    #define RAYCHELSCRIPT_VM_TAIL_LOCATION_C tail_location(stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index3())
+    #define RAYCHELSCRIPT_VM_TAIL_JUMP(_offset)                                                                                 \
+        instruction_pointer += static_cast<std::ptrdiff_t>((_offset).offset() - 1)
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(unknown_opcode)
+    {
+        (void)state;
+        (void)instruction_pointer;
+        (void)stack_pointer;
+        (void)flag;
+        return VMErrorCode::unknown_opcode;
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mov)
+    {
+        tail_location(stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index2()) = RAYCHELSCRIPT_VM_TAIL_A;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(add)
+    {
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A + RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(sub)
+    {
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A - RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mul)
+    {
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A * RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(div)
+    {
+        const auto divisor = RAYCHELSCRIPT_VM_TAIL_B;
+        if (divisor == 0.0) [[unlikely]]
+            return VMErrorCode::divide_by_zero;
+
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A / divisor;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mag)
+    {
+        *stack_pointer = std::abs(RAYCHELSCRIPT_VM_TAIL_A);
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(fac)
+    {
+        //Slow path anyway, so just reuse the regular handler
+        state.stack_pointer = stack_pointer;
+        handle_fac(state, RAYCHELSCRIPT_VM_TAIL_CURRENT.index1());
+        if (state.halt_flag) [[unlikely]]
+            return state.error;
+
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(pow)
+    {
+        *stack_pointer = std::pow(RAYCHELSCRIPT_VM_TAIL_A, RAYCHELSCRIPT_VM_TAIL_B);
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(inc)
+    {
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_A += RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(dec)
+    {
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_A -= RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mas)
+    {
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_A *= RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(das)
+    {
+        const auto divisor = RAYCHELSCRIPT_VM_TAIL_B;
+        if (divisor == 0.0) [[unlikely]]
+            return VMErrorCode::divide_by_zero;
+
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_A /= divisor;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(pas)
+    {
+        auto& res = RAYCHELSCRIPT_VM_TAIL_LOCATION_A;
+        res = std::pow(res, RAYCHELSCRIPT_VM_TAIL_B);
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(clt)
+    {
+        flag = RAYCHELSCRIPT_VM_TAIL_A < RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(cgt)
+    {
+        flag = RAYCHELSCRIPT_VM_TAIL_A > RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(ceq)
+    {
+        flag = RAYCHELSCRIPT_VM_TAIL_A == RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(cne)
+    {
+        flag = RAYCHELSCRIPT_VM_TAIL_A != RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jpz)
+    {
+        if (!flag)
+            instruction_pointer += static_cast<std::ptrdiff_t>(RAYCHELSCRIPT_VM_TAIL_CURRENT.index1().offset() - 1);
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jmp)
+    {
+        instruction_pointer += static_cast<std::ptrdiff_t>(RAYCHELSCRIPT_VM_TAIL_CURRENT.index1().offset() - 1);
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(hlt)
+    {
+        (void)instruction_pointer;
+        state.stack_pointer = stack_pointer;
+        state.flag = flag;
+        return VMErrorCode::ok;
+    }
+
+    //Calls and returns go through the regular handlers, which need the VM registers to be written back first
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jsr)
+    {
+        state.frame_pointer->instruction_pointer = instruction_pointer;
+        state.stack_pointer = stack_pointer;
+
+        handle_jsr(state, RAYCHELSCRIPT_VM_TAIL_CURRENT.index1());
+        if (state.halt_flag) [[unlikely]]
+            return state.error;
+
+        instruction_pointer = state.frame_pointer->instruction_pointer;
+        stack_pointer = state.stack_pointer;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(ret)
+    {
+        (void)instruction_pointer;
+        state.stack_pointer = stack_pointer;
+
+        handle_ret(state);
+        if (state.halt_flag) [[unlikely]]
+            return state.error;
+
+        instruction_pointer = state.frame_pointer->instruction_pointer;
+        stack_pointer = state.stack_pointer;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(put)
+    {
+        const auto next_stack_pointer = stack_pointer + state.frame_pointer->size;
+        tail_location(next_stack_pointer, RAYCHELSCRIPT_VM_TAIL_CURRENT.index2()) = RAYCHELSCRIPT_VM_TAIL_A;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jnl)
+    {
+        if (!(RAYCHELSCRIPT_VM_TAIL_A < RAYCHELSCRIPT_VM_TAIL_B))
+            RAYCHELSCRIPT_VM_TAIL_JUMP(RAYCHELSCRIPT_VM_TAIL_CURRENT.index3());
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jng)
+    {
+        if (!(RAYCHELSCRIPT_VM_TAIL_A > RAYCHELSCRIPT_VM_TAIL_B))
+            RAYCHELSCRIPT_VM_TAIL_JUMP(RAYCHELSCRIPT_VM_TAIL_CURRENT.index3());
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jne)
+    {
+        if (!(RAYCHELSCRIPT_VM_TAIL_A == RAYCHELSCRIPT_VM_TAIL_B))
+            RAYCHELSCRIPT_VM_TAIL_JUMP(RAYCHELSCRIPT_VM_TAIL_CURRENT.index3());
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(jeq)
+    {
+        if (!(RAYCHELSCRIPT_VM_TAIL_A != RAYCHELSCRIPT_VM_TAIL_B))
+            RAYCHELSCRIPT_VM_TAIL_JUMP(RAYCHELSCRIPT_VM_TAIL_CURRENT.index3());
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mad)
+    {
+        const auto product = RAYCHELSCRIPT_VM_TAIL_A * RAYCHELSCRIPT_VM_TAIL_B;
+        *stack_pointer = product + RAYCHELSCRIPT_VM_TAIL_C;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(adt)
+    {
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A + RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_C = *stack_pointer;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(sbt)
+    {
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A - RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_C = *stack_pointer;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(mlt)
+    {
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A * RAYCHELSCRIPT_VM_TAIL_B;
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_C = *stack_pointer;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    RAYCHELSCRIPT_VM_TAIL_HANDLER(dvt)
+    {
+        const auto divisor = RAYCHELSCRIPT_VM_TAIL_B;
+        if (divisor == 0.0) [[unlikely]]
+            return VMErrorCode::divide_by_zero;
+
+        *stack_pointer = RAYCHELSCRIPT_VM_TAIL_A / divisor;
+        RAYCHELSCRIPT_VM_TAIL_LOCATION_C = *stack_pointer;
+        RAYCHELSCRIPT_VM_TAIL_DISPATCH();
+    }
+
+    #undef RAYCHELSCRIPT_VM_TAIL_JUMP
+    #undef RAYCHELSCRIPT_VM_TAIL_LOCATION_C
+    #undef RAYCHELSCRIPT_VM_TAIL_LOCATION_A
+    #undef RAYCHELSCRIPT_VM_TAIL_C
+    #undef RAYCHELSCRIPT_VM_TAIL_B
+    #undef RAYCHELSCRIPT_VM_TAIL_A
+    #undef RAYCHELSCRIPT_VM_TAIL_CURRENT
+    #undef RAYCHELSCRIPT_VM_TAIL_HANDLER
+
+#endif
+
     // Main execution loop
 
     VMErrorCode do_execute(VMState& state)
@@ -325,6 +849,7 @@ namespace RaychelScript::VM {
             const auto instruction = *(state.frame_pointer->instruction_pointer++);
             const auto a = instruction.index1();
             const auto b = instruction.index2();
+            const auto c = instruction.index3();
 
             switch (instruction.op_code()) {
                 case mov:
@@ -395,6 +920,33 @@ namespace RaychelScript::VM {
                 case put:
                     handle_put(state, a, b);
                     break;
+                case jnl:
+                    handle_jnl(state, a, b, c);
+                    break;
+                case jng:
+                    handle_jng(state, a, b, c);
+                    break;
+                case jne:
+                    handle_jne(state, a, b, c);
+                    break;
+                case jeq:
+                    handle_jeq(state, a, b, c);
+                    break;
+                case mad:
+                    handle_mad(state, a, b, c);
+                    break;
+                case adt:
+                    handle_adt(state, a, b, c);
+                    break;
+                case sbt:
+                    handle_sbt(state, a, b, c);
+                    break;
+                case mlt:
+                    handle_mlt(state, a, b, c);
+                    break;
+                case dvt:
+                    handle_dvt(state, a, b, c);
+                    break;
                 default:
                     return VMErrorCode::unknown_opcode;
             }
@@ -420,11 +972,16 @@ namespace RaychelScript::VM {
             &&cne,  &&jpz,
             &&jmp,  &&hlt,
             &&jsr,  &&ret,
-            &&put,
+            &&put,  &&jnl,
+            &&jng,  &&jne,
+            &&jeq,  &&mad,
+            &&adt,  &&sbt,
+            &&mlt,  &&dvt,
         };
 
         MemoryIndex index1{};
         MemoryIndex index2{};
+        MemoryIndex index3{};
 
         const auto next = [&] {
             if (state.halt_flag) [[unlikely]]
@@ -438,6 +995,7 @@ namespace RaychelScript::VM {
 
             index1 = instruction.index1();
             index2 = instruction.index2();
+            index3 = instruction.index3();
 
             //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index): we have checked the index before
             return labels[static_cast<std::size_t>(instruction.op_code()) + 2];
@@ -513,19 +1071,281 @@ namespace RaychelScript::VM {
     put:
         handle_put(state, index1, index2);
         goto* next();
+    jnl:
+        handle_jnl(state, index1, index2, index3);
+        goto* next();
+    jng:
+        handle_jng(state, index1, index2, index3);
+        goto* next();
+    jne:
+        handle_jne(state, index1, index2, index3);
+        goto* next();
+    jeq:
+        handle_jeq(state, index1, index2, index3);
+        goto* next();
+    mad:
+        handle_mad(state, index1, index2, index3);
+        goto* next();
+    adt:
+        handle_adt(state, index1, index2, index3);
+        goto* next();
+    sbt:
+        handle_sbt(state, index1, index2, index3);
+        goto* next();
+    mlt:
+        handle_mlt(state, index1, index2, index3);
+        goto* next();
+    dvt:
+        handle_dvt(state, index1, index2, index3);
+        goto* next();
     unknown_opcode:
         return VMErrorCode::unknown_opcode;
     done:
         return state.error;
     #pragma GCC diagnostic pop
+
+#elif RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_TAIL_CALL
+
+        const auto instruction_pointer = state.frame_pointer->instruction_pointer;
+
+        return tail_handlers[static_cast<std::size_t>(instruction_pointer->op_code())](
+            state, instruction_pointer + 1, state.stack_pointer, state.flag);
+
+    #undef RAYCHELSCRIPT_VM_TAIL_DISPATCH
+
+#elif RAYCHELSCRIPT_VM_EXECUTION_TYPE == RAYCHELSCRIPT_VM_EXECUTION_TYPE_ACCUMULATOR
+
+        // Same as COMPUTED_GOTO, but the A register (stack slot 0) lives in a local for the whole loop.
+        // It is only written back to memory around calls, returns and when halting.
+        // Errors are returned directly and the instruction counter is not maintained in this mode.
+
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpedantic"
+
+        constexpr static std::array labels{
+            &&unknown_opcode,
+
+            &&mov,  &&add,
+            &&sub,  &&mul,
+            &&div,  &&mag,
+            &&fac,  &&pow,
+            &&inc,  &&dec,
+            &&mas,  &&das,
+            &&pas,  &&clt,
+            &&cgt,  &&ceq,
+            &&cne,  &&jpz,
+            &&jmp,  &&hlt,
+            &&jsr,  &&ret,
+            &&put,  &&jnl,
+            &&jng,  &&jne,
+            &&jeq,  &&mad,
+            &&adt,  &&sbt,
+            &&mlt,  &&dvt,
+        };
+
+        auto instruction_pointer = state.frame_pointer->instruction_pointer;
+        auto stack_pointer = state.stack_pointer;
+        double accumulator = *stack_pointer;
+        bool flag = state.flag;
+
+        MemoryIndex index1{};
+        MemoryIndex index2{};
+        MemoryIndex index3{};
+
+        const auto value = [&](MemoryIndex index) {
+            if (index.type() == MemoryIndex::ValueType::immediate)
+                return state.immediate_values[index.value()];
+            if (index.value() == 0U)
+                return accumulator;
+            return stack_pointer[index.value()];
+        };
+
+        const auto location = [&](MemoryIndex index) -> double& {
+            if (index.value() == 0U)
+                return accumulator;
+            return stack_pointer[index.value()];
+        };
+
+        //Write the VM registers back so we can fall back to the regular handlers
+        const auto spill = [&] {
+            *stack_pointer = accumulator;
+            state.stack_pointer = stack_pointer;
+            state.frame_pointer->instruction_pointer = instruction_pointer;
+            state.flag = flag;
+        };
+
+        const auto reload = [&] {
+            stack_pointer = state.stack_pointer;
+            instruction_pointer = state.frame_pointer->instruction_pointer;
+            accumulator = *stack_pointer;
+        };
+
+        const auto next = [&] {
+            const auto& instruction = *(instruction_pointer++);
+            const auto code = instruction.op_code();
+            if (code >= Assembly::OpCode::num_op_codes) [[unlikely]]
+                return labels[0]; //unknown_opcode
+
+            index1 = instruction.index1();
+            index2 = instruction.index2();
+            index3 = instruction.index3();
+
+            //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index): we have checked the index before
+            return labels[static_cast<std::size_t>(code) + 1];
+        };
+
+        const auto jump = [&](MemoryIndex offset) {
+            instruction_pointer += static_cast<std::ptrdiff_t>(offset.offset() - 1);
+        };
+
+        goto* next();
+
+    mov:
+        location(index2) = value(index1);
+        goto* next();
+    add:
+        accumulator = value(index1) + value(index2);
+        goto* next();
+    sub:
+        accumulator = value(index1) - value(index2);
+        goto* next();
+    mul:
+        accumulator = value(index1) * value(index2);
+        goto* next();
+    div : {
+        const auto divisor = value(index2);
+        if (divisor == 0.0) [[unlikely]]
+            return VMErrorCode::divide_by_zero;
+        accumulator = value(index1) / divisor;
+        goto* next();
+    }
+    mag:
+        accumulator = std::abs(value(index1));
+        goto* next();
+    fac:
+        spill();
+        handle_fac(state, index1);
+        if (state.halt_flag) [[unlikely]]
+            return state.error;
+        accumulator = *stack_pointer;
+        goto* next();
+    pow:
+        accumulator = std::pow(value(index1), value(index2));
+        goto* next();
+    inc:
+        location(index1) += value(index2);
+        goto* next();
+    dec:
+        location(index1) -= value(index2);
+        goto* next();
+    mas:
+        location(index1) *= value(index2);
+        goto* next();
+    das : {
+        const auto divisor = value(index2);
+        if (divisor == 0.0) [[unlikely]]
+            return VMErrorCode::divide_by_zero;
+        location(index1) /= divisor;
+        goto* next();
+    }
+    pas : {
+        auto& res = location(index1);
+        res = std::pow(res, value(index2));
+        goto* next();
+    }
+    clt:
+        flag = value(index1) < value(index2);
+        goto* next();
+    cgt:
+        flag = value(index1) > value(index2);
+        goto* next();
+    ceq:
+        flag = value(index1) == value(index2);
+        goto* next();
+    cne:
+        flag = value(index1) != value(index2);
+        goto* next();
+    jpz:
+        if (!flag)
+            jump(index1);
+        goto* next();
+    jmp:
+        jump(index1);
+        goto* next();
+    hlt:
+        spill();
+        return VMErrorCode::ok;
+    jsr:
+        spill();
+        handle_jsr(state, index1);
+        if (state.halt_flag) [[unlikely]]
+            return state.error;
+        reload();
+        goto* next();
+    ret:
+        spill();
+        handle_ret(state);
+        if (state.halt_flag) [[unlikely]]
+            return state.error;
+        reload();
+        goto* next();
+    put:
+        stack_pointer[state.frame_pointer->size + index2.value()] = value(index1);
+        goto* next();
+    jnl:
+        if (!(value(index1) < value(index2)))
+            jump(index3);
+        goto* next();
+    jng:
+        if (!(value(index1) > value(index2)))
+            jump(index3);
+        goto* next();
+    jne:
+        if (!(value(index1) == value(index2)))
+            jump(index3);
+        goto* next();
+    jeq:
+        if (!(value(index1) != value(index2)))
+            jump(index3);
+        goto* next();
+    mad : {
+        const auto product = value(index1) * value(index2);
+        accumulator = product + value(index3);
+        goto* next();
+    }
+    adt:
+        accumulator = value(index1) + value(index2);
+        location(index3) = accumulator;
+        goto* next();
+    sbt:
+        accumulator = value(index1) - value(index2);
+        location(index3) = accumulator;
+        goto* next();
+    mlt:
+        accumulator = value(index1) * value(index2);
+        location(index3) = accumulator;
+        goto* next();
+    dvt : {
+        const auto divisor = value(index2);
+        if (divisor == 0.0) [[unlikely]]
+            return VMErrorCode::divide_by_zero;
+        accumulator = value(index1) / divisor;
+        location(index3) = accumulator;
+        goto* next();
+    }
+    unknown_opcode:
+        return VMErrorCode::unknown_opcode;
+    #pragma GCC diagnostic pop
+
 #else
     #error "Unknown execution type"
 #endif
     }
 
-    VMErrorCode execute(
-        const VMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
-        std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    template <typename Data>
+    static VMErrorCode execute_impl(
+        const Data& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource, CallCache* call_cache = nullptr) noexcept
     {
 #ifdef RAYCHELSCRIPT_VM_ENABLE_DEBUG_TIMING
         const auto start = std::chrono::high_resolution_clock::now();
@@ -537,14 +1357,42 @@ namespace RaychelScript::VM {
         if (std::cmp_not_equal(output_values.size(), data.num_output_identifiers))
             return VMErrorCode::mismatched_outputs;
 
-        //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-        auto* call_stack = reinterpret_cast<VMState::CallFrame*>(
-            resource->allocate(stack_size * sizeof(VMState::CallFrame), alignof(VMState::CallFrame)));
+        DynamicArray<VMState::FrameTableEntry> frame_table(data.call_frames.size(), resource);
+        resolve_frame_table(data, frame_table);
+
+        //The global frame is placed at the bottom of memory without any further checks, so it has to fit entirely
+        if (frame_table.empty() || std::cmp_greater(frame_table.front().size, memory_size) ||
+            memory_size < input_variables.size() + output_values.size() + 1U) [[unlikely]]
+            return VMErrorCode::memory_overflow;
+
+
+        const FrameLoader* frame_loader{};
+        if constexpr (std::is_same_v<Data, LazyVMData>) {
+            frame_loader = &data.loader;
 
+            //The global frame is entered without a jsr, so it has to be loaded up front
+            auto& global_frame = frame_table.front();
+            if (global_frame.instruction_pointer == nullptr)
+                global_frame.instruction_pointer = data.loader.load(data.loader.context, 0U);
+            if (global_frame.instruction_pointer == nullptr)
+                return VMErrorCode::call_frame_not_loaded;
+        }
+
+        DynamicArray<VMState::CallFrame> call_stack(stack_size, resource);
         DynamicArray<double> memory(memory_size, 0.0, resource);
 
-        //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-        VMState state{details::Range{memory}, details::Range{call_stack, call_stack + stack_size}, data};
+        VMState state{
+            details::Range{memory},
+            details::Range{call_stack.data(), call_stack.data() + call_stack.size()},
+            data.immediate_values,
+            frame_table,
+            frame_loader};
+
+        if (call_cache != nullptr) {
+            //A previous run that failed may have left calls behind that will never return
+            call_cache->reset_pending_calls();
+            state.call_cache = call_cache;
+        }
 
 #ifdef RAYCHELSCRIPT_VM_ENABLE_DEBUG_TIMING
         [[maybe_unused]] Raychel::Finally _{[start, &state] {
@@ -557,13 +1405,13 @@ namespace RaychelScript::VM {
         std::size_t i{1};
         for (const auto& value : input_variables) {
             RAYCHELSCRIPT_VM_DEBUG("Assigning input value ", value, " to address $", static_cast<std::uint32_t>(i));
-            memory[i] = value;
+            memory[i++] = value;
         }
 
         if (const auto ec = do_execute(state); ec != VMErrorCode::ok) [[unlikely]]
             return ec;
 
-        for (uint8_t j{}; j != data.num_output_identifiers; ++j) {
+        for (std::uint32_t j{}; j != data.num_output_identifiers; ++j) {
             const auto value = memory[i + j];
             RAYCHELSCRIPT_VM_DEBUG(
                 "storing output variable #",
@@ -577,4 +1425,49 @@ namespace RaychelScript::VM {
 
         return VMErrorCode::ok;
     }
+
+    VMErrorCode execute(
+        const VMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    {
+        return execute_impl(data, input_variables, output_values, stack_size, memory_size, resource);
+    }
+
+    VMErrorCode execute(
+        const VMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource, CallCache& call_cache) noexcept
+    {
+        return execute_impl(data, input_variables, output_values, stack_size, memory_size, resource, &call_cache);
+    }
+
+    CallCache make_call_cache(const VMData& data, std::size_t capacity, std::size_t max_pending_calls) noexcept
+    {
+        std::vector<std::optional<std::uint32_t>> arities;
+        arities.reserve(data.call_frames.size());
+        for (const auto& frame : data.call_frames) {
+            arities.push_back(frame.is_pure ? std::optional{frame.num_arguments} : std::nullopt);
+        }
+        return CallCache{arities, capacity, max_pending_calls};
+    }
+
+    VMErrorCode execute(
+        const LinkedVMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    {
+        return execute_impl(data, input_variables, output_values, stack_size, memory_size, resource);
+    }
+
+    VMErrorCode execute(
+        const VMDataView& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    {
+        return execute_impl(data, input_variables, output_values, stack_size, memory_size, resource);
+    }
+
+    VMErrorCode execute(
+        const LazyVMData& data, std::span<const double> input_variables, std::span<double> output_values, std::size_t stack_size,
+        std::size_t memory_size, std::pmr::memory_resource* resource) noexcept
+    {
+        return execute_impl(data, input_variables, output_values, stack_size, memory_size, resource);
+    }
 } // namespace RaychelScript::VM
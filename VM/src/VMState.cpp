@@ -32,19 +32,56 @@
 
 namespace RaychelScript::VM {
 
-    //defined in VM.cpp
-    void push_frame(VMState&, const CallFrameDescriptor&);
-
-    VMState::VMState(details::Range<StackPointer> memory, details::Range<FramePointer> stack, const VMData& _data) noexcept
+    VMState::VMState(
+        details::Range<StackPointer> memory, details::Range<FramePointer> stack, std::span<const double> _immediate_values,
+        std::span<FrameTableEntry> _frame_table, const FrameLoader* _frame_loader) noexcept
         : frame_pointer{stack.begin},
           stack_pointer{memory.begin},
+          high_water_mark{memory.begin},
           beginning_of_stack{stack.begin},
           end_of_stack{stack.end},
           end_of_memory{memory.end},
-          data{_data}
+          immediate_values{_immediate_values.data()},
+          frame_table{_frame_table.data()},
+          frame_table_size{_frame_table.size()},
+          frame_loader{_frame_loader}
+    {
+        const auto& global_frame = _frame_table.front();
+        new (std::to_address(frame_pointer)) CallFrame{global_frame};
+        //Callers make sure the global frame fits into memory
+        high_water_mark += global_frame.size;
+    }
+
+    void resolve_frame_table(const VMData& data, std::span<VMState::FrameTableEntry> out) noexcept
+    {
+        for (std::size_t i{}; i != out.size(); ++i) {
+            const auto& descriptor = data.call_frames[i];
+            out[i] = VMState::FrameTableEntry{descriptor.instructions.data(), static_cast<std::ptrdiff_t>(descriptor.size)};
+        }
+    }
+
+    void resolve_frame_table(const LinkedVMData& data, std::span<VMState::FrameTableEntry> out) noexcept
+    {
+        resolve_frame_table(view_of(data), out);
+    }
+
+    void resolve_frame_table(const VMDataView& data, std::span<VMState::FrameTableEntry> out) noexcept
+    {
+        for (std::size_t i{}; i != out.size(); ++i) {
+            const auto& descriptor = data.call_frames[i];
+            //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            out[i] = VMState::FrameTableEntry{data.code.data() + descriptor.entry_point, static_cast<std::ptrdiff_t>(descriptor.size)};
+        }
+    }
+
+    void resolve_frame_table(const LazyVMData& data, std::span<VMState::FrameTableEntry> out) noexcept
     {
-        const auto& global_frame = data.call_frames.front();
-        new (std::to_address(frame_pointer)) CallFrame{global_frame.instructions.begin(), global_frame.size};
+        for (std::size_t i{}; i != out.size(); ++i) {
+            const auto& descriptor = data.call_frames[i];
+            //Frames that have not been loaded get a null instruction pointer, which makes jsr ask the loader for them
+            const auto* instructions = descriptor.instructions.empty() ? nullptr : descriptor.instructions.data();
+            out[i] = VMState::FrameTableEntry{instructions, static_cast<std::ptrdiff_t>(descriptor.size)};
+        }
     }
 
 } //namespace RaychelScript::VM
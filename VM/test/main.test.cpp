@@ -1,14 +1,369 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
 #include <span>
+#include "VM/ExecutionContext.h"
 #include "VM/VM.h"
 
 #include "Assembler/AssemblerPipe.h"
+#include "Assembler/CachePipe.h"
+#include "Interpreter/InterpreterPipe.h"
 #include "Lexer/LexerPipe.h"
 #include "Parser/ParserPipe.h"
 #include "VM/VMPipe.h"
 #include "rasm/ReadPipe.h"
+#include "rasm/cache.h"
+#include "shared/Misc/Purity.h"
 
 #include "RaychelCore/AssertingGet.h"
 
+//True if the global code calls a pure function that calls itself. A call cache looks up every call into a pure function
+static bool calls_pure_recursive_function(const RaychelScript::AST& ast) noexcept
+{
+    using namespace RaychelScript; //NOLINT
+
+    const auto pure_functions = find_pure_functions(ast);
+    const auto callee_of = [](const AST_Node& node) { return node.to_node_data<FunctionCallData>().mangled_callee_name; };
+
+    bool result{false};
+    for_each_node(ast.nodes, [&](const AST_Node& node) {
+        if (node.type() != NodeType::function_call || !pure_functions.contains(callee_of(node))) {
+            return;
+        }
+        const auto name = callee_of(node);
+        for_each_node(ast.functions.at(name).body, [&](const AST_Node& inner) {
+            result = result || (inner.type() == NodeType::function_call && callee_of(inner) == name);
+        });
+    });
+    return result;
+}
+
+//Large enough for the global frame of every script in shared/test
+constexpr std::size_t stack_size = 32U;
+constexpr std::size_t memory_size = 1'024U;
+
+//Compiling through a cache has to give the same outputs on a miss and on the hit that follows it
+static bool check_compilation_cache(
+    const std::string& file_name, const std::vector<double>& args, std::span<const double> outputs)
+{
+    using namespace RaychelScript::Pipes; //NOLINT
+
+    std::ifstream stream{file_name};
+    const std::string source_text{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    const auto key = RaychelScript::Assembly::cache_key(source_text, RaychelScript::Assembler::codegen_version);
+
+    //Every script gets its own directory, so tests running at the same time do not remove each other's entries
+    const auto cache_directory =
+        (std::filesystem::temp_directory_path() / ("raychelscript_test_cache_" + std::to_string(key))).string();
+    std::filesystem::remove_all(cache_directory);
+
+    const auto execute = Execute<std::dynamic_extent, stack_size, memory_size>(args);
+    const auto cold_values_or_error = CompileCached{source_text, cache_directory} | execute;
+    const auto is_cached = std::holds_alternative<RaychelScript::VM::VMData>(
+        RaychelScript::Assembly::read_cached_rsbf(cache_directory, key, source_text));
+    const auto warm_values_or_error = CompileCached{source_text, cache_directory} | execute;
+    std::filesystem::remove_all(cache_directory);
+
+    if (log_if_error(cold_values_or_error) || log_if_error(warm_values_or_error)) {
+        return false;
+    }
+    if (!is_cached) {
+        Logger::error("Compiling the script did not add it to the compilation cache!\n");
+        return false;
+    }
+    const auto matches_outputs = [outputs](std::span<const double> values) {
+        return values.size() == outputs.size() && std::memcmp(values.data(), outputs.data(), outputs.size_bytes()) == 0;
+    };
+    if (!matches_outputs(cold_values_or_error.value()) || !matches_outputs(warm_values_or_error.value())) {
+        Logger::error("Running the script from the compilation cache changed the outputs!\n");
+        return false;
+    }
+    return true;
+}
+
+//Expanding calls into their callers must not change the outputs, even if the callee writes to its arguments
+static bool check_inlining(const RaychelScript::AST& ast, const std::vector<double>& args, std::span<const double> outputs)
+{
+    using namespace RaychelScript::Pipes; //NOLINT
+
+    auto not_inlined_ast = ast;
+    not_inlined_ast.config_block.config_vars["inline_threshold"] = {"0"};
+    const auto not_inlined_values_or_error = PipeResult<RaychelScript::AST>{not_inlined_ast} | Assemble{} |
+                                             Execute<std::dynamic_extent, stack_size, memory_size>(args);
+    if (log_if_error(not_inlined_values_or_error)) {
+        return false;
+    }
+    const auto& not_inlined_values = not_inlined_values_or_error.value();
+    if (not_inlined_values.size() != outputs.size() ||
+        std::memcmp(not_inlined_values.data(), outputs.data(), outputs.size_bytes()) != 0) {
+        Logger::error("Inlining function calls changed the outputs!\n");
+        return false;
+    }
+    return true;
+}
+
+//The Interpreter executes the AST directly, so the assembled code has to compute the same outputs. Unlike the Assembler, it
+//does not allow functions to write to their arguments
+static bool check_interpreter(const RaychelScript::AST& ast, const std::vector<double>& args, std::span<const double> outputs)
+{
+    using namespace RaychelScript::Pipes; //NOLINT
+
+    const auto& config_block = ast.config_block;
+    std::map<std::string, double> named_args;
+    for (std::size_t input_index{}; input_index != config_block.input_identifiers.size(); ++input_index) {
+        named_args.emplace(config_block.input_identifiers.at(input_index), args.at(input_index));
+    }
+
+    const auto state_or_error = PipeResult<RaychelScript::AST>{ast} | Interpret{std::move(named_args)};
+    if (state_or_error.is_error() && state_or_error.to_error_code<RaychelScript::Interpreter::InterpreterErrorCode>() ==
+                                         RaychelScript::Interpreter::InterpreterErrorCode::constant_reassign) {
+        Logger::info("The Interpreter does not accept this script, its outputs are not compared\n");
+        return true;
+    }
+    if (log_if_error(state_or_error)) {
+        return false;
+    }
+    const auto& state = state_or_error.value();
+
+    for (std::size_t output_index{}; output_index != config_block.output_identifiers.size(); ++output_index) {
+        const auto& name = config_block.output_identifiers.at(output_index);
+        const auto expected = state.variables.at(state.scopes.front().lookup_table.at(name).index);
+        const auto actual = outputs[output_index];
+        if (expected != actual && !(std::isnan(expected) && std::isnan(actual))) {
+            Logger::error("Output '", name, "' is ", actual, " but the Interpreter computed ", expected, "!\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+//A global frame that does not fit into memory has to be rejected before anything is written to it
+static bool check_memory_overflow(const RaychelScript::VM::VMData& data, const std::vector<double>& args)
+{
+    const auto global_frame_size = data.call_frames.front().size;
+    std::vector<double> overflow_outputs(data.num_output_identifiers);
+    if (const auto ec = RaychelScript::VM::execute(
+            data, args, overflow_outputs, stack_size, global_frame_size - 1U, std::pmr::get_default_resource());
+        ec != RaychelScript::VM::VMErrorCode::memory_overflow) {
+        Logger::error("Executing a global frame of ", global_frame_size, " slots with less memory returned '", ec, "'!\n");
+        return false;
+    }
+    RaychelScript::VM::ExecutionContext small_context{data, stack_size, global_frame_size - 1U};
+    if (const auto ec = small_context.run(args, overflow_outputs); ec != RaychelScript::VM::VMErrorCode::memory_overflow) {
+        Logger::error("Running a global frame of ", global_frame_size, " slots in a smaller context returned '", ec, "'!\n");
+        return false;
+    }
+    return true;
+}
+
+//Memoising pure functions must not change the outputs. If the script makes pure recursive calls, some of them have to be
+//looked up, because frames that lost their purity, for example when reading them from a file, are silently not memoised
+static bool check_memoisation(
+    const RaychelScript::VM::VMData& data, const std::vector<double>& args, std::span<const double> outputs,
+    bool expects_lookups)
+{
+    const auto matches_outputs = [outputs](const std::vector<double>& values) {
+        return std::ranges::equal(values, outputs);
+    };
+
+    auto call_cache = RaychelScript::VM::make_call_cache(data, RaychelScript::CallCache::default_capacity, stack_size);
+    std::vector<double> memoised_outputs(data.num_output_identifiers);
+    if (const auto ec = RaychelScript::VM::execute(
+            data, args, memoised_outputs, stack_size, memory_size, std::pmr::get_default_resource(), call_cache);
+        ec != RaychelScript::VM::VMErrorCode::ok || !matches_outputs(memoised_outputs)) {
+        Logger::error("Memoised execution does not match regular execution!\n");
+        return false;
+    }
+    const auto [hits, misses] = call_cache.statistics();
+    Logger::info("Memoised execution: ", hits, " cache hits, ", misses, " cache misses\n");
+
+    if (expects_lookups && hits + misses == 0U) {
+        Logger::error("The script makes pure recursive calls, but memoised execution never looked any of them up!\n");
+        return false;
+    }
+
+    //Nested calls that do not fit into the pending call storage are simply not memoised
+    auto shallow_call_cache = RaychelScript::VM::make_call_cache(data, RaychelScript::CallCache::default_capacity, 1U);
+    if (const auto ec = RaychelScript::VM::execute(
+            data, args, memoised_outputs, stack_size, memory_size, std::pmr::get_default_resource(), shallow_call_cache);
+        ec != RaychelScript::VM::VMErrorCode::ok || !matches_outputs(memoised_outputs)) {
+        Logger::error("Memoised execution with a single pending call does not match regular execution!\n");
+        return false;
+    }
+    return true;
+}
+
+//The prepared VM specialises every instruction on the kinds of its operands, which must not change the outputs
+static bool check_prepared_vm(
+    const RaychelScript::VM::VMData& data, const std::vector<double>& args, std::span<const double> outputs)
+{
+    const auto prepared_data_or_error = RaychelScript::VM::prepare(data);
+    if (const auto* ec = std::get_if<RaychelScript::VM::VMErrorCode>(&prepared_data_or_error); ec != nullptr) {
+        Logger::error("Could not prepare the script: ", *ec, '\n');
+        return false;
+    }
+    const auto& prepared_data = Raychel::get<RaychelScript::VM::PreparedVMData>(prepared_data_or_error);
+    std::vector<double> prepared_outputs(data.num_output_identifiers);
+    if (const auto ec = RaychelScript::VM::execute(
+            prepared_data, args, prepared_outputs, stack_size, memory_size, std::pmr::get_default_resource());
+        ec != RaychelScript::VM::VMErrorCode::ok || !std::ranges::equal(prepared_outputs, outputs)) {
+        Logger::error("Prepared execution does not match regular execution!\n");
+        return false;
+    }
+    if (const auto ec = RaychelScript::VM::execute(
+            prepared_data,
+            args,
+            prepared_outputs,
+            stack_size,
+            prepared_data.call_frames.front().size - 1U,
+            std::pmr::get_default_resource());
+        ec != RaychelScript::VM::VMErrorCode::memory_overflow) {
+        Logger::error("Executing a prepared global frame with less memory returned '", ec, "'!\n");
+        return false;
+    }
+    return true;
+}
+
+//Reusing a context must not leak state from one run into the next, so every run has to match a fresh execution
+static bool check_context_reuse(const RaychelScript::VM::VMData& data, const std::vector<double>& args)
+{
+    RaychelScript::VM::ExecutionContext context{data, stack_size, memory_size};
+    std::vector<double> run_inputs(data.num_input_identifiers);
+    std::vector<double> context_outputs(data.num_output_identifiers);
+    std::vector<double> fresh_outputs(data.num_output_identifiers);
+    for (std::size_t run{}; run != 8U; ++run) {
+        for (std::size_t input_index{}; input_index != data.num_input_identifiers; ++input_index) {
+            run_inputs[input_index] = args.at(input_index) + static_cast<double>((run * 3U) % 4U);
+        }
+        const auto context_ec = context.run(run_inputs, context_outputs);
+        const auto fresh_ec = RaychelScript::VM::execute(
+            data, run_inputs, fresh_outputs, stack_size, memory_size, std::pmr::get_default_resource());
+        if (context_ec != fresh_ec || (context_ec == RaychelScript::VM::VMErrorCode::ok && context_outputs != fresh_outputs)) {
+            Logger::error("Run #", run, " on a reused execution context does not match a fresh execution!\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+//Three full groups of lanes and a partial one. Every batched and every parallel invocation has to match a scalar run with the
+//same inputs, and has to report the first error a scalar run reports, in invocation order
+static bool check_batch_execution(const RaychelScript::VM::VMData& data, const std::vector<double>& args)
+{
+    const auto count = RaychelScript::VM::batch_lane_count() * 3U + 1U;
+    std::vector<double> inputs(data.num_input_identifiers * count);
+    for (std::size_t input_index{}; input_index != data.num_input_identifiers; ++input_index) {
+        for (std::size_t k{}; k != count; ++k) {
+            inputs[input_index * count + k] = args.at(input_index) + static_cast<double>(k % 4U);
+        }
+    }
+
+    std::vector<double> scalar_outputs(data.num_output_identifiers * count);
+    const auto scalar_ec = [&] {
+        std::vector<double> invocation_inputs(data.num_input_identifiers);
+        std::vector<double> invocation_outputs(data.num_output_identifiers);
+        for (std::size_t k{}; k != count; ++k) {
+            for (std::size_t input_index{}; input_index != data.num_input_identifiers; ++input_index) {
+                invocation_inputs[input_index] = inputs[input_index * count + k];
+            }
+            if (const auto ec = RaychelScript::VM::execute(
+                    data, invocation_inputs, invocation_outputs, stack_size, memory_size, std::pmr::get_default_resource());
+                ec != RaychelScript::VM::VMErrorCode::ok) {
+                return ec;
+            }
+            for (std::size_t output_index{}; output_index != data.num_output_identifiers; ++output_index) {
+                scalar_outputs[output_index * count + k] = invocation_outputs[output_index];
+            }
+        }
+        return RaychelScript::VM::VMErrorCode::ok;
+    }();
+
+    const auto matches_scalar_execution = [&](std::span<const double> batch_outputs) {
+        return std::memcmp(scalar_outputs.data(), batch_outputs.data(), scalar_outputs.size() * sizeof(double)) == 0;
+    };
+
+    std::vector<double> serial_outputs(data.num_output_identifiers * count);
+    std::vector<double> parallel_outputs(data.num_output_identifiers * count);
+
+    //At least four workers, so the chunks run concurrently and get stolen even on a single core
+    RaychelScript::BatchExecutor executor{std::max<std::size_t>(RaychelScript::BatchExecutor::default_number_of_threads(), 4U)};
+
+    const auto serial_start = std::chrono::steady_clock::now();
+    const auto serial_ec = RaychelScript::VM::execute_batch<stack_size, memory_size>(data, inputs, serial_outputs, count);
+    const auto parallel_start = std::chrono::steady_clock::now();
+    const auto parallel_ec =
+        RaychelScript::VM::execute_parallel<stack_size, memory_size>(data, inputs, parallel_outputs, count, executor);
+    const auto parallel_end = std::chrono::steady_clock::now();
+
+    //All invocations fit into one chunk of execute_parallel(). Chunks of a single invocation are spread over all workers
+    std::vector<double> chunked_outputs(data.num_output_identifiers * count);
+    const auto chunked_ec = executor.run(
+        [&data](std::span<const double> chunk_inputs, std::span<double> chunk_outputs, std::size_t chunk_count,
+                std::pmr::memory_resource* arena) {
+            return RaychelScript::VM::execute_batch(
+                data, chunk_inputs, chunk_outputs, chunk_count, stack_size, memory_size, arena);
+        },
+        inputs,
+        chunked_outputs,
+        data.num_input_identifiers,
+        data.num_output_identifiers,
+        count,
+        1U);
+
+    if (serial_ec != scalar_ec ||
+        (serial_ec == RaychelScript::VM::VMErrorCode::ok && !matches_scalar_execution(serial_outputs))) {
+        Logger::error(
+            "Batched execution on ",
+            RaychelScript::VM::batch_lane_count(),
+            " lanes returned '",
+            serial_ec,
+            "' and does not match scalar execution, which returned '",
+            scalar_ec,
+            "'!\n");
+        return false;
+    }
+    if (parallel_ec != serial_ec ||
+        (parallel_ec == RaychelScript::VM::VMErrorCode::ok && !matches_scalar_execution(parallel_outputs))) {
+        Logger::error(
+            "Parallel execution on ",
+            executor.number_of_threads(),
+            " threads returned '",
+            parallel_ec,
+            "' and does not match scalar execution, which returned '",
+            scalar_ec,
+            "'!\n");
+        return false;
+    }
+    if (chunked_ec != serial_ec ||
+        (chunked_ec == RaychelScript::VM::VMErrorCode::ok && !matches_scalar_execution(chunked_outputs))) {
+        Logger::error(
+            "Execution in chunks of one invocation returned '",
+            chunked_ec,
+            "' and does not match scalar execution, which returned '",
+            scalar_ec,
+            "'!\n");
+        return false;
+    }
+
+    using std::chrono::duration_cast, std::chrono::microseconds;
+    Logger::info(
+        count,
+        " invocations took ",
+        duration_cast<microseconds>(parallel_start - serial_start).count(),
+        "µs on one thread and ",
+        duration_cast<microseconds>(parallel_end - parallel_start).count(),
+        "µs on ",
+        executor.number_of_threads(),
+        " threads\n");
+    return true;
+}
+
 int main(int argc, char** argv)
 {
     Logger::setMinimumLogLevel(Logger::LogLevel::debug);
@@ -44,10 +399,15 @@ int main(int argc, char** argv)
         if (is_binary_file) {
             return ReadRSBF{file_name};
         }
+        //NOLINTNEXTLINE(concurrency-mt-unsafe): nothing else is running yet
+        if (const auto* cache_directory = std::getenv("RAYCHELSCRIPT_CACHE_DIR"); cache_directory != nullptr) {
+            return CompileCached{lex_file, file_name, cache_directory};
+        }
         return Lex{{}, file_name} | Parse{} | Assemble{};
     }();
 
-    const auto values_or_error = data_or_error | RaychelScript::Pipes::Execute<std::dynamic_extent, 32, 128>(args);
+    const auto values_or_error =
+        data_or_error | RaychelScript::Pipes::Execute<std::dynamic_extent, stack_size, memory_size>(args);
 
     if (log_if_error(values_or_error)) {
         return 1;
@@ -58,5 +418,29 @@ int main(int argc, char** argv)
         Logger::info("Output #", ++i, " = ", value, '\n');
     }
 
+    //Binary files do not come with the source they were assembled from
+    const auto ast = [&]() -> std::optional<RaychelScript::AST> {
+        using namespace RaychelScript::Pipes; //NOLINT
+        if (is_binary_file) {
+            return std::nullopt;
+        }
+        return (Lex{{}, file_name} | Parse{}).value();
+    }();
+    const auto& outputs = values_or_error.value();
+
+    if (ast.has_value() &&
+        (!check_compilation_cache(file_name, args, outputs) || !check_inlining(*ast, args, outputs) ||
+         !check_interpreter(*ast, args, outputs))) {
+        return 1;
+    }
+
+    const auto& data = data_or_error.value();
+    const auto expects_lookups = ast.has_value() && calls_pure_recursive_function(*ast);
+
+    if (!check_memory_overflow(data, args) || !check_memoisation(data, args, outputs, expects_lookups) ||
+        !check_prepared_vm(data, args, outputs) || !check_context_reuse(data, args) || !check_batch_execution(data, args)) {
+        return 1;
+    }
+
     return 0;
 }
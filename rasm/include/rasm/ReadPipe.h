@@ -28,10 +28,12 @@
 #ifndef RAYCHELSCRIPT_READ_PIPE_H
 #define RAYCHELSCRIPT_READ_PIPE_H
 
+#include "bundle.h"
 #include "read.h"
 #include "shared/Pipes/PipeResult.h"
 
 #include <fstream>
+#include <string>
 #include <string_view>
 
 namespace RaychelScript::Pipes {
@@ -56,6 +58,30 @@ namespace RaychelScript::Pipes {
         std::ifstream input_stream_;
     };
 
+    /**
+    * \brief Fetch a single script out of a bundle by name. The bundle has to stay mapped while the pipe is used
+    */
+    class ReadBundledRSBF
+    {
+    public:
+        ReadBundledRSBF(const Assembly::BundleView& bundle, std::string_view name) : bundle_{bundle}, name_{name}
+        {}
+
+        Assembly::ReadResult operator()() const noexcept
+        {
+            return bundle_.read(name_);
+        }
+
+        operator PipeResult<VM::VMData>() const noexcept //NOLINT: we want this conversion operator to be implicit
+        {
+            return (*this)();
+        }
+
+    private:
+        Assembly::BundleView bundle_;
+        std::string name_;
+    };
+
 } //namespace RaychelScript::Pipes
 
 #endif //!RAYCHELSCRIPT_READ_PIPE_H
@@ -0,0 +1,193 @@
+/**
+* \file bundle.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for RSBF bundles
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_ASSEMBLY_BUNDLE_H
+#define RAYCHELSCRIPT_ASSEMBLY_BUNDLE_H
+
+#include "magic.h"
+#include "map.h"
+#include "read.h"
+#include "shared/VM/VMData.h"
+#include "shared/VM/VMDataView.h"
+
+#include "RaychelCore/ClassMacros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace RaychelScript::Assembly {
+
+    //Bundles are written in native byte order, just like mapped files
+    constexpr std::uint32_t bundle_magic_word = 0x420F00D4U;
+
+    /**
+    * \brief Layout of RSBF bundles
+    *
+    * A bundle starts with a Header, followed by one Script entry per script, sorted by name, and the names of all scripts.
+    * All scripts share one pool of immediate values. The immediate indices in their code point straight into that pool, so
+    * every script can be executed from the mapping without any fix-ups. The call frames and the code of each script start
+    * on their own code_alignment boundary.
+    */
+    namespace Bundle {
+
+        struct Header
+        {
+            std::uint32_t magic{bundle_magic_word};
+            std::uint32_t version{};
+            std::uint32_t number_of_scripts{};
+            std::uint32_t number_of_immediates{};
+            std::uint64_t immediates_offset{};
+            std::uint64_t names_offset{};
+            std::uint64_t names_size{};
+        };
+
+        struct Script
+        {
+            std::uint64_t name_offset{}; //from the start of the names
+            std::uint32_t name_size{};
+            std::uint32_t num_input_identifiers{};
+            std::uint32_t num_output_identifiers{};
+            std::uint32_t number_of_call_frames{};
+            std::uint32_t number_of_instructions{};
+            std::uint32_t reserved{};
+            std::uint64_t call_frames_offset{}; //from the start of the file
+            std::uint64_t code_offset{};        //from the start of the file
+        };
+
+        static_assert(sizeof(Header) == 40U && sizeof(Script) == 48U);
+        //Written byte for byte like the mapped layout (see map.h for the Instruction layout), so no padding is allowed
+        static_assert(std::has_unique_object_representations_v<Header> && std::has_unique_object_representations_v<Script>);
+
+    } // namespace Bundle
+
+    /**
+    * \brief Scripts to put into a bundle, by name
+    */
+    using BundleContents = std::map<std::string, VM::VMData, std::less<>>;
+
+    /**
+    * \brief A validated bundle image. Scripts are looked up by name and returned as views into the image
+    */
+    class BundleView
+    {
+        friend RAYCHELSCRIPT_ASSEMBLY_API std::variant<ReadingErrorCode, BundleView>
+        view_bundle(std::span<const std::byte> bytes) noexcept;
+
+    public:
+        BundleView() = default;
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return scripts_.size();
+        }
+
+        [[nodiscard]] std::string_view name(std::size_t index) const noexcept
+        {
+            return names_.substr(scripts_[index].name_offset, scripts_[index].name_size);
+        }
+
+        [[nodiscard]] std::span<const double> immediate_values() const noexcept
+        {
+            return immediate_values_;
+        }
+
+        /**
+        * \brief Find a script by name. The code of a script is only validated when it is looked up
+        */
+        [[nodiscard]] RAYCHELSCRIPT_ASSEMBLY_API ViewResult find(std::string_view name) const noexcept;
+
+        /**
+        * \brief Copy a script out of the bundle. Only the immediate values the script uses are copied
+        */
+        [[nodiscard]] RAYCHELSCRIPT_ASSEMBLY_API ReadResult read(std::string_view name) const noexcept;
+
+    private:
+        std::span<const std::byte> bytes_{};
+        std::span<const Bundle::Script> scripts_{};
+        std::string_view names_{};
+        std::span<const double> immediate_values_{};
+    };
+
+    using BundleViewResult = std::variant<ReadingErrorCode, BundleView>;
+
+    /**
+    * \brief Validate the header and index of a bundle image
+    *
+    * bytes has to be aligned to VM::code_alignment and must outlive the view.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] BundleViewResult view_bundle(std::span<const std::byte> bytes) noexcept;
+
+    /**
+    * \brief A read-only mapping of a bundle
+    */
+    class MappedBundle
+    {
+        friend RAYCHELSCRIPT_ASSEMBLY_API std::variant<ReadingErrorCode, MappedBundle>
+        read_bundle(std::string_view path) noexcept;
+
+        explicit MappedBundle(MappedFile file, BundleView view) noexcept : file_{std::move(file)}, view_{view}
+        {}
+
+    public:
+        RAYCHEL_MAKE_NONCOPY(MappedBundle)
+        RAYCHEL_MAKE_DEFAULT_MOVE(MappedBundle)
+
+        /**
+        * \brief The scripts inside the mapping. Only valid while this object is alive
+        */
+        [[nodiscard]] const BundleView& view() const noexcept
+        {
+            return view_;
+        }
+
+        ~MappedBundle() noexcept = default;
+
+    private:
+        MappedFile file_;
+        BundleView view_{};
+    };
+
+    using BundleResult = std::variant<ReadingErrorCode, MappedBundle>;
+
+    /**
+    * \brief Map a bundle written by write_bundle() into memory
+    *
+    * The whole bundle is opened with a single mapping and only its header and index are checked up front.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] BundleResult read_bundle(std::string_view path) noexcept;
+
+} //namespace RaychelScript::Assembly
+
+#endif //!RAYCHELSCRIPT_ASSEMBLY_BUNDLE_H
@@ -0,0 +1,78 @@
+/**
+* \file cache.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the RSBF compilation cache
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_ASSEMBLY_CACHE_H
+#define RAYCHELSCRIPT_ASSEMBLY_CACHE_H
+
+#include "magic.h"
+#include "read.h"
+#include "shared/VM/VMData.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace RaychelScript::Assembly {
+
+    /**
+    * \brief Key of a compiled script in a compilation cache
+    *
+    * The key is a hash of the source text, the RSBF version and codegen_version, the version of the code generator that
+    * compiled the script. Files written by an incompatible toolchain or with older code generation are never hit.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] std::uint64_t
+    cache_key(std::string_view source_text, std::uint32_t codegen_version) noexcept;
+
+    /**
+    * \brief Path of the cache entry for key inside cache_directory
+    *
+    * Entries are not plain RSBF files: they start with the length and a second, independent hash of the source text they
+    * were compiled from.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] std::string cache_path(std::string_view cache_directory, std::uint64_t key) noexcept;
+
+    /**
+    * \brief Read the script compiled from source_text from a compilation cache
+    *
+    * Misses are reported as ReadingErrorCode::file_not_found. An entry that was compiled from a different source, because its
+    * key collides with the one of source_text or because it was put there by someone else, is a miss as well.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] ReadResult
+    read_cached_rsbf(std::string_view cache_directory, std::uint64_t key, std::string_view source_text) noexcept;
+
+    /**
+    * \brief Store a script in a compilation cache, creating cache_directory if needed
+    *
+    * The file is written under a temporary name first and then renamed, so readers in other processes never see a partially
+    * written entry.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] bool write_cached_rsbf(
+        std::string_view cache_directory, std::uint64_t key, std::string_view source_text, const VM::VMData& data) noexcept;
+
+} //namespace RaychelScript::Assembly
+
+#endif //!RAYCHELSCRIPT_ASSEMBLY_CACHE_H
@@ -0,0 +1,121 @@
+/**
+* \file lazy.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for lazy RSBF loading
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_ASSEMBLY_LAZY_H
+#define RAYCHELSCRIPT_ASSEMBLY_LAZY_H
+
+#include "magic.h"
+#include "read.h"
+#include "shared/VM/LazyVMData.h"
+
+#include "RaychelCore/ClassMacros.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace RaychelScript::Assembly {
+
+    /**
+    * \brief An RSBF file whose call frames are only read once they are needed
+    *
+    * Opening the file reads the header, the immediates and the function index. The instructions of a call frame are read
+    * the first time the VM calls into it (see data()) or when load_call_frame() is called. Files written before version 9
+    * have no function index and are read completely when they are opened.
+    *
+    * Not thread safe: loading a call frame seeks the underlying stream.
+    */
+    class LazyRSBF
+    {
+        friend RAYCHELSCRIPT_ASSEMBLY_API std::variant<ReadingErrorCode, LazyRSBF>
+        open_lazy_rsbf(std::unique_ptr<std::istream> stream) noexcept;
+
+        struct FrameLocation
+        {
+            std::uint64_t offset{};
+            std::uint32_t number_of_instructions{};
+        };
+
+        LazyRSBF() = default;
+
+    public:
+        RAYCHEL_MAKE_NONCOPY(LazyRSBF)
+        RAYCHEL_MAKE_DEFAULT_MOVE(LazyRSBF)
+
+        /**
+        * \brief The script with a loader that reads missing call frames from this file. Only valid while this object is alive
+        *
+        * The loader refers to this object, so the returned data has to be requested again after this object was moved.
+        */
+        [[nodiscard]] RAYCHELSCRIPT_ASSEMBLY_API VM::LazyVMData data() noexcept;
+
+        /**
+        * \brief Read the instructions of a call frame if that has not happened yet
+        */
+        [[nodiscard]] RAYCHELSCRIPT_ASSEMBLY_API bool load_call_frame(std::uint32_t index) noexcept;
+
+        [[nodiscard]] bool is_loaded(std::uint32_t index) const noexcept
+        {
+            return index < loaded_.size() && loaded_[index];
+        }
+
+        [[nodiscard]] std::size_t number_of_call_frames() const noexcept
+        {
+            return data_.call_frames.size();
+        }
+
+        ~LazyRSBF() noexcept = default;
+
+    private:
+        std::unique_ptr<std::istream> stream_{};
+        std::streamoff code_begin_{};
+        std::vector<FrameLocation> locations_{};
+        std::vector<bool> loaded_{};
+
+        VM::VMData data_{};
+    };
+
+    using LazyReadResult = std::variant<ReadingErrorCode, LazyRSBF>;
+
+    /**
+    * \brief Open an RSBF file for lazy loading. stream has to be seekable
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] LazyReadResult open_lazy_rsbf(std::unique_ptr<std::istream> stream) noexcept;
+
+    [[nodiscard]] inline LazyReadResult open_lazy_rsbf(std::string_view path) noexcept
+    {
+        return open_lazy_rsbf(std::make_unique<std::ifstream>(std::string{path}, std::ios::in | std::ios::binary));
+    }
+
+} //namespace RaychelScript::Assembly
+
+#endif //!RAYCHELSCRIPT_ASSEMBLY_LAZY_H
@@ -0,0 +1,182 @@
+/**
+* \file map.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for memory mapped RSBF files
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_ASSEMBLY_MAP_H
+#define RAYCHELSCRIPT_ASSEMBLY_MAP_H
+
+#include "magic.h"
+#include "read.h"
+#include "shared/VM/VMDataView.h"
+
+#include "RaychelCore/ClassMacros.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace RaychelScript::Assembly {
+
+    //Mapped files are written in native byte order, so this also tells if a file came from a machine with different endianness
+    constexpr std::uint32_t mapped_magic_word = 0x4D0F00D4U;
+
+    /**
+    * \brief Layout of memory mapped RSBF files
+    *
+    * A mapped file starts with a Header, followed by a table of Sections. Every section is an array of the type its kind
+    * names and starts on a code_alignment boundary. The code section holds the code segment of the linked script, including
+    * the padding between call frames, so nothing has to be copied or relocated when the file is loaded.
+    */
+    namespace Mapped {
+
+        enum class SectionKind : std::uint32_t {
+            immediates = 1,  //double
+            call_frames,     //VM::LinkedCallFrameDescriptor
+            code,            //Instruction
+        };
+
+        struct Header
+        {
+            std::uint32_t magic{mapped_magic_word};
+            std::uint32_t version{};
+            std::uint32_t num_input_identifiers{};
+            std::uint32_t num_output_identifiers{};
+            std::uint32_t number_of_sections{};
+            std::uint32_t reserved{};
+        };
+
+        struct Section
+        {
+            SectionKind kind{};
+            std::uint32_t count{};  //number of elements, not bytes
+            std::uint64_t offset{}; //from the start of the file
+        };
+
+        static_assert(sizeof(Header) == 24U && sizeof(Section) == 16U);
+        static_assert(sizeof(VM::LinkedCallFrameDescriptor) == 12U);
+        //Everything is written byte for byte, so none of these may contain padding with indeterminate values
+        static_assert(std::has_unique_object_representations_v<Header> && std::has_unique_object_representations_v<Section>);
+        static_assert(sizeof(Instruction) == 16U && std::has_unique_object_representations_v<Instruction>);
+
+    } // namespace Mapped
+
+    using ViewResult = std::variant<ReadingErrorCode, VM::VMDataView>;
+
+    /**
+    * \brief Validate a mapped RSBF image and return a view into it
+    *
+    * bytes has to be aligned to VM::code_alignment and must outlive the view.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] ViewResult view_rsbf(std::span<const std::byte> bytes) noexcept;
+
+    /**
+    * \brief A read-only mapping of a whole file. The mapping starts on a VM::code_alignment boundary
+    */
+    class MappedFile
+    {
+        friend RAYCHELSCRIPT_ASSEMBLY_API std::variant<ReadingErrorCode, MappedFile> map_file(std::string_view path) noexcept;
+
+        explicit MappedFile(void* address, std::size_t size) noexcept : address_{address}, size_{size}
+        {}
+
+    public:
+        RAYCHEL_MAKE_NONCOPY(MappedFile)
+
+        MappedFile(MappedFile&& other) noexcept
+            : address_{std::exchange(other.address_, nullptr)}, size_{std::exchange(other.size_, 0U)}
+        {}
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            std::swap(address_, other.address_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept
+        {
+            return {static_cast<const std::byte*>(address_), size_};
+        }
+
+        RAYCHELSCRIPT_ASSEMBLY_API ~MappedFile() noexcept;
+
+    private:
+        void* address_{};
+        std::size_t size_{};
+    };
+
+    using MappedFileResult = std::variant<ReadingErrorCode, MappedFile>;
+
+    /**
+    * \brief Map a file into memory. On platforms without mmap, the file is read into an aligned buffer instead
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] MappedFileResult map_file(std::string_view path) noexcept;
+
+    /**
+    * \brief A read-only mapping of a mapped RSBF file
+    */
+    class MappedRSBF
+    {
+        friend RAYCHELSCRIPT_ASSEMBLY_API std::variant<ReadingErrorCode, MappedRSBF> map_rsbf(std::string_view path) noexcept;
+
+        explicit MappedRSBF(MappedFile file, VM::VMDataView view) noexcept : file_{std::move(file)}, view_{view}
+        {}
+
+    public:
+        RAYCHEL_MAKE_NONCOPY(MappedRSBF)
+        RAYCHEL_MAKE_DEFAULT_MOVE(MappedRSBF)
+
+        /**
+        * \brief The script inside the mapping. Only valid while this object is alive
+        */
+        [[nodiscard]] const VM::VMDataView& view() const noexcept
+        {
+            return view_;
+        }
+
+        ~MappedRSBF() noexcept = default;
+
+    private:
+        MappedFile file_;
+        VM::VMDataView view_{};
+    };
+
+    using MapResult = std::variant<ReadingErrorCode, MappedRSBF>;
+
+    /**
+    * \brief Map a file written by write_mapped_rsbf() into memory
+    *
+    * Loading only costs the page faults for the parts of the file that are actually used.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] MapResult map_rsbf(std::string_view path) noexcept;
+
+} //namespace RaychelScript::Assembly
+
+#endif //!RAYCHELSCRIPT_ASSEMBLY_MAP_H
@@ -29,6 +29,7 @@
 #define RAYCHELSCRIPT_ASSEMBLY_READ_H
 
 #include "magic.h"
+#include "shared/VM/LinkedVMData.h"
 #include "shared/VM/VMData.h"
 
 #include <fstream>
@@ -45,6 +46,8 @@ namespace RaychelScript::Assembly {
         no_magic_word,
         wrong_version,
         reading_failure,
+        wrong_byte_order,
+        script_not_found,
     };
 
     constexpr std::string_view error_code_to_reason_string(ReadingErrorCode ec) noexcept
@@ -60,6 +63,10 @@ namespace RaychelScript::Assembly {
                 return "Incombatible version";
             case ReadingErrorCode::reading_failure:
                 return "Error while reading data";
+            case ReadingErrorCode::wrong_byte_order:
+                return "File was written on a machine with different byte order";
+            case ReadingErrorCode::script_not_found:
+                return "No script with that name in the bundle";
         }
         return "<unknown>";
     }
@@ -79,6 +86,19 @@ namespace RaychelScript::Assembly {
         return read_rsbf(stream);
     }
 
+    using LinkedReadResult = std::variant<ReadingErrorCode, VM::LinkedVMData>;
+
+    /**
+    * \brief Read an RSBF file directly into the linked layout used by the VM
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API LinkedReadResult read_linked_rsbf(std::istream& stream) noexcept;
+
+    inline LinkedReadResult read_linked_rsbf(std::string_view path) noexcept
+    {
+        std::ifstream stream{std::string{path}, std::ios::in | std::ios::binary};
+        return read_linked_rsbf(stream);
+    }
+
 } //namespace RaychelScript::Assembly
 
 #endif //!RAYCHELSCRIPT_ASSEMBLY_READ  _H
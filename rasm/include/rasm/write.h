@@ -28,7 +28,9 @@
 #ifndef RAYCHELSCRIPT_ASSEMBLY_WRITE_H
 #define RAYCHELSCRIPT_ASSEMBLY_WRITE_H
 
+#include "bundle.h"
 #include "magic.h"
+#include "shared/VM/LinkedVMData.h"
 #include "shared/VM/VMData.h"
 
 #include <fstream>
@@ -46,6 +48,45 @@ namespace RaychelScript::Assembly {
         return write_rsbf(stream, data);
     }
 
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] bool write_rsbf(std::ostream& stream, const VM::LinkedVMData& data) noexcept;
+
+    [[nodiscard]] inline bool write_rsbf(std::string_view path, const VM::LinkedVMData& data) noexcept
+    {
+        std::ofstream stream{std::string{path}, std::ios::out | std::ios::binary};
+        return write_rsbf(stream, data);
+    }
+
+    /**
+    * \brief Write data in the memory mappable layout read by map_rsbf() (see rasm/map.h)
+    *
+    * The file is written in native byte order and every section goes out in a single write.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] bool write_mapped_rsbf(std::ostream& stream, const VM::LinkedVMData& data) noexcept;
+
+    [[nodiscard]] inline bool write_mapped_rsbf(std::string_view path, const VM::LinkedVMData& data) noexcept
+    {
+        std::ofstream stream{std::string{path}, std::ios::out | std::ios::binary};
+        return write_mapped_rsbf(stream, data);
+    }
+
+    [[nodiscard]] inline bool write_mapped_rsbf(std::string_view path, const VM::VMData& data) noexcept
+    {
+        return write_mapped_rsbf(path, VM::link(data));
+    }
+
+    /**
+    * \brief Write several scripts into one bundle that can be opened with read_bundle() (see rasm/bundle.h)
+    *
+    * Immediate values that appear in more than one script are only stored once.
+    */
+    RAYCHELSCRIPT_ASSEMBLY_API [[nodiscard]] bool write_bundle(std::ostream& stream, const BundleContents& scripts) noexcept;
+
+    [[nodiscard]] inline bool write_bundle(std::string_view path, const BundleContents& scripts) noexcept
+    {
+        std::ofstream stream{std::string{path}, std::ios::out | std::ios::binary};
+        return write_bundle(stream, scripts);
+    }
+
 } //namespace RaychelScript::Assembly
 
 #endif //!RAYCHELSCRIPT_ASSEMBLY_WRITE_H
@@ -0,0 +1,179 @@
+/**
+* \file cache.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for the RSBF compilation cache
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "rasm/cache.h"
+#include "rasm/write.h"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <system_error>
+#include <thread>
+
+namespace RaychelScript::Assembly {
+
+    namespace {
+
+        //64-bit FNV-1a
+        constexpr std::uint64_t fnv_offset_basis = 0xCBF2'9CE4'8422'2325U;
+        constexpr std::uint64_t fnv_prime = 0x0000'0100'0000'01B3U;
+
+        std::uint64_t hash_bytes(std::uint64_t hash, std::string_view bytes) noexcept
+        {
+            for (const auto byte : bytes) {
+                hash ^= static_cast<std::uint8_t>(byte);
+                hash *= fnv_prime;
+            }
+            return hash;
+        }
+
+        //Multiplicative hash with a xorshift after every byte. It shares nothing with FNV-1a, so two sources whose keys collide
+        //still have different digests
+        std::uint64_t source_digest(std::string_view source_text) noexcept
+        {
+            constexpr std::uint64_t multiplier = 0x9E37'79B9'7F4A'7C15U;
+            std::uint64_t hash{source_text.size()};
+            for (const auto byte : source_text) {
+                hash = (hash + static_cast<std::uint8_t>(byte)) * multiplier;
+                hash ^= hash >> 29U;
+            }
+            return hash;
+        }
+
+        //Every entry starts with the length and digest of the source it was compiled from, followed by the RSBF file
+        using EntryHeader = std::array<std::uint64_t, 2>;
+
+        EntryHeader entry_header(std::string_view source_text) noexcept
+        {
+            return EntryHeader{source_text.size(), source_digest(source_text)};
+        }
+
+        bool write_entry_header(std::ostream& stream, const EntryHeader& header) noexcept
+        {
+            std::array<char, sizeof(EntryHeader)> bytes{};
+            for (std::size_t i{}; i != bytes.size(); ++i) {
+                const auto word = header.at(i / sizeof(std::uint64_t));
+                bytes.at(i) = static_cast<char>((word >> (8U * (i % sizeof(std::uint64_t)))) & 0xFFU);
+            }
+            stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            return stream.good();
+        }
+
+        std::optional<EntryHeader> read_entry_header(std::istream& stream) noexcept
+        {
+            std::array<char, sizeof(EntryHeader)> bytes{};
+            if (!stream.read(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+                return std::nullopt;
+
+            EntryHeader header{};
+            for (std::size_t i{}; i != bytes.size(); ++i) {
+                header.at(i / sizeof(std::uint64_t)) |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(bytes.at(i)))
+                                                        << (8U * (i % sizeof(std::uint64_t)));
+            }
+            return header;
+        }
+
+        std::string to_hex(std::uint64_t value) noexcept
+        {
+            constexpr std::string_view digits{"0123456789abcdef"};
+            std::string hex(16U, '0');
+            for (auto it = hex.rbegin(); it != hex.rend(); ++it) {
+                *it = digits[value & 0xFU];
+                value >>= 4U;
+            }
+            return hex;
+        }
+
+    } // namespace
+
+    std::uint64_t cache_key(std::string_view source_text, std::uint32_t codegen_version) noexcept
+    {
+        const std::array versions{version_number(), codegen_version};
+        std::array<char, sizeof(versions)> version_bytes{};
+        for (std::size_t i{}; i != version_bytes.size(); ++i) {
+            const auto version = versions.at(i / sizeof(std::uint32_t));
+            version_bytes.at(i) = static_cast<char>((version >> (8U * (i % sizeof(std::uint32_t)))) & 0xFFU);
+        }
+
+        const auto hash = hash_bytes(fnv_offset_basis, std::string_view{version_bytes.data(), version_bytes.size()});
+        return hash_bytes(hash, source_text);
+    }
+
+    std::string cache_path(std::string_view cache_directory, std::uint64_t key) noexcept
+    {
+        return (std::filesystem::path{cache_directory} / (to_hex(key) + ".rsbc")).string();
+    }
+
+    ReadResult read_cached_rsbf(std::string_view cache_directory, std::uint64_t key, std::string_view source_text) noexcept
+    {
+        std::ifstream stream{cache_path(cache_directory, key), std::ios::in | std::ios::binary};
+        if (!stream)
+            return ReadingErrorCode::file_not_found;
+
+        //The key alone can collide, and an entry compiled from another source must never be run
+        if (read_entry_header(stream) != entry_header(source_text))
+            return ReadingErrorCode::file_not_found;
+
+        return read_rsbf(stream);
+    }
+
+    bool write_cached_rsbf(
+        std::string_view cache_directory, std::uint64_t key, std::string_view source_text, const VM::VMData& data) noexcept
+    {
+        std::error_code ec{};
+        std::filesystem::create_directories(std::filesystem::path{cache_directory}, ec);
+        if (ec)
+            return false;
+
+        const auto path = cache_path(cache_directory, key);
+
+        //Processes compiling the same script at the same time must not write to the same temporary file
+        const auto salt = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                          std::hash<std::thread::id>{}(std::this_thread::get_id());
+        const auto temporary_path = path + '.' + to_hex(salt) + ".tmp";
+
+        {
+            std::ofstream stream{temporary_path, std::ios::out | std::ios::binary};
+            if (!write_entry_header(stream, entry_header(source_text)) || !write_rsbf(stream, data) || !stream.flush()) {
+                stream.close();
+                std::filesystem::remove(temporary_path, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary_path, path, ec);
+        if (ec) {
+            std::filesystem::remove(temporary_path, ec);
+            return false;
+        }
+        return true;
+    }
+
+} //namespace RaychelScript::Assembly
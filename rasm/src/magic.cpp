@@ -32,7 +32,7 @@ namespace RaychelScript::Assembly {
 
     [[nodiscard]] std::uint32_t version_number() noexcept
     {
-        return 0x6;
+        return 0xA;
     }
 
 } //namespace RaychelScript::Assembly
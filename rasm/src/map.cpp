@@ -0,0 +1,356 @@
+/**
+* \file map.cpp
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Implementation file for memory mapped RSBF files
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#include "rasm/map.h"
+#include "rasm/bundle.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #include <fstream>
+    #include <new>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace RaychelScript::Assembly {
+
+    namespace {
+
+        template <typename T>
+        T load(std::span<const std::byte> bytes, std::size_t offset) noexcept
+        {
+            T value{};
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            return value;
+        }
+
+        //Return the elements of section, or std::nullopt if it does not fit into the file or is misaligned
+        template <typename T>
+        std::optional<std::span<const T>> section_data(std::span<const std::byte> bytes, const Mapped::Section& section) noexcept
+        {
+            if (section.offset > bytes.size() || section.offset % alignof(T) != 0U)
+                return std::nullopt;
+            if (section.count > (bytes.size() - section.offset) / sizeof(T))
+                return std::nullopt;
+
+            //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast): the writer put trivially copyable objects here
+            const auto* begin = reinterpret_cast<const T*>(bytes.data() + section.offset);
+            return std::span<const T>{begin, section.count};
+        }
+
+        constexpr std::uint32_t byteswap(std::uint32_t x) noexcept
+        {
+            return (x >> 24U) | ((x >> 8U) & 0xFF00U) | ((x << 8U) & 0xFF'0000U) | (x << 24U);
+        }
+
+        bool is_valid_call_frame(const VM::LinkedCallFrameDescriptor& frame, std::size_t code_size) noexcept
+        {
+            return frame.entry_point <= code_size && frame.number_of_instructions <= code_size - frame.entry_point;
+        }
+
+    } // namespace
+
+    ViewResult view_rsbf(std::span<const std::byte> bytes) noexcept
+    {
+        if (bytes.size() < sizeof(Mapped::Header))
+            return ReadingErrorCode::reading_failure;
+        if (std::bit_cast<std::uintptr_t>(bytes.data()) % VM::code_alignment != 0U)
+            return ReadingErrorCode::reading_failure;
+
+        const auto header = load<Mapped::Header>(bytes, 0U);
+        if (header.magic == byteswap(mapped_magic_word))
+            return ReadingErrorCode::wrong_byte_order;
+        if (header.magic != mapped_magic_word)
+            return ReadingErrorCode::no_magic_word;
+
+        //The mapped layout was introduced with version 8
+        if (header.version < 8U || header.version > version_number())
+            return ReadingErrorCode::wrong_version;
+
+        const auto table_size = static_cast<std::size_t>(header.number_of_sections) * sizeof(Mapped::Section);
+        if (table_size > bytes.size() - sizeof(Mapped::Header))
+            return ReadingErrorCode::reading_failure;
+
+        VM::VMDataView view{
+            .num_input_identifiers = header.num_input_identifiers,
+            .num_output_identifiers = header.num_output_identifiers,
+        };
+        bool has_code{false};
+        bool has_call_frames{false};
+
+        for (std::uint32_t i{}; i != header.number_of_sections; ++i) {
+            const auto section = load<Mapped::Section>(bytes, sizeof(Mapped::Header) + i * sizeof(Mapped::Section));
+            switch (section.kind) {
+                case Mapped::SectionKind::immediates:
+                    if (const auto data = section_data<double>(bytes, section); data.has_value()) {
+                        view.immediate_values = *data;
+                        continue;
+                    }
+                    return ReadingErrorCode::reading_failure;
+                case Mapped::SectionKind::call_frames:
+                    if (const auto data = section_data<VM::LinkedCallFrameDescriptor>(bytes, section); data.has_value()) {
+                        view.call_frames = *data;
+                        has_call_frames = true;
+                        continue;
+                    }
+                    return ReadingErrorCode::reading_failure;
+                case Mapped::SectionKind::code:
+                    if (const auto data = section_data<Instruction>(bytes, section); data.has_value()) {
+                        view.code = *data;
+                        has_code = true;
+                        continue;
+                    }
+                    return ReadingErrorCode::reading_failure;
+            }
+            //sections this version does not know about are skipped
+        }
+
+        if (!has_code || !has_call_frames || view.call_frames.empty())
+            return ReadingErrorCode::reading_failure;
+
+        for (const auto& frame : view.call_frames) {
+            if (!is_valid_call_frame(frame, view.code.size()))
+                return ReadingErrorCode::reading_failure;
+        }
+
+        return view;
+    }
+
+    BundleViewResult view_bundle(std::span<const std::byte> bytes) noexcept
+    {
+        if (bytes.size() < sizeof(Bundle::Header))
+            return ReadingErrorCode::reading_failure;
+        if (std::bit_cast<std::uintptr_t>(bytes.data()) % VM::code_alignment != 0U)
+            return ReadingErrorCode::reading_failure;
+
+        const auto header = load<Bundle::Header>(bytes, 0U);
+        if (header.magic == byteswap(bundle_magic_word))
+            return ReadingErrorCode::wrong_byte_order;
+        if (header.magic != bundle_magic_word)
+            return ReadingErrorCode::no_magic_word;
+
+        //Bundles were introduced with version 9
+        if (header.version < 9U || header.version > version_number())
+            return ReadingErrorCode::wrong_version;
+
+        BundleView view{};
+        view.bytes_ = bytes;
+
+        const auto scripts = section_data<Bundle::Script>(
+            bytes, Mapped::Section{.count = header.number_of_scripts, .offset = sizeof(Bundle::Header)});
+        const auto names = section_data<char>(
+            bytes, Mapped::Section{.count = static_cast<std::uint32_t>(header.names_size), .offset = header.names_offset});
+        const auto immediates = section_data<double>(
+            bytes, Mapped::Section{.count = header.number_of_immediates, .offset = header.immediates_offset});
+        if (!scripts.has_value() || !names.has_value() || !immediates.has_value() || header.names_size != names->size())
+            return ReadingErrorCode::reading_failure;
+
+        view.scripts_ = *scripts;
+        view.names_ = std::string_view{names->data(), names->size()};
+        view.immediate_values_ = *immediates;
+
+        //Lookups are binary searches, so the names have to be sorted and unique
+        for (std::size_t i{}; i != view.scripts_.size(); ++i) {
+            const auto& script = view.scripts_[i];
+            if (script.name_offset > view.names_.size() || script.name_size > view.names_.size() - script.name_offset)
+                return ReadingErrorCode::reading_failure;
+            if (i != 0U && !(view.name(i - 1U) < view.name(i)))
+                return ReadingErrorCode::reading_failure;
+        }
+
+        return view;
+    }
+
+    ViewResult BundleView::find(std::string_view name) const noexcept
+    {
+        const auto it = std::ranges::lower_bound(
+            scripts_, name, std::less<>{}, [this](const Bundle::Script& script) {
+                return names_.substr(script.name_offset, script.name_size);
+            });
+        if (it == scripts_.end() || names_.substr(it->name_offset, it->name_size) != name)
+            return ReadingErrorCode::script_not_found;
+
+        const auto call_frames = section_data<VM::LinkedCallFrameDescriptor>(
+            bytes_, Mapped::Section{.count = it->number_of_call_frames, .offset = it->call_frames_offset});
+        const auto code =
+            section_data<Instruction>(bytes_, Mapped::Section{.count = it->number_of_instructions, .offset = it->code_offset});
+        if (!call_frames.has_value() || !code.has_value() || call_frames->empty())
+            return ReadingErrorCode::reading_failure;
+
+        for (const auto& frame : *call_frames) {
+            if (!is_valid_call_frame(frame, code->size()))
+                return ReadingErrorCode::reading_failure;
+        }
+
+        return VM::VMDataView{
+            .num_input_identifiers = it->num_input_identifiers,
+            .num_output_identifiers = it->num_output_identifiers,
+            .immediate_values = immediate_values_,
+            .code = *code,
+            .call_frames = *call_frames,
+        };
+    }
+
+    ReadResult BundleView::read(std::string_view name) const noexcept
+    {
+        const auto maybe_view = find(name);
+        if (const auto* ec = std::get_if<ReadingErrorCode>(&maybe_view); ec)
+            return *ec;
+        const auto& view = std::get<VM::VMDataView>(maybe_view);
+
+        VM::VMData data{
+            .num_input_identifiers = view.num_input_identifiers,
+            .num_output_identifiers = view.num_output_identifiers,
+        };
+
+        //Immediate indices point into the shared pool and have to be made local to the script again
+        std::unordered_map<std::uint32_t, std::uint32_t> local_indices{};
+        const auto localize = [&](MemoryIndex& index) {
+            if (index.type() != MemoryIndex::ValueType::immediate)
+                return true;
+            if (index.value() >= immediate_values_.size())
+                return false;
+
+            const auto [it, inserted] =
+                local_indices.try_emplace(index.value(), static_cast<std::uint32_t>(data.immediate_values.size()));
+            if (inserted)
+                data.immediate_values.emplace_back(immediate_values_[index.value()]);
+            index = make_memory_index(it->second, MemoryIndex::ValueType::immediate);
+            return true;
+        };
+
+        for (const auto& frame : view.call_frames) {
+            auto& descriptor = data.call_frames.emplace_back(VM::CallFrameDescriptor{.size = frame.size});
+            const auto code = view.code.subspan(frame.entry_point, frame.number_of_instructions);
+            descriptor.instructions.assign(code.begin(), code.end());
+
+            for (auto& instruction : descriptor.instructions) {
+                if (instruction.op_code() == OpCode::jsr)
+                    continue;
+                if (!localize(instruction.index1()) || !localize(instruction.index2()) || !localize(instruction.index3()))
+                    return ReadingErrorCode::reading_failure;
+            }
+        }
+
+        return data;
+    }
+
+#ifdef _WIN32
+
+    //Without mmap the file is read into an aligned buffer in one go
+    MappedFileResult map_file(std::string_view path) noexcept
+    {
+        std::ifstream stream{std::string{path}, std::ios::in | std::ios::binary | std::ios::ate};
+        if (!stream)
+            return ReadingErrorCode::file_not_found;
+
+        const auto size = static_cast<std::size_t>(stream.tellg());
+        stream.seekg(0);
+
+        void* buffer = ::operator new(size, std::align_val_t{VM::code_alignment}, std::nothrow);
+        if (buffer == nullptr)
+            return ReadingErrorCode::reading_failure;
+
+        MappedFile file{buffer, size};
+        if (!stream.read(static_cast<char*>(buffer), static_cast<std::streamsize>(size)))
+            return ReadingErrorCode::reading_failure;
+        return file;
+    }
+
+    MappedFile::~MappedFile() noexcept
+    {
+        if (address_ != nullptr)
+            ::operator delete(address_, std::align_val_t{VM::code_alignment});
+    }
+
+#else
+
+    MappedFileResult map_file(std::string_view path) noexcept
+    {
+        const int file = open(std::string{path}.c_str(), O_RDONLY | O_CLOEXEC); //NOLINT(cppcoreguidelines-pro-type-vararg)
+        if (file == -1)
+            return ReadingErrorCode::file_not_found;
+
+        struct stat file_status{};
+        if (fstat(file, &file_status) != 0 || file_status.st_size <= 0) {
+            close(file);
+            return ReadingErrorCode::reading_failure;
+        }
+
+        const auto size = static_cast<std::size_t>(file_status.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        close(file); //the mapping keeps its own reference to the file
+        if (address == MAP_FAILED)
+            return ReadingErrorCode::reading_failure;
+
+        return MappedFile{address, size};
+    }
+
+    MappedFile::~MappedFile() noexcept
+    {
+        if (address_ != nullptr)
+            munmap(address_, size_);
+    }
+
+#endif
+
+    MapResult map_rsbf(std::string_view path) noexcept
+    {
+        auto maybe_file = map_file(path);
+        if (const auto* ec = std::get_if<ReadingErrorCode>(&maybe_file); ec)
+            return *ec;
+        auto& file = std::get<MappedFile>(maybe_file);
+
+        const auto maybe_view = view_rsbf(file.bytes());
+        if (const auto* ec = std::get_if<ReadingErrorCode>(&maybe_view); ec)
+            return *ec;
+        return MappedRSBF{std::move(file), std::get<VM::VMDataView>(maybe_view)};
+    }
+
+    BundleResult read_bundle(std::string_view path) noexcept
+    {
+        auto maybe_file = map_file(path);
+        if (const auto* ec = std::get_if<ReadingErrorCode>(&maybe_file); ec)
+            return *ec;
+        auto& file = std::get<MappedFile>(maybe_file);
+
+        const auto maybe_view = view_bundle(file.bytes());
+        if (const auto* ec = std::get_if<ReadingErrorCode>(&maybe_view); ec)
+            return *ec;
+        return MappedBundle{std::move(file), std::get<BundleView>(maybe_view)};
+    }
+
+} //namespace RaychelScript::Assembly
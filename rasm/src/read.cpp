@@ -27,13 +27,16 @@
 */
 
 #include "rasm/read.h"
+#include "rasm/lazy.h"
 
 #include <algorithm>
 #include <array>
 #include <bit>
 #include <concepts>
 #include <cstring>
+#include <limits>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -75,34 +78,6 @@ namespace RaychelScript::Assembly {
             return obj;
         }
 
-        template <>
-        std::optional<Instruction> read<Instruction>(std::istream& stream) noexcept
-        {
-            TRY_READ(std::uint32_t, data, std::nullopt)
-
-            return Instruction::from_binary(data);
-        }
-
-        template <typename T>
-        std::optional<std::vector<T>> read_vector(std::istream& stream) noexcept
-        {
-            TRY_READ(std::uint32_t, vector_size, std::nullopt)
-
-            std::vector<T> obj{};
-            obj.reserve(vector_size);
-
-            for (std::uint32_t i = 0; i < vector_size; i++) {
-                TRY_READ(T, elem, std::nullopt)
-                obj.emplace_back(std::move(elem));
-            }
-
-            return obj;
-        }
-
-    } // namespace details
-
-    namespace V6 {
-
         std::optional<std::vector<double>> read_immediate_section(std::istream& stream) noexcept
         {
             TRY_READ(std::uint32_t, immediates_size, std::nullopt);
@@ -118,48 +93,257 @@ namespace RaychelScript::Assembly {
             return vec;
         }
 
-        std::optional<std::vector<VM::CallFrameDescriptor>> read_scope_data(std::istream& stream) noexcept
+        //Bit 0 of the flags word of a function index entry, set if the function can be memoised
+        constexpr std::uint32_t pure_frame_flag = 1U;
+
+        struct FunctionIndexEntry
+        {
+            std::uint32_t size{};
+            std::uint32_t number_of_instructions{};
+            std::uint64_t offset{};
+            std::uint32_t num_arguments{};
+            bool is_pure{};
+        };
+
+        template <typename Format>
+        std::optional<std::vector<FunctionIndexEntry>> read_function_index(std::istream& stream) noexcept
         {
-            TRY_READ(std::uint32_t, scopes_size, std::nullopt);
+            TRY_READ(std::uint32_t, number_of_call_frames, std::nullopt)
+
+            std::vector<FunctionIndexEntry> index{};
+            for (std::uint32_t i{}; i != number_of_call_frames; ++i) {
+                TRY_READ(std::uint32_t, size, std::nullopt)
+                TRY_READ(std::uint32_t, number_of_instructions, std::nullopt)
+                TRY_READ(std::uint64_t, offset, std::nullopt)
+                auto& entry = index.emplace_back(FunctionIndexEntry{size, number_of_instructions, offset});
+
+                if constexpr (Format::has_frame_signature) {
+                    TRY_READ(std::uint32_t, num_arguments, std::nullopt)
+                    TRY_READ(std::uint32_t, flags, std::nullopt)
+                    entry.num_arguments = num_arguments;
+                    entry.is_pure = (flags & pure_frame_flag) != 0U;
+                }
+            }
 
-            std::vector<VM::CallFrameDescriptor> call_frames{};
+            return index;
+        }
 
-            for (std::uint32_t i{}; i != scopes_size; ++i) {
-                TRY_READ(std::uint8_t, frame_size, std::nullopt);
-                if (auto maybe_instructions = details::read_vector<Instruction>(stream); maybe_instructions.has_value()) {
-                    call_frames.emplace_back(
-                        VM::CallFrameDescriptor{.size = frame_size, .instructions = std::move(maybe_instructions).value()});
-                } else
-                    return std::nullopt;
+        //Calls on_frame(entry) for every call frame in the file, followed by on_instruction(instruction) for each of its
+        //instructions. Files without a function index only fill in the size and number of instructions of the entry
+        template <typename Format, typename FrameCallback, typename InstructionCallback>
+        bool read_call_frames(std::istream& stream, FrameCallback&& on_frame, InstructionCallback&& on_instruction) noexcept
+        {
+            const auto read_instructions = [&](std::uint32_t number_of_instructions) {
+                std::uint64_t byte_size{};
+                for (std::uint32_t i{}; i != number_of_instructions; ++i) {
+                    auto maybe_instruction = Format::read_instruction(stream);
+                    if (!maybe_instruction.has_value())
+                        return std::optional<std::uint64_t>{};
+                    byte_size += Format::encoded_size(maybe_instruction.value());
+                    on_instruction(maybe_instruction.value());
+                }
+                return std::optional{byte_size};
+            };
+
+            if constexpr (Format::has_function_index) {
+                const auto maybe_index = read_function_index<Format>(stream);
+                if (!maybe_index.has_value())
+                    return false;
+
+                //The code of all call frames follows the index back to back, so it can be read without seeking
+                std::uint64_t offset{};
+                for (const auto& entry : maybe_index.value()) {
+                    if (entry.offset != offset)
+                        return false;
+                    on_frame(entry);
+
+                    const auto byte_size = read_instructions(entry.number_of_instructions);
+                    if (!byte_size.has_value())
+                        return false;
+                    offset += byte_size.value();
+                }
+            } else {
+                TRY_READ(std::uint32_t, number_of_call_frames, false)
+                for (std::uint32_t i{}; i != number_of_call_frames; ++i) {
+                    TRY_READ(typename Format::SizeType, frame_size, false)
+                    TRY_READ(std::uint32_t, number_of_instructions, false)
+                    on_frame(FunctionIndexEntry{.size = frame_size, .number_of_instructions = number_of_instructions});
+
+                    if (!read_instructions(number_of_instructions).has_value())
+                        return false;
+                }
             }
 
-            return call_frames;
+            return true;
         }
 
+        template <typename Format>
         ReadResult do_read(std::istream& stream) noexcept
         {
-            TRY_READ(std::uint8_t, num_input_constants, ReadingErrorCode::reading_failure);
-            TRY_READ(std::uint8_t, num_output_variables, ReadingErrorCode::reading_failure);
+            VM::VMData data{};
+
+            TRY_READ(typename Format::SizeType, num_input_constants, ReadingErrorCode::reading_failure);
+            TRY_READ(typename Format::SizeType, num_output_variables, ReadingErrorCode::reading_failure);
+            data.num_input_identifiers = num_input_constants;
+            data.num_output_identifiers = num_output_variables;
 
             auto maybe_immediates = read_immediate_section(stream);
             if (!maybe_immediates.has_value())
                 return ReadingErrorCode::reading_failure;
+            data.immediate_values = std::move(maybe_immediates).value();
+
+            const auto read_ok = read_call_frames<Format>(
+                stream,
+                [&data](const FunctionIndexEntry& entry) {
+                    auto& frame = data.call_frames.emplace_back(VM::CallFrameDescriptor{
+                        .size = entry.size, .num_arguments = entry.num_arguments, .is_pure = entry.is_pure});
+                    frame.instructions.reserve(entry.number_of_instructions);
+                },
+                [&data](const Instruction& instruction) { data.call_frames.back().instructions.emplace_back(instruction); });
+            if (!read_ok)
+                return ReadingErrorCode::reading_failure;
+
+            return data;
+        }
 
-            auto maybe_scopes = read_scope_data(stream);
-            if (!maybe_scopes.has_value())
+        template <typename Format>
+        LinkedReadResult do_read_linked(std::istream& stream) noexcept
+        {
+            VM::LinkedVMData data{};
+
+            TRY_READ(typename Format::SizeType, num_input_constants, ReadingErrorCode::reading_failure);
+            TRY_READ(typename Format::SizeType, num_output_variables, ReadingErrorCode::reading_failure);
+            data.num_input_identifiers = num_input_constants;
+            data.num_output_identifiers = num_output_variables;
+
+            auto maybe_immediates = read_immediate_section(stream);
+            if (!maybe_immediates.has_value())
+                return ReadingErrorCode::reading_failure;
+            data.immediate_values = std::move(maybe_immediates).value();
+
+            //Read the instructions straight into the code segment instead of going through per-frame vectors
+            const auto read_ok = read_call_frames<Format>(
+                stream,
+                [&data](const FunctionIndexEntry& entry) {
+                    VM::link_call_frame(data, entry.size, nullptr, nullptr);
+                    data.call_frames.back().number_of_instructions = entry.number_of_instructions;
+                },
+                [&data](const Instruction& instruction) { data.code.emplace_back(instruction); });
+            if (!read_ok)
                 return ReadingErrorCode::reading_failure;
 
-            return VM::VMData{
-                .num_input_identifiers = num_input_constants,
-                .num_output_identifiers = num_output_variables,
-                .immediate_values = std::move(maybe_immediates).value(),
-                .call_frames = std::move(maybe_scopes).value(),
-            };
+            return data;
         }
 
+    } // namespace details
+
+    namespace V6 {
+
+        //I/O counts and frame sizes are single bytes. Instructions are packed into one word with two 12-bit indices and
+        //(since version 7) an extension word holding the third index of instructions that have one
+        struct Format
+        {
+            using SizeType = std::uint8_t;
+            static constexpr bool has_function_index = false;
+            static constexpr bool has_frame_signature = false;
+
+            static std::uint64_t encoded_size(const Instruction& instruction) noexcept
+            {
+                return number_of_arguments(instruction.op_code()) > 2 ? 2U * sizeof(std::uint32_t) : sizeof(std::uint32_t);
+            }
+
+            static std::optional<MemoryIndex> decode_index(std::uint32_t data) noexcept
+            {
+                const auto maybe_index = MemoryIndex::from_binary(data & 0xFFFU);
+                if (!maybe_index.has_value() || maybe_index->type() != MemoryIndex::ValueType::jump_offset)
+                    return maybe_index;
+                //jump offsets were 8-bit two's complement
+                return make_memory_index(static_cast<std::int8_t>(maybe_index->value()), MemoryIndex::ValueType::jump_offset);
+            }
+
+            static std::optional<Instruction> read_instruction(std::istream& stream) noexcept
+            {
+                TRY_READ(std::uint32_t, data, std::nullopt)
+
+                const auto code = static_cast<OpCode>((data >> 24U) & 0xFFU);
+                if (code >= OpCode::num_op_codes)
+                    return std::nullopt;
+
+                std::uint32_t extension{};
+                if (number_of_arguments(code) > 2) {
+                    TRY_READ(std::uint32_t, extension_word, std::nullopt)
+                    extension = extension_word;
+                }
+
+                const auto index1 = decode_index(data >> 12U);
+                const auto index2 = decode_index(data);
+                const auto index3 = decode_index(extension);
+                if (!index1.has_value() || !index2.has_value() || !index3.has_value())
+                    return std::nullopt;
+
+                return Instruction{code, index1.value(), index2.value(), index3.value()};
+            }
+        };
+
     } // namespace V6
 
-    ReadResult read_rsbf(std::istream& stream) noexcept
+    namespace V8 {
+
+        //I/O counts and frame sizes are 32-bit. Every instruction is an op code word followed by one word per index
+        struct Format
+        {
+            using SizeType = std::uint32_t;
+            static constexpr bool has_function_index = false;
+            static constexpr bool has_frame_signature = false;
+
+            static std::uint64_t encoded_size(const Instruction& instruction) noexcept
+            {
+                return (1U + number_of_arguments(instruction.op_code())) * sizeof(std::uint32_t);
+            }
+
+            static std::optional<Instruction> read_instruction(std::istream& stream) noexcept
+            {
+                TRY_READ(std::uint32_t, data, std::nullopt)
+
+                const auto maybe_code = Instruction::op_code_from_binary(data);
+                if (!maybe_code.has_value())
+                    return std::nullopt;
+
+                std::array<std::uint32_t, 3> indices{};
+                const auto number_of_indices = number_of_arguments(maybe_code.value());
+                for (std::size_t i{}; i != number_of_indices; ++i) {
+                    TRY_READ(std::uint32_t, index, std::nullopt)
+                    indices.at(i) = index;
+                }
+
+                return Instruction::from_binary(maybe_code.value(), std::span{indices.data(), number_of_indices});
+            }
+        };
+
+    } // namespace V8
+
+    namespace V9 {
+
+        //Same encoding as version 8, but the call frames are preceded by a function index holding the offset of each one
+        struct Format : V8::Format
+        {
+            static constexpr bool has_function_index = true;
+        };
+
+    } // namespace V9
+
+    namespace V10 {
+
+        //Same encoding as version 9, but every function index entry also holds the number of arguments of the function and
+        //whether it can be memoised
+        struct Format : V9::Format
+        {
+            static constexpr bool has_frame_signature = true;
+        };
+
+    } // namespace V10
+
+    static ReadingErrorCode read_preamble(std::istream& stream, std::uint32_t& version) noexcept
     {
         if (!stream)
             return ReadingErrorCode::file_not_found;
@@ -168,7 +352,8 @@ namespace RaychelScript::Assembly {
         if (magic != magic_word)
             return ReadingErrorCode::no_magic_word;
 
-        TRY_READ(std::uint32_t, version, ReadingErrorCode::reading_failure)
+        TRY_READ(std::uint32_t, file_version, ReadingErrorCode::reading_failure)
+        version = file_version;
         if (version > version_number())
             return ReadingErrorCode::wrong_version;
 
@@ -181,9 +366,145 @@ namespace RaychelScript::Assembly {
         if (version != version_number())
             Logger::warn("Mismatched versions between reading library and written file. Please consider regenerating the file\n");
 
-        if (version == 6)
-            return V6::do_read(stream);
+        return ReadingErrorCode::ok;
+    }
+
+    ReadResult read_rsbf(std::istream& stream) noexcept
+    {
+        std::uint32_t version{};
+        if (const auto ec = read_preamble(stream, version); ec != ReadingErrorCode::ok)
+            return ec;
+
+        //Version 7 only added the extension word for instructions with three arguments, which cannot appear in older files
+        if (version == 6 || version == 7)
+            return details::do_read<V6::Format>(stream);
+        if (version == 8)
+            return details::do_read<V8::Format>(stream);
+        if (version == 9)
+            return details::do_read<V9::Format>(stream);
+        if (version == 10)
+            return details::do_read<V10::Format>(stream);
+        return ReadingErrorCode::wrong_version;
+    }
+
+    LinkedReadResult read_linked_rsbf(std::istream& stream) noexcept
+    {
+        std::uint32_t version{};
+        if (const auto ec = read_preamble(stream, version); ec != ReadingErrorCode::ok)
+            return ec;
+
+        if (version == 6 || version == 7)
+            return details::do_read_linked<V6::Format>(stream);
+        if (version == 8)
+            return details::do_read_linked<V8::Format>(stream);
+        if (version == 9)
+            return details::do_read_linked<V9::Format>(stream);
+        if (version == 10)
+            return details::do_read_linked<V10::Format>(stream);
         return ReadingErrorCode::wrong_version;
     }
 
+    LazyReadResult open_lazy_rsbf(std::unique_ptr<std::istream> file_stream) noexcept
+    {
+        if (!file_stream)
+            return ReadingErrorCode::file_not_found;
+        auto& stream = *file_stream;
+
+        std::uint32_t version{};
+        if (const auto ec = read_preamble(stream, version); ec != ReadingErrorCode::ok)
+            return ec;
+
+        LazyRSBF file{};
+
+        //Older files have no function index, so there is nothing to be gained from reading them lazily
+        if (version == 6 || version == 7 || version == 8) {
+            auto result = version == 8 ? details::do_read<V8::Format>(stream) : details::do_read<V6::Format>(stream);
+            if (const auto* ec = std::get_if<ReadingErrorCode>(&result); ec)
+                return *ec;
+
+            file.data_ = std::get<VM::VMData>(std::move(result));
+            file.loaded_.assign(file.data_.call_frames.size(), true);
+            return file;
+        }
+        if (version != 9 && version != 10)
+            return ReadingErrorCode::wrong_version;
+
+        TRY_READ(V9::Format::SizeType, num_input_constants, ReadingErrorCode::reading_failure)
+        TRY_READ(V9::Format::SizeType, num_output_variables, ReadingErrorCode::reading_failure)
+        file.data_.num_input_identifiers = num_input_constants;
+        file.data_.num_output_identifiers = num_output_variables;
+
+        auto maybe_immediates = details::read_immediate_section(stream);
+        if (!maybe_immediates.has_value())
+            return ReadingErrorCode::reading_failure;
+        file.data_.immediate_values = std::move(maybe_immediates).value();
+
+        const auto maybe_index = version == 9 ? details::read_function_index<V9::Format>(stream)
+                                              : details::read_function_index<V10::Format>(stream);
+        if (!maybe_index.has_value())
+            return ReadingErrorCode::reading_failure;
+
+        file.code_begin_ = stream.tellg();
+        if (file.code_begin_ < 0)
+            return ReadingErrorCode::reading_failure;
+
+        for (const auto& entry : maybe_index.value()) {
+            file.data_.call_frames.emplace_back(
+                VM::CallFrameDescriptor{.size = entry.size, .num_arguments = entry.num_arguments, .is_pure = entry.is_pure});
+            file.locations_.emplace_back(LazyRSBF::FrameLocation{entry.offset, entry.number_of_instructions});
+        }
+        file.loaded_.assign(file.data_.call_frames.size(), false);
+        file.stream_ = std::move(file_stream);
+
+        return file;
+    }
+
+    bool LazyRSBF::load_call_frame(std::uint32_t index) noexcept
+    {
+        if (index >= loaded_.size())
+            return false;
+        if (loaded_[index])
+            return true;
+
+        const auto& location = locations_[index];
+        if (location.offset > static_cast<std::uint64_t>(std::numeric_limits<std::streamoff>::max() - code_begin_))
+            return false;
+
+        stream_->clear();
+        if (!stream_->seekg(code_begin_ + static_cast<std::streamoff>(location.offset)))
+            return false;
+
+        std::vector<Instruction> instructions{};
+        for (std::uint32_t i{}; i != location.number_of_instructions; ++i) {
+            auto maybe_instruction = V9::Format::read_instruction(*stream_);
+            if (!maybe_instruction.has_value())
+                return false;
+            instructions.emplace_back(maybe_instruction.value());
+        }
+
+        data_.call_frames[index].instructions = std::move(instructions);
+        loaded_[index] = true;
+        return true;
+    }
+
+    VM::LazyVMData LazyRSBF::data() noexcept
+    {
+        const auto load = [](void* context, std::uint32_t index) noexcept -> const Instruction* {
+            auto& self = *static_cast<LazyRSBF*>(context);
+            if (!self.load_call_frame(index))
+                return nullptr;
+
+            const auto& instructions = self.data_.call_frames[index].instructions;
+            return instructions.empty() ? nullptr : instructions.data();
+        };
+
+        return VM::LazyVMData{
+            .num_input_identifiers = data_.num_input_identifiers,
+            .num_output_identifiers = data_.num_output_identifiers,
+            .immediate_values = data_.immediate_values,
+            .call_frames = data_.call_frames,
+            .loader = VM::FrameLoader{.context = this, .load = load},
+        };
+    }
+
 } //namespace RaychelScript::Assembly
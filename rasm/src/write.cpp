@@ -27,6 +27,8 @@
 */
 
 #include "rasm/write.h"
+#include "rasm/bundle.h"
+#include "rasm/map.h"
 
 #include <algorithm>
 #include <array>
@@ -35,6 +37,9 @@
 #include <cstring>
 #include <limits>
 #include <ranges>
+#include <span>
+#include <unordered_map>
+#include <vector>
 
 #include "RaychelCore/Raychel_assert.h"
 
@@ -66,18 +71,18 @@ namespace RaychelScript::Assembly {
 
     bool write(std::ostream& stream, const Assembly::Instruction& instruction) noexcept
     {
-        return write(stream, instruction.to_binary());
+        TRY(write(stream, instruction.to_binary()))
+
+        const std::array indices{instruction.index1(), instruction.index2(), instruction.index3()};
+        for (std::size_t i{}; i != number_of_arguments(instruction.op_code()); ++i) {
+            TRY(write(stream, indices.at(i).to_binary()))
+        }
+        return true;
     }
 
     template <typename T>
     bool write(std::ostream& stream, const std::vector<T>& vec) noexcept;
 
-    bool write(std::ostream& stream, const VM::CallFrameDescriptor& frame) noexcept
-    {
-        TRY(write(stream, frame.size));
-        return write(stream, frame.instructions);
-    }
-
     template <typename T>
     bool write(std::ostream& stream, const std::vector<T>& vec) noexcept
     {
@@ -91,7 +96,8 @@ namespace RaychelScript::Assembly {
         return true;
     }
 
-    [[nodiscard]] bool write_rsbf(std::ostream& stream, const VM::VMData& data) noexcept
+    template <typename Data>
+    bool write_header(std::ostream& stream, const Data& data) noexcept
     {
         if (!stream) {
             return false;
@@ -106,10 +112,248 @@ namespace RaychelScript::Assembly {
         TRY(write(stream, data.num_output_identifiers));
 
         //Immediate section
-        TRY(write(stream, data.immediate_values));
+        return write(stream, data.immediate_values);
+    }
+
+    std::uint64_t encoded_size(const Instruction& instruction) noexcept
+    {
+        return (1U + number_of_arguments(instruction.op_code())) * sizeof(std::uint32_t);
+    }
+
+    //Bit 0 of the flags word of a function index entry, set if the function can be memoised
+    constexpr std::uint32_t pure_frame_flag = 1U;
+
+    //Writes the function index followed by the code of every call frame. instructions_of(frame) returns the code of a frame.
+    //Linked call frames carry no arity or purity, so their functions are never memoised after reading them back
+    template <typename Frames, typename GetInstructions>
+    bool write_call_frames(std::ostream& stream, const Frames& frames, GetInstructions&& instructions_of) noexcept
+    {
+        constexpr auto max_count = std::numeric_limits<std::uint32_t>::max();
+        if (!std::cmp_less_equal(frames.size(), max_count))
+            return false;
+
+        TRY(write(stream, static_cast<std::uint32_t>(frames.size())))
+
+        //Offsets are counted from the end of the index, so a reader can seek straight to the code of any call frame
+        std::uint64_t offset{};
+        for (const auto& frame : frames) {
+            const std::span<const Instruction> instructions = instructions_of(frame);
+            if (!std::cmp_less_equal(instructions.size(), max_count))
+                return false;
+
+            TRY(write(stream, frame.size))
+            TRY(write(stream, static_cast<std::uint32_t>(instructions.size())))
+            TRY(write(stream, offset))
+            if constexpr (requires { frame.is_pure; }) {
+                TRY(write(stream, frame.num_arguments))
+                TRY(write(stream, frame.is_pure ? pure_frame_flag : 0U))
+            } else {
+                TRY(write(stream, std::uint32_t{}))
+                TRY(write(stream, std::uint32_t{}))
+            }
+            for (const auto& instruction : instructions) {
+                offset += encoded_size(instruction);
+            }
+        }
+
+        for (const auto& frame : frames) {
+            for (const auto& instruction : instructions_of(frame)) {
+                TRY(write(stream, instruction))
+            }
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool write_rsbf(std::ostream& stream, const VM::VMData& data) noexcept
+    {
+        TRY(write_header(stream, data))
 
         //Scope section
-        TRY(write(stream, data.call_frames));
+        return write_call_frames(
+            stream, data.call_frames, [](const VM::CallFrameDescriptor& frame) { return std::span{frame.instructions}; });
+    }
+
+    [[nodiscard]] bool write_rsbf(std::ostream& stream, const VM::LinkedVMData& data) noexcept
+    {
+        TRY(write_header(stream, data))
+
+        //Scope section. The padding between frames is not written, so the file layout is the same as for unlinked data
+        return write_call_frames(stream, data.call_frames, [&data](const VM::LinkedCallFrameDescriptor& frame) {
+            return std::span{data.code}.subspan(frame.entry_point, frame.number_of_instructions);
+        });
+    }
+
+    namespace {
+
+        std::uint64_t align_up(std::uint64_t offset) noexcept
+        {
+            return (offset + VM::code_alignment - 1U) / VM::code_alignment * VM::code_alignment;
+        }
+
+        template <typename T, std::size_t Extent>
+        bool write_raw(std::ostream& stream, std::span<T, Extent> data) noexcept
+        {
+            //NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size_bytes()));
+            return stream.good();
+        }
+
+        bool write_padding(std::ostream& stream, std::uint64_t& position, std::uint64_t offset) noexcept
+        {
+            constexpr std::array<char, VM::code_alignment> zeros{};
+            RAYCHEL_ASSERT(offset >= position && offset - position <= zeros.size());
+
+            stream.write(zeros.data(), static_cast<std::streamsize>(offset - position));
+            position = offset;
+            return stream.good();
+        }
+
+    } // namespace
+
+    [[nodiscard]] bool write_mapped_rsbf(std::ostream& stream, const VM::LinkedVMData& data) noexcept
+    {
+        if (!stream)
+            return false;
+
+        constexpr auto max_count = std::numeric_limits<std::uint32_t>::max();
+        if (data.immediate_values.size() > max_count || data.call_frames.size() > max_count || data.code.size() > max_count)
+            return false;
+
+        using enum Mapped::SectionKind;
+        std::array sections{
+            Mapped::Section{.kind = immediates, .count = static_cast<std::uint32_t>(data.immediate_values.size())},
+            Mapped::Section{.kind = call_frames, .count = static_cast<std::uint32_t>(data.call_frames.size())},
+            Mapped::Section{.kind = code, .count = static_cast<std::uint32_t>(data.code.size())},
+        };
+        const std::array element_sizes{sizeof(double), sizeof(VM::LinkedCallFrameDescriptor), sizeof(Instruction)};
+
+        //Every section starts on its own cache line
+        auto offset = align_up(sizeof(Mapped::Header) + sizeof(sections));
+        for (std::size_t i{}; i != sections.size(); ++i) {
+            sections.at(i).offset = offset;
+            offset = align_up(offset + sections.at(i).count * element_sizes.at(i));
+        }
+
+        const std::array header{Mapped::Header{
+            .version = version_number(),
+            .num_input_identifiers = data.num_input_identifiers,
+            .num_output_identifiers = data.num_output_identifiers,
+            .number_of_sections = static_cast<std::uint32_t>(sections.size()),
+        }};
+
+        TRY(write_raw(stream, std::span{header}))
+        TRY(write_raw(stream, std::span{sections}))
+        std::uint64_t position = sizeof(header) + sizeof(sections);
+
+        TRY(write_padding(stream, position, sections[0].offset))
+        TRY(write_raw(stream, std::span{data.immediate_values}))
+        position += data.immediate_values.size() * sizeof(double);
+
+        TRY(write_padding(stream, position, sections[1].offset))
+        TRY(write_raw(stream, std::span{data.call_frames}))
+        position += data.call_frames.size() * sizeof(VM::LinkedCallFrameDescriptor);
+
+        TRY(write_padding(stream, position, sections[2].offset))
+        return write_raw(stream, std::span{data.code});
+    }
+
+    [[nodiscard]] bool write_bundle(std::ostream& stream, const BundleContents& scripts) noexcept
+    {
+        if (!stream)
+            return false;
+
+        constexpr auto max_count = std::numeric_limits<std::uint32_t>::max();
+        if (scripts.size() > max_count)
+            return false;
+
+        //Immediates are pooled by their bit pattern, so 0.0 and -0.0 (or NaNs with different payloads) are kept apart
+        std::vector<double> pool{};
+        std::unordered_map<std::uint64_t, std::uint32_t> pool_indices{};
+        const auto pool_index = [&](MemoryIndex& index, const VM::VMData& data) {
+            if (index.type() != MemoryIndex::ValueType::immediate)
+                return true;
+            if (index.value() >= data.immediate_values.size() || pool.size() > MemoryIndex::max_value)
+                return false;
+
+            const auto value = data.immediate_values[index.value()];
+            const auto [it, inserted] =
+                pool_indices.try_emplace(std::bit_cast<std::uint64_t>(value), static_cast<std::uint32_t>(pool.size()));
+            if (inserted)
+                pool.emplace_back(value);
+            index = make_memory_index(it->second, MemoryIndex::ValueType::immediate);
+            return true;
+        };
+
+        std::vector<VM::LinkedVMData> linked_scripts{};
+        std::vector<Bundle::Script> entries{};
+        std::uint64_t names_size{};
+        for (const auto& [name, data] : scripts) {
+            auto& linked = linked_scripts.emplace_back(VM::link(data));
+            if (name.size() > max_count || linked.call_frames.size() > max_count || linked.code.size() > max_count)
+                return false;
+
+            for (auto& instruction : linked.code) {
+                //The argument of jsr is a call frame index, not an immediate value
+                if (instruction.op_code() == OpCode::jsr)
+                    continue;
+                TRY(pool_index(instruction.index1(), data))
+                TRY(pool_index(instruction.index2(), data))
+                TRY(pool_index(instruction.index3(), data))
+            }
+
+            entries.emplace_back(Bundle::Script{
+                .name_offset = names_size,
+                .name_size = static_cast<std::uint32_t>(name.size()),
+                .num_input_identifiers = data.num_input_identifiers,
+                .num_output_identifiers = data.num_output_identifiers,
+                .number_of_call_frames = static_cast<std::uint32_t>(linked.call_frames.size()),
+                .number_of_instructions = static_cast<std::uint32_t>(linked.code.size()),
+            });
+            names_size += name.size();
+        }
+
+        //The pool and the call frames and code of every script start on their own cache line
+        const auto names_offset = sizeof(Bundle::Header) + entries.size() * sizeof(Bundle::Script);
+        const auto immediates_offset = align_up(names_offset + names_size);
+        auto offset = align_up(immediates_offset + pool.size() * sizeof(double));
+        for (auto& entry : entries) {
+            entry.call_frames_offset = offset;
+            offset = align_up(offset + entry.number_of_call_frames * sizeof(VM::LinkedCallFrameDescriptor));
+            entry.code_offset = offset;
+            offset = align_up(offset + entry.number_of_instructions * sizeof(Instruction));
+        }
+
+        const std::array header{Bundle::Header{
+            .version = version_number(),
+            .number_of_scripts = static_cast<std::uint32_t>(entries.size()),
+            .number_of_immediates = static_cast<std::uint32_t>(pool.size()),
+            .immediates_offset = immediates_offset,
+            .names_offset = names_offset,
+            .names_size = names_size,
+        }};
+
+        TRY(write_raw(stream, std::span{header}))
+        TRY(write_raw(stream, std::span{entries}))
+        for (const auto& [name, _] : scripts) {
+            TRY(write_raw(stream, std::span{name}))
+        }
+        std::uint64_t position = names_offset + names_size;
+
+        TRY(write_padding(stream, position, immediates_offset))
+        TRY(write_raw(stream, std::span{pool}))
+        position += pool.size() * sizeof(double);
+
+        for (std::size_t i{}; i != entries.size(); ++i) {
+            const auto& linked = linked_scripts[i];
+
+            TRY(write_padding(stream, position, entries[i].call_frames_offset))
+            TRY(write_raw(stream, std::span{linked.call_frames}))
+            position += linked.call_frames.size() * sizeof(VM::LinkedCallFrameDescriptor);
+
+            TRY(write_padding(stream, position, entries[i].code_offset))
+            TRY(write_raw(stream, std::span{linked.code}))
+            position += linked.code.size() * sizeof(Instruction);
+        }
         return true;
     }
 
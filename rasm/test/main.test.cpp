@@ -27,11 +27,21 @@
 */
 
 #include "rasm/WritePipe.h"
+#include "rasm/bundle.h"
+#include "rasm/cache.h"
+#include "rasm/lazy.h"
+#include "rasm/map.h"
 #include "rasm/read.h"
 #include "rasm/write.h"
 #include "shared/rasm/Instruction.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
 #include <iostream>
+#include <span>
 #include <vector>
 
 #include "RaychelCore/AssertingGet.h"
@@ -48,9 +58,12 @@ int main()
     Instruction div{OpCode::div, 0_mi, 2_imm};
     Instruction mag{OpCode::mag, 0_mi};
     Instruction fac{OpCode::fac, 0_mi};
+    Instruction mad{OpCode::mad, 1_mi, 2_imm, 3_mi};
+    Instruction wide{OpCode::mov, 70'000_imm, 4'000_mi};
+    Instruction jmp{OpCode::jmp, make_memory_index(-1'000, MemoryIndex::ValueType::jump_offset)};
 
     const std::vector<Instruction> instructions{
-        mov, add, div, Instruction{OpCode::mov, 0_imm, 12_mi}, sub, add, mov, Instruction{OpCode::hlt}};
+        mov, add, div, Instruction{OpCode::mov, 0_imm, 12_mi}, sub, mad, add, mov, wide, jmp, Instruction{OpCode::hlt}};
 
     if (!write_rsbf(
             "./instr.rsbf",
@@ -61,7 +74,10 @@ int main()
                 .call_frames = {
                     CallFrameDescriptor{.size = 16U, .instructions = instructions},
                     CallFrameDescriptor{
-                        .size = 1U, .instructions = {Instruction{OpCode::mov, 3_imm, 0_mi}, Instruction{OpCode::ret}}}}})) {
+                        .size = 1U,
+                        .instructions = {Instruction{OpCode::mov, 3_imm, 0_mi}, Instruction{OpCode::ret}},
+                        .num_arguments = 2U,
+                        .is_pure = true}}})) {
         Logger::error("Writing failed!\n");
         return 1;
     }
@@ -98,5 +114,126 @@ int main()
         }
     }
 
+    //Functions read back from a file have to be memoised like freshly assembled ones
+    if (data.call_frames[0].is_pure || !data.call_frames[1].is_pure || data.call_frames[1].num_arguments != 2U) {
+        Logger::error("The arity and purity of the call frames were not read back!\n");
+        return 1;
+    }
+
+    if (!write_mapped_rsbf("./instr.rsbm", data)) {
+        Logger::error("Writing mapped file failed!\n");
+        return 1;
+    }
+
+    const auto mapped_or_error = map_rsbf("./instr.rsbm");
+    if (const auto* ec = std::get_if<ReadingErrorCode>(&mapped_or_error); ec) {
+        Logger::error("Mapping failed: ", *ec, '\n');
+        return 1;
+    }
+
+    const auto& view = Raychel::get<MappedRSBF>(mapped_or_error).view();
+    Logger::info("Mapped file with ", view.call_frames.size(), " call frames and ", view.code.size(), " instructions\n");
+
+    //Instructions are written as they are in memory, so the bytes between the op code and the first index must be zero
+    const auto has_zero_padding = [](std::span<const Instruction> code) {
+        return std::ranges::all_of(code, [](const Instruction& instruction) {
+            const auto bytes = std::bit_cast<std::array<std::uint8_t, sizeof(Instruction)>>(instruction);
+            return bytes[1] == 0U && bytes[2] == 0U && bytes[3] == 0U;
+        });
+    };
+    if (!has_zero_padding(view.code)) {
+        Logger::error("Mapped file contains non-zero instruction padding!\n");
+        return 1;
+    }
+
+    auto lazy_or_error = open_lazy_rsbf("./instr.rsbf");
+    if (const auto* ec = std::get_if<ReadingErrorCode>(&lazy_or_error); ec) {
+        Logger::error("Opening lazily failed: ", *ec, '\n');
+        return 1;
+    }
+
+    auto& lazy = Raychel::get<LazyRSBF>(lazy_or_error);
+    if (lazy.is_loaded(1U) || !lazy.load_call_frame(1U) || lazy.data().call_frames[1].instructions.size() != 2U ||
+        !lazy.data().call_frames[1].is_pure) {
+        Logger::error("Lazily loading call frame #1 failed!\n");
+        return 1;
+    }
+    Logger::info("Lazily loaded call frame #1 of ", lazy.number_of_call_frames(), '\n');
+
+    //Both scripts use 12, which only ends up in the bundle once
+    const auto make_script = [](std::vector<double> immediates) {
+        return VMData{
+            .num_input_identifiers = 1U,
+            .num_output_identifiers = 1U,
+            .immediate_values = std::move(immediates),
+            .call_frames = {CallFrameDescriptor{
+                .size = 3U,
+                .instructions =
+                    {Instruction{OpCode::add, 0_imm, 1_imm}, Instruction{OpCode::mov, 0_mi, 2_mi}, Instruction{OpCode::hlt}}}}};
+    };
+
+    if (!write_bundle("./instr.rsbb", BundleContents{{"first", make_script({0.1, 12})}, {"second", make_script({12, 99})}})) {
+        Logger::error("Writing bundle failed!\n");
+        return 1;
+    }
+
+    const auto bundle_or_error = read_bundle("./instr.rsbb");
+    if (const auto* ec = std::get_if<ReadingErrorCode>(&bundle_or_error); ec) {
+        Logger::error("Reading bundle failed: ", *ec, '\n');
+        return 1;
+    }
+
+    const auto& bundle = Raychel::get<MappedBundle>(bundle_or_error).view();
+    for (std::size_t script_index{}; script_index != bundle.size(); ++script_index) {
+        const auto bundled_view_or_error = bundle.find(bundle.name(script_index));
+        if (const auto* bundled_view = std::get_if<VMDataView>(&bundled_view_or_error);
+            bundled_view == nullptr || !has_zero_padding(bundled_view->code)) {
+            Logger::error("Script '", bundle.name(script_index), "' in the bundle contains non-zero instruction padding!\n");
+            return 1;
+        }
+    }
+
+    const auto bundled_or_error = bundle.read("second");
+    if (const auto* ec = std::get_if<ReadingErrorCode>(&bundled_or_error); ec) {
+        Logger::error("Reading script from bundle failed: ", *ec, '\n');
+        return 1;
+    }
+    Logger::info(
+        "Bundle with ",
+        bundle.size(),
+        " scripts sharing ",
+        bundle.immediate_values().size(),
+        " immediates. Script 'second' has ",
+        Raychel::get<VMData>(bundled_or_error).call_frames.size(),
+        " call frames\n");
+
+    //A cache entry is only hit for the source it was compiled from, even if another source has the same key
+    std::filesystem::remove_all("./cache");
+    constexpr std::string_view cached_source{"cached source"};
+    const auto key = cache_key(cached_source, 1U);
+    if (!write_cached_rsbf("./cache", key, cached_source, make_script({0.1, 12}))) {
+        Logger::error("Writing cache entry failed!\n");
+        return 1;
+    }
+    if (const auto cached_or_error = read_cached_rsbf("./cache", key, cached_source);
+        !std::holds_alternative<VMData>(cached_or_error)) {
+        Logger::error("Reading cache entry failed!\n");
+        return 1;
+    }
+    if (const auto colliding_or_error = read_cached_rsbf("./cache", key, "another source");
+        !std::holds_alternative<ReadingErrorCode>(colliding_or_error) ||
+        Raychel::get<ReadingErrorCode>(colliding_or_error) != ReadingErrorCode::file_not_found) {
+        Logger::error("A cache entry was hit for a different source!\n");
+        return 1;
+    }
+
+    //A plain RSBF file that happens to have the name of an entry is not one
+    std::filesystem::copy_file("./instr.rsbf", cache_path("./cache", key), std::filesystem::copy_options::overwrite_existing);
+    if (const auto foreign_or_error = read_cached_rsbf("./cache", key, cached_source);
+        !std::holds_alternative<ReadingErrorCode>(foreign_or_error)) {
+        Logger::error("A foreign file in the cache directory was hit!\n");
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,367 @@
+/**
+* \file BatchExecutor.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for BatchExecutor class
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_BATCH_EXECUTOR_H
+#define RAYCHELSCRIPT_BATCH_EXECUTOR_H
+
+#include "RaychelCore/ClassMacros.h"
+#include "RaychelCore/Raychel_assert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace RaychelScript {
+
+    /**
+    * \brief A kernel runs count invocations of a script at once
+    *
+    * Inputs and outputs are laid out as structure-of-arrays like in VM::execute_batch() and Runtime::ScriptRunner::run_batch().
+    * Scratch memory should be allocated from the arena. The returned error code means success if it compares equal to its
+    * value-initialized state, which holds for VM::VMErrorCode, Runtime::RuntimeErrorCode and Interpreter::InterpreterErrorCode.
+    *
+    * The same kernel object is called from several threads at once, so it must not modify shared state.
+    */
+    template <typename Kernel>
+    concept BatchKernel = requires(
+        const Kernel& kernel, std::span<const double> input_values, std::span<double> output_values, std::size_t count,
+        std::pmr::memory_resource* arena) {
+        {
+            kernel(input_values, output_values, count, arena)
+            } -> std::equality_comparable;
+    };
+
+    template <BatchKernel Kernel>
+    using BatchKernelResult = std::remove_cvref_t<
+        std::invoke_result_t<const Kernel&, std::span<const double>, std::span<double>, std::size_t, std::pmr::memory_resource*>>;
+
+    /**
+    * \brief Work-stealing thread pool for running a script on large input sets
+    *
+    * run() splits the invocations into chunks and hands every worker an equal share. A worker that runs out of chunks steals half
+    * of the remaining chunks of another worker. Each worker owns an arena that is reset before every chunk, so chunks do not
+    * touch the global heap unless they outgrow it.
+    */
+    class BatchExecutor
+    {
+        static constexpr std::size_t cache_line_size = 64U;
+
+        //Chunks [begin, end) a worker has not started yet, packed into one word so both ends can be updated atomically
+        using ChunkRange = std::uint64_t;
+
+        //Returns false if the run failed and the remaining chunks should be skipped
+        using ChunkFunction = bool (*)(void* context, std::size_t chunk_index, std::pmr::memory_resource* arena) noexcept;
+
+        struct alignas(cache_line_size) Worker
+        {
+            //The owner takes chunks from the front, thieves take them from the back
+            std::atomic<ChunkRange> chunks{};
+            std::unique_ptr<std::byte[]> arena_buffer; //NOLINT(*-avoid-c-arrays)
+        };
+
+        template <typename Kernel>
+        struct RunContext
+        {
+            const Kernel& kernel;
+            std::span<const double> input_values;
+            std::span<double> output_values;
+            std::size_t number_of_inputs;
+            std::size_t number_of_outputs;
+            std::size_t count;
+            std::size_t chunk_size;
+            //index of the first chunk (in invocation order) that failed so far. error belongs to it
+            std::atomic<std::size_t> first_failed_chunk{std::numeric_limits<std::size_t>::max()};
+            std::mutex error_mutex{};
+            BatchKernelResult<Kernel> error{};
+        };
+
+    public:
+        static constexpr std::size_t default_chunk_size = 1'024U;
+        static constexpr std::size_t default_arena_size = 256U * 1'024U;
+
+        /**
+        * \brief Start number_of_threads - 1 worker threads. The thread calling run() is the last worker
+        */
+        explicit BatchExecutor(
+            std::size_t number_of_threads = default_number_of_threads(), std::size_t arena_size = default_arena_size) noexcept
+            : number_of_workers_{std::max<std::size_t>(number_of_threads, 1U)},
+              arena_size_{arena_size},
+              workers_{std::make_unique<Worker[]>(number_of_workers_)} //NOLINT(*-avoid-c-arrays)
+        {
+            for (std::size_t i{}; i != number_of_workers_; ++i) {
+                workers_[i].arena_buffer = std::make_unique<std::byte[]>(arena_size_); //NOLINT(*-avoid-c-arrays)
+            }
+            threads_.reserve(number_of_workers_ - 1U);
+            for (std::size_t i{1U}; i != number_of_workers_; ++i) {
+                threads_.emplace_back([this, i] { _thread_main(i); });
+            }
+        }
+
+        RAYCHEL_MAKE_NONCOPY_NONMOVE(BatchExecutor)
+
+        [[nodiscard]] static std::size_t default_number_of_threads() noexcept
+        {
+            return std::max<std::size_t>(std::thread::hardware_concurrency(), 1U);
+        }
+
+        [[nodiscard]] std::size_t number_of_threads() const noexcept
+        {
+            return number_of_workers_;
+        }
+
+        /**
+        * \brief Run kernel for count invocations
+        *
+        * Input #i of invocation #k is read from input_values[i * count + k] and output #j is written to
+        * output_values[j * count + k]. Every chunk is handed a contiguous copy of its inputs and outputs.
+        * If a chunk fails, the chunks after it are skipped. The error of the first failing chunk in invocation order is returned,
+        * so the result is the same as running all chunks one after another.
+        * Calls from different threads are serialized.
+        */
+        template <BatchKernel Kernel>
+        [[nodiscard]] BatchKernelResult<Kernel> run(
+            const Kernel& kernel, std::span<const double> input_values, std::span<double> output_values,
+            std::size_t number_of_inputs, std::size_t number_of_outputs, std::size_t count,
+            std::size_t chunk_size = default_chunk_size) noexcept
+        {
+            RAYCHEL_ASSERT(input_values.size() == number_of_inputs * count);
+            RAYCHEL_ASSERT(output_values.size() == number_of_outputs * count);
+
+            if (count == 0U) {
+                return {};
+            }
+
+            //chunk indices have to fit into half a ChunkRange
+            constexpr std::size_t max_number_of_chunks = std::numeric_limits<std::uint32_t>::max();
+            chunk_size = std::max({chunk_size, std::size_t{1U}, (count + max_number_of_chunks - 1U) / max_number_of_chunks});
+
+            RunContext<Kernel> context{
+                .kernel = kernel,
+                .input_values = input_values,
+                .output_values = output_values,
+                .number_of_inputs = number_of_inputs,
+                .number_of_outputs = number_of_outputs,
+                .count = count,
+                .chunk_size = chunk_size,
+            };
+
+            _run((count + chunk_size - 1U) / chunk_size, &_run_chunk<Kernel>, &context);
+
+            return context.error;
+        }
+
+        ~BatchExecutor() noexcept
+        {
+            {
+                std::scoped_lock lock{mutex_};
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+    private:
+        template <typename Kernel>
+        static bool _run_chunk(void* context_ptr, std::size_t chunk_index, std::pmr::memory_resource* arena) noexcept
+        {
+            auto& context = *static_cast<RunContext<Kernel>*>(context_ptr);
+            //chunks are popped in ascending order, so every chunk this worker has left comes after a failed one as well
+            if (chunk_index > context.first_failed_chunk.load(std::memory_order::relaxed)) {
+                return false;
+            }
+
+            const auto first = chunk_index * context.chunk_size;
+            const auto size = std::min(context.chunk_size, context.count - first);
+
+            std::pmr::vector<double> input_values(context.number_of_inputs * size, arena);
+            std::pmr::vector<double> output_values(context.number_of_outputs * size, arena);
+
+            for (std::size_t i{}; i != context.number_of_inputs; ++i) {
+                const auto source = context.input_values.subspan(i * context.count + first, size);
+                std::ranges::copy(source, std::next(input_values.begin(), static_cast<std::ptrdiff_t>(i * size)));
+            }
+
+            if (const auto ec = context.kernel(input_values, output_values, size, arena); ec != BatchKernelResult<Kernel>{}) {
+                std::scoped_lock lock{context.error_mutex};
+                if (chunk_index < context.first_failed_chunk.load(std::memory_order::relaxed)) {
+                    context.first_failed_chunk.store(chunk_index, std::memory_order::relaxed);
+                    context.error = ec;
+                }
+                return false;
+            }
+
+            for (std::size_t j{}; j != context.number_of_outputs; ++j) {
+                const auto source = std::span{output_values}.subspan(j * size, size);
+                std::ranges::copy(source, context.output_values.subspan(j * context.count + first, size).begin());
+            }
+
+            return true;
+        }
+
+        static ChunkRange _pack(std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            return begin | (end << 32U);
+        }
+
+        static std::uint64_t _begin(ChunkRange range) noexcept
+        {
+            return range & std::numeric_limits<std::uint32_t>::max();
+        }
+
+        static std::uint64_t _end(ChunkRange range) noexcept
+        {
+            return range >> 32U;
+        }
+
+        void _run(std::size_t number_of_chunks, ChunkFunction function, void* context) noexcept
+        {
+            std::scoped_lock run_lock{run_mutex_};
+
+            for (std::size_t i{}; i != number_of_workers_; ++i) {
+                const auto begin = number_of_chunks * i / number_of_workers_;
+                const auto end = number_of_chunks * (i + 1U) / number_of_workers_;
+                workers_[i].chunks.store(_pack(begin, end), std::memory_order::relaxed);
+            }
+
+            {
+                std::scoped_lock lock{mutex_};
+                function_ = function;
+                context_ = context;
+                pending_threads_ = threads_.size();
+                ++generation_;
+            }
+            wake_.notify_all();
+
+            _work(0U);
+
+            std::unique_lock lock{mutex_};
+            done_.wait(lock, [this] { return pending_threads_ == 0U; });
+        }
+
+        void _thread_main(std::size_t worker_index) noexcept
+        {
+            std::uint64_t seen_generation{};
+            while (true) {
+                {
+                    std::unique_lock lock{mutex_};
+                    wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+                    if (stopping_) {
+                        return;
+                    }
+                    seen_generation = generation_;
+                }
+
+                _work(worker_index);
+
+                {
+                    std::scoped_lock lock{mutex_};
+                    if (--pending_threads_ == 0U) {
+                        done_.notify_one();
+                    }
+                }
+            }
+        }
+
+        void _work(std::size_t worker_index) noexcept
+        {
+            auto& worker = workers_[worker_index];
+
+            do {
+                while (const auto chunk_index = _pop(worker)) {
+                    std::pmr::monotonic_buffer_resource arena{
+                        worker.arena_buffer.get(), arena_size_, std::pmr::get_default_resource()};
+                    if (!function_(context_, *chunk_index, &arena)) {
+                        return;
+                    }
+                }
+            } while (_steal(worker_index));
+        }
+
+        static std::optional<std::size_t> _pop(Worker& worker) noexcept
+        {
+            auto range = worker.chunks.load(std::memory_order::acquire);
+            while (_begin(range) < _end(range)) {
+                if (worker.chunks.compare_exchange_weak(
+                        range, _pack(_begin(range) + 1U, _end(range)), std::memory_order::acq_rel, std::memory_order::acquire)) {
+                    return _begin(range);
+                }
+            }
+            return std::nullopt;
+        }
+
+        //Move half of the chunks of another worker to this one. Returns false if there was nothing left to steal
+        bool _steal(std::size_t thief_index) noexcept
+        {
+            for (std::size_t offset{1U}; offset != number_of_workers_; ++offset) {
+                auto& victim = workers_[(thief_index + offset) % number_of_workers_];
+                auto range = victim.chunks.load(std::memory_order::acquire);
+                while (_begin(range) < _end(range)) {
+                    const auto split = _end(range) - (_end(range) - _begin(range) + 1U) / 2U;
+                    if (victim.chunks.compare_exchange_weak(
+                            range, _pack(_begin(range), split), std::memory_order::acq_rel, std::memory_order::acquire)) {
+                        //our own range is empty, so thieves leave it alone
+                        workers_[thief_index].chunks.store(_pack(split, _end(range)), std::memory_order::release);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        std::size_t number_of_workers_;
+        std::size_t arena_size_;
+        std::unique_ptr<Worker[]> workers_; //NOLINT(*-avoid-c-arrays)
+        std::vector<std::thread> threads_;
+
+        std::mutex run_mutex_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::uint64_t generation_{};
+        std::size_t pending_threads_{};
+        bool stopping_{};
+        ChunkFunction function_{};
+        void* context_{};
+    };
+
+} // namespace RaychelScript
+
+#endif //!RAYCHELSCRIPT_BATCH_EXECUTOR_H
@@ -0,0 +1,270 @@
+/**
+* \file CallCache.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for CallCache class
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_CALL_CACHE_H
+#define RAYCHELSCRIPT_CALL_CACHE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace RaychelScript {
+
+    /**
+    * \brief Bounded memoisation table for calls to pure script functions
+    *
+    * Every cached function gets its own direct-mapped table with a fixed number of entries, so a colliding call simply evicts
+    * the previous one. All memory is allocated when the cache is constructed, including room for max_pending_calls nested
+    * calls that are waiting for their result. Calls nested deeper than that are made as usual but their results are not
+    * recorded. Arguments are compared bit by bit, which keeps 0.0 and -0.0 apart and lets NaN arguments hit.
+    *
+    * Entries stay valid across runs of the same script. The cache is not synchronized, so every thread needs its own.
+    */
+    class CallCache
+    {
+        struct FunctionTable
+        {
+            bool is_cached{};
+            std::uint32_t number_of_arguments{};
+            std::vector<double> keys{};
+            std::vector<double> results{};
+            std::vector<std::uint8_t> occupied{};
+            std::size_t hits{};
+            std::size_t misses{};
+        };
+
+        //A call that missed and whose result has to be inserted once it returns
+        struct PendingCall
+        {
+            std::size_t function_index{};
+            std::size_t depth{};
+            std::size_t first_argument{};
+        };
+
+    public:
+        static constexpr std::size_t default_capacity = 1'024U;
+
+        //Same as the default call stack size of the VM
+        static constexpr std::size_t default_max_pending_calls = 128U;
+
+        struct Statistics
+        {
+            std::size_t hits{};
+            std::size_t misses{};
+        };
+
+        CallCache() = default;
+
+        /**
+        * \brief Create a cache for a script with arities.size() functions
+        *
+        * \param arities Number of arguments of every function, or std::nullopt if calls to it must not be cached
+        * \param capacity Number of entries per function. Rounded up to the next power of two
+        * \param max_pending_calls Number of nested calls begin_call() can remember at the same time
+        */
+        explicit CallCache(
+            std::span<const std::optional<std::uint32_t>> arities, std::size_t capacity = default_capacity,
+            std::size_t max_pending_calls = default_max_pending_calls) noexcept
+            : capacity_{std::bit_ceil(std::max<std::size_t>(capacity, 1U))}, max_pending_calls_{max_pending_calls}
+        {
+            std::uint32_t max_number_of_arguments{};
+
+            functions_.reserve(arities.size());
+            for (const auto& arity : arities) {
+                auto& function = functions_.emplace_back();
+                if (!arity.has_value())
+                    continue;
+
+                function.is_cached = true;
+                function.number_of_arguments = *arity;
+                function.keys.resize(capacity_ * *arity);
+                function.results.resize(capacity_);
+                function.occupied.resize(capacity_);
+                max_number_of_arguments = std::max(max_number_of_arguments, *arity);
+            }
+
+            //begin_call() never grows these past their reserved size, so it does not allocate
+            pending_calls_.reserve(max_pending_calls_);
+            pending_arguments_.reserve(max_pending_calls_ * max_number_of_arguments);
+        }
+
+        [[nodiscard]] bool is_cached(std::size_t function_index) const noexcept
+        {
+            return function_index < functions_.size() && functions_[function_index].is_cached;
+        }
+
+        [[nodiscard]] std::uint32_t number_of_arguments(std::size_t function_index) const noexcept
+        {
+            return functions_[function_index].number_of_arguments;
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        /**
+        * \brief Look up the result of a call. Counts as a hit or a miss in the statistics
+        */
+        [[nodiscard]] std::optional<double> find(std::size_t function_index, std::span<const double> arguments) noexcept
+        {
+            auto& function = functions_[function_index];
+            const auto slot = _slot_for(arguments);
+
+            if (function.occupied[slot] != 0U && _keys_match(function, slot, arguments)) {
+                ++function.hits;
+                return function.results[slot];
+            }
+
+            ++function.misses;
+            return std::nullopt;
+        }
+
+        void insert(std::size_t function_index, std::span<const double> arguments, double result) noexcept
+        {
+            auto& function = functions_[function_index];
+            const auto slot = _slot_for(arguments);
+
+            std::ranges::copy(arguments, std::next(function.keys.begin(), static_cast<std::ptrdiff_t>(slot * arguments.size())));
+            function.results[slot] = result;
+            function.occupied[slot] = 1U;
+        }
+
+        /**
+        * \brief Remember the arguments of a call that missed so its result can be inserted by finish_call()
+        *
+        * The arguments are copied because the callee may overwrite them. depth must uniquely identify the call among all calls
+        * that are active at the same time, for example the depth of the call stack after entering the callee.
+        * If max_pending_calls calls are already waiting, the call is not remembered and its result is not inserted.
+        */
+        void begin_call(std::size_t function_index, std::span<const double> arguments, std::size_t depth) noexcept
+        {
+            if (pending_calls_.size() == max_pending_calls_) [[unlikely]]
+                return;
+
+            pending_calls_.push_back(PendingCall{function_index, depth, pending_arguments_.size()});
+            pending_arguments_.insert(pending_arguments_.end(), arguments.begin(), arguments.end());
+        }
+
+        /**
+        * \brief Called whenever a function at depth returns. Inserts the result if that call was started with begin_call()
+        */
+        void finish_call(std::size_t depth, double result) noexcept
+        {
+            if (pending_calls_.empty() || pending_calls_.back().depth != depth)
+                return;
+
+            const auto call = pending_calls_.back();
+            pending_calls_.pop_back();
+
+            const auto arguments = std::span{pending_arguments_}.subspan(call.first_argument);
+            insert(call.function_index, arguments, result);
+            pending_arguments_.resize(call.first_argument);
+        }
+
+        /**
+        * \brief Forget all calls that never returned, for example because the run was aborted
+        */
+        void reset_pending_calls() noexcept
+        {
+            pending_calls_.clear();
+            pending_arguments_.clear();
+        }
+
+        /**
+        * \brief Drop all entries and statistics but keep the memory
+        */
+        void clear() noexcept
+        {
+            reset_pending_calls();
+            for (auto& function : functions_) {
+                std::ranges::fill(function.occupied, std::uint8_t{0});
+                function.hits = 0U;
+                function.misses = 0U;
+            }
+        }
+
+        [[nodiscard]] Statistics statistics(std::size_t function_index) const noexcept
+        {
+            const auto& function = functions_[function_index];
+            return Statistics{function.hits, function.misses};
+        }
+
+        [[nodiscard]] Statistics statistics() const noexcept
+        {
+            Statistics total{};
+            for (const auto& function : functions_) {
+                total.hits += function.hits;
+                total.misses += function.misses;
+            }
+            return total;
+        }
+
+    private:
+        [[nodiscard]] static std::uint64_t _mix(std::uint64_t x) noexcept
+        {
+            //splitmix64 finalizer
+            x += 0x9E37'79B9'7F4A'7C15U;
+            x = (x ^ (x >> 30U)) * 0xBF58'476D'1CE4'E5B9U;
+            x = (x ^ (x >> 27U)) * 0x94D0'49BB'1331'11EBU;
+            return x ^ (x >> 31U);
+        }
+
+        [[nodiscard]] std::size_t _slot_for(std::span<const double> arguments) const noexcept
+        {
+            std::uint64_t hash{};
+            for (const auto argument : arguments) {
+                hash = _mix(hash ^ std::bit_cast<std::uint64_t>(argument));
+            }
+            return static_cast<std::size_t>(hash & (capacity_ - 1U));
+        }
+
+        [[nodiscard]] static bool
+        _keys_match(const FunctionTable& function, std::size_t slot, std::span<const double> arguments) noexcept
+        {
+            const auto first_key = slot * arguments.size();
+            for (std::size_t i{}; i != arguments.size(); ++i) {
+                if (std::bit_cast<std::uint64_t>(function.keys[first_key + i]) != std::bit_cast<std::uint64_t>(arguments[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        std::size_t capacity_{default_capacity};
+        std::size_t max_pending_calls_{};
+        std::vector<FunctionTable> functions_{};
+        std::vector<PendingCall> pending_calls_{};
+        std::vector<double> pending_arguments_{};
+    };
+
+} // namespace RaychelScript
+
+#endif //!RAYCHELSCRIPT_CALL_CACHE_H
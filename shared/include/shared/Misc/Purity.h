@@ -0,0 +1,101 @@
+/**
+* \file Purity.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the function purity analysis
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_PURITY_H
+#define RAYCHELSCRIPT_PURITY_H
+
+#include "WalkAST.h"
+#include "shared/AST/AST.h"
+
+#include <set>
+#include <string>
+
+namespace RaychelScript {
+
+    namespace details {
+
+        //A declaration without an initializer reads whatever the previous call left in its memory location
+        [[nodiscard]] inline bool has_uninitialized_variables(const FunctionData& function) noexcept
+        {
+            std::size_t number_of_declarations{};
+            std::size_t number_of_initialized_declarations{};
+            for_each_node(function.body, [&](const AST_Node& node) {
+                if (node.type() == NodeType::variable_decl) {
+                    ++number_of_declarations;
+                } else if (node.type() == NodeType::assignment) {
+                    if (node.to_node_data<AssignmentExpressionData>().lhs.type() == NodeType::variable_decl)
+                        ++number_of_initialized_declarations;
+                }
+            });
+            return number_of_declarations != number_of_initialized_declarations;
+        }
+
+    } // namespace details
+
+    /**
+    * \brief Find all functions whose result only depends on their arguments
+    *
+    * Functions can only see their own arguments and locals, so a function is pure unless it declares a variable without
+    * initializing it or calls a function that is not pure.
+    */
+    [[nodiscard]] inline std::set<std::string> find_pure_functions(const AST& ast) noexcept
+    {
+        std::set<std::string> pure_functions;
+        for (const auto& [name, function] : ast.functions) {
+            if (!details::has_uninitialized_variables(function))
+                pure_functions.insert(name);
+        }
+
+        //Every round removes the functions calling one that was removed in the round before, until nothing changes
+        bool changed{true};
+        while (changed) {
+            changed = false;
+            for (const auto& [name, function] : ast.functions) {
+                if (!pure_functions.contains(name))
+                    continue;
+
+                bool calls_impure_function{false};
+                for_each_node(function.body, [&](const AST_Node& node) {
+                    if (node.type() == NodeType::function_call &&
+                        !pure_functions.contains(node.to_node_data<FunctionCallData>().mangled_callee_name)) {
+                        calls_impure_function = true;
+                    }
+                });
+
+                if (calls_impure_function) {
+                    pure_functions.erase(name);
+                    changed = true;
+                }
+            }
+        }
+
+        return pure_functions;
+    }
+
+} // namespace RaychelScript
+
+#endif //!RAYCHELSCRIPT_PURITY_H
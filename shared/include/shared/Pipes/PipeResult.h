@@ -49,6 +49,10 @@ namespace RaychelScript {
         enum class ParserErrorCode;
     } //namespace Parser
 
+    namespace Optimizer {
+        enum class OptimizerErrorCode;
+    } //namespace Optimizer
+
     namespace Interpreter {
         enum class InterpreterErrorCode;
     } // namespace Interpreter
@@ -102,6 +106,10 @@ namespace RaychelScript::Pipes {
         struct _error_type_for<Parser::ParserErrorCode> : _base<ErrorType::parser_error>
         {};
 
+        template <>
+        struct _error_type_for<Optimizer::OptimizerErrorCode> : _base<ErrorType::optimizer_error>
+        {};
+
         template <>
         struct _error_type_for<Interpreter::InterpreterErrorCode> : _base<ErrorType::interpreter_error>
         {};
@@ -306,7 +314,8 @@ namespace RaychelScript::Pipes {
                 Logger::error("Parser error: ", result.template to_error_code<Parser::ParserErrorCode>(), '\n');
                 break;
             case ErrorType::optimizer_error:
-                RAYCHEL_TODO("Handle optimizer error codes");
+                Logger::error("Optimizer error: ", result.template to_error_code<Optimizer::OptimizerErrorCode>(), '\n');
+                break;
             case ErrorType::interpreter_error:
                 Logger::error("Interpreter error: ", result.template to_error_code<Interpreter::InterpreterErrorCode>(), '\n');
                 break;
@@ -0,0 +1,71 @@
+/**
+* \file LazyVMData.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for LazyVMData struct
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_LAZY_VM_DATA_H
+#define RAYCHELSCRIPT_LAZY_VM_DATA_H
+
+#include "VMData.h"
+
+#include <cstdint>
+#include <span>
+
+namespace RaychelScript::VM {
+
+    /**
+    * \brief Callback the VM uses to load the instructions of a call frame the first time jsr reaches it
+    *
+    * load returns a pointer to the instructions of call frame frame_index, or nullptr if they could not be loaded. The
+    * returned instructions have to stay valid until the execution finishes.
+    */
+    struct FrameLoader
+    {
+        using LoadFunction = const Assembly::Instruction* (*)(void* context, std::uint32_t frame_index) noexcept;
+
+        void* context{};
+        LoadFunction load{};
+    };
+
+    /**
+    * \brief A script whose call frames are loaded on demand
+    *
+    * Call frames without instructions have not been loaded yet and are handed to loader once they are called.
+    * Usually obtained from a rasm LazyRSBF.
+    */
+    struct LazyVMData
+    {
+        std::uint32_t num_input_identifiers{};
+        std::uint32_t num_output_identifiers{};
+
+        std::span<const double> immediate_values{};
+        std::span<const CallFrameDescriptor> call_frames{};
+
+        FrameLoader loader{};
+    };
+
+} // namespace RaychelScript::VM
+
+#endif //!RAYCHELSCRIPT_LAZY_VM_DATA_H
@@ -0,0 +1,149 @@
+/**
+* \file LinkedVMData.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for the linked (single code segment) form of VMData
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_LINKED_VM_DATA_H
+#define RAYCHELSCRIPT_LINKED_VM_DATA_H
+
+#include "VMData.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace RaychelScript::VM {
+
+    constexpr std::size_t code_alignment = 64U; //one cache line
+
+    template <typename T>
+    struct CodeAllocator
+    {
+        using value_type = T;
+
+        CodeAllocator() = default;
+
+        template <typename U>
+        constexpr CodeAllocator(const CodeAllocator<U>&) noexcept //NOLINT: allocators must be implicitly convertible
+        {}
+
+        [[nodiscard]] T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{code_alignment}));
+        }
+
+        void deallocate(T* p, std::size_t /*unused*/) noexcept
+        {
+            ::operator delete(p, std::align_val_t{code_alignment});
+        }
+
+        template <typename U>
+        constexpr bool operator==(const CodeAllocator<U>& /*unused*/) const noexcept
+        {
+            return true;
+        }
+    };
+
+    using CodeSegment = std::vector<Assembly::Instruction, CodeAllocator<Assembly::Instruction>>;
+
+    struct LinkedCallFrameDescriptor
+    {
+        std::uint32_t entry_point{}; //offset of the first instruction in the code segment
+        std::uint32_t number_of_instructions{};
+        std::uint32_t size{1};
+    };
+
+    /**
+    * \brief VMData with the instructions of all call frames laid out in one contiguous code segment
+    *
+    * Every call frame starts on a cache line boundary. The gaps between frames are filled with hlt instructions.
+    */
+    struct LinkedVMData
+    {
+        std::uint32_t num_input_identifiers{};
+        std::uint32_t num_output_identifiers{};
+
+        std::vector<double> immediate_values{};
+        CodeSegment code{};
+        std::vector<LinkedCallFrameDescriptor> call_frames{};
+    };
+
+    namespace details {
+
+        constexpr std::size_t instructions_per_cache_line = code_alignment / sizeof(Assembly::Instruction);
+
+        inline void pad_code_segment(CodeSegment& code)
+        {
+            while (code.size() % instructions_per_cache_line != 0U)
+                code.emplace_back(Assembly::OpCode::hlt);
+        }
+
+    } // namespace details
+
+    /**
+    * \brief Append a call frame to the code segment of data
+    */
+    inline void
+    link_call_frame(LinkedVMData& data, std::uint32_t size, const Assembly::Instruction* begin, const Assembly::Instruction* end)
+    {
+        details::pad_code_segment(data.code);
+
+        data.call_frames.emplace_back(LinkedCallFrameDescriptor{
+            .entry_point = static_cast<std::uint32_t>(data.code.size()),
+            .number_of_instructions = static_cast<std::uint32_t>(end - begin),
+            .size = size,
+        });
+        data.code.insert(data.code.end(), begin, end);
+    }
+
+    [[nodiscard]] inline LinkedVMData link(const VMData& data)
+    {
+        LinkedVMData linked{
+            .num_input_identifiers = data.num_input_identifiers,
+            .num_output_identifiers = data.num_output_identifiers,
+            .immediate_values = data.immediate_values,
+            .code = {},
+            .call_frames = {},
+        };
+
+        std::size_t code_size{};
+        for (const auto& frame : data.call_frames) {
+            code_size += frame.instructions.size() + details::instructions_per_cache_line;
+        }
+        linked.code.reserve(code_size);
+        linked.call_frames.reserve(data.call_frames.size());
+
+        for (const auto& frame : data.call_frames) {
+            const auto* begin = frame.instructions.data();
+            link_call_frame(linked, frame.size, begin, begin + frame.instructions.size()); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        return linked;
+    }
+
+} // namespace RaychelScript::VM
+
+#endif //!RAYCHELSCRIPT_LINKED_VM_DATA_H
@@ -36,9 +36,13 @@ namespace RaychelScript::VM {
 
     struct CallFrameDescriptor
     {
-        std::uint8_t size{1};
+        std::uint32_t size{1};
 
         std::vector<Assembly::Instruction> instructions{};
+
+        //Filled in by the Assembler and saved in RSBF files since version 10. Frames without them are never memoised
+        std::uint32_t num_arguments{};
+        bool is_pure{};
     };
 
     /**
@@ -46,8 +50,8 @@ namespace RaychelScript::VM {
     */
     struct VMData
     {
-        std::uint8_t num_input_identifiers{};
-        std::uint8_t num_output_identifiers{};
+        std::uint32_t num_input_identifiers{};
+        std::uint32_t num_output_identifiers{};
 
         std::vector<double> immediate_values{};
         std::vector<CallFrameDescriptor> call_frames{};
@@ -0,0 +1,67 @@
+/**
+* \file VMDataView.h
+* \author Weckyy702 (weckyy702@gmail.com)
+* \brief Header file for non-owning views of linked VM data
+* \date 2026-10-16
+*
+* MIT License
+* Copyright (c) [2026] [Weckyy702 (weckyy702@gmail.com | https://github.com/Weckyy702)]
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+*/
+#ifndef RAYCHELSCRIPT_VM_DATA_VIEW_H
+#define RAYCHELSCRIPT_VM_DATA_VIEW_H
+
+#include "LinkedVMData.h"
+
+#include <cstdint>
+#include <span>
+
+namespace RaychelScript::VM {
+
+    /**
+    * \brief Non-owning form of LinkedVMData
+    *
+    * The spans usually point straight into a memory mapped RSBF file (see rasm/map.h), so a script can be executed without
+    * copying its code anywhere. The viewed memory has to outlive the view.
+    */
+    struct VMDataView
+    {
+        std::uint32_t num_input_identifiers{};
+        std::uint32_t num_output_identifiers{};
+
+        std::span<const double> immediate_values{};
+        std::span<const Assembly::Instruction> code{};
+        std::span<const LinkedCallFrameDescriptor> call_frames{};
+    };
+
+    [[nodiscard]] inline VMDataView view_of(const LinkedVMData& data) noexcept
+    {
+        return VMDataView{
+            .num_input_identifiers = data.num_input_identifiers,
+            .num_output_identifiers = data.num_output_identifiers,
+            .immediate_values = data.immediate_values,
+            .code = data.code,
+            .call_frames = data.call_frames,
+        };
+    }
+
+} // namespace RaychelScript::VM
+
+#endif //!RAYCHELSCRIPT_VM_DATA_VIEW_H
@@ -31,36 +31,55 @@
 #include "MemoryIndex.h"
 #include "OpCode.h"
 
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <ostream>
+#include <span>
 
 namespace RaychelScript::Assembly {
 
-    class Instruction
+    //The op code and three indices take up thirteen bytes. Padding to sixteen keeps instructions from straddling cache lines.
+    //Mapped RSBF files store instructions as they are in memory, so the padding is an explicit member that is always zero
+    class alignas(16) Instruction
     {
     public:
         explicit Instruction() = default;
 
-        explicit Instruction(OpCode op_code, MemoryIndex index1 = {}, MemoryIndex index2 = {})
-            : code_{op_code}, index1_{index1}, index2_{index2}
+        explicit Instruction(OpCode op_code, MemoryIndex index1 = {}, MemoryIndex index2 = {}, MemoryIndex index3 = {})
+            : code_{op_code}, index1_{index1}, index2_{index2}, index3_{index3}
         {}
 
-        static std::optional<Instruction> from_binary(std::uint32_t data) noexcept
+        /**
+        * \brief Return the op code encoded in the first word of an instruction
+        *
+        * The op code word is followed by one word per argument of the op code (see number_of_arguments())
+        */
+        [[nodiscard]] static std::optional<OpCode> op_code_from_binary(std::uint32_t data) noexcept
         {
             const auto code = static_cast<OpCode>((data >> 24U) & 0xFFU);
-            if (code >= OpCode::num_op_codes) {
+            if (code >= OpCode::num_op_codes || (data & 0xFF'FFFFU) != 0U) {
                 return std::nullopt;
             }
-            const auto maybe_index1 = MemoryIndex::from_binary((data >> 12U) & 0xFFFU);
-            if (!maybe_index1.has_value()) {
+            return code;
+        }
+
+        static std::optional<Instruction> from_binary(OpCode code, std::span<const std::uint32_t> indices) noexcept
+        {
+            if (code >= OpCode::num_op_codes || indices.size() != number_of_arguments(code)) {
                 return std::nullopt;
             }
-            const auto maybe_index2 = MemoryIndex::from_binary(data & 0xFFFU);
-            if (!maybe_index2.has_value()) {
-                return std::nullopt;
+
+            std::array<MemoryIndex, 3> decoded{};
+            for (std::size_t i{}; i != indices.size(); ++i) {
+                const auto maybe_index = MemoryIndex::from_binary(indices[i]);
+                if (!maybe_index.has_value()) {
+                    return std::nullopt;
+                }
+                decoded.at(i) = maybe_index.value();
             }
 
-            return Instruction{code, maybe_index1.value(), maybe_index2.value()};
+            return Instruction{code, decoded[0], decoded[1], decoded[2]};
         }
 
         [[nodiscard]] std::uint32_t to_binary() const noexcept
@@ -68,16 +87,10 @@ namespace RaychelScript::Assembly {
             /*
             Instruction layout:
             |....:....|....:....|....:....|....:....|
-            |OpCode...|....Index1....|....Index2....|
+            |OpCode...|............Zero.............|
+            The op code word is followed by the binary form of the first number_of_arguments() indices
             */
-
-            std::uint32_t instr{};
-
-            instr |= (static_cast<std::uint32_t>(code_) & 0xFFU) << 24U;
-            instr |= index1_.to_binary() << 12U;
-            instr |= index2_.to_binary();
-
-            return instr;
+            return (static_cast<std::uint32_t>(code_) & 0xFFU) << 24U;
         }
 
         [[nodiscard]] auto op_code() const noexcept
@@ -95,6 +108,11 @@ namespace RaychelScript::Assembly {
             return index2_;
         }
 
+        [[nodiscard]] auto index3() const noexcept
+        {
+            return index3_;
+        }
+
         [[nodiscard]] auto& index1() noexcept
         {
             return index1_;
@@ -105,10 +123,17 @@ namespace RaychelScript::Assembly {
             return index2_;
         }
 
+        [[nodiscard]] auto& index3() noexcept
+        {
+            return index3_;
+        }
+
     private:
         OpCode code_{OpCode::num_op_codes};
+        std::array<std::uint8_t, 3> reserved_{};
         MemoryIndex index1_{};
         MemoryIndex index2_{};
+        MemoryIndex index3_{};
     };
 
     inline std::ostream& operator<<(std::ostream& os, const Instruction& instr) noexcept
@@ -122,6 +147,9 @@ namespace RaychelScript::Assembly {
         if (num_args > 1) {
             os << ' ' << instr.index2();
         }
+        if (num_args > 2) {
+            os << ' ' << instr.index3();
+        }
         return os;
     }
 
@@ -48,9 +48,16 @@ namespace RaychelScript::Assembly {
             num_value_types,
         };
 
+        //The value and type of an index share one 32-bit word. Jump offsets are stored in two's complement
+        static constexpr std::uint32_t value_bits = 28U;
+        static constexpr std::uint32_t max_value = (1U << value_bits) - 1U;
+        static constexpr std::int32_t min_offset = -(1 << (value_bits - 1U));
+        static constexpr std::int32_t max_offset = (1 << (value_bits - 1U)) - 1;
+
     private:
         template <std::integral T>
-        explicit constexpr MemoryIndex(T index, ValueType type) : data_{static_cast<std::uint8_t>(index)}, type_{type}
+        explicit constexpr MemoryIndex(T index, ValueType type)
+            : data_{((static_cast<std::uint32_t>(index) & max_value) << 4U) | static_cast<std::uint32_t>(type)}
         {}
 
     public:
@@ -58,31 +65,38 @@ namespace RaychelScript::Assembly {
 
         static_assert(static_cast<std::uint8_t>(num_value_types) - 1 <= 0xFU, "Memory index value types must fit into 4 bytes");
 
-        [[nodiscard]] constexpr std::uint8_t value() const noexcept
+        [[nodiscard]] constexpr std::uint32_t value() const noexcept
         {
-            return data_;
+            return data_ >> 4U;
+        }
+
+        /**
+        * \brief Return the value of a jump offset index, sign-extended
+        */
+        [[nodiscard]] constexpr std::int32_t offset() const noexcept
+        {
+            return static_cast<std::int32_t>(data_) >> 4U;
         }
 
         [[nodiscard]] constexpr ValueType type() const noexcept
         {
-            return type_;
+            return static_cast<ValueType>(data_ & 0xFU);
         }
 
         [[nodiscard]] static constexpr std::optional<MemoryIndex> from_binary(std::uint32_t data) noexcept
         {
-            const auto value = static_cast<std::uint8_t>(data >> 4U);
             const auto type = static_cast<ValueType>(data & 0xFU);
             if (type >= ValueType::num_value_types)
                 return std::nullopt;
-            return MemoryIndex{value, type};
+            return MemoryIndex{data >> 4U, type};
         }
 
         [[nodiscard]] constexpr std::uint32_t to_binary() const noexcept
         {
             //Index layout:
             //|....:....|....:....|....:....|....:....|
-            //|..........Zero..........|..Data...|Type|
-            return (static_cast<std::uint32_t>(data_) << 4U) | static_cast<std::uint32_t>(type_);
+            //|..................Data............|Type|
+            return data_;
         }
 
         constexpr MemoryIndex() = default;
@@ -93,8 +107,7 @@ namespace RaychelScript::Assembly {
         template <std::integral T>
         friend constexpr MemoryIndex make_memory_index(T value, ValueType type);
 
-        std::uint8_t data_{};
-        ValueType type_{};
+        std::uint32_t data_{};
     };
 
     template <std::integral T>
@@ -107,9 +120,11 @@ namespace RaychelScript::Assembly {
     constexpr MemoryIndex make_memory_index(T value, MemoryIndex::ValueType type)
     {
         if (type == MemoryIndex::ValueType::jump_offset) {
-            RAYCHEL_ASSERT(std::in_range<std::int8_t>(value)); //jump offsets can be negative
+            //jump offsets can be negative
+            RAYCHEL_ASSERT(
+                std::cmp_greater_equal(value, MemoryIndex::min_offset) && std::cmp_less_equal(value, MemoryIndex::max_offset));
         } else {
-            RAYCHEL_ASSERT(std::in_range<std::uint8_t>(value));
+            RAYCHEL_ASSERT(std::cmp_greater_equal(value, 0) && std::cmp_less_equal(value, MemoryIndex::max_value));
         }
         return MemoryIndex{value, type};
     }
@@ -146,8 +161,8 @@ namespace RaychelScript::Assembly {
     {
         os << prefix_for(index.type());
         if (index.type() == MemoryIndex::ValueType::jump_offset)
-            return os << static_cast<std::int32_t>(static_cast<std::int8_t>(index.value()));
-        return os << static_cast<std::uint32_t>(static_cast<std::uint8_t>(index.value()));
+            return os << index.offset();
+        return os << index.value();
     }
 
 } // namespace RaychelScript::Assembly
@@ -67,6 +67,17 @@ namespace RaychelScript::Assembly {
         ret, //return from subroutine
         put, //put argument into the next stack frame
 
+        //fused instructions (superinstructions). These are only emitted by the peephole pass in the assembler
+        jnl, //jump by c if a is not less than b (clt a b; jpz c). Does not set the flag
+        jng, //jump by c if a is not greater than b (cgt a b; jpz c). Does not set the flag
+        jne, //jump by c if a is not equal to b (ceq a b; jpz c). Does not set the flag
+        jeq, //jump by c if a is equal to b (cne a b; jpz c). Does not set the flag
+        mad, //multiply a by b and add c (a * b + c)
+        adt, //add b to a and store the result in c (add a b; mov A c)
+        sbt, //subtract b from a and store the result in c (sub a b; mov A c)
+        mlt, //multiply a by b and store the result in c (mul a b; mov A c)
+        dvt, //divide a by b and store the result in c (div a b; mov A c)
+
         num_op_codes
     };
 
@@ -119,6 +130,24 @@ namespace RaychelScript::Assembly {
                 return "RET";
             case OpCode::put:
                 return "PUT";
+            case OpCode::jnl:
+                return "JNL";
+            case OpCode::jng:
+                return "JNG";
+            case OpCode::jne:
+                return "JNE";
+            case OpCode::jeq:
+                return "JEQ";
+            case OpCode::mad:
+                return "MAD";
+            case OpCode::adt:
+                return "ADT";
+            case OpCode::sbt:
+                return "SBT";
+            case OpCode::mlt:
+                return "MLT";
+            case OpCode::dvt:
+                return "DVT";
             case OpCode::num_op_codes:
                 break;
         }
@@ -128,6 +157,16 @@ namespace RaychelScript::Assembly {
     [[nodiscard]] constexpr std::size_t number_of_arguments(OpCode code) noexcept
     {
         switch (code) {
+            case OpCode::jnl:
+            case OpCode::jng:
+            case OpCode::jne:
+            case OpCode::jeq:
+            case OpCode::mad:
+            case OpCode::adt:
+            case OpCode::sbt:
+            case OpCode::mlt:
+            case OpCode::dvt:
+                return 3;
             case OpCode::mov:
             case OpCode::add:
             case OpCode::sub: